@@ -36,6 +36,8 @@
  * sink is shut down or reaches EOS. There are also timed variants of these
  * methods, gst_app_sink_try_pull_sample() and gst_app_sink_try_pull_preroll(),
  * which accept a timeout parameter to limit the amount of time to wait.
+ * Applications that pull many small buffers can use
+ * gst_app_sink_pull_buffer_list() to take all the queued buffers at once.
  *
  * Appsink will internally use a queue to collect buffers from the streaming
  * thread. If the application is not pulling samples fast enough, this queue
@@ -67,6 +69,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/base/gstqueuearray.h>
 #include <gst/gstbuffer.h>
 #include <gst/gstbufferlist.h>
 
@@ -85,7 +88,9 @@ struct _GstAppSinkPrivate
 
   GCond cond;
   GMutex mutex;
-  GQueue *queue;
+  GstQueueArray *queue;
+  guint app_waiting;            /* application threads waiting for data */
+  guint stream_waiting;         /* streaming thread waiting for the app */
   GstBuffer *preroll;
   GstCaps *preroll_caps;
   GstCaps *last_caps;
@@ -117,6 +122,8 @@ enum
   SIGNAL_PULL_SAMPLE,
   SIGNAL_TRY_PULL_PREROLL,
   SIGNAL_TRY_PULL_SAMPLE,
+  SIGNAL_PULL_BUFFER_LIST,
+  SIGNAL_TRY_PULL_BUFFER_LIST,
 
   LAST_SIGNAL
 };
@@ -411,6 +418,43 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
       G_STRUCT_OFFSET (GstAppSinkClass, try_pull_sample), NULL, NULL, NULL,
       GST_TYPE_SAMPLE, 1, GST_TYPE_CLOCK_TIME);
 
+  /**
+   * GstAppSink::pull-buffer-list:
+   * @appsink: the appsink element to emit this signal on
+   *
+   * Take all the buffers that are queued in @appsink at once, in the
+   * #GstBufferList of one sample. See gst_app_sink_pull_buffer_list().
+   *
+   * Returns: a #GstSample with a #GstBufferList or NULL when the appsink is
+   *     stopped or EOS.
+   *
+   * Since: 1.12
+   */
+  gst_app_sink_signals[SIGNAL_PULL_BUFFER_LIST] =
+      g_signal_new_class_handler ("pull-buffer-list",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_app_sink_pull_buffer_list), NULL, NULL, NULL,
+      GST_TYPE_SAMPLE, 0, G_TYPE_NONE);
+
+  /**
+   * GstAppSink::try-pull-buffer-list:
+   * @appsink: the appsink element to emit this signal on
+   * @timeout: the maximum amount of time to wait for a buffer
+   *
+   * Take all the buffers that are queued in @appsink at once, in the
+   * #GstBufferList of one sample. See gst_app_sink_try_pull_buffer_list().
+   *
+   * Returns: a #GstSample with a #GstBufferList or NULL when the appsink is
+   *     stopped or EOS or the timeout expires.
+   *
+   * Since: 1.12
+   */
+  gst_app_sink_signals[SIGNAL_TRY_PULL_BUFFER_LIST] =
+      g_signal_new_class_handler ("try-pull-buffer-list",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_CALLBACK (gst_app_sink_try_pull_buffer_list), NULL, NULL, NULL,
+      GST_TYPE_SAMPLE, 1, GST_TYPE_CLOCK_TIME);
+
   gst_element_class_set_static_metadata (element_class, "AppSink",
       "Generic/Sink", "Allow the application to get access to raw buffer",
       "David Schleef <ds@schleef.org>, Wim Taymans <wim.taymans@gmail.com>");
@@ -449,7 +493,7 @@ gst_app_sink_init (GstAppSink * appsink)
 
   g_mutex_init (&priv->mutex);
   g_cond_init (&priv->cond);
-  priv->queue = g_queue_new ();
+  priv->queue = gst_queue_array_new (16);
 
   priv->emit_signals = DEFAULT_PROP_EMIT_SIGNALS;
   priv->max_buffers = DEFAULT_PROP_MAX_BUFFERS;
@@ -479,7 +523,7 @@ gst_app_sink_dispose (GObject * obj)
   GST_OBJECT_UNLOCK (appsink);
 
   g_mutex_lock (&priv->mutex);
-  while ((queue_obj = g_queue_pop_head (priv->queue)))
+  while ((queue_obj = gst_queue_array_pop_head (priv->queue)))
     gst_mini_object_unref (queue_obj);
   gst_buffer_replace (&priv->preroll, NULL);
   gst_caps_replace (&priv->preroll_caps, NULL);
@@ -497,7 +541,7 @@ gst_app_sink_finalize (GObject * obj)
 
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
-  g_queue_free (priv->queue);
+  gst_queue_array_free (priv->queue);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -615,7 +659,7 @@ gst_app_sink_flush_unlocked (GstAppSink * appsink)
   GST_DEBUG_OBJECT (appsink, "flush stop appsink");
   priv->is_eos = FALSE;
   gst_buffer_replace (&priv->preroll, NULL);
-  while ((obj = g_queue_pop_head (priv->queue)))
+  while ((obj = gst_queue_array_pop_head (priv->queue)))
     gst_mini_object_unref (obj);
   priv->num_buffers = 0;
   g_cond_signal (&priv->cond);
@@ -667,7 +711,7 @@ gst_app_sink_setcaps (GstBaseSink * sink, GstCaps * caps)
 
   g_mutex_lock (&priv->mutex);
   GST_DEBUG_OBJECT (appsink, "receiving CAPS");
-  g_queue_push_tail (priv->queue, gst_event_new_caps (caps));
+  gst_queue_array_push_tail (priv->queue, gst_event_new_caps (caps));
   if (!priv->preroll)
     gst_caps_replace (&priv->preroll_caps, caps);
   g_mutex_unlock (&priv->mutex);
@@ -685,7 +729,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_SEGMENT:
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving SEGMENT");
-      g_queue_push_tail (priv->queue, gst_event_ref (event));
+      gst_queue_array_push_tail (priv->queue, gst_event_ref (event));
       if (!priv->preroll)
         gst_event_copy_segment (event, &priv->preroll_segment);
       g_mutex_unlock (&priv->mutex);
@@ -704,8 +748,10 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
        * Otherwise we might signal EOS before all buffers are
        * consumed, which is a bit confusing for the application
        */
+      priv->stream_waiting++;
       while (priv->num_buffers > 0 && !priv->flushing && priv->wait_on_eos)
         g_cond_wait (&priv->cond, &priv->mutex);
+      priv->stream_waiting--;
       if (priv->flushing)
         emit = FALSE;
       g_mutex_unlock (&priv->mutex);
@@ -782,7 +828,7 @@ dequeue_buffer (GstAppSink * appsink)
   GstMiniObject *obj;
 
   do {
-    obj = g_queue_pop_head (priv->queue);
+    obj = gst_queue_array_pop_head (priv->queue);
 
     if (GST_IS_BUFFER (obj) || GST_IS_BUFFER_LIST (obj)) {
       GST_DEBUG_OBJECT (appsink, "dequeued buffer/list %p", obj);
@@ -816,6 +862,57 @@ dequeue_buffer (GstAppSink * appsink)
   return obj;
 }
 
+/* called with the lock held, waits until a buffer can be dequeued. Returns
+ * FALSE when stopped, EOS or when the timeout expired */
+static gboolean
+gst_app_sink_wait_buffer (GstAppSink * appsink, GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  gboolean timeout_valid;
+  gint64 end_time = 0;
+  gboolean res = TRUE;
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv->app_waiting++;
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab a buffer");
+    if (!priv->started) {
+      GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+      res = FALSE;
+      break;
+    }
+
+    if (priv->num_buffers > 0)
+      break;
+
+    if (priv->is_eos) {
+      GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+      res = FALSE;
+      break;
+    }
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    if (timeout_valid) {
+      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time)) {
+        GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+        res = FALSE;
+        break;
+      }
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
+  }
+  priv->app_waiting--;
+
+  return res;
+}
+
 static GstFlowReturn
 gst_app_sink_render_common (GstBaseSink * psink, GstMiniObject * data,
     gboolean is_list)
@@ -866,15 +963,19 @@ restart:
       }
 
       /* wait for a buffer to be removed or flush */
+      priv->stream_waiting++;
       g_cond_wait (&priv->cond, &priv->mutex);
+      priv->stream_waiting--;
       if (priv->flushing)
         goto flushing;
     }
   }
   /* we need to ref the buffer/list when pushing it in the queue */
-  g_queue_push_tail (priv->queue, gst_mini_object_ref (data));
+  gst_queue_array_push_tail (priv->queue, gst_mini_object_ref (data));
   priv->num_buffers++;
-  g_cond_signal (&priv->cond);
+  /* only wake up the application when it is waiting for data */
+  if (priv->app_waiting)
+    g_cond_signal (&priv->cond);
   emit = priv->emit_signals;
   g_mutex_unlock (&priv->mutex);
 
@@ -1532,41 +1633,15 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
   GstAppSinkPrivate *priv;
   GstSample *sample = NULL;
   GstMiniObject *obj;
-  gboolean timeout_valid;
-  gint64 end_time;
 
   g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
 
-  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
-
-  if (timeout_valid)
-    end_time =
-        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
-
   priv = appsink->priv;
 
   g_mutex_lock (&priv->mutex);
 
-  while (TRUE) {
-    GST_DEBUG_OBJECT (appsink, "trying to grab a buffer");
-    if (!priv->started)
-      goto not_started;
-
-    if (priv->num_buffers > 0)
-      break;
-
-    if (priv->is_eos)
-      goto eos;
-
-    /* nothing to return, wait */
-    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
-    if (timeout_valid) {
-      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
-        goto expired;
-    } else {
-      g_cond_wait (&priv->cond, &priv->mutex);
-    }
-  }
+  if (!gst_app_sink_wait_buffer (appsink, timeout))
+    goto no_buffer;
 
   obj = dequeue_buffer (appsink);
   if (GST_IS_BUFFER (obj)) {
@@ -1580,27 +1655,137 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
   }
   gst_mini_object_unref (obj);
 
-  g_cond_signal (&priv->cond);
+  /* only wake up the streaming thread when it is waiting for space */
+  if (priv->stream_waiting)
+    g_cond_signal (&priv->cond);
   g_mutex_unlock (&priv->mutex);
 
   return sample;
 
-  /* special conditions */
-expired:
+no_buffer:
   {
-    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
     g_mutex_unlock (&priv->mutex);
     return NULL;
   }
-eos:
-  {
-    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
-    g_mutex_unlock (&priv->mutex);
-    return NULL;
+}
+
+/**
+ * gst_app_sink_pull_buffer_list:
+ * @appsink: a #GstAppSink
+ *
+ * This function blocks until a sample or EOS becomes available or the appsink
+ * element is set to the READY/NULL state.
+ *
+ * Unlike gst_app_sink_pull_sample(), this function takes all the buffers
+ * that are queued in @appsink at once and returns them in the #GstBufferList
+ * of a single #GstSample. The list stops before the first buffer that has
+ * different caps or a different segment, which will be returned by the next
+ * call. Pulling many small buffers this way is a lot cheaper than pulling
+ * them one by one.
+ *
+ * If an EOS event was received before any buffers, this function returns
+ * %NULL. Use gst_app_sink_is_eos () to check for the EOS condition.
+ *
+ * Returns: (transfer full): a #GstSample with a #GstBufferList or NULL when
+ *          the appsink is stopped or EOS. Call gst_sample_unref() after usage.
+ *
+ * Since: 1.12
+ */
+GstSample *
+gst_app_sink_pull_buffer_list (GstAppSink * appsink)
+{
+  return gst_app_sink_try_pull_buffer_list (appsink, GST_CLOCK_TIME_NONE);
+}
+
+/* adds the buffers of @obj to @list, takes ownership of @obj */
+static void
+gst_app_sink_add_to_list (GstBufferList * list, GstMiniObject * obj)
+{
+  if (GST_IS_BUFFER (obj)) {
+    gst_buffer_list_add (list, GST_BUFFER_CAST (obj));
+  } else {
+    GstBufferList *other = GST_BUFFER_LIST_CAST (obj);
+    guint i, len;
+
+    len = gst_buffer_list_length (other);
+    for (i = 0; i < len; i++)
+      gst_buffer_list_add (list,
+          gst_buffer_ref (gst_buffer_list_get (other, i)));
+    gst_buffer_list_unref (other);
   }
-not_started:
+}
+
+/**
+ * gst_app_sink_try_pull_buffer_list:
+ * @appsink: a #GstAppSink
+ * @timeout: the maximum amount of time to wait for a buffer
+ *
+ * This function blocks until a sample or EOS becomes available or the appsink
+ * element is set to the READY/NULL state or the timeout expires.
+ *
+ * Unlike gst_app_sink_try_pull_sample(), this function takes all the buffers
+ * that are queued in @appsink at once and returns them in the #GstBufferList
+ * of a single #GstSample. The list stops before the first buffer that has
+ * different caps or a different segment, which will be returned by the next
+ * call.
+ *
+ * If an EOS event was received before any buffers or the timeout expires,
+ * this function returns %NULL. Use gst_app_sink_is_eos () to check for the EOS
+ * condition.
+ *
+ * Returns: (transfer full): a #GstSample with a #GstBufferList or NULL when
+ *          the appsink is stopped or EOS or the timeout expires.
+ *          Call gst_sample_unref() after usage.
+ *
+ * Since: 1.12
+ */
+GstSample *
+gst_app_sink_try_pull_buffer_list (GstAppSink * appsink, GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GstSample *sample;
+  GstBufferList *list;
+  GstMiniObject *obj;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+
+  if (!gst_app_sink_wait_buffer (appsink, timeout))
+    goto no_buffer;
+
+  list = gst_buffer_list_new_sized (priv->num_buffers);
+
+  /* this applies the caps and segment in front of the first buffer */
+  gst_app_sink_add_to_list (list, dequeue_buffer (appsink));
+
+  /* take the following buffers until the next caps or segment */
+  while (priv->num_buffers > 0) {
+    obj = gst_queue_array_peek_head (priv->queue);
+    if (!GST_IS_BUFFER (obj) && !GST_IS_BUFFER_LIST (obj))
+      break;
+    gst_queue_array_pop_head (priv->queue);
+    priv->num_buffers--;
+    gst_app_sink_add_to_list (list, obj);
+  }
+
+  GST_DEBUG_OBJECT (appsink, "we have a list of %u buffers, %u left",
+      gst_buffer_list_length (list), priv->num_buffers);
+
+  sample = gst_sample_new (NULL, priv->last_caps, &priv->last_segment, NULL);
+  gst_sample_set_buffer_list (sample, list);
+  gst_buffer_list_unref (list);
+
+  if (priv->stream_waiting)
+    g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->mutex);
+
+  return sample;
+
+no_buffer:
   {
-    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
     g_mutex_unlock (&priv->mutex);
     return NULL;
   }
@@ -0,0 +1,36 @@
+/* GStreamer
+ * Copyright (C) 2004 Ronald Bultje <rbultje@ronald.bitfreak.net>
+ * Copyright (C) 2008 Sebastian Dröge <slomo@circular-chaos.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_AUDIO_CHANNEL_MIXER_PRIVATE_H__
+#define __GST_AUDIO_CHANNEL_MIXER_PRIVATE_H__
+
+#include <gst/audio/audio-channel-mixer.h>
+
+G_BEGIN_DECLS
+
+/* only for the unit tests: makes the mixer always use the generic functions
+ * that apply the complete matrix, to compare the faster ways of mixing with */
+#define GST_AUDIO_CHANNEL_MIXER_FLAGS_GENERIC ((GstAudioChannelMixerFlags) (1 << 30))
+
+const gchar * _gst_audio_channel_mixer_get_path (GstAudioChannelMixer * mix);
+
+G_END_DECLS
+
+#endif /* __GST_AUDIO_CHANNEL_MIXER_PRIVATE_H__ */
@@ -0,0 +1,140 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+
+#include "audio-channel-mixer-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* must match audio-channel-mixer.c */
+#define PRECISION_INT 10
+
+/* Same as the SSE2 kernels but with twice the vector width. No fused
+ * multiply-adds are used so that the results stay the same as the C
+ * version. */
+
+void
+audio_channel_mixer_mix_gfloat_avx2 (const gfloat * matrix, gint stride,
+    gint in_channels, gint out_channels, const gfloat * in, gfloat * out,
+    gint samples)
+{
+  gint n, i, o;
+  gfloat tmp[8];
+
+  for (n = 0; n < samples; n++) {
+    for (o = 0; o < out_channels; o += 8) {
+      const gfloat *m = matrix + o;
+      __m256 sum = _mm256_setzero_ps ();
+
+      for (i = 0; i < in_channels; i++, m += stride)
+        sum = _mm256_add_ps (sum,
+            _mm256_mul_ps (_mm256_set1_ps (in[i]), _mm256_load_ps (m)));
+
+      if (o + 8 <= out_channels) {
+        _mm256_storeu_ps (out + o, sum);
+      } else {
+        _mm256_storeu_ps (tmp, sum);
+        memcpy (out + o, tmp, (out_channels - o) * sizeof (gfloat));
+      }
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+void
+audio_channel_mixer_mix_gdouble_avx2 (const gdouble * matrix, gint stride,
+    gint in_channels, gint out_channels, const gdouble * in, gdouble * out,
+    gint samples)
+{
+  gint n, i, o;
+  gdouble tmp[4];
+
+  for (n = 0; n < samples; n++) {
+    for (o = 0; o < out_channels; o += 4) {
+      const gdouble *m = matrix + o;
+      __m256d sum = _mm256_setzero_pd ();
+
+      for (i = 0; i < in_channels; i++, m += stride)
+        sum = _mm256_add_pd (sum,
+            _mm256_mul_pd (_mm256_set1_pd (in[i]), _mm256_load_pd (m)));
+
+      if (o + 4 <= out_channels) {
+        _mm256_storeu_pd (out + o, sum);
+      } else {
+        _mm256_storeu_pd (tmp, sum);
+        memcpy (out + o, tmp, (out_channels - o) * sizeof (gdouble));
+      }
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+/* The 256 bit pack works per 128 bit lane, the permute moves the packed
+ * outputs of both lanes next to each other in the lower half. */
+void
+audio_channel_mixer_mix_gint16_avx2 (const gint16 * matrix, gint stride,
+    gint in_channels, gint out_channels, const gint16 * in, gint16 * out,
+    gint samples)
+{
+  const __m256i round = _mm256_set1_epi32 (1 << (PRECISION_INT - 1));
+  gint n, i, o, n_pairs = (in_channels + 1) / 2;
+  guint32 pairs[32];
+  gint16 tmp[8];
+
+  for (n = 0; n < samples; n++) {
+    for (i = 0; i + 1 < in_channels; i += 2)
+      pairs[i / 2] = (guint16) in[i] | ((guint32) (guint16) in[i + 1] << 16);
+    if (i < in_channels)
+      pairs[i / 2] = (guint16) in[i];
+
+    for (o = 0; o < out_channels; o += 8) {
+      const gint16 *m = matrix + 2 * o;
+      __m256i sum = round;
+      __m128i res;
+
+      for (i = 0; i < n_pairs; i++, m += stride)
+        sum = _mm256_add_epi32 (sum,
+            _mm256_madd_epi16 (_mm256_set1_epi32 (pairs[i]),
+                _mm256_load_si256 ((const __m256i *) m)));
+
+      sum = _mm256_srai_epi32 (sum, PRECISION_INT);
+      sum = _mm256_packs_epi32 (sum, sum);
+      res = _mm256_castsi256_si128 (_mm256_permute4x64_epi64 (sum, 0x08));
+
+      if (o + 8 <= out_channels) {
+        _mm_storeu_si128 ((__m128i *) (out + o), res);
+      } else {
+        _mm_storeu_si128 ((__m128i *) tmp, res);
+        memcpy (out + o, tmp, (out_channels - o) * sizeof (gint16));
+      }
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+#endif
@@ -0,0 +1,140 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+
+#include "audio-channel-mixer-x86-sse2.h"
+
+#if defined (HAVE_EMMINTRIN_H) && defined (__SSE2__)
+
+#include <emmintrin.h>
+
+/* must match audio-channel-mixer.c */
+#define PRECISION_INT 10
+
+/* The float matrices have a row of coefficients for each input channel,
+ * padded with zeros to @stride. A vector of output channels is calculated
+ * at a time by adding the products in the order of the input channels,
+ * like the C version does, so the results are exactly the same. */
+
+void
+audio_channel_mixer_mix_gfloat_sse2 (const gfloat * matrix, gint stride,
+    gint in_channels, gint out_channels, const gfloat * in, gfloat * out,
+    gint samples)
+{
+  gint n, i, o;
+  gfloat tmp[4];
+
+  for (n = 0; n < samples; n++) {
+    for (o = 0; o < out_channels; o += 4) {
+      const gfloat *m = matrix + o;
+      __m128 sum = _mm_setzero_ps ();
+
+      for (i = 0; i < in_channels; i++, m += stride)
+        sum = _mm_add_ps (sum,
+            _mm_mul_ps (_mm_set1_ps (in[i]), _mm_load_ps (m)));
+
+      if (o + 4 <= out_channels) {
+        _mm_storeu_ps (out + o, sum);
+      } else {
+        _mm_storeu_ps (tmp, sum);
+        memcpy (out + o, tmp, (out_channels - o) * sizeof (gfloat));
+      }
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+void
+audio_channel_mixer_mix_gdouble_sse2 (const gdouble * matrix, gint stride,
+    gint in_channels, gint out_channels, const gdouble * in, gdouble * out,
+    gint samples)
+{
+  gint n, i, o;
+
+  for (n = 0; n < samples; n++) {
+    for (o = 0; o < out_channels; o += 2) {
+      const gdouble *m = matrix + o;
+      __m128d sum = _mm_setzero_pd ();
+
+      for (i = 0; i < in_channels; i++, m += stride)
+        sum = _mm_add_pd (sum,
+            _mm_mul_pd (_mm_set1_pd (in[i]), _mm_load_pd (m)));
+
+      if (o + 2 <= out_channels)
+        _mm_storeu_pd (out + o, sum);
+      else
+        _mm_store_sd (out + o, sum);
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+/* The int16 matrix has a row for each pair of input channels with the two
+ * coefficients of every output channel next to each other, so that
+ * _mm_madd_epi16() can multiply and add a pair of input samples at once.
+ * The sums are 32 bits like in the C version and the final pack saturates
+ * like CLAMP does. */
+
+void
+audio_channel_mixer_mix_gint16_sse2 (const gint16 * matrix, gint stride,
+    gint in_channels, gint out_channels, const gint16 * in, gint16 * out,
+    gint samples)
+{
+  const __m128i round = _mm_set1_epi32 (1 << (PRECISION_INT - 1));
+  gint n, i, o, n_pairs = (in_channels + 1) / 2;
+  guint32 pairs[32];
+  gint16 tmp[4];
+
+  for (n = 0; n < samples; n++) {
+    for (i = 0; i + 1 < in_channels; i += 2)
+      pairs[i / 2] = (guint16) in[i] | ((guint32) (guint16) in[i + 1] << 16);
+    if (i < in_channels)
+      pairs[i / 2] = (guint16) in[i];
+
+    for (o = 0; o < out_channels; o += 4) {
+      const gint16 *m = matrix + 2 * o;
+      __m128i sum = round;
+
+      for (i = 0; i < n_pairs; i++, m += stride)
+        sum = _mm_add_epi32 (sum,
+            _mm_madd_epi16 (_mm_set1_epi32 (pairs[i]),
+                _mm_load_si128 ((const __m128i *) m)));
+
+      sum = _mm_srai_epi32 (sum, PRECISION_INT);
+      sum = _mm_packs_epi32 (sum, sum);
+
+      if (o + 4 <= out_channels) {
+        _mm_storel_epi64 ((__m128i *) (out + o), sum);
+      } else {
+        _mm_storel_epi64 ((__m128i *) tmp, sum);
+        memcpy (out + o, tmp, (out_channels - o) * sizeof (gint16));
+      }
+    }
+    in += in_channels;
+    out += out_channels;
+  }
+}
+
+#endif
@@ -0,0 +1,37 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef AUDIO_CHANNEL_MIXER_X86_SSE2_H
+#define AUDIO_CHANNEL_MIXER_X86_SSE2_H
+
+#include <glib.h>
+
+G_GNUC_INTERNAL void
+audio_channel_mixer_mix_gint16_sse2 (const gint16 * matrix, gint stride,
+    gint in_channels, gint out_channels, const gint16 * in, gint16 * out,
+    gint samples);
+G_GNUC_INTERNAL void
+audio_channel_mixer_mix_gfloat_sse2 (const gfloat * matrix, gint stride,
+    gint in_channels, gint out_channels, const gfloat * in, gfloat * out,
+    gint samples);
+G_GNUC_INTERNAL void
+audio_channel_mixer_mix_gdouble_sse2 (const gdouble * matrix, gint stride,
+    gint in_channels, gint out_channels, const gdouble * in, gdouble * out,
+    gint samples);
+
+#endif /* AUDIO_CHANNEL_MIXER_X86_SSE2_H */
@@ -0,0 +1,51 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "audio-channel-mixer-x86-sse2.h"
+#include "audio-channel-mixer-x86-avx2.h"
+
+static void
+audio_channel_mixer_check_x86 (const gchar * option)
+{
+  if (!strcmp (option, "sse2")) {
+#if defined (HAVE_EMMINTRIN_H) && HAVE_SSE2
+    GST_DEBUG ("enable SSE2 optimisations");
+    mix_dense_gint16 = (MixerDenseFunc) audio_channel_mixer_mix_gint16_sse2;
+    mix_dense_gfloat = (MixerDenseFunc) audio_channel_mixer_mix_gfloat_sse2;
+    mix_dense_gdouble = (MixerDenseFunc) audio_channel_mixer_mix_gdouble_sse2;
+#else
+    GST_DEBUG ("SSE2 optimisations not enabled");
+#endif
+
+    /* ORC has no flag for AVX2, ask the CPU directly. Every CPU with AVX2
+     * also has SSE2 so this is only checked here. */
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && defined (__GNUC__)
+    if (__builtin_cpu_supports ("avx2")) {
+      GST_DEBUG ("enable AVX2 optimisations");
+      mix_dense_gint16 = (MixerDenseFunc) audio_channel_mixer_mix_gint16_avx2;
+      mix_dense_gfloat = (MixerDenseFunc) audio_channel_mixer_mix_gfloat_avx2;
+      mix_dense_gdouble =
+          (MixerDenseFunc) audio_channel_mixer_mix_gdouble_avx2;
+    } else {
+      GST_DEBUG ("AVX2 not supported by the CPU");
+    }
+#else
+    GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+  }
+}
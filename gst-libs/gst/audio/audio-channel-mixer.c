@@ -27,7 +27,12 @@
 #include <math.h>
 #include <string.h>
 
+#ifdef HAVE_ORC
+#include <orc/orc.h>
+#endif
+
 #include "audio-channel-mixer.h"
+#include "audio-channel-mixer-private.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -54,8 +59,60 @@ ensure_debug_category (void)
 
 #define PRECISION_INT 10
 
+#define MEM_ALIGN(m,a) ((gint8 *)((guintptr)((gint8 *)(m) + ((a)-1)) & ~((a)-1)))
+#define ALIGN 32
+
 typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src,
     gpointer dst, gint samples);
+typedef void (*MixerDenseFunc) (gconstpointer matrix, gint stride,
+    gint in_channels, gint out_channels, gconstpointer src, gpointer dst,
+    gint samples);
+
+/* SIMD functions for dense matrices, set when the CPU supports them */
+static MixerDenseFunc mix_dense_gint16 = NULL;
+static MixerDenseFunc mix_dense_gfloat = NULL;
+static MixerDenseFunc mix_dense_gdouble = NULL;
+
+#if defined HAVE_ORC && !defined DISABLE_ORC
+# if defined (__i386__) || defined (__x86_64__)
+#  define CHECK_X86
+#  include "audio-channel-mixer-x86.h"
+# endif
+#endif
+
+static void
+audio_channel_mixer_init (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#if defined HAVE_ORC && !defined DISABLE_ORC
+    orc_init ();
+    {
+      OrcTarget *target = orc_target_get_default ();
+      gint i;
+
+      if (target) {
+        const gchar *name;
+        unsigned int flags = orc_target_get_default_flags (target);
+
+        for (i = 0; i < 32; ++i) {
+          if (!(flags & (1U << i)))
+            continue;
+
+          name = orc_target_get_flag_name (target, i);
+          GST_DEBUG ("target flag %s", name);
+#ifdef CHECK_X86
+          if (name)
+            audio_channel_mixer_check_x86 (name);
+#endif
+        }
+      }
+    }
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
 
 struct _GstAudioChannelMixer
 {
@@ -77,8 +134,27 @@ struct _GstAudioChannelMixer
   gint **matrix_int;
 
   MixerFunc func;
+  /* name of the way func mixes, for the unit tests */
+  const gchar *path;
 
   gpointer tmp;
+
+  /* for permutations, the input channel of each output channel or -1 when
+   * the output channel is silent */
+  gint *perm;
+
+  /* for sparse matrices, the nonzero coefficients of output channel j are
+   * at sparse_offset[j] up to sparse_offset[j + 1] */
+  gint *sparse_offset;
+  gint *sparse_in;
+  gfloat *sparse_coeff;
+  gint *sparse_coeff_int;
+
+  /* for dense matrices, the matrix padded and aligned for dense_func */
+  MixerDenseFunc dense_func;
+  gpointer dense;
+  gpointer dense_mem;
+  gint dense_stride;
 };
 
 /**
@@ -106,6 +182,13 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->tmp);
   mix->tmp = NULL;
 
+  g_free (mix->perm);
+  g_free (mix->sparse_offset);
+  g_free (mix->sparse_in);
+  g_free (mix->sparse_coeff);
+  g_free (mix->sparse_coeff_int);
+  g_free (mix->dense_mem);
+
   g_slice_free (GstAudioChannelMixer, mix);
 }
 
@@ -806,6 +889,304 @@ gst_audio_channel_mixer_mix_double (GstAudioChannelMixer * mix,
   }
 }
 
+/* every output channel is a copy of one input channel or silence */
+#define MAKE_PERMUTE_FUNC(type)                                         \
+static void                                                             \
+gst_audio_channel_mixer_permute_##type (GstAudioChannelMixer * mix,    \
+    const type * in_data, type * out_data, gint samples)               \
+{                                                                       \
+  gint n, out;                                                          \
+  gint inchannels = mix->in_channels, outchannels = mix->out_channels;  \
+  const gint *perm = mix->perm;                                         \
+                                                                        \
+  for (n = 0; n < samples; n++) {                                       \
+    for (out = 0; out < outchannels; out++)                             \
+      out_data[out] = perm[out] < 0 ? 0 : in_data[perm[out]];           \
+    in_data += inchannels;                                              \
+    out_data += outchannels;                                            \
+  }                                                                     \
+}
+
+MAKE_PERMUTE_FUNC (gint16);
+MAKE_PERMUTE_FUNC (gint32);
+MAKE_PERMUTE_FUNC (gint64);
+
+static void
+gst_audio_channel_mixer_copy (GstAudioChannelMixer * mix,
+    const gpointer in_data, gpointer out_data, gint samples)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (mix->format);
+
+  memcpy (out_data, in_data, (gsize) samples * mix->out_channels *
+      (GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8));
+}
+
+/* same as the functions above but only with the nonzero coefficients, the
+ * products are added in the same order so the results are the same */
+#define MAKE_SPARSE_INT_FUNC(name,type,acc_type,min,max)                \
+static void                                                             \
+gst_audio_channel_mixer_mix_##name##_sparse (GstAudioChannelMixer * mix,\
+    const type * in_data, type * out_data, gint samples)               \
+{                                                                       \
+  gint n, out, k;                                                       \
+  gint inchannels = mix->in_channels, outchannels = mix->out_channels;  \
+  const gint *offset = mix->sparse_offset, *in = mix->sparse_in;        \
+  const gint *coeff = mix->sparse_coeff_int;                            \
+  acc_type res;                                                         \
+                                                                        \
+  for (n = 0; n < samples; n++) {                                       \
+    for (out = 0; out < outchannels; out++) {                           \
+      res = 0;                                                          \
+      for (k = offset[out]; k < offset[out + 1]; k++)                   \
+        res += in_data[in[k]] * (acc_type) coeff[k];                    \
+                                                                        \
+      /* remove factor from int matrix */                               \
+      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT;        \
+      out_data[out] = CLAMP (res, min, max);                            \
+    }                                                                   \
+    in_data += inchannels;                                              \
+    out_data += outchannels;                                            \
+  }                                                                     \
+}
+
+#define MAKE_SPARSE_FLOAT_FUNC(name,type)                               \
+static void                                                             \
+gst_audio_channel_mixer_mix_##name##_sparse (GstAudioChannelMixer * mix,\
+    const type * in_data, type * out_data, gint samples)               \
+{                                                                       \
+  gint n, out, k;                                                       \
+  gint inchannels = mix->in_channels, outchannels = mix->out_channels;  \
+  const gint *offset = mix->sparse_offset, *in = mix->sparse_in;        \
+  const gfloat *coeff = mix->sparse_coeff;                              \
+  type res;                                                             \
+                                                                        \
+  for (n = 0; n < samples; n++) {                                       \
+    for (out = 0; out < outchannels; out++) {                           \
+      res = 0.0;                                                        \
+      for (k = offset[out]; k < offset[out + 1]; k++)                   \
+        res += in_data[in[k]] * coeff[k];                               \
+                                                                        \
+      out_data[out] = res;                                              \
+    }                                                                   \
+    in_data += inchannels;                                              \
+    out_data += outchannels;                                            \
+  }                                                                     \
+}
+
+MAKE_SPARSE_INT_FUNC (int16, gint16, gint32, G_MININT16, G_MAXINT16);
+MAKE_SPARSE_INT_FUNC (int32, gint32, gint64, G_MININT32, G_MAXINT32);
+MAKE_SPARSE_FLOAT_FUNC (float, gfloat);
+MAKE_SPARSE_FLOAT_FUNC (double, gdouble);
+
+static void
+gst_audio_channel_mixer_mix_dense (GstAudioChannelMixer * mix,
+    const gpointer in_data, gpointer out_data, gint samples)
+{
+  mix->dense_func (mix->dense, mix->dense_stride, mix->in_channels,
+      mix->out_channels, in_data, out_data, samples);
+}
+
+static void
+gst_audio_channel_mixer_setup_perm (GstAudioChannelMixer * mix)
+{
+  gint i, j;
+
+  mix->perm = g_new (gint, mix->out_channels);
+  for (j = 0; j < mix->out_channels; j++) {
+    mix->perm[j] = -1;
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] != 0.0)
+        mix->perm[j] = i;
+    }
+  }
+}
+
+static void
+gst_audio_channel_mixer_setup_sparse (GstAudioChannelMixer * mix,
+    gint nonzero)
+{
+  gint i, j, k = 0;
+
+  mix->sparse_offset = g_new (gint, mix->out_channels + 1);
+  mix->sparse_in = g_new (gint, MAX (nonzero, 1));
+  mix->sparse_coeff = g_new (gfloat, MAX (nonzero, 1));
+  mix->sparse_coeff_int = g_new (gint, MAX (nonzero, 1));
+
+  for (j = 0; j < mix->out_channels; j++) {
+    mix->sparse_offset[j] = k;
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] == 0.0)
+        continue;
+      mix->sparse_in[k] = i;
+      mix->sparse_coeff[k] = mix->matrix[i][j];
+      mix->sparse_coeff_int[k] = mix->matrix_int[i][j];
+      k++;
+    }
+  }
+  mix->sparse_offset[j] = k;
+}
+
+/* lay out the matrix like the SIMD functions want it, see
+ * audio-channel-mixer-x86-sse2.c */
+static gboolean
+gst_audio_channel_mixer_setup_dense (GstAudioChannelMixer * mix)
+{
+  gint i, j, rows, stride, bps;
+
+  switch (mix->format) {
+    case GST_AUDIO_FORMAT_S16:
+      mix->dense_func = mix_dense_gint16;
+      /* two coefficients for each pair of input channels */
+      rows = (mix->in_channels + 1) / 2;
+      stride = 2 * GST_ROUND_UP_8 (mix->out_channels);
+      bps = 2;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      mix->dense_func = mix_dense_gfloat;
+      rows = mix->in_channels;
+      stride = GST_ROUND_UP_8 (mix->out_channels);
+      bps = 4;
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      mix->dense_func = mix_dense_gdouble;
+      rows = mix->in_channels;
+      stride = GST_ROUND_UP_8 (mix->out_channels);
+      bps = 8;
+      break;
+    default:
+      return FALSE;
+  }
+  if (mix->dense_func == NULL)
+    return FALSE;
+
+  /* the int16 coefficients must fit in 16 bits */
+  if (mix->format == GST_AUDIO_FORMAT_S16) {
+    for (i = 0; i < mix->in_channels; i++) {
+      for (j = 0; j < mix->out_channels; j++) {
+        if (mix->matrix_int[i][j] < G_MININT16 ||
+            mix->matrix_int[i][j] > G_MAXINT16) {
+          mix->dense_func = NULL;
+          return FALSE;
+        }
+      }
+    }
+  }
+
+  mix->dense_stride = stride;
+  mix->dense_mem = g_malloc0 (rows * stride * bps + ALIGN - 1);
+  mix->dense = MEM_ALIGN (mix->dense_mem, ALIGN);
+
+  for (i = 0; i < mix->in_channels; i++) {
+    for (j = 0; j < mix->out_channels; j++) {
+      switch (mix->format) {
+        case GST_AUDIO_FORMAT_S16:
+          ((gint16 *) mix->dense)[(i / 2) * stride + 2 * j + (i & 1)] =
+              mix->matrix_int[i][j];
+          break;
+        case GST_AUDIO_FORMAT_F32:
+          ((gfloat *) mix->dense)[i * stride + j] = mix->matrix[i][j];
+          break;
+        case GST_AUDIO_FORMAT_F64:
+          ((gdouble *) mix->dense)[i * stride + j] = mix->matrix[i][j];
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return TRUE;
+}
+
+/* Pick the fastest way to apply the matrix. Many matrices have a lot of
+ * zeros, a downmix to stereo never mixes the left channels into the right
+ * output for example, and some only copy channels around. */
+static void
+gst_audio_channel_mixer_setup_func (GstAudioChannelMixer * mix)
+{
+  gint i, j, n, nonzero = 0;
+  gboolean permute = TRUE, identity;
+
+  identity = mix->in_channels == mix->out_channels;
+
+  for (j = 0; j < mix->out_channels; j++) {
+    n = 0;
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] == 0.0)
+        continue;
+      n++;
+      if (mix->matrix[i][j] != 1.0)
+        permute = FALSE;
+      if (i != j)
+        identity = FALSE;
+    }
+    if (n > 1)
+      permute = FALSE;
+    if (n != 1)
+      identity = FALSE;
+    nonzero += n;
+  }
+
+  if (permute && identity) {
+    GST_DEBUG ("using identity mixing");
+    mix->path = "identity";
+    mix->func = (MixerFunc) gst_audio_channel_mixer_copy;
+  } else if (permute) {
+    GST_DEBUG ("using permutation mixing");
+    mix->path = "permutation";
+    gst_audio_channel_mixer_setup_perm (mix);
+    switch (mix->format) {
+      case GST_AUDIO_FORMAT_S16:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_permute_gint16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+      case GST_AUDIO_FORMAT_F32:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_permute_gint32;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_permute_gint64;
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  } else if (mix->out_channels >= 8 &&
+      nonzero * 4 > mix->in_channels * mix->out_channels &&
+      gst_audio_channel_mixer_setup_dense (mix)) {
+    /* the SIMD functions do a vector of output channels at once but don't
+     * skip zeros, with fewer output channels or many zeros the sparse
+     * function is faster */
+    GST_DEBUG ("using dense SIMD mixing, %d of %d coefficients", nonzero,
+        mix->in_channels * mix->out_channels);
+    mix->path = "dense";
+    mix->func = (MixerFunc) gst_audio_channel_mixer_mix_dense;
+  } else if (nonzero < mix->in_channels * mix->out_channels) {
+    GST_DEBUG ("using sparse mixing, %d of %d coefficients", nonzero,
+        mix->in_channels * mix->out_channels);
+    mix->path = "sparse";
+    gst_audio_channel_mixer_setup_sparse (mix, nonzero);
+    switch (mix->format) {
+      case GST_AUDIO_FORMAT_S16:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int16_sparse;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int32_sparse;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_mix_float_sparse;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        mix->func = (MixerFunc) gst_audio_channel_mixer_mix_double_sparse;
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  } else {
+    GST_DEBUG ("using generic mixing, %d of %d coefficients", nonzero,
+        mix->in_channels * mix->out_channels);
+  }
+}
+
 /**
  * gst_audio_channel_mixer_new: (skip):
  * @flags: #GstAudioChannelMixerFlags
@@ -836,8 +1217,10 @@ gst_audio_channel_mixer_new (GstAudioChannelMixerFlags flags,
   g_return_val_if_fail (in_channels > 0 && in_channels < 64, NULL);
   g_return_val_if_fail (out_channels > 0 && out_channels < 64, NULL);
 
+  audio_channel_mixer_init ();
+
   mix = g_slice_new0 (GstAudioChannelMixer);
-  mix->flags = flags;
+  mix->flags = flags & ~GST_AUDIO_CHANNEL_MIXER_FLAGS_GENERIC;
   mix->format = format;
   mix->in_channels = in_channels;
   mix->out_channels = out_channels;
@@ -849,6 +1232,7 @@ gst_audio_channel_mixer_new (GstAudioChannelMixerFlags flags,
 
   gst_audio_channel_mixer_setup_matrix (mix);
 
+  mix->path = "generic";
   switch (mix->format) {
     case GST_AUDIO_FORMAT_S16:
       mix->func = (MixerFunc) gst_audio_channel_mixer_mix_int16;
@@ -866,9 +1250,20 @@ gst_audio_channel_mixer_new (GstAudioChannelMixerFlags flags,
       g_assert_not_reached ();
       break;
   }
+  if (!(flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_GENERIC))
+    gst_audio_channel_mixer_setup_func (mix);
+
   return mix;
 }
 
+/* Only for the unit tests, returns how @mix mixes: "identity",
+ * "permutation", "dense", "sparse" or "generic" */
+const gchar *
+_gst_audio_channel_mixer_get_path (GstAudioChannelMixer * mix)
+{
+  return mix->path;
+}
+
 /**
  * gst_audio_channel_mixer_is_passthrough:
  * @mix: a #GstAudioChannelMixer
@@ -49,6 +49,9 @@ typedef void (*ResampleFunc) (GstAudioResampler * resampler, gpointer in[],
 typedef void (*DeinterleaveFunc) (GstAudioResampler * resampler,
     gpointer * sbuf, gpointer in[], gsize in_frames);
 
+typedef struct _AudioResamplerTask AudioResamplerTask;
+typedef struct _AudioResamplerFilter AudioResamplerFilter;
+
 struct _GstAudioResampler
 {
   GstAudioResamplerMethod method;
@@ -75,20 +78,19 @@ struct _GstAudioResampler
   /* temp taps */
   gpointer tmp_taps;
 
+  /* shared filter tables, owns the memory of the tables below */
+  AudioResamplerFilter *filter;
+
   /* oversampled main filter table */
   gint oversample;
   gint n_taps;
   gpointer taps;
-  gpointer taps_mem;
   gsize taps_stride;
   gint n_phases;
-  gint alloc_taps;
-  gint alloc_phases;
 
   /* cached taps */
   gpointer *cached_phases;
   gpointer cached_taps;
-  gpointer cached_taps_mem;
   gsize cached_taps_stride;
 
   ConvertTapsFunc convert_taps;
@@ -96,6 +98,10 @@ struct _GstAudioResampler
   DeinterleaveFunc deinterleave;
   ResampleFunc resample;
 
+  /* the kernels to pick the functions above from */
+  const ResampleFunc *resample_funcs;
+  const InterpolateFunc *interpolate_funcs;
+
   gint blocks;
   gint inc;
   gint samp_inc;
@@ -108,6 +114,18 @@ struct _GstAudioResampler
   gsize samples_len;
   gsize samples_avail;
   gpointer *sbuf;
+
+  /* resampling the channels on multiple threads */
+  guint n_threads;
+  struct _GstParallelizedTaskRunner *runner;
+  AudioResamplerTask *tasks;
+  gpointer *task_data;
 };
 
+/* only for the unit tests: G_TYPE_STRING, the kernels the new resampler
+ * uses instead of the best ones for the CPU. "c" for the plain C kernels
+ * or "avx2" for the AVX2 kernels. Kernels that were not built or that the
+ * CPU doesn't support leave the default kernels in place. */
+#define GST_AUDIO_RESAMPLER_OPT_KERNELS "GstAudioResampler.kernels"
+
 #endif /* __GST_AUDIO_RESAMPLER_PRIVATE_H__ */
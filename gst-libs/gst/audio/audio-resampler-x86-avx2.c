@@ -0,0 +1,669 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* Same as the SSE kernels but with twice the vector width. The taps are
+ * 32 byte aligned so they can be loaded with aligned loads. When compiled
+ * with FMA support the float kernels use fused multiply-adds. */
+
+#ifdef __FMA__
+#define MADD_PS(a,b,c) _mm256_fmadd_ps (a, b, c)
+#define MADD_PD(a,b,c) _mm256_fmadd_pd (a, b, c)
+#else
+#define MADD_PS(a,b,c) _mm256_add_ps (_mm256_mul_ps (a, b), c)
+#define MADD_PD(a,b,c) _mm256_add_pd (_mm256_mul_pd (a, b), c)
+#endif
+
+/* add the upper and lower 128 bits */
+#define FOLD_PS(v) _mm_add_ps (_mm256_castps256_ps128 (v),      \
+    _mm256_extractf128_ps (v, 1))
+#define FOLD_PD(v) _mm_add_pd (_mm256_castpd256_pd128 (v),      \
+    _mm256_extractf128_pd (v, 1))
+#define FOLD_EPI32(v) _mm_add_epi32 (_mm256_castsi256_si128 (v), \
+    _mm256_extracti128_si256 (v, 1))
+#define FOLD_EPI64(v) _mm_add_epi64 (_mm256_castsi256_si128 (v), \
+    _mm256_extracti128_si256 (v, 1))
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum;
+  __m128i res;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    sum =
+        _mm256_add_epi32 (sum,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_load_si256 ((__m256i *) (b + i))));
+  }
+  res = FOLD_EPI32 (sum);
+  res = _mm_add_epi32 (res, _mm_shuffle_epi32 (res, _MM_SHUFFLE (2, 3, 2, 3)));
+  res = _mm_add_epi32 (res, _mm_shuffle_epi32 (res, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  res = _mm_add_epi32 (res, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  res = _mm_srai_epi32 (res, PRECISION_S16);
+  res = _mm_packs_epi32 (res, res);
+  *o = _mm_extract_epi16 (res, 0);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256i sum[2], t;
+  __m128i res[2];
+  __m128i f = _mm_set_epi64x (0, *((gint64 *) icoeff));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] =
+        _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_load_si256 ((__m256i *) (c[0] + i))));
+    sum[1] =
+        _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_load_si256 ((__m256i *) (c[1] + i))));
+  }
+  res[0] = _mm_srai_epi32 (FOLD_EPI32 (sum[0]), PRECISION_S16);
+  res[1] = _mm_srai_epi32 (FOLD_EPI32 (sum[1]), PRECISION_S16);
+
+  res[0] =
+      _mm_madd_epi16 (res[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  res[1] =
+      _mm_madd_epi16 (res[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  res[0] = _mm_add_epi32 (res[0], res[1]);
+
+  res[0] =
+      _mm_add_epi32 (res[0], _mm_shuffle_epi32 (res[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  res[0] =
+      _mm_add_epi32 (res[0], _mm_shuffle_epi32 (res[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  res[0] = _mm_add_epi32 (res[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  res[0] = _mm_srai_epi32 (res[0], PRECISION_S16);
+  res[0] = _mm_packs_epi32 (res[0], res[0]);
+  *o = _mm_extract_epi16 (res[0], 0);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256i sum[4], t;
+  __m128i res[4], r[4];
+  __m128i f = _mm_set_epi64x (0, *((gint64 *) icoeff));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] =
+        _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_load_si256 ((__m256i *) (c[0] + i))));
+    sum[1] =
+        _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_load_si256 ((__m256i *) (c[1] + i))));
+    sum[2] =
+        _mm256_add_epi32 (sum[2], _mm256_madd_epi16 (t,
+            _mm256_load_si256 ((__m256i *) (c[2] + i))));
+    sum[3] =
+        _mm256_add_epi32 (sum[3], _mm256_madd_epi16 (t,
+            _mm256_load_si256 ((__m256i *) (c[3] + i))));
+  }
+  res[0] = FOLD_EPI32 (sum[0]);
+  res[1] = FOLD_EPI32 (sum[1]);
+  res[2] = FOLD_EPI32 (sum[2]);
+  res[3] = FOLD_EPI32 (sum[3]);
+
+  r[0] = _mm_unpacklo_epi32 (res[0], res[1]);
+  r[1] = _mm_unpacklo_epi32 (res[2], res[3]);
+  r[2] = _mm_unpackhi_epi32 (res[0], res[1]);
+  r[3] = _mm_unpackhi_epi32 (res[2], res[3]);
+
+  res[0] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (r[0], r[1]), _mm_unpackhi_epi64 (r[0],
+          r[1]));
+  res[2] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (r[2], r[3]), _mm_unpackhi_epi64 (r[2],
+          r[3]));
+  res[0] = _mm_add_epi32 (res[0], res[2]);
+
+  res[0] = _mm_srai_epi32 (res[0], PRECISION_S16);
+  res[0] = _mm_madd_epi16 (res[0], f);
+
+  res[0] =
+      _mm_add_epi32 (res[0], _mm_shuffle_epi32 (res[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  res[0] =
+      _mm_add_epi32 (res[0], _mm_shuffle_epi32 (res[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  res[0] = _mm_add_epi32 (res[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  res[0] = _mm_srai_epi32 (res[0], PRECISION_S16);
+  res[0] = _mm_packs_epi32 (res[0], res[0]);
+  *o = _mm_extract_epi16 (res[0], 0);
+}
+
+#if defined (__x86_64__)
+/* _mm256_mul_epi32 only multiplies the even elements, the odd elements are
+ * shifted down to multiply them as well */
+#define MUL_ADD_EPI32(sum,ta,tb)                                        \
+G_STMT_START {                                                          \
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (ta, tb));              \
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (                       \
+        _mm256_srli_epi64 (ta, 32), _mm256_srli_epi64 (tb, 32)));       \
+} G_STMT_END
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256i sum, ta, tb;
+  __m128i res;
+  gint64 r;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    tb = _mm256_load_si256 ((__m256i *) (b + i));
+    MUL_ADD_EPI32 (sum, ta, tb);
+  }
+  res = FOLD_EPI64 (sum);
+  res = _mm_add_epi64 (res, _mm_unpackhi_epi64 (res, res));
+  r = _mm_cvtsi128_si64 (res);
+
+  r = (r + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (r, -(1L << 31), (1L << 31) - 1);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i = 0;
+  gint64 r;
+  __m256i sum[2], ta, tb;
+  __m128i res[2];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    tb = _mm256_load_si256 ((__m256i *) (c[0] + i));
+    MUL_ADD_EPI32 (sum[0], ta, tb);
+
+    tb = _mm256_load_si256 ((__m256i *) (c[1] + i));
+    MUL_ADD_EPI32 (sum[1], ta, tb);
+  }
+  res[0] = _mm_srli_epi64 (FOLD_EPI64 (sum[0]), PRECISION_S32);
+  res[1] = _mm_srli_epi64 (FOLD_EPI64 (sum[1]), PRECISION_S32);
+  res[0] =
+      _mm_mul_epi32 (res[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  res[1] =
+      _mm_mul_epi32 (res[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  res[0] = _mm_add_epi64 (res[0], res[1]);
+  res[0] = _mm_add_epi64 (res[0], _mm_unpackhi_epi64 (res[0], res[0]));
+  r = _mm_cvtsi128_si64 (res[0]);
+
+  r = (r + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (r, -(1L << 31), (1L << 31) - 1);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i = 0;
+  gint64 r;
+  __m256i sum[4], ta, tb;
+  __m128i res[4];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    tb = _mm256_load_si256 ((__m256i *) (c[0] + i));
+    MUL_ADD_EPI32 (sum[0], ta, tb);
+
+    tb = _mm256_load_si256 ((__m256i *) (c[1] + i));
+    MUL_ADD_EPI32 (sum[1], ta, tb);
+
+    tb = _mm256_load_si256 ((__m256i *) (c[2] + i));
+    MUL_ADD_EPI32 (sum[2], ta, tb);
+
+    tb = _mm256_load_si256 ((__m256i *) (c[3] + i));
+    MUL_ADD_EPI32 (sum[3], ta, tb);
+  }
+  res[0] = _mm_srli_epi64 (FOLD_EPI64 (sum[0]), PRECISION_S32);
+  res[1] = _mm_srli_epi64 (FOLD_EPI64 (sum[1]), PRECISION_S32);
+  res[2] = _mm_srli_epi64 (FOLD_EPI64 (sum[2]), PRECISION_S32);
+  res[3] = _mm_srli_epi64 (FOLD_EPI64 (sum[3]), PRECISION_S32);
+  res[0] =
+      _mm_mul_epi32 (res[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  res[1] =
+      _mm_mul_epi32 (res[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  res[2] =
+      _mm_mul_epi32 (res[2], _mm_shuffle_epi32 (f, _MM_SHUFFLE (2, 2, 2, 2)));
+  res[3] =
+      _mm_mul_epi32 (res[3], _mm_shuffle_epi32 (f, _MM_SHUFFLE (3, 3, 3, 3)));
+  res[0] = _mm_add_epi64 (res[0], res[1]);
+  res[2] = _mm_add_epi64 (res[2], res[3]);
+  res[0] = _mm_add_epi64 (res[0], res[2]);
+  res[0] = _mm_add_epi64 (res[0], _mm_unpackhi_epi64 (res[0], res[0]));
+  r = _mm_cvtsi128_si64 (res[0]);
+
+  r = (r + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (r, -(1L << 31), (1L << 31) - 1);
+}
+#endif
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2];
+  __m128 res;
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  /* two accumulators to hide the latency of the multiply-adds */
+  for (; i + 16 <= len; i += 16) {
+    sum[0] = MADD_PS (_mm256_loadu_ps (a + i + 0),
+        _mm256_load_ps (b + i + 0), sum[0]);
+    sum[1] = MADD_PS (_mm256_loadu_ps (a + i + 8),
+        _mm256_load_ps (b + i + 8), sum[1]);
+  }
+  for (; i < len; i += 8)
+    sum[0] = MADD_PS (_mm256_loadu_ps (a + i), _mm256_load_ps (b + i), sum[0]);
+
+  res = FOLD_PS (_mm256_add_ps (sum[0], sum[1]));
+  res = _mm_add_ps (res, _mm_movehl_ps (res, res));
+  res = _mm_add_ss (res, _mm_shuffle_ps (res, res, 0x55));
+  _mm_store_ss (o, res);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2], t;
+  __m128 res;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = MADD_PS (t, _mm256_load_ps (c[0] + i), sum[0]);
+    sum[1] = MADD_PS (t, _mm256_load_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = MADD_PS (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff), sum[1]);
+
+  res = FOLD_PS (sum[0]);
+  res = _mm_add_ps (res, _mm_movehl_ps (res, res));
+  res = _mm_add_ss (res, _mm_shuffle_ps (res, res, 0x55));
+  _mm_store_ss (o, res);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[4], t;
+  __m128 res;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = MADD_PS (t, _mm256_load_ps (c[0] + i), sum[0]);
+    sum[1] = MADD_PS (t, _mm256_load_ps (c[1] + i), sum[1]);
+    sum[2] = MADD_PS (t, _mm256_load_ps (c[2] + i), sum[2]);
+    sum[3] = MADD_PS (t, _mm256_load_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  sum[0] = MADD_PS (sum[1], _mm256_broadcast_ss (icoeff + 1), sum[0]);
+  sum[0] = MADD_PS (sum[2], _mm256_broadcast_ss (icoeff + 2), sum[0]);
+  sum[0] = MADD_PS (sum[3], _mm256_broadcast_ss (icoeff + 3), sum[0]);
+
+  res = FOLD_PS (sum[0]);
+  res = _mm_add_ps (res, _mm_movehl_ps (res, res));
+  res = _mm_add_ss (res, _mm_shuffle_ps (res, res, 0x55));
+  _mm_store_ss (o, res);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2];
+  __m128d res;
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 8) {
+    sum[0] = MADD_PD (_mm256_loadu_pd (a + i + 0),
+        _mm256_load_pd (b + i + 0), sum[0]);
+    sum[1] = MADD_PD (_mm256_loadu_pd (a + i + 4),
+        _mm256_load_pd (b + i + 4), sum[1]);
+  }
+  res = FOLD_PD (_mm256_add_pd (sum[0], sum[1]));
+  res = _mm_add_sd (res, _mm_unpackhi_pd (res, res));
+  _mm_store_sd (o, res);
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2], t;
+  __m128d res;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = MADD_PD (t, _mm256_load_pd (c[0] + i), sum[0]);
+    sum[1] = MADD_PD (t, _mm256_load_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = MADD_PD (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff), sum[1]);
+
+  res = FOLD_PD (sum[0]);
+  res = _mm_add_sd (res, _mm_unpackhi_pd (res, res));
+  _mm_store_sd (o, res);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[4], t;
+  __m128d res;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = MADD_PD (t, _mm256_load_pd (c[0] + i), sum[0]);
+    sum[1] = MADD_PD (t, _mm256_load_pd (c[1] + i), sum[1]);
+    sum[2] = MADD_PD (t, _mm256_load_pd (c[2] + i), sum[2]);
+    sum[3] = MADD_PD (t, _mm256_load_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  sum[0] = MADD_PD (sum[1], _mm256_broadcast_sd (icoeff + 1), sum[0]);
+  sum[0] = MADD_PD (sum[2], _mm256_broadcast_sd (icoeff + 2), sum[0]);
+  sum[0] = MADD_PD (sum[3], _mm256_broadcast_sd (icoeff + 3), sum[0]);
+
+  res = FOLD_PD (sum[0]);
+  res = _mm_add_sd (res, _mm_unpackhi_pd (res, res));
+  _mm_store_sd (o, res);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+#if defined (__x86_64__)
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+#endif
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+/* the 256 bit unpack and pack instructions both work per 128 bit lane so
+ * the packed result ends up in the right order again */
+void
+interpolate_gint16_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i = 0;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, t1, t2;
+  __m256i f = _mm256_set1_epi32 (*((gint32 *) ic));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (; i < len; i += 16) {
+    ta = _mm256_load_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_load_si256 ((__m256i *) (c[1] + i));
+
+    t1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f);
+    t2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f);
+
+    t1 = _mm256_add_epi32 (t1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+    t2 = _mm256_add_epi32 (t2, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+
+    t1 = _mm256_srai_epi32 (t1, PRECISION_S16);
+    t2 = _mm256_srai_epi32 (t2, PRECISION_S16);
+
+    t1 = _mm256_packs_epi32 (t1, t2);
+    _mm256_store_si256 ((__m256i *) (o + i), t1);
+  }
+}
+
+void
+interpolate_gint16_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i = 0;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, tl1, tl2, th1, th2;
+  __m256i f[2];
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride),
+    (gint16 *) ((gint8 *) a + 2 * astride),
+    (gint16 *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_set1_epi32 (*((gint32 *) (ic + 0)));
+  f[1] = _mm256_set1_epi32 (*((gint32 *) (ic + 2)));
+
+  for (; i < len; i += 16) {
+    ta = _mm256_load_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_load_si256 ((__m256i *) (c[1] + i));
+
+    tl1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[0]);
+    th1 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[0]);
+
+    ta = _mm256_load_si256 ((__m256i *) (c[2] + i));
+    tb = _mm256_load_si256 ((__m256i *) (c[3] + i));
+
+    tl2 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[1]);
+    th2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[1]);
+
+    tl1 = _mm256_add_epi32 (tl1, tl2);
+    th1 = _mm256_add_epi32 (th1, th2);
+
+    tl1 = _mm256_add_epi32 (tl1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+    th1 = _mm256_add_epi32 (th1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+
+    tl1 = _mm256_srai_epi32 (tl1, PRECISION_S16);
+    th1 = _mm256_srai_epi32 (th1, PRECISION_S16);
+
+    tl1 = _mm256_packs_epi32 (tl1, th1);
+    _mm256_store_si256 ((__m256i *) (o + i), tl1);
+  }
+}
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+
+  for (i = 0; i < len; i += 8) {
+    _mm256_store_ps (o + i, MADD_PS (_mm256_load_ps (c[1] + i), f[1],
+            _mm256_mul_ps (_mm256_load_ps (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t[2];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+  f[2] = _mm256_broadcast_ss (ic + 2);
+  f[3] = _mm256_broadcast_ss (ic + 3);
+
+  for (i = 0; i < len; i += 8) {
+    t[0] = _mm256_mul_ps (_mm256_load_ps (c[0] + i), f[0]);
+    t[1] = _mm256_mul_ps (_mm256_load_ps (c[2] + i), f[2]);
+    t[0] = MADD_PS (_mm256_load_ps (c[1] + i), f[1], t[0]);
+    t[1] = MADD_PS (_mm256_load_ps (c[3] + i), f[3], t[1]);
+    _mm256_store_ps (o + i, _mm256_add_ps (t[0], t[1]));
+  }
+}
+
+void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[2];
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+
+  for (i = 0; i < len; i += 4) {
+    _mm256_store_pd (o + i, MADD_PD (_mm256_load_pd (c[1] + i), f[1],
+            _mm256_mul_pd (_mm256_load_pd (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[4], t[2];
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+  f[2] = _mm256_broadcast_sd (ic + 2);
+  f[3] = _mm256_broadcast_sd (ic + 3);
+
+  for (i = 0; i < len; i += 4) {
+    t[0] = _mm256_mul_pd (_mm256_load_pd (c[0] + i), f[0]);
+    t[1] = _mm256_mul_pd (_mm256_load_pd (c[2] + i), f[2]);
+    t[0] = MADD_PD (_mm256_load_pd (c[1] + i), f[1], t[0]);
+    t[1] = MADD_PD (_mm256_load_pd (c[3] + i), f[3], t[1]);
+    _mm256_store_pd (o + i, _mm256_add_pd (t[0], t[1]));
+  }
+}
+
+#endif
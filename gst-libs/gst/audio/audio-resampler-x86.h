@@ -21,6 +21,53 @@
 #include "audio-resampler-x86-sse.h"
 #include "audio-resampler-x86-sse2.h"
 #include "audio-resampler-x86-sse41.h"
+#include "audio-resampler-x86-avx2.h"
+
+/* replaces the kernels that @name has an implementation for, returns
+ * %FALSE when they were not built or the CPU doesn't support them */
+static gboolean
+audio_resampler_set_x86_kernels (const gchar *name)
+{
+  if (!strcmp (name, "avx2")) {
+    /* ORC has no flag for AVX2, ask the CPU directly. The kernels are built
+     * with FMA when the compiler supports it, so the CPU needs it too. */
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && defined (__GNUC__)
+    if (!__builtin_cpu_supports ("avx2"))
+      return FALSE;
+#if HAVE_FMA
+    if (!__builtin_cpu_supports ("fma"))
+      return FALSE;
+#endif
+    resample_gint16_full_1 = resample_gint16_full_1_avx2;
+    resample_gint16_linear_1 = resample_gint16_linear_1_avx2;
+    resample_gint16_cubic_1 = resample_gint16_cubic_1_avx2;
+
+    interpolate_gint16_linear = interpolate_gint16_linear_avx2;
+    interpolate_gint16_cubic = interpolate_gint16_cubic_avx2;
+#if defined (__x86_64__)
+    resample_gint32_full_1 = resample_gint32_full_1_avx2;
+    resample_gint32_linear_1 = resample_gint32_linear_1_avx2;
+    resample_gint32_cubic_1 = resample_gint32_cubic_1_avx2;
+#endif
+
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+    interpolate_gfloat_linear = interpolate_gfloat_linear_avx2;
+    interpolate_gfloat_cubic = interpolate_gfloat_cubic_avx2;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+
+    interpolate_gdouble_linear = interpolate_gdouble_linear_avx2;
+    interpolate_gdouble_cubic = interpolate_gdouble_cubic_avx2;
+    return TRUE;
+#endif
+  }
+  return FALSE;
+}
 
 static void
 audio_resampler_check_x86 (const gchar *option)
@@ -67,5 +114,11 @@ audio_resampler_check_x86 (const gchar *option)
 #else
     GST_DEBUG ("SSE41 optimisations not enabled");
 #endif
+
+    /* every CPU with AVX2 also has SSE4.1 so this is only checked here */
+    if (audio_resampler_set_x86_kernels ("avx2"))
+      GST_DEBUG ("enable AVX2 optimisations");
+    else
+      GST_DEBUG ("AVX2 optimisations not enabled or not supported");
   }
 }
@@ -34,7 +34,7 @@
 #include "audio-resampler-macros.h"
 
 #define MEM_ALIGN(m,a) ((gint8 *)((guintptr)((gint8 *)(m) + ((a)-1)) & ~((a)-1)))
-#define ALIGN 16
+#define ALIGN 32
 #define TAPS_OVERREAD 16
 
 GST_DEBUG_CATEGORY_STATIC (audio_resampler_debug);
@@ -104,6 +104,7 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
+#define DEFAULT_OPT_THREADS 1
 
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
@@ -123,6 +124,15 @@ get_opt_int (GstStructure * options, const gchar * name, gint def)
   return res;
 }
 
+static guint
+get_opt_uint (GstStructure * options, const gchar * name, guint def)
+{
+  guint res;
+  if (!options || !gst_structure_get_uint (options, name, &res))
+    res = def;
+  return res;
+}
+
 static gint
 get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
 {
@@ -159,6 +169,8 @@ get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
     GST_AUDIO_RESAMPLER_OPT_FILTER_OVERSAMPLE, DEFAULT_OPT_FILTER_OVERSAMPLE)
 #define GET_OPT_MAX_PHASE_ERROR(options) get_opt_double(options, \
     GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR, DEFAULT_OPT_MAX_PHASE_ERROR)
+#define GET_OPT_THREADS(options) get_opt_uint(options, \
+    GST_AUDIO_RESAMPLER_OPT_THREADS, DEFAULT_OPT_THREADS)
 
 #include "dbesi0.c"
 #define bessel dbesi0
@@ -503,6 +515,12 @@ GET_TAPS_NEAREST_FUNC (gdouble);
 #define get_taps_gfloat_nearest get_taps_gfloat_nearest
 #define get_taps_gdouble_nearest get_taps_gdouble_nearest
 
+/* The full filter table is shared by all resamplers with the same filter
+ * and by the threads of a resampler. It is filled lazily, the phases are
+ * made with the lock held and published atomically so that the fast path
+ * only needs an atomic read. */
+static GMutex cache_lock;
+
 #define GET_TAPS_FULL_FUNC(type)                                                \
 DECL_GET_TAPS_FULL_FUNC(type)                                                   \
 {                                                                               \
@@ -512,47 +530,52 @@ DECL_GET_TAPS_FULL_FUNC(type)
   gint phase = (n_phases == out_rate ? *samp_phase :                            \
       ((gint64)*samp_phase * n_phases) / out_rate);                             \
                                                                                 \
-  res = resampler->cached_phases[phase];                                        \
+  res = g_atomic_pointer_get (&resampler->cached_phases[phase]);                \
   if (G_UNLIKELY (res == NULL)) {                                               \
-    res = (gint8 *) resampler->cached_taps +                                    \
-                        phase * resampler->cached_taps_stride;                  \
-    switch (resampler->filter_interpolation) {                                  \
-      case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE:                       \
-      {                                                                         \
-        gdouble x;                                                              \
-        gint n_taps = resampler->n_taps;                                        \
+    g_mutex_lock (&cache_lock);                                                 \
+    res = resampler->cached_phases[phase];                                      \
+    if (res == NULL) {                                                          \
+      res = (gint8 *) resampler->cached_taps +                                  \
+                          phase * resampler->cached_taps_stride;                \
+      switch (resampler->filter_interpolation) {                                \
+        case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE:                     \
+        {                                                                       \
+          gdouble x;                                                            \
+          gint n_taps = resampler->n_taps;                                      \
                                                                                 \
-        x = 1.0 - n_taps / 2 - (gdouble) phase / n_phases;                      \
-        make_taps (resampler, res, x, n_taps);                                  \
-        break;                                                                  \
-      }                                                                         \
-      default:                                                                  \
-      {                                                                         \
-        gint offset, pos, frac;                                                 \
-        gint oversample = resampler->oversample;                                \
-        gint taps_stride = resampler->taps_stride;                              \
-        gint n_taps = resampler->n_taps;                                        \
-        type ic[4], *taps;                                                      \
+          x = 1.0 - n_taps / 2 - (gdouble) phase / n_phases;                    \
+          make_taps (resampler, res, x, n_taps);                                \
+          break;                                                                \
+        }                                                                       \
+        default:                                                                \
+        {                                                                       \
+          gint offset, pos, frac;                                               \
+          gint oversample = resampler->oversample;                              \
+          gint taps_stride = resampler->taps_stride;                            \
+          gint n_taps = resampler->n_taps;                                      \
+          type ic[4], *taps;                                                    \
                                                                                 \
-        pos = phase * oversample;                                               \
-        offset = (oversample - 1) - pos / n_phases;                             \
-        frac = pos % n_phases;                                                  \
+          pos = phase * oversample;                                             \
+          offset = (oversample - 1) - pos / n_phases;                           \
+          frac = pos % n_phases;                                                \
                                                                                 \
-        taps = (type *) ((gint8 *) resampler->taps + offset * taps_stride);     \
+          taps = (type *) ((gint8 *) resampler->taps + offset * taps_stride);   \
                                                                                 \
-        switch (resampler->filter_interpolation) {                              \
-          default:                                                              \
-          case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR:                 \
-            make_coeff_##type##_linear (frac, n_phases, ic);                    \
-            break;                                                              \
-          case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC:                  \
-            make_coeff_##type##_cubic (frac, n_phases, ic);                     \
-            break;                                                              \
+          switch (resampler->filter_interpolation) {                            \
+            default:                                                            \
+            case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR:               \
+              make_coeff_##type##_linear (frac, n_phases, ic);                  \
+              break;                                                            \
+            case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC:                \
+              make_coeff_##type##_cubic (frac, n_phases, ic);                   \
+              break;                                                            \
+          }                                                                     \
+          resampler->interpolate (res, taps, n_taps, ic, taps_stride);          \
         }                                                                       \
-        resampler->interpolate (res, taps, n_taps, ic, taps_stride);            \
       }                                                                         \
+      g_atomic_pointer_set (&resampler->cached_phases[phase], res);             \
     }                                                                           \
-    resampler->cached_phases[phase] = res;                                      \
+    g_mutex_unlock (&cache_lock);                                               \
   }                                                                             \
   *samp_index += resampler->samp_inc;                                           \
   *samp_phase += resampler->samp_frac;                                          \
@@ -821,6 +844,22 @@ static ResampleFunc resample_funcs[] = {
 #define resample_gfloat_cubic_1 resample_funcs[14]
 #define resample_gdouble_cubic_1 resample_funcs[15]
 
+/* kernels a resampler can ask for with GST_AUDIO_RESAMPLER_OPT_KERNELS,
+ * filled once at init. "c" are the plain C kernels, the others the C
+ * kernels with the ones of that instruction set on top. */
+typedef struct
+{
+  const gchar *name;
+  gboolean available;
+  ResampleFunc resample[G_N_ELEMENTS (resample_funcs)];
+  InterpolateFunc interpolate[G_N_ELEMENTS (interpolate_funcs)];
+} AudioResamplerKernels;
+
+static AudioResamplerKernels audio_resampler_kernels[] = {
+  {"c", TRUE},
+  {"avx2", FALSE},
+};
+
 #if defined HAVE_ORC && !defined DISABLE_ORC
 # if defined (HAVE_ARM_NEON)
 #  define CHECK_NEON
@@ -832,52 +871,113 @@ static ResampleFunc resample_funcs[] = {
 # endif
 #endif
 
+static void
+audio_resampler_set_c_kernels (void)
+{
+  memcpy (resample_funcs, audio_resampler_kernels[0].resample,
+      sizeof (resample_funcs));
+  memcpy (interpolate_funcs, audio_resampler_kernels[0].interpolate,
+      sizeof (interpolate_funcs));
+}
+
+/* select the best kernels for the CPU */
+static void
+audio_resampler_detect_kernels (void)
+{
+  audio_resampler_set_c_kernels ();
+
+#if defined HAVE_ORC && !defined DISABLE_ORC
+  {
+    OrcTarget *target = orc_target_get_default ();
+    gint i;
+
+    if (target) {
+      const gchar *name;
+      unsigned int flags = orc_target_get_default_flags (target);
+
+      for (i = -1; i < 32; ++i) {
+        if (i == -1) {
+          name = orc_target_get_name (target);
+          GST_DEBUG ("target %s, default flags %08x", name, flags);
+        } else if (flags & (1U << i)) {
+          name = orc_target_get_flag_name (target, i);
+          GST_DEBUG ("target flag %s", name);
+        } else
+          name = NULL;
+
+        if (name) {
+#ifdef CHECK_X86
+          audio_resampler_check_x86 (name);
+#endif
+#ifdef CHECK_NEON
+          audio_resampler_check_neon (name);
+#endif
+        }
+      }
+    }
+  }
+#endif
+}
+
 static void
 audio_resampler_init (void)
 {
   static gsize init_gonce = 0;
 
   if (g_once_init_enter (&init_gonce)) {
+    gint i;
 
     GST_DEBUG_CATEGORY_INIT (audio_resampler_debug, "audio-resampler", 0,
         "audio-resampler object");
 
-#if defined HAVE_ORC && !defined DISABLE_ORC
-    orc_init ();
-    {
-      OrcTarget *target = orc_target_get_default ();
-      gint i;
-
-      if (target) {
-        const gchar *name;
-        unsigned int flags = orc_target_get_default_flags (target);
-
-        for (i = -1; i < 32; ++i) {
-          if (i == -1) {
-            name = orc_target_get_name (target);
-            GST_DEBUG ("target %s, default flags %08x", name, flags);
-          } else if (flags & (1U << i)) {
-            name = orc_target_get_flag_name (target, i);
-            GST_DEBUG ("target flag %s", name);
-          } else
-            name = NULL;
-
-          if (name) {
+    /* nothing uses the tables before init is done, so they can be
+     * used to build the selectable kernels */
+    for (i = 0; i < G_N_ELEMENTS (audio_resampler_kernels); i++) {
+      AudioResamplerKernels *kernels = &audio_resampler_kernels[i];
+
+      if (i > 0) {
+        audio_resampler_set_c_kernels ();
 #ifdef CHECK_X86
-            audio_resampler_check_x86 (name);
-#endif
-#ifdef CHECK_NEON
-            audio_resampler_check_neon (name);
+        kernels->available = audio_resampler_set_x86_kernels (kernels->name);
 #endif
-          }
-        }
       }
+      memcpy (kernels->resample, resample_funcs, sizeof (resample_funcs));
+      memcpy (kernels->interpolate, interpolate_funcs,
+          sizeof (interpolate_funcs));
     }
+
+#if defined HAVE_ORC && !defined DISABLE_ORC
+    orc_init ();
 #endif
+    audio_resampler_detect_kernels ();
     g_once_init_leave (&init_gonce, 1);
   }
 }
 
+/* use the kernels of @name instead of the best ones for the CPU */
+static void
+audio_resampler_select_kernels (GstAudioResampler * resampler,
+    const gchar * name)
+{
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (audio_resampler_kernels); i++) {
+    AudioResamplerKernels *kernels = &audio_resampler_kernels[i];
+
+    if (strcmp (kernels->name, name))
+      continue;
+
+    if (kernels->available) {
+      GST_DEBUG ("using %s kernels", name);
+      resampler->resample_funcs = kernels->resample;
+      resampler->interpolate_funcs = kernels->interpolate;
+      return;
+    }
+    break;
+  }
+  GST_INFO ("%s kernels not available, using the default kernels", name);
+}
+
 #define MAKE_DEINTERLEAVE_FUNC(type)                                    \
 static void                                                             \
 deinterleave_ ##type (GstAudioResampler * resampler, gpointer sbuf[],   \
@@ -950,78 +1050,314 @@ calculate_kaiser_params (GstAudioResampler * resampler)
       resampler->n_taps, resampler->cutoff);
 }
 
+/* Filter tables only depend on the parameters in the key, resamplers with
+ * the same key share the tables. The oversampled table is complete when it
+ * is made, the full filter table is filled lazily, see
+ * GET_TAPS_FULL_FUNC. */
+typedef struct
+{
+  gint format_index;
+  GstAudioResamplerMethod method;
+  gint n_taps;
+  gdouble cutoff;
+  gdouble kaiser_beta;
+  gdouble b, c;
+  GstAudioResamplerFilterInterpolation filter_interpolation;
+  gint oversample;
+  gint n_phases;
+} AudioResamplerFilterKey;
+
+struct _AudioResamplerFilter
+{
+  AudioResamplerFilterKey key;
+  gint refcount;
+
+  /* oversampled main filter table */
+  gpointer taps;
+  gpointer taps_mem;
+  gsize taps_stride;
+
+  /* full filter table */
+  gpointer *cached_phases;
+  gpointer cached_taps;
+  gpointer cached_taps_mem;
+  gsize cached_taps_stride;
+};
+
+static GMutex filters_lock;
+static GHashTable *filters;
+
+static void
+filter_key_init (AudioResamplerFilterKey * key, GstAudioResampler * resampler)
+{
+  /* clear the padding too, we hash and compare the raw bytes */
+  memset (key, 0, sizeof (AudioResamplerFilterKey));
+
+  key->format_index = resampler->format_index;
+  key->method = resampler->method;
+  key->n_taps = resampler->n_taps;
+
+  switch (resampler->method) {
+    case GST_AUDIO_RESAMPLER_METHOD_CUBIC:
+      key->b = resampler->b;
+      key->c = resampler->c;
+      break;
+    case GST_AUDIO_RESAMPLER_METHOD_BLACKMAN_NUTTALL:
+      key->cutoff = resampler->cutoff;
+      break;
+    case GST_AUDIO_RESAMPLER_METHOD_KAISER:
+      key->cutoff = resampler->cutoff;
+      key->kaiser_beta = resampler->kaiser_beta;
+      break;
+    default:
+      break;
+  }
+
+  key->filter_interpolation = resampler->filter_interpolation;
+  if (key->filter_interpolation !=
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE)
+    key->oversample = resampler->oversample;
+  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL)
+    key->n_phases = resampler->n_phases;
+}
+
+static guint
+filter_key_hash (gconstpointer key)
+{
+  const guint8 *p = key;
+  guint i, h = 5381;
+
+  for (i = 0; i < sizeof (AudioResamplerFilterKey); i++)
+    h = (h << 5) + h + p[i];
+
+  return h;
+}
+
+static gboolean
+filter_key_equal (gconstpointer a, gconstpointer b)
+{
+  return memcmp (a, b, sizeof (AudioResamplerFilterKey)) == 0;
+}
+
 static void
-alloc_taps_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
+alloc_taps_mem (AudioResamplerFilter * filter, gint bps, gint n_taps,
     gint n_phases)
 {
-  if (resampler->alloc_taps >= n_taps && resampler->alloc_phases >= n_phases)
-    return;
-
   GST_DEBUG ("allocate bps %d n_taps %d n_phases %d", bps, n_taps, n_phases);
 
-  resampler->tmp_taps =
-      g_realloc_n (resampler->tmp_taps, n_taps, sizeof (gdouble));
+  filter->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
 
-  resampler->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
-
-  g_free (resampler->taps_mem);
-  resampler->taps_mem =
-      g_malloc0 (n_phases * resampler->taps_stride + ALIGN - 1);
-  resampler->taps = MEM_ALIGN ((gint8 *) resampler->taps_mem, ALIGN);
-  resampler->alloc_taps = n_taps;
-  resampler->alloc_phases = n_phases;
+  filter->taps_mem = g_malloc0 (n_phases * filter->taps_stride + ALIGN - 1);
+  filter->taps = MEM_ALIGN ((gint8 *) filter->taps_mem, ALIGN);
 }
 
 static void
-alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
+alloc_cache_mem (AudioResamplerFilter * filter, gint bps, gint n_taps,
     gint n_phases)
 {
   gsize phases_size;
 
-  resampler->tmp_taps =
-      g_realloc_n (resampler->tmp_taps, n_taps, sizeof (gdouble));
-
-  resampler->cached_taps_stride =
-      GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
+  filter->cached_taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
 
   phases_size = sizeof (gpointer) * n_phases;
 
-  g_free (resampler->cached_taps_mem);
-  resampler->cached_taps_mem =
-      g_malloc0 (phases_size + n_phases * resampler->cached_taps_stride +
+  filter->cached_taps_mem =
+      g_malloc0 (phases_size + n_phases * filter->cached_taps_stride +
       ALIGN - 1);
-  resampler->cached_taps =
-      MEM_ALIGN ((gint8 *) resampler->cached_taps_mem + phases_size, ALIGN);
-  resampler->cached_phases = resampler->cached_taps_mem;
+  filter->cached_taps =
+      MEM_ALIGN ((gint8 *) filter->cached_taps_mem + phases_size, ALIGN);
+  filter->cached_phases = filter->cached_taps_mem;
 }
 
 static void
-setup_functions (GstAudioResampler * resampler)
+filter_free (AudioResamplerFilter * filter)
 {
-  gint index, fidx;
+  g_free (filter->taps_mem);
+  g_free (filter->cached_taps_mem);
+  g_slice_free (AudioResamplerFilter, filter);
+}
 
-  index = resampler->format_index;
+static void
+filter_unref (AudioResamplerFilter * filter)
+{
+  gboolean last;
 
-  if (resampler->in_rate == resampler->out_rate)
-    resampler->resample = resample_funcs[index];
-  else {
-    switch (resampler->filter_interpolation) {
+  g_mutex_lock (&filters_lock);
+  last = --filter->refcount == 0;
+  if (last)
+    g_hash_table_remove (filters, &filter->key);
+  g_mutex_unlock (&filters_lock);
+
+  if (last) {
+    GST_DEBUG ("free filter %p", filter);
+    filter_free (filter);
+  }
+}
+
+static void
+resampler_use_tables (GstAudioResampler * resampler,
+    AudioResamplerFilter * filter)
+{
+  if (filter) {
+    resampler->taps = filter->taps;
+    resampler->taps_stride = filter->taps_stride;
+    resampler->cached_phases = filter->cached_phases;
+    resampler->cached_taps = filter->cached_taps;
+    resampler->cached_taps_stride = filter->cached_taps_stride;
+  } else {
+    resampler->taps = NULL;
+    resampler->taps_stride = 0;
+    resampler->cached_phases = NULL;
+    resampler->cached_taps = NULL;
+    resampler->cached_taps_stride = 0;
+  }
+}
+
+/* make @resampler use the tables of @filter, takes ownership of the
+ * reference and releases the previous filter */
+static void
+resampler_set_filter (GstAudioResampler * resampler,
+    AudioResamplerFilter * filter)
+{
+  if (resampler->filter)
+    filter_unref (resampler->filter);
+  resampler->filter = filter;
+  resampler_use_tables (resampler, filter);
+}
+
+/* calculate new tables for @key with the parameters of @resampler. The full
+ * filter table is only allocated here, it is filled while resampling. */
+static AudioResamplerFilter *
+resampler_make_filter (GstAudioResampler * resampler,
+    const AudioResamplerFilterKey * key)
+{
+  AudioResamplerFilter *filter;
+  gint i, bps, n_taps;
+
+  bps = resampler->bps;
+  n_taps = resampler->n_taps;
+
+  filter = g_slice_new0 (AudioResamplerFilter);
+  filter->key = *key;
+  filter->refcount = 1;
+
+  if (key->filter_interpolation !=
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE) {
+    gint isize, oversample = key->oversample;
+    gdouble x;
+    gpointer taps;
+
+    switch (key->filter_interpolation) {
       default:
-      case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE:
-        fidx = 0;
-        break;
       case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR:
-        GST_DEBUG ("using linear interpolation for filter coefficients");
-        fidx = 0;
+        GST_DEBUG ("using linear interpolation to build filter");
+        isize = 2;
         break;
       case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC:
-        GST_DEBUG ("using cubic interpolation for filter coefficients");
-        fidx = 4;
+        GST_DEBUG ("using cubic interpolation to build filter");
+        isize = 4;
         break;
     }
-    GST_DEBUG ("using filter interpolate function %d", index + fidx);
-    resampler->interpolate = interpolate_funcs[index + fidx];
 
+    alloc_taps_mem (filter, bps, n_taps, oversample + isize);
+
+    for (i = 0; i < oversample + isize; i++) {
+      x = -(n_taps / 2) + i / (gdouble) oversample;
+      taps = (gint8 *) filter->taps + i * filter->taps_stride;
+      make_taps (resampler, taps, x, n_taps);
+    }
+  }
+
+  if (key->n_phases > 0) {
+    GST_DEBUG ("setting up filter cache with %d phases", key->n_phases);
+    alloc_cache_mem (filter, bps, n_taps, key->n_phases);
+  }
+  return filter;
+}
+
+/* look up the filter tables for the current parameters of @resampler in the
+ * shared filters or make new ones */
+static void
+resampler_setup_filter (GstAudioResampler * resampler)
+{
+  AudioResamplerFilterKey key;
+  AudioResamplerFilter *filter, *other;
+
+  if (resampler->method == GST_AUDIO_RESAMPLER_METHOD_NEAREST ||
+      (resampler->filter_mode != GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
+          resampler->filter_interpolation ==
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE)) {
+    resampler_set_filter (resampler, NULL);
+    return;
+  }
+
+  /* also needed to fill the full filter table of a shared filter */
+  resampler->tmp_taps =
+      g_realloc_n (resampler->tmp_taps, resampler->n_taps, sizeof (gdouble));
+
+  filter_key_init (&key, resampler);
+
+  g_mutex_lock (&filters_lock);
+  if (filters == NULL)
+    filters = g_hash_table_new (filter_key_hash, filter_key_equal);
+  filter = g_hash_table_lookup (filters, &key);
+  if (filter)
+    filter->refcount++;
+  g_mutex_unlock (&filters_lock);
+
+  if (filter) {
+    GST_DEBUG ("reusing filter %p", filter);
+    resampler_set_filter (resampler, filter);
+    return;
+  }
+
+  filter = resampler_make_filter (resampler, &key);
+
+  /* another resampler could have made the same tables in the meantime */
+  g_mutex_lock (&filters_lock);
+  other = g_hash_table_lookup (filters, &key);
+  if (other)
+    other->refcount++;
+  else
+    g_hash_table_insert (filters, &filter->key, filter);
+  g_mutex_unlock (&filters_lock);
+
+  if (other) {
+    filter_free (filter);
+    filter = other;
+  }
+  GST_DEBUG ("using new filter %p", filter);
+  resampler_set_filter (resampler, filter);
+}
+
+static void
+setup_functions (GstAudioResampler * resampler)
+{
+  gint index, fidx;
+
+  index = resampler->format_index;
+
+  /* also needed to make the full filter table when not resampling */
+  switch (resampler->filter_interpolation) {
+    default:
+    case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE:
+      fidx = 0;
+      break;
+    case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR:
+      GST_DEBUG ("using linear interpolation for filter coefficients");
+      fidx = 0;
+      break;
+    case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC:
+      GST_DEBUG ("using cubic interpolation for filter coefficients");
+      fidx = 4;
+      break;
+  }
+  GST_DEBUG ("using filter interpolate function %d", index + fidx);
+  resampler->interpolate = resampler->interpolate_funcs[index + fidx];
+
+  if (resampler->in_rate == resampler->out_rate)
+    resampler->resample = resampler->resample_funcs[index];
+  else {
     switch (resampler->method) {
       case GST_AUDIO_RESAMPLER_METHOD_NEAREST:
         GST_DEBUG ("using nearest filter function");
@@ -1041,7 +1377,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using resample function %d", index);
-    resampler->resample = resample_funcs[index];
+    resampler->resample = resampler->resample_funcs[index];
   }
 }
 
@@ -1158,39 +1494,8 @@ resampler_calculate_taps (GstAudioResampler * resampler)
 
   resampler->filter_interpolation = filter_interpolation;
 
-  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
-      resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST) {
-    GST_DEBUG ("setting up filter cache");
+  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL)
     resampler->n_phases = out_rate;
-    alloc_cache_mem (resampler, bps, n_taps, out_rate);
-  }
-
-  if (resampler->filter_interpolation !=
-      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE) {
-    gint i, isize;
-    gdouble x;
-    gpointer taps;
-
-    switch (resampler->filter_interpolation) {
-      default:
-      case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR:
-        GST_DEBUG ("using linear interpolation to build filter");
-        isize = 2;
-        break;
-      case GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC:
-        GST_DEBUG ("using cubic interpolation to build filter");
-        isize = 4;
-        break;
-    }
-
-    alloc_taps_mem (resampler, bps, n_taps, oversample + isize);
-
-    for (i = 0; i < oversample + isize; i++) {
-      x = -(n_taps / 2) + i / (gdouble) oversample;
-      taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
-      make_taps (resampler, taps, x, n_taps);
-    }
-  }
 }
 
 #define PRINT_TAPS(type,print)                          \
@@ -1249,6 +1554,111 @@ resampler_dump (GstAudioResampler * resampler)
 #endif
 }
 
+#include "gst/parallelized-task-runner-private.h"
+
+/* Each task resamples a range of the channels with a copy of the resampler
+ * that only has those channels. All copies share the filter tables. */
+struct _AudioResamplerTask
+{
+  GstAudioResampler resampler;
+  gpointer *in;
+  gpointer *out;
+  gpointer out_interleaved;
+  gsize in_len;
+  gsize out_len;
+  gsize consumed;
+};
+
+static void
+resampler_free_threads (GstAudioResampler * resampler)
+{
+  if (resampler->runner)
+    gst_parallelized_task_runner_free (resampler->runner);
+  resampler->runner = NULL;
+  g_free (resampler->tasks);
+  resampler->tasks = NULL;
+  g_free (resampler->task_data);
+  resampler->task_data = NULL;
+  resampler->n_threads = 1;
+}
+
+static void
+resampler_setup_threads (GstAudioResampler * resampler, guint n_threads)
+{
+  guint i;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_threads = MIN (n_threads, resampler->blocks);
+
+  if (n_threads == resampler->n_threads)
+    return;
+
+  resampler_free_threads (resampler);
+  if (n_threads <= 1)
+    return;
+
+  resampler->runner =
+      gst_parallelized_task_runner_new ("audioresample", n_threads);
+  n_threads = resampler->runner->n_threads;
+  if (n_threads <= 1) {
+    resampler_free_threads (resampler);
+    return;
+  }
+
+  GST_DEBUG ("resampling %d channels with %u threads", resampler->blocks,
+      n_threads);
+
+  resampler->n_threads = n_threads;
+  resampler->tasks = g_new0 (AudioResamplerTask, n_threads);
+  resampler->task_data = g_new (gpointer, n_threads);
+  for (i = 0; i < n_threads; i++)
+    resampler->task_data[i] = &resampler->tasks[i];
+}
+
+static void
+resample_task (gpointer data)
+{
+  AudioResamplerTask *task = data;
+
+  task->resampler.resample (&task->resampler, task->in, task->in_len,
+      task->out, task->out_len, &task->consumed);
+}
+
+static void
+resample_threaded (GstAudioResampler * resampler, gpointer in[],
+    gsize in_len, gpointer out[], gsize out_len, gsize * consumed)
+{
+  guint i, n_threads = resampler->n_threads;
+  gint blocks = resampler->blocks;
+
+  for (i = 0; i < n_threads; i++) {
+    AudioResamplerTask *task = &resampler->tasks[i];
+    gint first = i * blocks / n_threads;
+    gint last = (i + 1) * blocks / n_threads;
+
+    task->resampler = *resampler;
+    task->resampler.blocks = last - first;
+    task->in = in + first;
+    if (resampler->ostride == 1) {
+      task->out = out + first;
+    } else {
+      task->out_interleaved = (gint8 *) out[0] + first * resampler->bps;
+      task->out = &task->out_interleaved;
+    }
+    task->in_len = in_len;
+    task->out_len = out_len;
+  }
+
+  gst_parallelized_task_runner_run (resampler->runner, resample_task,
+      resampler->task_data);
+
+  /* all channels advanced the same way */
+  resampler->samp_index = resampler->tasks[0].resampler.samp_index;
+  resampler->samp_phase = resampler->tasks[0].resampler.samp_phase;
+  *consumed = resampler->tasks[0].consumed;
+}
+
 /**
  * gst_audio_resampler_options_set_quality:
  * @method: a #GstAudioResamplerMethod
@@ -1374,6 +1784,7 @@ gst_audio_resampler_new (GstAudioResamplerMethod method,
   info = gst_audio_format_get_info (format);
   resampler->bps = GST_AUDIO_FORMAT_INFO_WIDTH (info) / 8;
   resampler->sbuf = g_malloc0 (sizeof (gpointer) * channels);
+  resampler->n_threads = 1;
 
   non_interleaved =
       (resampler->flags & GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT);
@@ -1384,6 +1795,8 @@ gst_audio_resampler_new (GstAudioResamplerMethod method,
   resampler->ostride = non_interleaved ? 1 : resampler->channels;
   resampler->deinterleave = deinterleave_funcs[resampler->format_index];
   resampler->convert_taps = convert_taps_funcs[resampler->format_index];
+  resampler->resample_funcs = resample_funcs;
+  resampler->interpolate_funcs = interpolate_funcs;
 
   GST_DEBUG ("method %d, bps %d, channels %d", method, resampler->bps,
       resampler->channels);
@@ -1393,6 +1806,13 @@ gst_audio_resampler_new (GstAudioResamplerMethod method,
         gst_structure_new_empty ("GstAudioResampler.options");
     gst_audio_resampler_options_set_quality (DEFAULT_RESAMPLER_METHOD,
         GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, in_rate, out_rate, options);
+  } else {
+    const gchar *kernels;
+
+    kernels = gst_structure_get_string (options,
+        GST_AUDIO_RESAMPLER_OPT_KERNELS);
+    if (kernels)
+      audio_resampler_select_kernels (resampler, kernels);
   }
 
   gst_audio_resampler_update (resampler, in_rate, out_rate, options);
@@ -1550,7 +1970,7 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
     old_n_taps = resampler->n_taps;
 
     resampler_calculate_taps (resampler);
-    resampler_dump (resampler);
+    resampler_setup_threads (resampler, GET_OPT_THREADS (resampler->options));
 
     if (old_n_taps > 0 && old_n_taps != resampler->n_taps) {
       gpointer *sbuf;
@@ -1586,10 +2006,11 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
   } else if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL) {
     GST_DEBUG ("setting up filter cache");
     resampler->n_phases = resampler->out_rate;
-    alloc_cache_mem (resampler, resampler->bps, resampler->n_taps,
-        resampler->n_phases);
   }
+  /* the full filter table is made with the interpolate function */
   setup_functions (resampler);
+  resampler_setup_filter (resampler);
+  resampler_dump (resampler);
 
   return TRUE;
 }
@@ -1607,8 +2028,8 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
 {
   g_return_if_fail (resampler != NULL);
 
-  g_free (resampler->cached_taps_mem);
-  g_free (resampler->taps_mem);
+  resampler_free_threads (resampler);
+  resampler_set_filter (resampler, NULL);
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
@@ -1760,8 +2181,12 @@ gst_audio_resampler_resample (GstAudioResampler * resampler,
   }
 
   /* resample all channels */
-  resampler->resample (resampler, sbuf, samples_avail, out, out_frames,
-      &consumed);
+  if (resampler->runner)
+    resample_threaded (resampler, sbuf, samples_avail, out, out_frames,
+        &consumed);
+  else
+    resampler->resample (resampler, sbuf, samples_avail, out, out_frames,
+        &consumed);
 
   GST_LOG ("in %" G_GSIZE_FORMAT ", avail %" G_GSIZE_FORMAT ", consumed %"
       G_GSIZE_FORMAT, in_frames, samples_avail, consumed);
@@ -153,6 +153,17 @@ typedef enum {
  */
 #define GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR "GstAudioResampler.max-phase-error"
 
+/**
+ * GST_AUDIO_RESAMPLER_OPT_THREADS:
+ *
+ * G_TYPE_UINT: maximum number of threads to use. The channels are divided
+ * between the threads, so no more threads than channels are used.
+ * 1 is the default, 0 uses the number of cores.
+ *
+ * Since: 1.12
+ */
+#define GST_AUDIO_RESAMPLER_OPT_THREADS "GstAudioResampler.threads"
+
 /**
  * GstAudioResamplerMethod:
  * @GST_AUDIO_RESAMPLER_METHOD_NEAREST: Duplicates the samples when
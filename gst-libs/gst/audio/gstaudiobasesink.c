@@ -74,6 +74,11 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkCustomSlavingCallback custom_slaving_callback;
   gpointer custom_slaving_cb_data;
   GDestroyNotify custom_slaving_cb_notify;
+
+  /* device thread scheduling */
+  GstAudioRingBufferThreadPolicy thread_policy;
+  gint thread_priority;
+  gchar *thread_affinity;
 };
 
 /* BaseAudioSink signals and args */
@@ -104,6 +109,10 @@ enum
  * fix itself, or is a permanent offset */
 #define DEFAULT_DISCONT_WAIT        (1 * GST_SECOND)
 
+#define DEFAULT_THREAD_POLICY   GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT
+#define DEFAULT_THREAD_PRIORITY 50
+#define DEFAULT_THREAD_AFFINITY NULL
+
 enum
 {
   PROP_0,
@@ -116,6 +125,9 @@ enum
   PROP_ALIGNMENT_THRESHOLD,
   PROP_DRIFT_TOLERANCE,
   PROP_DISCONT_WAIT,
+  PROP_THREAD_POLICY,
+  PROP_THREAD_PRIORITY,
+  PROP_THREAD_AFFINITY,
 
   PROP_LAST
 };
@@ -272,6 +284,55 @@ gst_audio_base_sink_class_init (GstAudioBaseSinkClass * klass)
           G_MAXUINT64 - 1, DEFAULT_DISCONT_WAIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSink:thread-policy:
+   *
+   * Scheduling policy requested for the thread that transfers the segments
+   * between the ringbuffer and the device. Realtime policies usually need
+   * extra permissions; when they can't be obtained the thread keeps its
+   * default scheduling. Whenever a policy or #GstAudioBaseSink:thread-affinity
+   * is requested, the thread posts a "GstAudioThreadScheduling" element
+   * message with the "policy", "priority" and "affinity" that were actually
+   * applied.
+   *
+   * Only used by subclasses whose ringbuffer runs its own device thread,
+   * such as #GstAudioSink. Takes effect the next time the thread is started.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_THREAD_POLICY,
+      g_param_spec_enum ("thread-policy", "Thread Policy",
+          "Scheduling policy of the device thread",
+          GST_TYPE_AUDIO_RING_BUFFER_THREAD_POLICY, DEFAULT_THREAD_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:thread-priority:
+   *
+   * Realtime priority of the device thread, used together with
+   * #GstAudioBaseSink:thread-policy. Clamped to the range the system
+   * supports for the policy.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_THREAD_PRIORITY,
+      g_param_spec_int ("thread-priority", "Thread Priority",
+          "Realtime priority of the device thread", 1, 99,
+          DEFAULT_THREAD_PRIORITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:thread-affinity:
+   *
+   * Comma separated list of CPUs or CPU ranges the device thread is pinned
+   * to, e.g. "2" or "0,4-5". %NULL leaves the affinity alone.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_THREAD_AFFINITY,
+      g_param_spec_string ("thread-affinity", "Thread Affinity",
+          "CPUs the device thread is pinned to (e.g. \"0,4-5\", NULL = any)",
+          DEFAULT_THREAD_AFFINITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_sink_change_state);
   gstelement_class->provide_clock =
@@ -311,6 +372,9 @@ gst_audio_base_sink_init (GstAudioBaseSink * audiobasesink)
   audiobasesink->priv->drift_tolerance = DEFAULT_DRIFT_TOLERANCE;
   audiobasesink->priv->alignment_threshold = DEFAULT_ALIGNMENT_THRESHOLD;
   audiobasesink->priv->discont_wait = DEFAULT_DISCONT_WAIT;
+  audiobasesink->priv->thread_policy = DEFAULT_THREAD_POLICY;
+  audiobasesink->priv->thread_priority = DEFAULT_THREAD_PRIORITY;
+  audiobasesink->priv->thread_affinity = g_strdup (DEFAULT_THREAD_AFFINITY);
   audiobasesink->priv->custom_slaving_callback = NULL;
   audiobasesink->priv->custom_slaving_cb_data = NULL;
   audiobasesink->priv->custom_slaving_cb_notify = NULL;
@@ -351,6 +415,9 @@ gst_audio_base_sink_dispose (GObject * object)
     sink->ringbuffer = NULL;
   }
 
+  g_free (sink->priv->thread_affinity);
+  sink->priv->thread_affinity = NULL;
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -879,6 +946,22 @@ gst_audio_base_sink_set_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       gst_audio_base_sink_set_discont_wait (sink, g_value_get_uint64 (value));
       break;
+    case PROP_THREAD_POLICY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->thread_policy = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_THREAD_PRIORITY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->thread_priority = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_THREAD_AFFINITY:
+      GST_OBJECT_LOCK (sink);
+      g_free (sink->priv->thread_affinity);
+      sink->priv->thread_affinity = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -919,6 +1002,21 @@ gst_audio_base_sink_get_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       g_value_set_uint64 (value, gst_audio_base_sink_get_discont_wait (sink));
       break;
+    case PROP_THREAD_POLICY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_enum (value, sink->priv->thread_policy);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_THREAD_PRIORITY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_int (value, sink->priv->thread_priority);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_THREAD_AFFINITY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_string (value, sink->priv->thread_affinity);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -74,6 +74,11 @@ struct _GstAudioBaseSrcPrivate
 {
   /* the clock slaving algorithm in use */
   GstAudioBaseSrcSlaveMethod slave_method;
+
+  /* device thread scheduling */
+  GstAudioRingBufferThreadPolicy thread_policy;
+  gint thread_priority;
+  gchar *thread_affinity;
 };
 
 /* BaseAudioSrc signals and args */
@@ -90,6 +95,9 @@ enum
 #define DEFAULT_ACTUAL_LATENCY_TIME    -1
 #define DEFAULT_PROVIDE_CLOCK   TRUE
 #define DEFAULT_SLAVE_METHOD    GST_AUDIO_BASE_SRC_SLAVE_SKEW
+#define DEFAULT_THREAD_POLICY   GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT
+#define DEFAULT_THREAD_PRIORITY 50
+#define DEFAULT_THREAD_AFFINITY NULL
 
 enum
 {
@@ -100,6 +108,9 @@ enum
   PROP_ACTUAL_LATENCY_TIME,
   PROP_PROVIDE_CLOCK,
   PROP_SLAVE_METHOD,
+  PROP_THREAD_POLICY,
+  PROP_THREAD_PRIORITY,
+  PROP_THREAD_AFFINITY,
   PROP_LAST
 };
 
@@ -215,6 +226,55 @@ gst_audio_base_src_class_init (GstAudioBaseSrcClass * klass)
           GST_TYPE_AUDIO_BASE_SRC_SLAVE_METHOD, DEFAULT_SLAVE_METHOD,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSrc:thread-policy:
+   *
+   * Scheduling policy requested for the thread that transfers the segments
+   * between the ringbuffer and the device. Realtime policies usually need
+   * extra permissions; when they can't be obtained the thread keeps its
+   * default scheduling. Whenever a policy or #GstAudioBaseSrc:thread-affinity
+   * is requested, the thread posts a "GstAudioThreadScheduling" element
+   * message with the "policy", "priority" and "affinity" that were actually
+   * applied.
+   *
+   * Only used by subclasses whose ringbuffer runs its own device thread,
+   * such as #GstAudioSrc. Takes effect the next time the thread is started.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_THREAD_POLICY,
+      g_param_spec_enum ("thread-policy", "Thread Policy",
+          "Scheduling policy of the device thread",
+          GST_TYPE_AUDIO_RING_BUFFER_THREAD_POLICY, DEFAULT_THREAD_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSrc:thread-priority:
+   *
+   * Realtime priority of the device thread, used together with
+   * #GstAudioBaseSrc:thread-policy. Clamped to the range the system
+   * supports for the policy.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_THREAD_PRIORITY,
+      g_param_spec_int ("thread-priority", "Thread Priority",
+          "Realtime priority of the device thread", 1, 99,
+          DEFAULT_THREAD_PRIORITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSrc:thread-affinity:
+   *
+   * Comma separated list of CPUs or CPU ranges the device thread is pinned
+   * to, e.g. "2" or "0,4-5". %NULL leaves the affinity alone.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_THREAD_AFFINITY,
+      g_param_spec_string ("thread-affinity", "Thread Affinity",
+          "CPUs the device thread is pinned to (e.g. \"0,4-5\", NULL = any)",
+          DEFAULT_THREAD_AFFINITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_src_change_state);
   gstelement_class->provide_clock =
@@ -248,6 +308,9 @@ gst_audio_base_src_init (GstAudioBaseSrc * audiobasesrc)
   else
     GST_OBJECT_FLAG_UNSET (audiobasesrc, GST_ELEMENT_FLAG_PROVIDE_CLOCK);
   audiobasesrc->priv->slave_method = DEFAULT_SLAVE_METHOD;
+  audiobasesrc->priv->thread_policy = DEFAULT_THREAD_POLICY;
+  audiobasesrc->priv->thread_priority = DEFAULT_THREAD_PRIORITY;
+  audiobasesrc->priv->thread_affinity = g_strdup (DEFAULT_THREAD_AFFINITY);
   /* reset blocksize we use latency time to calculate a more useful
    * value based on negotiated format. */
   GST_BASE_SRC (audiobasesrc)->blocksize = 0;
@@ -281,6 +344,9 @@ gst_audio_base_src_dispose (GObject * object)
     gst_object_unparent (GST_OBJECT_CAST (src->ringbuffer));
     src->ringbuffer = NULL;
   }
+
+  g_free (src->priv->thread_affinity);
+  src->priv->thread_affinity = NULL;
   GST_OBJECT_UNLOCK (src);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
@@ -461,6 +527,22 @@ gst_audio_base_src_set_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       gst_audio_base_src_set_slave_method (src, g_value_get_enum (value));
       break;
+    case PROP_THREAD_POLICY:
+      GST_OBJECT_LOCK (src);
+      src->priv->thread_policy = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_THREAD_PRIORITY:
+      GST_OBJECT_LOCK (src);
+      src->priv->thread_priority = g_value_get_int (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_THREAD_AFFINITY:
+      GST_OBJECT_LOCK (src);
+      g_free (src->priv->thread_affinity);
+      src->priv->thread_affinity = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -504,6 +586,21 @@ gst_audio_base_src_get_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       g_value_set_enum (value, gst_audio_base_src_get_slave_method (src));
       break;
+    case PROP_THREAD_POLICY:
+      GST_OBJECT_LOCK (src);
+      g_value_set_enum (value, src->priv->thread_policy);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_THREAD_PRIORITY:
+      GST_OBJECT_LOCK (src);
+      g_value_set_int (value, src->priv->thread_priority);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_THREAD_AFFINITY:
+      GST_OBJECT_LOCK (src);
+      g_value_set_string (value, src->priv->thread_affinity);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
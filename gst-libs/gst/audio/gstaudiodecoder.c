@@ -171,12 +171,16 @@ enum
   PROP_0,
   PROP_LATENCY,
   PROP_TOLERANCE,
-  PROP_PLC
+  PROP_PLC,
+  PROP_MIN_OUTPUT_SIZE,
+  PROP_BUFFER_LISTS
 };
 
 #define DEFAULT_LATENCY    0
 #define DEFAULT_TOLERANCE  0
 #define DEFAULT_PLC        FALSE
+#define DEFAULT_MIN_OUTPUT_SIZE  0
+#define DEFAULT_BUFFER_LISTS  FALSE
 #define DEFAULT_DRAINABLE  TRUE
 #define DEFAULT_NEEDS_FORMAT  FALSE
 
@@ -233,6 +237,11 @@ struct _GstAudioDecoderPrivate
   GstAdapter *adapter_out;
   /* ts and duration for output data collected above */
   GstClockTime out_ts, out_dur;
+  /* collected (already clipped) output buffers, if pushing lists */
+  GstBufferList *out_list;
+  /* bytes and duration of the buffers in out_list */
+  gsize out_list_size;
+  GstClockTime out_list_dur;
   /* mark outgoing discont */
   gboolean discont;
 
@@ -283,6 +292,8 @@ struct _GstAudioDecoderPrivate
   GstClockTime latency;
   GstClockTime tolerance;
   gboolean plc;
+  guint min_output_size;
+  gboolean buffer_lists;
   gboolean drainable;
   gboolean needs_format;
 
@@ -329,6 +340,7 @@ static gboolean gst_audio_decoder_propose_allocation_default (GstAudioDecoder *
     dec, GstQuery * query);
 static gboolean gst_audio_decoder_negotiate_default (GstAudioDecoder * dec);
 static gboolean gst_audio_decoder_negotiate_unlocked (GstAudioDecoder * dec);
+static GstFlowReturn gst_audio_decoder_push_list (GstAudioDecoder * dec);
 static gboolean gst_audio_decoder_handle_gap (GstAudioDecoder * dec,
     GstEvent * event);
 static gboolean gst_audio_decoder_sink_query_default (GstAudioDecoder * dec,
@@ -415,6 +427,36 @@ gst_audio_decoder_class_init (GstAudioDecoderClass * klass)
           "Perform packet loss concealment (if supported)",
           DEFAULT_PLC, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioDecoder:min-output-size:
+   *
+   * Aggregate output data to at least this many bytes before pushing
+   * downstream, in addition to (or instead of) #GstAudioDecoder:min-latency.
+   * As with #GstAudioDecoder:min-latency, aggregation only happens in
+   * non-live pipelines.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_MIN_OUTPUT_SIZE,
+      g_param_spec_uint ("min-output-size", "Minimum Output Size",
+          "Aggregate output data to a minimum of this many bytes (0 = unset)",
+          0, G_MAXUINT, DEFAULT_MIN_OUTPUT_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioDecoder:buffer-lists:
+   *
+   * When aggregating output, push the collected buffers downstream as one
+   * #GstBufferList instead of copying them into a single larger buffer.
+   * Only used for forward playback.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_BUFFER_LISTS,
+      g_param_spec_boolean ("buffer-lists", "Buffer Lists",
+          "Push aggregated output as buffer lists instead of merged buffers",
+          DEFAULT_BUFFER_LISTS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   audiodecoder_class->sink_event =
       GST_DEBUG_FUNCPTR (gst_audio_decoder_sink_eventfunc);
   audiodecoder_class->src_event =
@@ -480,6 +522,8 @@ gst_audio_decoder_init (GstAudioDecoder * dec, GstAudioDecoderClass * klass)
   dec->priv->latency = DEFAULT_LATENCY;
   dec->priv->tolerance = DEFAULT_TOLERANCE;
   dec->priv->plc = DEFAULT_PLC;
+  dec->priv->min_output_size = DEFAULT_MIN_OUTPUT_SIZE;
+  dec->priv->buffer_lists = DEFAULT_BUFFER_LISTS;
   dec->priv->drainable = DEFAULT_DRAINABLE;
   dec->priv->needs_format = DEFAULT_NEEDS_FORMAT;
 
@@ -548,6 +592,12 @@ gst_audio_decoder_reset (GstAudioDecoder * dec, gboolean full)
   gst_adapter_clear (dec->priv->adapter_out);
   dec->priv->out_ts = GST_CLOCK_TIME_NONE;
   dec->priv->out_dur = 0;
+  if (dec->priv->out_list) {
+    gst_buffer_list_unref (dec->priv->out_list);
+    dec->priv->out_list = NULL;
+  }
+  dec->priv->out_list_size = 0;
+  dec->priv->out_list_dur = 0;
   dec->priv->prev_ts = GST_CLOCK_TIME_NONE;
   dec->priv->prev_distance = 0;
   dec->priv->drained = TRUE;
@@ -573,6 +623,9 @@ gst_audio_decoder_finalize (GObject * object)
   if (dec->priv->adapter_out) {
     g_object_unref (dec->priv->adapter_out);
   }
+  if (dec->priv->out_list) {
+    gst_buffer_list_unref (dec->priv->out_list);
+  }
 
   g_rec_mutex_clear (&dec->stream_lock);
 
@@ -733,6 +786,14 @@ gst_audio_decoder_negotiate_unlocked (GstAudioDecoder * dec)
   GstAudioDecoderClass *klass = GST_AUDIO_DECODER_GET_CLASS (dec);
   gboolean ret = TRUE;
 
+  /* buffers collected in the old format go out before the new caps */
+  if (G_UNLIKELY (dec->priv->out_list)) {
+    GstFlowReturn flow_ret = gst_audio_decoder_push_list (dec);
+
+    GST_DEBUG_OBJECT (dec, "list pushed before negotiation: %s",
+        gst_flow_get_name (flow_ret));
+  }
+
   if (G_LIKELY (klass->negotiate))
     ret = klass->negotiate (dec);
 
@@ -761,6 +822,12 @@ gst_audio_decoder_negotiate (GstAudioDecoder * dec)
 
   GST_AUDIO_DECODER_STREAM_LOCK (dec);
   gst_pad_check_reconfigure (dec->srcpad);
+  if (G_UNLIKELY (dec->priv->out_list)) {
+    GstFlowReturn flow_ret = gst_audio_decoder_push_list (dec);
+
+    GST_DEBUG_OBJECT (dec, "list pushed before negotiation: %s",
+        gst_flow_get_name (flow_ret));
+  }
   if (klass->negotiate) {
     res = klass->negotiate (dec);
     if (!res)
@@ -903,19 +970,24 @@ gst_audio_decoder_setup (GstAudioDecoder * dec)
   dec->priv->agg = ! !res;
 }
 
+/* clips and decorates @buf for pushing, and gives the subclass a last look
+ * at it; *buf is set to NULL if nothing is left to be pushed */
 static GstFlowReturn
-gst_audio_decoder_push_forward (GstAudioDecoder * dec, GstBuffer * buf)
+gst_audio_decoder_prepare_push (GstAudioDecoder * dec, GstBuffer ** buffer)
 {
   GstAudioDecoderClass *klass;
   GstAudioDecoderPrivate *priv;
   GstAudioDecoderContext *ctx;
   GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buf = *buffer;
   GstClockTime ts;
 
   klass = GST_AUDIO_DECODER_GET_CLASS (dec);
   priv = dec->priv;
   ctx = &dec->priv->ctx;
 
+  *buffer = NULL;
+
   g_return_val_if_fail (ctx->info.bpf != 0, GST_FLOW_ERROR);
 
   if (G_UNLIKELY (!buf)) {
@@ -977,15 +1049,84 @@ gst_audio_decoder_push_forward (GstAudioDecoder * dec, GstBuffer * buf)
     }
   }
 
+  *buffer = buf;
+
+exit:
+  return ret;
+}
+
+static GstFlowReturn
+gst_audio_decoder_push_forward (GstAudioDecoder * dec, GstBuffer * buf)
+{
+  GstFlowReturn ret;
+
+  ret = gst_audio_decoder_prepare_push (dec, &buf);
+  if (!buf)
+    return ret;
+
   GST_LOG_OBJECT (dec,
       "pushing buffer of size %" G_GSIZE_FORMAT " with ts %" GST_TIME_FORMAT
       ", duration %" GST_TIME_FORMAT, gst_buffer_get_size (buf),
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)),
       GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
 
-  ret = gst_pad_push (dec->srcpad, buf);
+  return gst_pad_push (dec->srcpad, buf);
+}
+
+static GstFlowReturn
+gst_audio_decoder_push_list (GstAudioDecoder * dec)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstBufferList *list;
+
+  list = priv->out_list;
+  priv->out_list = NULL;
+  priv->out_list_size = 0;
+  priv->out_list_dur = 0;
+
+  if (!list)
+    return GST_FLOW_OK;
+
+  GST_LOG_OBJECT (dec, "pushing list of %u buffers",
+      gst_buffer_list_length (list));
+
+  return gst_pad_push_list (dec->srcpad, list);
+}
+
+/* collects clipped buffers in a list that is pushed once large enough,
+ * or right away if @buf is NULL */
+static GstFlowReturn
+gst_audio_decoder_output_list (GstAudioDecoder * dec, GstBuffer * buf)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstFlowReturn ret = GST_FLOW_OK, list_ret;
+  gboolean force = (buf == NULL);
+
+  if (buf) {
+    ret = gst_audio_decoder_prepare_push (dec, &buf);
+    if (buf) {
+      if (!priv->out_list)
+        priv->out_list = gst_buffer_list_new ();
+      priv->out_list_size += gst_buffer_get_size (buf);
+      if (GST_BUFFER_DURATION_IS_VALID (buf))
+        priv->out_list_dur += GST_BUFFER_DURATION (buf);
+      gst_buffer_list_add (priv->out_list, buf);
+    }
+  }
+
+  if (!priv->out_list)
+    return ret;
+
+  if (force || ret != GST_FLOW_OK ||
+      (priv->latency > 0 && priv->out_list_dur > priv->latency) ||
+      (priv->min_output_size > 0 &&
+          priv->out_list_size >= priv->min_output_size)) {
+    list_ret = gst_audio_decoder_push_list (dec);
+    GST_LOG_OBJECT (dec, "list pushed: %s", gst_flow_get_name (list_ret));
+    if (ret == GST_FLOW_OK)
+      ret = list_ret;
+  }
 
-exit:
   return ret;
 }
 
@@ -1011,9 +1152,38 @@ gst_audio_decoder_output (GstAudioDecoder * dec, GstBuffer * buf)
         GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
   }
 
+  if (priv->agg && (priv->latency > 0 || priv->min_output_size > 0)
+      && priv->buffer_lists && dec->output_segment.rate > 0.0) {
+    /* pass on whatever was merged before switching to lists */
+    if (G_UNLIKELY (gst_adapter_available (priv->adapter_out))) {
+      inbuf = gst_adapter_take_buffer (priv->adapter_out,
+          gst_adapter_available (priv->adapter_out));
+      GST_BUFFER_TIMESTAMP (inbuf) = priv->out_ts;
+      GST_BUFFER_DURATION (inbuf) = priv->out_dur;
+      priv->out_ts = GST_CLOCK_TIME_NONE;
+      priv->out_dur = 0;
+      ret = gst_audio_decoder_output_list (dec, inbuf);
+      if (ret != GST_FLOW_OK) {
+        if (buf)
+          gst_buffer_unref (buf);
+        return ret;
+      }
+    }
+    return gst_audio_decoder_output_list (dec, buf);
+  }
+
+  if (G_UNLIKELY (priv->out_list)) {
+    ret = gst_audio_decoder_push_list (dec);
+    if (ret != GST_FLOW_OK) {
+      if (buf)
+        gst_buffer_unref (buf);
+      return ret;
+    }
+  }
+
 again:
   inbuf = NULL;
-  if (priv->agg && dec->priv->latency > 0) {
+  if (priv->agg && (priv->latency > 0 || priv->min_output_size > 0)) {
     gint av;
     gboolean assemble = FALSE;
     const GstClockTimeDiff tol = 10 * GST_MSECOND;
@@ -1044,7 +1214,9 @@ again:
       av += gst_buffer_get_size (buf);
       buf = NULL;
     }
-    if (priv->out_dur > dec->priv->latency)
+    if (priv->latency > 0 && priv->out_dur > priv->latency)
+      assemble = TRUE;
+    if (priv->min_output_size > 0 && (guint) av >= priv->min_output_size)
       assemble = TRUE;
     if (av && assemble) {
       GST_LOG_OBJECT (dec, "assembling fragment");
@@ -1137,6 +1309,13 @@ check_pending_reconfigure (GstAudioDecoder * dec)
   if (G_UNLIKELY (ctx->output_format_changed ||
           (GST_AUDIO_INFO_IS_VALID (&ctx->info)
               && needs_reconfigure))) {
+    /* the collected buffers must not end up after the new caps */
+    ret = gst_audio_decoder_push_list (dec);
+    if (ret != GST_FLOW_OK) {
+      if (needs_reconfigure)
+        gst_pad_mark_reconfigure (dec->srcpad);
+      return ret;
+    }
     if (!gst_audio_decoder_negotiate_unlocked (dec)) {
       gst_pad_mark_reconfigure (dec->srcpad);
       if (GST_PAD_IS_FLUSHING (dec->srcpad))
@@ -1259,11 +1438,20 @@ gst_audio_decoder_finish_frame (GstAudioDecoder * dec, GstBuffer * buf,
 
   if (buf) {
     ret = check_pending_reconfigure (dec);
-    if (ret == GST_FLOW_FLUSHING || ret == GST_FLOW_NOT_NEGOTIATED)
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (buf);
       goto exit;
+    }
 
-    if (priv->pending_events)
+    if (priv->pending_events) {
+      /* keep collected buffers ahead of the events that followed them */
+      ret = gst_audio_decoder_push_list (dec);
+      if (ret != GST_FLOW_OK) {
+        gst_buffer_unref (buf);
+        goto exit;
+      }
       send_pending_events (dec);
+    }
   }
 
   /* output shoud be whole number of sample frames */
@@ -2136,10 +2324,14 @@ gst_audio_decoder_handle_gap (GstAudioDecoder * dec, GstEvent * event)
     /* sub-class doesn't know how to handle empty buffers,
      * so just try sending GAP downstream */
     flowret = check_pending_reconfigure (dec);
+    /* the collected buffers go out ahead of the gap */
+    if (flowret == GST_FLOW_OK)
+      flowret = gst_audio_decoder_push_list (dec);
     if (flowret == GST_FLOW_OK) {
       send_pending_events (dec);
       ret = gst_audio_decoder_push_event (dec, event);
     } else {
+      gst_event_unref (event);
       ret = FALSE;
     }
   }
@@ -2934,6 +3126,12 @@ gst_audio_decoder_get_property (GObject * object, guint prop_id,
     case PROP_PLC:
       g_value_set_boolean (value, dec->priv->plc);
       break;
+    case PROP_MIN_OUTPUT_SIZE:
+      g_value_set_uint (value, dec->priv->min_output_size);
+      break;
+    case PROP_BUFFER_LISTS:
+      g_value_set_boolean (value, dec->priv->buffer_lists);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2958,6 +3156,12 @@ gst_audio_decoder_set_property (GObject * object, guint prop_id,
     case PROP_PLC:
       dec->priv->plc = g_value_get_boolean (value);
       break;
+    case PROP_MIN_OUTPUT_SIZE:
+      dec->priv->min_output_size = g_value_get_uint (value);
+      break;
+    case PROP_BUFFER_LISTS:
+      dec->priv->buffer_lists = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3356,6 +3560,101 @@ gst_audio_decoder_get_min_latency (GstAudioDecoder * dec)
   return result;
 }
 
+/**
+ * gst_audio_decoder_set_min_output_size:
+ * @dec: a #GstAudioDecoder
+ * @size: new minimum output size in bytes, or 0 to unset
+ *
+ * Sets the minimum amount of output data the decoder aggregates before
+ * pushing it downstream.
+ *
+ * MT safe.
+ *
+ * Since: 1.12
+ */
+void
+gst_audio_decoder_set_min_output_size (GstAudioDecoder * dec, guint size)
+{
+  g_return_if_fail (GST_IS_AUDIO_DECODER (dec));
+
+  GST_OBJECT_LOCK (dec);
+  dec->priv->min_output_size = size;
+  GST_OBJECT_UNLOCK (dec);
+}
+
+/**
+ * gst_audio_decoder_get_min_output_size:
+ * @dec: a #GstAudioDecoder
+ *
+ * Queries the decoder's minimum output aggregation size.
+ *
+ * Returns: minimum output size in bytes.
+ *
+ * MT safe.
+ *
+ * Since: 1.12
+ */
+guint
+gst_audio_decoder_get_min_output_size (GstAudioDecoder * dec)
+{
+  guint result;
+
+  g_return_val_if_fail (GST_IS_AUDIO_DECODER (dec), 0);
+
+  GST_OBJECT_LOCK (dec);
+  result = dec->priv->min_output_size;
+  GST_OBJECT_UNLOCK (dec);
+
+  return result;
+}
+
+/**
+ * gst_audio_decoder_set_buffer_lists:
+ * @dec: a #GstAudioDecoder
+ * @enabled: new state
+ *
+ * Enable or disable pushing aggregated output as #GstBufferList.
+ *
+ * MT safe.
+ *
+ * Since: 1.12
+ */
+void
+gst_audio_decoder_set_buffer_lists (GstAudioDecoder * dec, gboolean enabled)
+{
+  g_return_if_fail (GST_IS_AUDIO_DECODER (dec));
+
+  GST_OBJECT_LOCK (dec);
+  dec->priv->buffer_lists = enabled;
+  GST_OBJECT_UNLOCK (dec);
+}
+
+/**
+ * gst_audio_decoder_get_buffer_lists:
+ * @dec: a #GstAudioDecoder
+ *
+ * Queries whether aggregated output is pushed as #GstBufferList.
+ *
+ * Returns: TRUE if buffer lists are pushed.
+ *
+ * MT safe.
+ *
+ * Since: 1.12
+ */
+gboolean
+gst_audio_decoder_get_buffer_lists (GstAudioDecoder * dec)
+{
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_AUDIO_DECODER (dec), FALSE);
+
+  GST_OBJECT_LOCK (dec);
+  result = dec->priv->buffer_lists;
+  GST_OBJECT_UNLOCK (dec);
+
+  return result;
+}
+
 /**
  * gst_audio_decoder_set_tolerance:
  * @dec: a #GstAudioDecoder
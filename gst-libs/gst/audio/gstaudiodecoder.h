@@ -374,6 +374,16 @@ void              gst_audio_decoder_set_min_latency (GstAudioDecoder * dec,
 
 GstClockTime      gst_audio_decoder_get_min_latency (GstAudioDecoder * dec);
 
+void              gst_audio_decoder_set_min_output_size (GstAudioDecoder * dec,
+                                                         guint             size);
+
+guint             gst_audio_decoder_get_min_output_size (GstAudioDecoder * dec);
+
+void              gst_audio_decoder_set_buffer_lists (GstAudioDecoder * dec,
+                                                      gboolean          enabled);
+
+gboolean          gst_audio_decoder_get_buffer_lists (GstAudioDecoder * dec);
+
 void              gst_audio_decoder_set_tolerance   (GstAudioDecoder * dec,
                                                      GstClockTime      tolerance);
 
@@ -37,6 +37,7 @@
  * </refsect2>
  */
 
+#include <errno.h>
 #include <string.h>
 
 #include <gst/audio/audio.h>
@@ -45,10 +46,19 @@
 GST_DEBUG_CATEGORY_STATIC (gst_audio_ring_buffer_debug);
 #define GST_CAT_DEFAULT gst_audio_ring_buffer_debug
 
+struct _GstAudioRingBufferPrivate
+{
+  /* writer and reader wait without the object lock, see wait_segment() */
+  gboolean lock_free;
+  /* control socket the waiter blocks on in lock free mode */
+  GstPoll *wakeup;
+};
+
 static void gst_audio_ring_buffer_dispose (GObject * object);
 static void gst_audio_ring_buffer_finalize (GObject * object);
 
 static gboolean gst_audio_ring_buffer_pause_unlocked (GstAudioRingBuffer * buf);
+static void wake_lock_free_waiter (GstAudioRingBuffer * buf);
 static void default_clear_all (GstAudioRingBuffer * buf);
 static guint default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum);
@@ -69,6 +79,8 @@ gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
   GST_DEBUG_CATEGORY_INIT (gst_audio_ring_buffer_debug, "ringbuffer", 0,
       "ringbuffer class");
 
+  g_type_class_add_private (klass, sizeof (GstAudioRingBufferPrivate));
+
   gobject_class->dispose = gst_audio_ring_buffer_dispose;
   gobject_class->finalize = gst_audio_ring_buffer_finalize;
 
@@ -79,6 +91,8 @@ gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
 static void
 gst_audio_ring_buffer_init (GstAudioRingBuffer * ringbuffer)
 {
+  ringbuffer->priv = G_TYPE_INSTANCE_GET_PRIVATE (ringbuffer,
+      GST_TYPE_AUDIO_RING_BUFFER, GstAudioRingBufferPrivate);
   ringbuffer->open = FALSE;
   ringbuffer->acquired = FALSE;
   ringbuffer->state = GST_AUDIO_RING_BUFFER_STATE_STOPPED;
@@ -108,6 +122,8 @@ gst_audio_ring_buffer_finalize (GObject * object)
 
   g_cond_clear (&ringbuffer->cond);
   g_free (ringbuffer->empty_seg);
+  if (ringbuffer->priv->wakeup)
+    gst_poll_free (ringbuffer->priv->wakeup);
 
   G_OBJECT_CLASS (gst_audio_ring_buffer_parent_class)->finalize (G_OBJECT
       (ringbuffer));
@@ -692,6 +708,7 @@ gst_audio_ring_buffer_release (GstAudioRingBuffer * buf)
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
   GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  wake_lock_free_waiter (buf);
 
   if (G_UNLIKELY (!res))
     goto release_failed;
@@ -1000,6 +1017,7 @@ gst_audio_ring_buffer_pause_unlocked (GstAudioRingBuffer * buf)
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
   GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  wake_lock_free_waiter (buf);
 
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->pause))
@@ -1109,6 +1127,7 @@ gst_audio_ring_buffer_stop (GstAudioRingBuffer * buf)
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
   GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  wake_lock_free_waiter (buf);
 
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->stop))
@@ -1274,6 +1293,64 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
     rclass->clear_all (buf);
 }
 
+/* in lock free mode the waiter is woken up through a control socket instead
+ * of the cond. Whoever resets the waiting flag from 1 to 0 owns the wakeup:
+ * wakers write a control token when they do, the waiter consumes it. */
+static void
+wake_lock_free_waiter (GstAudioRingBuffer * buf)
+{
+  if (!buf->priv->lock_free)
+    return;
+
+  if (g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0)) {
+    GST_DEBUG_OBJECT (buf, "wake up lock free waiter");
+    gst_poll_write_control (buf->priv->wakeup);
+  }
+}
+
+static gboolean
+wait_segment_lock_free (GstAudioRingBuffer * buf, gint segments)
+{
+  GstClockTime timeout;
+  gint res;
+
+  if (G_UNLIKELY (!g_atomic_int_compare_and_exchange (&buf->waiting, 0, 1)))
+    goto check_state;
+
+  /* the device might have advanced or we might have been stopped between
+   * checking and raising the flag, only sleep if that did not happen */
+  if (g_atomic_int_get (&buf->segdone) != segments || buf->flushing ||
+      g_atomic_int_get (&buf->state) != GST_AUDIO_RING_BUFFER_STATE_STARTED) {
+    if (!g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0))
+      gst_poll_read_control (buf->priv->wakeup);
+    goto check_state;
+  }
+
+  /* state changes made from outside this file only signal the cond, so
+   * don't sleep for longer than the buffer can hold */
+  timeout = buf->spec.buffer_time > 0 ?
+      buf->spec.buffer_time * GST_USECOND : GST_SECOND;
+
+  GST_DEBUG_OBJECT (buf, "waiting lock free..");
+  do {
+    res = gst_poll_wait (buf->priv->wakeup, timeout);
+  } while (G_UNLIKELY (res < 0 && errno == EINTR));
+
+  if (!g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0))
+    gst_poll_read_control (buf->priv->wakeup);
+
+check_state:
+  if (G_UNLIKELY (buf->flushing)) {
+    GST_DEBUG_OBJECT (buf, "flushing");
+    return FALSE;
+  }
+  if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+          GST_AUDIO_RING_BUFFER_STATE_STARTED)) {
+    GST_DEBUG_OBJECT (buf, "stopped processing");
+    return FALSE;
+  }
+  return TRUE;
+}
 
 static gboolean
 wait_segment (GstAudioRingBuffer * buf)
@@ -1296,6 +1373,14 @@ wait_segment (GstAudioRingBuffer * buf)
      * don't need to wait anymore */
     if (G_LIKELY (g_atomic_int_get (&buf->segdone) != segments))
       wait = FALSE;
+  } else {
+    segments = g_atomic_int_get (&buf->segdone);
+  }
+
+  if (buf->priv->lock_free) {
+    if (!wait)
+      return TRUE;
+    return wait_segment_lock_free (buf, segments);
   }
 
   /* take lock first, then update our waiting flag */
@@ -1875,6 +1960,11 @@ gst_audio_ring_buffer_advance (GstAudioRingBuffer * buf, guint advance)
   /* update counter */
   g_atomic_int_add (&buf->segdone, advance);
 
+  if (buf->priv->lock_free) {
+    wake_lock_free_waiter (buf);
+    return;
+  }
+
   /* the lock is already taken when the waiting flag is set,
    * we grab the lock as well to make sure the waiter is actually
    * waiting for the signal */
@@ -2048,3 +2138,89 @@ not_acquired:
     goto done;
   }
 }
+
+/**
+ * gst_audio_ring_buffer_set_lock_free:
+ * @buf: the #GstAudioRingBuffer
+ * @lock_free: the new mode
+ *
+ * Select how a writer (or reader) that has to wait for the device to
+ * process a segment is woken up. By default the object lock and a #GCond
+ * are used. In lock free mode the waiter only relies on the atomic
+ * segment counter and a control socket, and the device thread only
+ * touches the socket when somebody is actually waiting, so
+ * gst_audio_ring_buffer_advance() never takes the object lock.
+ *
+ * The mode can only be changed while the ringbuffer is not acquired.
+ *
+ * Returns: %TRUE if the mode could be set.
+ *
+ * Since: 1.12
+ */
+gboolean
+gst_audio_ring_buffer_set_lock_free (GstAudioRingBuffer * buf,
+    gboolean lock_free)
+{
+  GstAudioRingBufferPrivate *priv;
+  gboolean res = TRUE;
+
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), FALSE);
+
+  priv = buf->priv;
+
+  GST_OBJECT_LOCK (buf);
+  if (G_UNLIKELY (buf->acquired))
+    goto was_acquired;
+
+  if (lock_free && !priv->wakeup) {
+    priv->wakeup = gst_poll_new_timer ();
+    if (G_UNLIKELY (!priv->wakeup))
+      goto no_poll;
+  }
+  priv->lock_free = lock_free;
+  GST_DEBUG_OBJECT (buf, "lock free mode %d", lock_free);
+
+done:
+  GST_OBJECT_UNLOCK (buf);
+
+  return res;
+
+  /* ERRORS */
+was_acquired:
+  {
+    GST_WARNING_OBJECT (buf, "can't change mode while acquired");
+    res = FALSE;
+    goto done;
+  }
+no_poll:
+  {
+    GST_WARNING_OBJECT (buf, "could not create wakeup socket");
+    res = FALSE;
+    goto done;
+  }
+}
+
+/**
+ * gst_audio_ring_buffer_get_lock_free:
+ * @buf: the #GstAudioRingBuffer
+ *
+ * Check if @buf uses lock free waiting, see
+ * gst_audio_ring_buffer_set_lock_free().
+ *
+ * Returns: %TRUE if lock free waiting is used.
+ *
+ * Since: 1.12
+ */
+gboolean
+gst_audio_ring_buffer_get_lock_free (GstAudioRingBuffer * buf)
+{
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), FALSE);
+
+  GST_OBJECT_LOCK (buf);
+  res = buf->priv->lock_free;
+  GST_OBJECT_UNLOCK (buf);
+
+  return res;
+}
@@ -40,6 +40,7 @@ G_BEGIN_DECLS
 typedef struct _GstAudioRingBuffer GstAudioRingBuffer;
 typedef struct _GstAudioRingBufferClass GstAudioRingBufferClass;
 typedef struct _GstAudioRingBufferSpec GstAudioRingBufferSpec;
+typedef struct _GstAudioRingBufferPrivate GstAudioRingBufferPrivate;
 
 /**
  * GstAudioRingBufferCallback:
@@ -71,6 +72,26 @@ typedef enum {
   GST_AUDIO_RING_BUFFER_STATE_ERROR
 } GstAudioRingBufferState;
 
+/**
+ * GstAudioRingBufferThreadPolicy:
+ * @GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT: keep the scheduling policy
+ *     the device thread was created with
+ * @GST_AUDIO_RING_BUFFER_THREAD_POLICY_FIFO: realtime first in, first out
+ *     scheduling (SCHED_FIFO)
+ * @GST_AUDIO_RING_BUFFER_THREAD_POLICY_RR: realtime round robin scheduling
+ *     (SCHED_RR)
+ *
+ * The scheduling policy requested for the thread that reads or writes the
+ * ringbuffer segments from or to the device.
+ *
+ * Since: 1.12
+ */
+typedef enum {
+  GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT,
+  GST_AUDIO_RING_BUFFER_THREAD_POLICY_FIFO,
+  GST_AUDIO_RING_BUFFER_THREAD_POLICY_RR
+} GstAudioRingBufferThreadPolicy;
+
 /**
  * GstAudioRingBufferFormatType:
  * @GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW: samples in linear or float
@@ -206,7 +227,8 @@ struct _GstAudioRingBuffer {
   gboolean                    active;
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  GstAudioRingBufferPrivate  *priv;
+  gpointer _gst_reserved[GST_PADDING - 1];
 };
 
 /**
@@ -333,6 +355,10 @@ void            gst_audio_ring_buffer_advance         (GstAudioRingBuffer *buf,
 
 void            gst_audio_ring_buffer_may_start       (GstAudioRingBuffer *buf, gboolean allowed);
 
+/* waiting mode */
+gboolean        gst_audio_ring_buffer_set_lock_free   (GstAudioRingBuffer *buf, gboolean lock_free);
+gboolean        gst_audio_ring_buffer_get_lock_free   (GstAudioRingBuffer *buf);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstAudioRingBuffer, gst_object_unref)
 #endif
@@ -69,6 +69,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudiosink.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_sink_debug);
 #define GST_CAT_DEFAULT gst_audio_sink_debug
@@ -214,6 +215,9 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   WriteFunc writefunc;
   GstMessage *message;
   GValue val = { 0 };
+  GstAudioRingBufferThreadPolicy policy;
+  gint priority;
+  gchar *affinity;
 
   sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
   csink = GST_AUDIO_SINK_GET_CLASS (sink);
@@ -238,6 +242,12 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   GST_DEBUG_OBJECT (sink, "posting ENTER stream status");
   gst_element_post_message (GST_ELEMENT_CAST (sink), message);
 
+  g_object_get (sink, "thread-policy", &policy, "thread-priority", &priority,
+      "thread-affinity", &affinity, NULL);
+  __gst_audio_set_thread_scheduling (GST_ELEMENT_CAST (sink), policy, priority,
+      affinity);
+  g_free (affinity);
+
   while (TRUE) {
     gint left, len;
     guint8 *readptr;
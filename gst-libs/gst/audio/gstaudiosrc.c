@@ -69,6 +69,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudiosrc.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_src_debug);
 #define GST_CAT_DEFAULT gst_audio_src_debug
@@ -206,6 +207,9 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   ReadFunc readfunc;
   GstMessage *message;
   GValue val = { 0 };
+  GstAudioRingBufferThreadPolicy policy;
+  gint priority;
+  gchar *affinity;
 
   src = GST_AUDIO_SRC (GST_OBJECT_PARENT (buf));
   csrc = GST_AUDIO_SRC_GET_CLASS (src);
@@ -224,6 +228,12 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   GST_DEBUG_OBJECT (src, "posting ENTER stream status");
   gst_element_post_message (GST_ELEMENT_CAST (src), message);
 
+  g_object_get (src, "thread-policy", &policy, "thread-priority", &priority,
+      "thread-affinity", &affinity, NULL);
+  __gst_audio_set_thread_scheduling (GST_ELEMENT_CAST (src), policy, priority,
+      affinity);
+  g_free (affinity);
+
   while (TRUE) {
     gint left, len;
     guint8 *readptr;
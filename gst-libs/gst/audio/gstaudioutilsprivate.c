@@ -19,10 +19,22 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             /* for pthread_setaffinity_np() */
+#endif
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#include <stdlib.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_SCHED_H
+#include <sched.h>
+#endif
+
 #include <gst/audio/audio.h>
 #include "gstaudioutilsprivate.h"
 
@@ -212,3 +224,154 @@ __gst_audio_encoded_audio_convert (GstAudioInfo * fmt,
 exit:
   return res;
 }
+
+/*
+ * Parses a list of CPUs like "0,2-3" into @cpus, where the entries of the
+ * listed CPUs are set to %TRUE. Returns %FALSE if the list is malformed,
+ * empty or names a CPU >= @n_cpus.
+ */
+gboolean
+_gst_audio_parse_cpu_list (const gchar * list, gboolean * cpus, guint n_cpus)
+{
+  gchar **ranges;
+  gboolean res = TRUE, any = FALSE;
+  guint i;
+
+  g_return_val_if_fail (list != NULL, FALSE);
+  g_return_val_if_fail (cpus != NULL, FALSE);
+
+  for (i = 0; i < n_cpus; i++)
+    cpus[i] = FALSE;
+
+  ranges = g_strsplit (list, ",", -1);
+  for (i = 0; ranges[i]; i++) {
+    gchar *end;
+    guint64 first, last, cpu;
+
+    first = g_ascii_strtoull (ranges[i], &end, 10);
+    if (end == ranges[i]) {
+      res = FALSE;
+      break;
+    }
+    last = first;
+    if (*end == '-') {
+      const gchar *start = end + 1;
+
+      last = g_ascii_strtoull (start, &end, 10);
+      if (end == start) {
+        res = FALSE;
+        break;
+      }
+    }
+    if (*end != '\0' || last < first || last >= n_cpus) {
+      res = FALSE;
+      break;
+    }
+    for (cpu = first; cpu <= last; cpu++)
+      cpus[cpu] = TRUE;
+    any = TRUE;
+  }
+  g_strfreev (ranges);
+
+  return res && any;
+}
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+static gboolean
+parse_cpu_set (const gchar * list, cpu_set_t * set)
+{
+  gboolean *cpus;
+  gboolean res;
+  guint i;
+
+  cpus = g_new (gboolean, CPU_SETSIZE);
+  res = _gst_audio_parse_cpu_list (list, cpus, CPU_SETSIZE);
+
+  CPU_ZERO (set);
+  for (i = 0; res && i < CPU_SETSIZE; i++) {
+    if (cpus[i])
+      CPU_SET (i, set);
+  }
+  g_free (cpus);
+
+  return res;
+}
+#endif
+
+/*
+ * Applies the requested realtime policy and CPU affinity to the calling
+ * thread. Failures (e.g. missing permissions) are not fatal, the thread
+ * simply keeps running with what it has. The scheduling that was actually
+ * achieved is posted as a "GstAudioThreadScheduling" element message.
+ */
+void
+__gst_audio_set_thread_scheduling (GstElement * element,
+    GstAudioRingBufferThreadPolicy policy, gint priority,
+    const gchar * affinity)
+{
+  GstAudioRingBufferThreadPolicy achieved_policy =
+      GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT;
+  gint achieved_priority = 0;
+  const gchar *achieved_affinity = NULL;
+  GstStructure *s;
+
+  if (affinity && *affinity == '\0')
+    affinity = NULL;
+
+  if (policy == GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT && !affinity)
+    return;
+
+  if (policy != GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT) {
+#if defined (HAVE_PTHREAD_SETSCHEDPARAM) && defined (HAVE_SCHED_H)
+    struct sched_param param = { 0, };
+    int sched_policy, res;
+
+    sched_policy = policy == GST_AUDIO_RING_BUFFER_THREAD_POLICY_FIFO ?
+        SCHED_FIFO : SCHED_RR;
+    param.sched_priority = CLAMP (priority,
+        sched_get_priority_min (sched_policy),
+        sched_get_priority_max (sched_policy));
+
+    res = pthread_setschedparam (pthread_self (), sched_policy, &param);
+    if (res == 0) {
+      GST_INFO_OBJECT (element, "thread runs with %s priority %d",
+          sched_policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR",
+          param.sched_priority);
+      achieved_policy = policy;
+      achieved_priority = param.sched_priority;
+    } else {
+      GST_WARNING_OBJECT (element, "could not set realtime scheduling: %s",
+          g_strerror (res));
+    }
+#else
+    GST_WARNING_OBJECT (element, "realtime scheduling not supported");
+#endif
+  }
+
+  if (affinity) {
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    cpu_set_t set;
+    int res;
+
+    if (!parse_cpu_set (affinity, &set)) {
+      GST_WARNING_OBJECT (element, "invalid CPU list '%s'", affinity);
+    } else if ((res = pthread_setaffinity_np (pthread_self (), sizeof (set),
+                &set)) != 0) {
+      GST_WARNING_OBJECT (element, "could not set CPU affinity: %s",
+          g_strerror (res));
+    } else {
+      GST_INFO_OBJECT (element, "thread pinned to CPUs %s", affinity);
+      achieved_affinity = affinity;
+    }
+#else
+    GST_WARNING_OBJECT (element, "CPU affinity not supported");
+#endif
+  }
+
+  s = gst_structure_new ("GstAudioThreadScheduling",
+      "policy", GST_TYPE_AUDIO_RING_BUFFER_THREAD_POLICY, achieved_policy,
+      "priority", G_TYPE_INT, achieved_priority,
+      "affinity", G_TYPE_STRING, achieved_affinity, NULL);
+  gst_element_post_message (element,
+      gst_message_new_element (GST_OBJECT_CAST (element), s));
+}
@@ -42,6 +42,16 @@ gboolean __gst_audio_encoded_audio_convert (GstAudioInfo * fmt, gint64 bytes,
                                             gint64 src_value, GstFormat * dest_format,
                                             gint64 * dest_value);
 
+/* Device thread scheduling */
+G_GNUC_INTERNAL
+void __gst_audio_set_thread_scheduling (GstElement * element,
+                                        GstAudioRingBufferThreadPolicy policy,
+                                        gint priority, const gchar * affinity);
+
+/* only for the unit tests */
+gboolean _gst_audio_parse_cpu_list (const gchar * list, gboolean * cpus,
+                                    guint n_cpus);
+
 G_END_DECLS
 
 #endif
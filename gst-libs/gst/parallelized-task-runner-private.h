@@ -0,0 +1,212 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ * Copyright (C) 2010 Sebastian Dröge <sebastian.droege@collabora.co.uk>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PARALLELIZED_TASK_RUNNER_PRIVATE_H__
+#define __PARALLELIZED_TASK_RUNNER_PRIVATE_H__
+
+/* The task runner used by the video converter and the audio resampler. The
+ * functions are static so that every library gets its own private copy, so
+ * this must only be included from the one file that uses it, after the
+ * GST_CAT_DEFAULT of that file is defined. */
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+typedef struct _GstParallelizedTaskThread GstParallelizedTaskThread;
+
+struct _GstParallelizedTaskThread
+{
+  GstParallelizedTaskRunner *runner;
+  guint idx;
+  GThread *thread;
+};
+
+/* A small pool of persistent worker threads. The thread calling
+ * gst_parallelized_task_runner_run() always executes the last task itself so
+ * that a runner with 1 thread never spawns anything. */
+struct _GstParallelizedTaskRunner
+{
+  guint n_threads;
+
+  GstParallelizedTaskThread *threads;
+
+  GstParallelizedTaskFunc func;
+  gpointer *task_data;
+
+  GMutex lock;
+  GCond cond_todo, cond_done;
+  gint n_todo, n_done;
+  gboolean quit;
+};
+
+static gpointer
+gst_parallelized_task_thread_func (gpointer data)
+{
+  GstParallelizedTaskThread *self = data;
+  GstParallelizedTaskRunner *runner = self->runner;
+
+  g_mutex_lock (&runner->lock);
+  do {
+    gint idx;
+
+    while (runner->n_todo == -1 && !runner->quit)
+      g_cond_wait (&runner->cond_todo, &runner->lock);
+
+    if (runner->quit)
+      break;
+
+    idx = runner->n_todo--;
+    g_assert (runner->n_todo >= -1);
+    g_mutex_unlock (&runner->lock);
+
+    g_assert (runner->func != NULL);
+
+    runner->func (runner->task_data[idx]);
+
+    g_mutex_lock (&runner->lock);
+    runner->n_done++;
+    if (runner->n_done == runner->n_threads - 1)
+      g_cond_signal (&runner->cond_done);
+  } while (TRUE);
+  g_mutex_unlock (&runner->lock);
+
+  return NULL;
+}
+
+static void
+gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
+{
+  guint i;
+
+  g_mutex_lock (&self->lock);
+  self->quit = TRUE;
+  g_cond_broadcast (&self->cond_todo);
+  g_mutex_unlock (&self->lock);
+
+  for (i = 1; i < self->n_threads; i++) {
+    if (!self->threads[i].thread)
+      continue;
+
+    g_thread_join (self->threads[i].thread);
+  }
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond_todo);
+  g_cond_clear (&self->cond_done);
+  g_free (self->threads);
+  g_free (self);
+}
+
+static GstParallelizedTaskRunner *
+gst_parallelized_task_runner_new (const gchar * name, guint n_threads)
+{
+  GstParallelizedTaskRunner *self;
+  guint i;
+  GError *err = NULL;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstParallelizedTaskRunner, 1);
+  self->n_threads = n_threads;
+  self->threads = g_new0 (GstParallelizedTaskThread, n_threads);
+
+  self->quit = FALSE;
+  self->n_todo = -1;
+  self->n_done = 0;
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond_todo);
+  g_cond_init (&self->cond_done);
+
+  /* set when scheduling a job */
+  self->func = NULL;
+  self->task_data = NULL;
+
+  for (i = 0; i < n_threads; i++) {
+    self->threads[i].runner = self;
+    self->threads[i].idx = i;
+
+    /* first thread is the one calling run() */
+    if (i > 0) {
+      self->threads[i].thread =
+          g_thread_try_new (name, gst_parallelized_task_thread_func,
+          &self->threads[i], &err);
+      if (!self->threads[i].thread)
+        goto thread_failed;
+    }
+  }
+
+  return self;
+
+  /* ERRORS */
+thread_failed:
+  {
+    GST_WARNING ("failed to start thread %u: %s, using %u threads", i,
+        err->message, i);
+    g_clear_error (&err);
+
+    /* the already started threads are still waiting for work, we only
+     * have to forget about the ones we could not start */
+    g_mutex_lock (&self->lock);
+    self->n_threads = i;
+    g_mutex_unlock (&self->lock);
+
+    return self;
+  }
+}
+
+static void
+gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+    GstParallelizedTaskFunc func, gpointer * task_data)
+{
+  guint n_threads = self->n_threads;
+
+  self->func = func;
+  self->task_data = task_data;
+
+  if (n_threads > 1) {
+    g_mutex_lock (&self->lock);
+    self->n_todo = self->n_threads - 2;
+    self->n_done = 0;
+    g_cond_broadcast (&self->cond_todo);
+    g_mutex_unlock (&self->lock);
+  }
+
+  self->func (self->task_data[self->n_threads - 1]);
+
+  if (n_threads > 1) {
+    g_mutex_lock (&self->lock);
+    while (self->n_done < self->n_threads - 1)
+      g_cond_wait (&self->cond_done, &self->lock);
+    self->n_done = 0;
+    g_mutex_unlock (&self->lock);
+  }
+
+  self->func = NULL;
+  self->task_data = NULL;
+}
+
+G_END_DECLS
+
+#endif /* __PARALLELIZED_TASK_RUNNER_PRIVATE_H__ */
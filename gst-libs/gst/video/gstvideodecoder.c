@@ -321,6 +321,34 @@ GST_DEBUG_CATEGORY (videodecoder_debug);
     (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GST_TYPE_VIDEO_DECODER, \
         GstVideoDecoderPrivate))
 
+typedef struct _Timestamp Timestamp;
+struct _Timestamp
+{
+  guint64 offset;
+  GstClockTime pts;
+  GstClockTime dts;
+  GstClockTime duration;
+  guint flags;
+  /* to queue without allocating */
+  GList link;
+};
+
+typedef enum
+{
+  THREADED_FRAME_PENDING,
+  THREADED_FRAME_FINISH,
+  THREADED_FRAME_DROP,
+  THREADED_FRAME_RELEASE
+} ThreadedFrameAction;
+
+/* a frame handed to the thread pool, output in decoding order */
+typedef struct
+{
+  guint32 system_frame_number;
+  GstVideoCodecFrame *frame;
+  ThreadedFrameAction action;
+} ThreadedFrame;
+
 struct _GstVideoDecoderPrivate
 {
   /* FIXME introduce a context ? */
@@ -365,7 +393,12 @@ struct _GstVideoDecoderPrivate
   /* relative offset of frame */
   guint64 frame_offset;
   /* tracking ts and offsets */
-  GList *timestamps;
+  GQueue timestamps;
+  /* unused Timestamp records */
+  GQueue free_timestamps;
+  /* with OBJECT_LOCK, so the stats can be read while decoding */
+  guint64 timestamps_allocated;
+  guint64 timestamps_reused;
 
   /* last outgoing ts */
   GstClockTime last_timestamp_out;
@@ -398,7 +431,10 @@ struct _GstVideoDecoderPrivate
   guint32 system_frame_number;
   guint32 decode_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GstVideoCodecFramePool *frame_pool;
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  /* system_frame_number -> link in frames */
+  GHashTable *frames_index;
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;     /* OBJECT_LOCK and STREAM_LOCK */
   gboolean output_state_changed;
@@ -430,6 +466,24 @@ struct _GstVideoDecoderPrivate
 
   /* flags */
   gboolean use_default_pad_acceptcaps;
+
+  /* frame threading */
+  gint max_threads;             /* STREAM_LOCK */
+  GThreadPool *thread_pool;
+  /* set while handle_frame may be run in the thread pool */
+  gboolean dispatch_threads;    /* STREAM_LOCK */
+  /* frames handed to the thread pool, in decoding order */
+  GQueue thread_frames;         /* STREAM_LOCK */
+  GMutex threads_lock;
+  GCond threads_cond;
+  guint threads_in_flight;      /* threads_lock */
+  GstFlowReturn threads_ret;    /* threads_lock */
+};
+
+enum
+{
+  PROP_0,
+  PROP_POOL_STATS
 };
 
 static GstElementClass *parent_class = NULL;
@@ -438,6 +492,8 @@ static void gst_video_decoder_init (GstVideoDecoder * dec,
     GstVideoDecoderClass * klass);
 
 static void gst_video_decoder_finalize (GObject * object);
+static void gst_video_decoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_video_decoder_setcaps (GstVideoDecoder * dec,
     GstCaps * caps);
@@ -490,6 +546,11 @@ static gboolean gst_video_decoder_sink_query_default (GstVideoDecoder * decoder,
 static gboolean gst_video_decoder_src_query_default (GstVideoDecoder * decoder,
     GstQuery * query);
 
+static GstFlowReturn gst_video_decoder_order_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, ThreadedFrameAction action);
+static GstFlowReturn gst_video_decoder_wait_threads (GstVideoDecoder * decoder,
+    guint max_in_flight);
+
 static gboolean gst_video_decoder_transform_meta_default (GstVideoDecoder *
     decoder, GstVideoCodecFrame * frame, GstMeta * meta);
 
@@ -537,6 +598,23 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
   g_type_class_add_private (klass, sizeof (GstVideoDecoderPrivate));
 
   gobject_class->finalize = gst_video_decoder_finalize;
+  gobject_class->get_property = gst_video_decoder_get_property;
+
+  /**
+   * GstVideoDecoder:pool-stats:
+   *
+   * Counters of the frames and timestamp records the element allocated and
+   * reused from its free lists, as a #GstStructure with the
+   * "frames-allocated", "frames-reused", "timestamps-allocated" and
+   * "timestamps-reused" #guint64 fields. Once the stream runs, only the
+   * reused counters should grow.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_POOL_STATS,
+      g_param_spec_boxed ("pool-stats", "Pool statistics",
+          "Frame allocation counters, for debugging", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_video_decoder_change_state);
@@ -599,6 +677,18 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
   decoder->priv->min_latency = 0;
   decoder->priv->max_latency = 0;
 
+  decoder->priv->frame_pool = __gst_video_codec_frame_pool_new ();
+  g_queue_init (&decoder->priv->timestamps);
+  g_queue_init (&decoder->priv->free_timestamps);
+  g_queue_init (&decoder->priv->frames);
+  decoder->priv->frames_index = g_hash_table_new (NULL, NULL);
+
+  decoder->priv->max_threads = 1;
+  g_queue_init (&decoder->priv->thread_frames);
+  g_mutex_init (&decoder->priv->threads_lock);
+  g_cond_init (&decoder->priv->threads_cond);
+  decoder->priv->threads_ret = GST_FLOW_OK;
+
   gst_video_decoder_reset (decoder, TRUE, TRUE);
 }
 
@@ -751,15 +841,66 @@ refused_format:
   }
 }
 
+static GstStructure *
+gst_video_decoder_get_pool_stats (GstVideoDecoder * decoder)
+{
+  GstStructure *s;
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  guint64 frames_allocated, frames_reused;
+
+  __gst_video_codec_frame_pool_get_stats (priv->frame_pool,
+      &frames_allocated, &frames_reused);
+
+  /* not the STREAM_LOCK, this must not wait for the decoding */
+  GST_OBJECT_LOCK (decoder);
+  s = gst_structure_new ("GstVideoDecoderPoolStats",
+      "frames-allocated", G_TYPE_UINT64, frames_allocated,
+      "frames-reused", G_TYPE_UINT64, frames_reused,
+      "timestamps-allocated", G_TYPE_UINT64, priv->timestamps_allocated,
+      "timestamps-reused", G_TYPE_UINT64, priv->timestamps_reused, NULL);
+  GST_OBJECT_UNLOCK (decoder);
+
+  return s;
+}
+
+static void
+gst_video_decoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoDecoder *decoder = GST_VIDEO_DECODER (object);
+
+  switch (prop_id) {
+    case PROP_POOL_STATS:
+      g_value_take_boxed (value, gst_video_decoder_get_pool_stats (decoder));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_video_decoder_finalize (GObject * object)
 {
   GstVideoDecoder *decoder;
+  GList *link;
 
   decoder = GST_VIDEO_DECODER (object);
 
   GST_DEBUG_OBJECT (object, "finalize");
 
+  if (decoder->priv->thread_pool) {
+    g_thread_pool_free (decoder->priv->thread_pool, FALSE, TRUE);
+    decoder->priv->thread_pool = NULL;
+  }
+  g_mutex_clear (&decoder->priv->threads_lock);
+  g_cond_clear (&decoder->priv->threads_cond);
+
+  g_hash_table_unref (decoder->priv->frames_index);
+  while ((link = g_queue_pop_head_link (&decoder->priv->free_timestamps)))
+    g_slice_free (Timestamp, link->data);
+  __gst_video_codec_frame_pool_unref (decoder->priv->frame_pool);
+
   g_rec_mutex_clear (&decoder->stream_lock);
 
   if (decoder->priv->input_adapter) {
@@ -1312,7 +1453,7 @@ gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
       GList *l;
 
       GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-      for (l = priv->frames; l; l = l->next) {
+      for (l = priv->frames.head; l; l = l->next) {
         GstVideoCodecFrame *frame = l->data;
 
         frame->events = _flush_events (decoder->srcpad, frame->events);
@@ -1398,6 +1539,11 @@ gst_video_decoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (decoder, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* let the frames that are still decoding in the thread pool go out
+   * before anything that is serialized with them */
+  if (GST_EVENT_IS_SERIALIZED (event))
+    gst_video_decoder_wait_threads (decoder, 0);
+
   if (decoder_class->sink_event)
     ret = decoder_class->sink_event (decoder, event);
 
@@ -1895,20 +2041,36 @@ gst_video_decoder_sink_query (GstPad * pad, GstObject * parent,
   return ret;
 }
 
-typedef struct _Timestamp Timestamp;
-struct _Timestamp
+/* with STREAM_LOCK */
+static Timestamp *
+gst_video_decoder_new_timestamp (GstVideoDecoder * decoder)
 {
-  guint64 offset;
-  GstClockTime pts;
-  GstClockTime dts;
-  GstClockTime duration;
-  guint flags;
-};
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *link;
+  Timestamp *ts;
+
+  link = g_queue_pop_head_link (&priv->free_timestamps);
+  if (link) {
+    ts = link->data;
+    GST_OBJECT_LOCK (decoder);
+    priv->timestamps_reused++;
+    GST_OBJECT_UNLOCK (decoder);
+  } else {
+    ts = g_slice_new (Timestamp);
+    ts->link.data = ts;
+    ts->link.prev = ts->link.next = NULL;
+    GST_OBJECT_LOCK (decoder);
+    priv->timestamps_allocated++;
+    GST_OBJECT_UNLOCK (decoder);
+  }
+  return ts;
+}
 
+/* with STREAM_LOCK, @ts must not be queued */
 static void
-timestamp_free (Timestamp * ts)
+gst_video_decoder_recycle_timestamp (GstVideoDecoder * decoder, Timestamp * ts)
 {
-  g_slice_free (Timestamp, ts);
+  g_queue_push_head_link (&decoder->priv->free_timestamps, &ts->link);
 }
 
 static void
@@ -1917,7 +2079,7 @@ gst_video_decoder_add_timestamp (GstVideoDecoder * decoder, GstBuffer * buffer)
   GstVideoDecoderPrivate *priv = decoder->priv;
   Timestamp *ts;
 
-  ts = g_slice_new (Timestamp);
+  ts = gst_video_decoder_new_timestamp (decoder);
 
   GST_LOG_OBJECT (decoder,
       "adding PTS %" GST_TIME_FORMAT " DTS %" GST_TIME_FORMAT
@@ -1931,7 +2093,7 @@ gst_video_decoder_add_timestamp (GstVideoDecoder * decoder, GstBuffer * buffer)
   ts->duration = GST_BUFFER_DURATION (buffer);
   ts->flags = GST_BUFFER_FLAGS (buffer);
 
-  priv->timestamps = g_list_append (priv->timestamps, ts);
+  g_queue_push_tail_link (&priv->timestamps, &ts->link);
 }
 
 static void
@@ -1943,30 +2105,24 @@ gst_video_decoder_get_timestamp_at_offset (GstVideoDecoder *
   guint64 got_offset = 0;
 #endif
   Timestamp *ts;
-  GList *g;
 
   *pts = GST_CLOCK_TIME_NONE;
   *dts = GST_CLOCK_TIME_NONE;
   *duration = GST_CLOCK_TIME_NONE;
   *flags = 0;
 
-  g = decoder->priv->timestamps;
-  while (g) {
-    ts = g->data;
-    if (ts->offset <= offset) {
+  /* timestamps are queued in offset order, the ones we pass are consumed */
+  while ((ts = g_queue_peek_head (&decoder->priv->timestamps))
+      && ts->offset <= offset) {
 #ifndef GST_DISABLE_GST_DEBUG
-      got_offset = ts->offset;
+    got_offset = ts->offset;
 #endif
-      *pts = ts->pts;
-      *dts = ts->dts;
-      *duration = ts->duration;
-      *flags = ts->flags;
-      g = g->next;
-      decoder->priv->timestamps = g_list_remove (decoder->priv->timestamps, ts);
-      timestamp_free (ts);
-    } else {
-      break;
-    }
+    *pts = ts->pts;
+    *dts = ts->dts;
+    *duration = ts->duration;
+    *flags = ts->flags;
+    g_queue_pop_head_link (&decoder->priv->timestamps);
+    gst_video_decoder_recycle_timestamp (decoder, ts);
   }
 
   GST_LOG_OBJECT (decoder,
@@ -1979,6 +2135,7 @@ static void
 gst_video_decoder_clear_queues (GstVideoDecoder * dec)
 {
   GstVideoDecoderPrivate *priv = dec->priv;
+  ThreadedFrame *tf;
 
   g_list_free_full (priv->output_queued,
       (GDestroyNotify) gst_mini_object_unref);
@@ -1993,8 +2150,15 @@ gst_video_decoder_clear_queues (GstVideoDecoder * dec)
   g_list_free_full (priv->parse_gather,
       (GDestroyNotify) gst_video_codec_frame_unref);
   priv->parse_gather = NULL;
-  g_list_free_full (priv->frames, (GDestroyNotify) gst_video_codec_frame_unref);
-  priv->frames = NULL;
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
+  g_hash_table_remove_all (priv->frames_index);
+
+  while ((tf = g_queue_pop_head (&priv->thread_frames))) {
+    if (tf->frame)
+      gst_video_codec_frame_unref (tf->frame);
+    g_slice_free (ThreadedFrame, tf);
+  }
 }
 
 static void
@@ -2002,6 +2166,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     gboolean flush_hard)
 {
   GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *link;
 
   GST_DEBUG_OBJECT (decoder, "reset full %d", full);
 
@@ -2029,6 +2194,10 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     priv->had_output_data = FALSE;
     priv->had_input_data = FALSE;
 
+    g_mutex_lock (&priv->threads_lock);
+    priv->threads_ret = GST_FLOW_OK;
+    g_mutex_unlock (&priv->threads_lock);
+
     GST_OBJECT_LOCK (decoder);
     priv->earliest_time = GST_CLOCK_TIME_NONE;
     priv->proportion = 0.5;
@@ -2088,8 +2257,8 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   priv->frame_offset = 0;
   gst_adapter_clear (priv->input_adapter);
   gst_adapter_clear (priv->output_adapter);
-  g_list_free_full (priv->timestamps, (GDestroyNotify) timestamp_free);
-  priv->timestamps = NULL;
+  while ((link = g_queue_pop_head_link (&priv->timestamps)))
+    gst_video_decoder_recycle_timestamp (decoder, link->data);
 
   GST_OBJECT_LOCK (decoder);
   priv->bytes_out = 0;
@@ -2413,12 +2582,16 @@ gst_video_decoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
   GstVideoDecoder *decoder;
   GstFlowReturn ret = GST_FLOW_OK;
+  gint max_threads;
 
   decoder = GST_VIDEO_DECODER (parent);
 
   if (G_UNLIKELY (!decoder->priv->input_state && decoder->priv->needs_format))
     goto not_negotiated;
 
+  if (GST_BUFFER_IS_DISCONT (buf))
+    gst_video_decoder_wait_threads (decoder, 0);
+
   GST_LOG_OBJECT (decoder,
       "chain PTS %" GST_TIME_FORMAT ", DTS %" GST_TIME_FORMAT " duration %"
       GST_TIME_FORMAT " size %" G_GSIZE_FORMAT,
@@ -2450,12 +2623,22 @@ gst_video_decoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
   decoder->priv->had_input_data = TRUE;
 
-  if (decoder->input_segment.rate > 0.0)
+  max_threads = decoder->priv->max_threads;
+  if (decoder->input_segment.rate > 0.0) {
+    decoder->priv->dispatch_threads = (max_threads > 1);
     ret = gst_video_decoder_chain_forward (decoder, buf, FALSE);
-  else
+    decoder->priv->dispatch_threads = FALSE;
+  } else {
     ret = gst_video_decoder_chain_reverse (decoder, buf);
+  }
 
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  /* wait for a free thread without the stream lock, the frames in flight
+   * need it to get finished */
+  if (max_threads > 1 && ret == GST_FLOW_OK)
+    ret = gst_video_decoder_wait_threads (decoder, max_threads - 1);
+
   return ret;
 
   /* ERRORS */
@@ -2503,6 +2686,8 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      gst_video_decoder_wait_threads (decoder, 0);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -2562,9 +2747,7 @@ gst_video_decoder_new_frame (GstVideoDecoder * decoder)
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = __gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -2609,7 +2792,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
 
 #ifndef GST_DISABLE_GST_DEBUG
   GST_LOG_OBJECT (decoder, "n %d in %" G_GSIZE_FORMAT " out %" G_GSIZE_FORMAT,
-      g_list_length (priv->frames),
+      priv->frames.length,
       gst_adapter_available (priv->input_adapter),
       gst_adapter_available (priv->output_adapter));
 #endif
@@ -2623,7 +2806,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
       sync, GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->dts));
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2683,7 +2866,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2717,7 +2900,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     /* some more maintenance, ts2 holds PTS */
     min_ts = GST_CLOCK_TIME_NONE;
     seen_none = FALSE;
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts2)) {
@@ -2794,29 +2977,21 @@ no_output_buffer:
   }
 }
 
-/**
- * gst_video_decoder_release_frame:
- * @dec: a #GstVideoDecoder
- * @frame: (transfer full): the #GstVideoCodecFrame to release
- *
- * Similar to gst_video_decoder_drop_frame(), but simply releases @frame
- * without any processing other than removing it from list of pending frames,
- * after which it is considered finished and released.
- *
- * Since: 1.2.2
- */
-void
-gst_video_decoder_release_frame (GstVideoDecoder * dec,
+static void
+gst_video_decoder_do_release_frame (GstVideoDecoder * dec,
     GstVideoCodecFrame * frame)
 {
   GList *link;
 
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
-  link = g_list_find (dec->priv->frames, frame);
-  if (link) {
+  link = g_hash_table_lookup (dec->priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  if (link && link->data == frame) {
     gst_video_codec_frame_unref (frame);
-    dec->priv->frames = g_list_delete_link (dec->priv->frames, link);
+    g_hash_table_remove (dec->priv->frames_index,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    g_queue_delete_link (&dec->priv->frames, link);
   }
   if (frame->events) {
     dec->priv->pending_events =
@@ -2830,18 +3005,31 @@ gst_video_decoder_release_frame (GstVideoDecoder * dec,
 }
 
 /**
- * gst_video_decoder_drop_frame:
+ * gst_video_decoder_release_frame:
  * @dec: a #GstVideoDecoder
- * @frame: (transfer full): the #GstVideoCodecFrame to drop
+ * @frame: (transfer full): the #GstVideoCodecFrame to release
  *
- * Similar to gst_video_decoder_finish_frame(), but drops @frame in any
- * case and posts a QoS message with the frame's details on the bus.
- * In any case, the frame is considered finished and released.
+ * Similar to gst_video_decoder_drop_frame(), but simply releases @frame
+ * without any processing other than removing it from list of pending frames,
+ * after which it is considered finished and released.
  *
- * Returns: a #GstFlowReturn, usually GST_FLOW_OK.
+ * Since: 1.2.2
  */
-GstFlowReturn
-gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
+void
+gst_video_decoder_release_frame (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  if (G_UNLIKELY (dec->priv->thread_frames.length > 0))
+    gst_video_decoder_order_frame (dec, frame, THREADED_FRAME_RELEASE);
+  else
+    gst_video_decoder_do_release_frame (dec, frame);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+}
+
+static GstFlowReturn
+gst_video_decoder_do_drop_frame (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
 {
   GstClockTime stream_time, jitter, earliest_time, qostime, timestamp;
   GstSegment *segment;
@@ -2882,13 +3070,39 @@ gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
   gst_element_post_message (GST_ELEMENT_CAST (dec), qos_msg);
 
   /* now free the frame */
-  gst_video_decoder_release_frame (dec, frame);
+  gst_video_decoder_do_release_frame (dec, frame);
 
   GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
 
   return GST_FLOW_OK;
 }
 
+/**
+ * gst_video_decoder_drop_frame:
+ * @dec: a #GstVideoDecoder
+ * @frame: (transfer full): the #GstVideoCodecFrame to drop
+ *
+ * Similar to gst_video_decoder_finish_frame(), but drops @frame in any
+ * case and posts a QoS message with the frame's details on the bus.
+ * In any case, the frame is considered finished and released.
+ *
+ * Returns: a #GstFlowReturn, usually GST_FLOW_OK.
+ */
+GstFlowReturn
+gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
+{
+  GstFlowReturn ret;
+
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  if (G_UNLIKELY (dec->priv->thread_frames.length > 0))
+    ret = gst_video_decoder_order_frame (dec, frame, THREADED_FRAME_DROP);
+  else
+    ret = gst_video_decoder_do_drop_frame (dec, frame);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+
+  return ret;
+}
+
 static gboolean
 gst_video_decoder_transform_meta_default (GstVideoDecoder *
     decoder, GstVideoCodecFrame * frame, GstMeta * meta)
@@ -2945,24 +3159,8 @@ foreach_metadata (GstBuffer * inbuf, GstMeta ** meta, gpointer user_data)
   return TRUE;
 }
 
-/**
- * gst_video_decoder_finish_frame:
- * @decoder: a #GstVideoDecoder
- * @frame: (transfer full): a decoded #GstVideoCodecFrame
- *
- * @frame should have a valid decoded data buffer, whose metadata fields
- * are then appropriately set according to frame data and pushed downstream.
- * If no output data is provided, @frame is considered skipped.
- * In any case, the frame is considered finished and released.
- *
- * After calling this function the output buffer of the frame is to be
- * considered read-only. This function will also change the metadata
- * of the buffer.
- *
- * Returns: a #GstFlowReturn resulting from sending data downstream
- */
-GstFlowReturn
-gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
+static GstFlowReturn
+gst_video_decoder_do_finish_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame)
 {
   GstFlowReturn ret = GST_FLOW_OK;
@@ -3048,7 +3246,7 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
    * if possible, i.e. if the subclass does not hold additional references
    * to the frame
    */
-  gst_video_decoder_release_frame (decoder, frame);
+  gst_video_decoder_do_release_frame (decoder, frame);
   frame = NULL;
 
   if (decoder->output_segment.rate < 0.0) {
@@ -3060,8 +3258,167 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
 
 done:
   if (frame)
-    gst_video_decoder_release_frame (decoder, frame);
+    gst_video_decoder_do_release_frame (decoder, frame);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+  return ret;
+}
+
+/**
+ * gst_video_decoder_finish_frame:
+ * @decoder: a #GstVideoDecoder
+ * @frame: (transfer full): a decoded #GstVideoCodecFrame
+ *
+ * @frame should have a valid decoded data buffer, whose metadata fields
+ * are then appropriately set according to frame data and pushed downstream.
+ * If no output data is provided, @frame is considered skipped.
+ * In any case, the frame is considered finished and released.
+ *
+ * After calling this function the output buffer of the frame is to be
+ * considered read-only. This function will also change the metadata
+ * of the buffer.
+ *
+ * Returns: a #GstFlowReturn resulting from sending data downstream
+ */
+GstFlowReturn
+gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstFlowReturn ret;
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  if (G_UNLIKELY (decoder->priv->thread_frames.length > 0))
+    ret =
+        gst_video_decoder_order_frame (decoder, frame, THREADED_FRAME_FINISH);
+  else
+    ret = gst_video_decoder_do_finish_frame (decoder, frame);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_video_decoder_do_frame_action (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, ThreadedFrameAction action)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  switch (action) {
+    case THREADED_FRAME_FINISH:
+      ret = gst_video_decoder_do_finish_frame (decoder, frame);
+      break;
+    case THREADED_FRAME_DROP:
+      ret = gst_video_decoder_do_drop_frame (decoder, frame);
+      break;
+    case THREADED_FRAME_RELEASE:
+      gst_video_decoder_do_release_frame (decoder, frame);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+  return ret;
+}
+
+/* With stream lock. Output the frames at the head of the queue that the
+ * subclass is done with */
+static GstFlowReturn
+gst_video_decoder_push_threaded_frames (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  ThreadedFrame *tf;
+  GstFlowReturn ret = GST_FLOW_OK, res;
+
+  while ((tf = g_queue_peek_head (&priv->thread_frames))
+      && tf->action != THREADED_FRAME_PENDING) {
+    g_queue_pop_head (&priv->thread_frames);
+
+    GST_LOG_OBJECT (decoder, "output threaded frame %u",
+        tf->system_frame_number);
+    res = gst_video_decoder_do_frame_action (decoder, tf->frame, tf->action);
+    if (ret == GST_FLOW_OK)
+      ret = res;
+    g_slice_free (ThreadedFrame, tf);
+  }
+  return ret;
+}
+
+/* With stream lock, takes the frame reference. Frames decoded in the thread
+ * pool are held back until all frames before them are done */
+static GstFlowReturn
+gst_video_decoder_order_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, ThreadedFrameAction action)
+{
+  GList *l;
+
+  for (l = decoder->priv->thread_frames.head; l; l = l->next) {
+    ThreadedFrame *tf = l->data;
+
+    if (tf->system_frame_number == frame->system_frame_number
+        && tf->action == THREADED_FRAME_PENDING) {
+      tf->frame = frame;
+      tf->action = action;
+      return gst_video_decoder_push_threaded_frames (decoder);
+    }
+  }
+  /* not from the thread pool */
+  return gst_video_decoder_do_frame_action (decoder, frame, action);
+}
+
+static void
+gst_video_decoder_thread_func (GstVideoCodecFrame * frame,
+    GstVideoDecoder * decoder)
+{
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  guint32 system_frame_number = frame->system_frame_number;
+  GstFlowReturn ret, res;
+  GList *l;
+
+  ret = decoder_class->handle_frame (decoder, frame);
+  if (ret != GST_FLOW_OK)
+    GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
+
+  /* a frame the subclass kept for later is not ordered anymore */
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  for (l = priv->thread_frames.head; l; l = l->next) {
+    ThreadedFrame *tf = l->data;
+
+    if (tf->system_frame_number == system_frame_number
+        && tf->action == THREADED_FRAME_PENDING) {
+      GST_WARNING_OBJECT (decoder, "frame %u not finished by handle_frame",
+          system_frame_number);
+      g_queue_delete_link (&priv->thread_frames, l);
+      g_slice_free (ThreadedFrame, tf);
+      res = gst_video_decoder_push_threaded_frames (decoder);
+      if (ret == GST_FLOW_OK)
+        ret = res;
+      break;
+    }
+  }
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  g_mutex_lock (&priv->threads_lock);
+  if (ret != GST_FLOW_OK && priv->threads_ret == GST_FLOW_OK)
+    priv->threads_ret = ret;
+  priv->threads_in_flight--;
+  g_cond_broadcast (&priv->threads_cond);
+  g_mutex_unlock (&priv->threads_lock);
+}
+
+/* Must be called without the stream lock, returns the first flow error of
+ * the threads */
+static GstFlowReturn
+gst_video_decoder_wait_threads (GstVideoDecoder * decoder, guint max_in_flight)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&priv->threads_lock);
+  while (priv->threads_in_flight > max_in_flight)
+    g_cond_wait (&priv->threads_cond, &priv->threads_lock);
+  ret = priv->threads_ret;
+  g_mutex_unlock (&priv->threads_lock);
+
   return ret;
 }
 
@@ -3385,17 +3742,38 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       frame->distance_from_sync);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
 
-  if (g_list_length (priv->frames) > 10) {
+  if (priv->frames.length > 10) {
     GST_DEBUG_OBJECT (decoder, "decoder frame list getting long: %d frames,"
-        "possible internal leaking?", g_list_length (priv->frames));
+        "possible internal leaking?", priv->frames.length);
   }
 
   frame->deadline =
       gst_segment_to_running_time (&decoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  if (priv->dispatch_threads && priv->thread_pool) {
+    ThreadedFrame *tf = g_slice_new0 (ThreadedFrame);
+
+    tf->system_frame_number = frame->system_frame_number;
+    tf->action = THREADED_FRAME_PENDING;
+    g_queue_push_tail (&priv->thread_frames, tf);
+
+    g_mutex_lock (&priv->threads_lock);
+    priv->threads_in_flight++;
+    ret = priv->threads_ret;
+    g_mutex_unlock (&priv->threads_lock);
+
+    GST_LOG_OBJECT (decoder, "decoding frame %u in a thread",
+        frame->system_frame_number);
+    g_thread_pool_push (priv->thread_pool, frame, NULL);
+
+    return ret;
+  }
+
   /* do something with frame */
   ret = decoder_class->handle_frame (decoder, frame);
   if (ret != GST_FLOW_OK)
@@ -3505,8 +3883,8 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  if (decoder->priv->frames)
-    frame = gst_video_codec_frame_ref (decoder->priv->frames->data);
+  if (decoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (decoder->priv->frames.head->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -3530,14 +3908,10 @@ gst_video_decoder_get_frame (GstVideoDecoder * decoder, int frame_number)
   GST_DEBUG_OBJECT (decoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  for (g = decoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  g = g_hash_table_lookup (decoder->priv->frames_index,
+      GUINT_TO_POINTER (frame_number));
+  if (g)
+    frame = gst_video_codec_frame_ref (g->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return frame;
@@ -3557,7 +3931,7 @@ gst_video_decoder_get_frames (GstVideoDecoder * decoder)
   GList *frames;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  frames = g_list_copy (decoder->priv->frames);
+  frames = g_list_copy (decoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
@@ -3787,7 +4161,7 @@ gst_video_decoder_negotiate_default (GstVideoDecoder * decoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = decoder->priv->frames ? decoder->priv->frames->data : NULL;
+  frame = g_queue_peek_head (&decoder->priv->frames);
   if (frame || decoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -4219,6 +4593,76 @@ gst_video_decoder_get_packetized (GstVideoDecoder * decoder)
   return decoder->priv->packetized;
 }
 
+/**
+ * gst_video_decoder_set_max_threads:
+ * @decoder: a #GstVideoDecoder
+ * @n_threads: maximum number of frames to decode at the same time, 0 to use
+ *     the number of processors
+ *
+ * Lets the base class call @handle_frame for up to @n_threads frames at the
+ * same time from a pool of threads. The default is 1, in which case
+ * @handle_frame is only called from the streaming thread.
+ *
+ * This is meant for codecs where every frame can be decoded on its own, like
+ * intra-only video codecs and image formats. @handle_frame is then called
+ * without the stream lock and has to be thread-safe. Frames are still output
+ * in decoding order, so each frame should be finished, dropped or released
+ * before @handle_frame returns.
+ *
+ * Frames are only decoded in threads in forward playback.
+ *
+ * Since: 1.12
+ */
+void
+gst_video_decoder_set_max_threads (GstVideoDecoder * decoder, gint n_threads)
+{
+  GstVideoDecoderPrivate *priv;
+
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+  g_return_if_fail (n_threads >= 0);
+
+  priv = decoder->priv;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_DEBUG_OBJECT (decoder, "max threads %d", n_threads);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  priv->max_threads = n_threads;
+  if (n_threads > 1) {
+    if (priv->thread_pool == NULL)
+      priv->thread_pool =
+          g_thread_pool_new ((GFunc) gst_video_decoder_thread_func, decoder,
+          n_threads, FALSE, NULL);
+    else
+      g_thread_pool_set_max_threads (priv->thread_pool, n_threads, NULL);
+  }
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+}
+
+/**
+ * gst_video_decoder_get_max_threads:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Returns: the maximum number of frames that are decoded at the same time
+ *
+ * Since: 1.12
+ */
+gint
+gst_video_decoder_get_max_threads (GstVideoDecoder * decoder)
+{
+  gint result;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), 1);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  result = decoder->priv->max_threads;
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  return result;
+}
+
 /**
  * gst_video_decoder_set_estimate_rate:
  * @dec: a #GstVideoDecoder
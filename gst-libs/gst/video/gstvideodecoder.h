@@ -357,6 +357,11 @@ void     gst_video_decoder_set_max_errors (GstVideoDecoder * dec,
 
 gint     gst_video_decoder_get_max_errors (GstVideoDecoder * dec);
 
+void     gst_video_decoder_set_max_threads (GstVideoDecoder * decoder,
+                                            gint              n_threads);
+
+gint     gst_video_decoder_get_max_threads (GstVideoDecoder * decoder);
+
 void     gst_video_decoder_set_needs_format (GstVideoDecoder * dec,
                                              gboolean enabled);
 
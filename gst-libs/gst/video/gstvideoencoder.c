@@ -151,7 +151,10 @@ struct _GstVideoEncoderPrivate
 
   guint32 system_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GstVideoCodecFramePool *frame_pool;
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  /* system_frame_number -> link in frames */
+  GHashTable *frames_index;
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;
   gboolean output_state_changed;
@@ -206,12 +209,20 @@ forced_key_unit_event_new (GstClockTime running_time, gboolean all_headers,
   return evt;
 }
 
+enum
+{
+  PROP_0,
+  PROP_POOL_STATS
+};
+
 static GstElementClass *parent_class = NULL;
 static void gst_video_encoder_class_init (GstVideoEncoderClass * klass);
 static void gst_video_encoder_init (GstVideoEncoder * enc,
     GstVideoEncoderClass * klass);
 
 static void gst_video_encoder_finalize (GObject * object);
+static void gst_video_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean gst_video_encoder_setcaps (GstVideoEncoder * enc,
     GstCaps * caps);
@@ -305,6 +316,22 @@ gst_video_encoder_class_init (GstVideoEncoderClass * klass)
   g_type_class_add_private (klass, sizeof (GstVideoEncoderPrivate));
 
   gobject_class->finalize = gst_video_encoder_finalize;
+  gobject_class->get_property = gst_video_encoder_get_property;
+
+  /**
+   * GstVideoEncoder:pool-stats:
+   *
+   * Counters of the frames the element allocated and reused from
+   * its free lists, as a #GstStructure with the "frames-allocated" and
+   * "frames-reused" #guint64 fields. Once the stream runs, only the
+   * reused counters should grow.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_POOL_STATS,
+      g_param_spec_boxed ("pool-stats", "Pool statistics",
+          "Frame allocation counters, for debugging", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_video_encoder_change_state);
@@ -400,7 +427,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   } else {
     GList *l;
 
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *frame = l->data;
 
       frame->events = _flush_events (encoder->srcpad, frame->events);
@@ -409,9 +436,9 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
         encoder->priv->current_frame_events);
   }
 
-  g_list_foreach (priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
-  g_list_free (priv->frames);
-  priv->frames = NULL;
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
+  g_hash_table_remove_all (priv->frames_index);
 
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -482,6 +509,10 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->min_pts = GST_CLOCK_TIME_NONE;
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
 
+  priv->frame_pool = __gst_video_codec_frame_pool_new ();
+  g_queue_init (&priv->frames);
+  priv->frames_index = g_hash_table_new (NULL, NULL);
+
   gst_video_encoder_reset (encoder, TRUE);
 }
 
@@ -846,6 +877,38 @@ gst_video_encoder_sink_query (GstPad * pad, GstObject * parent,
   return ret;
 }
 
+static GstStructure *
+gst_video_encoder_get_pool_stats (GstVideoEncoder * encoder)
+{
+  GstStructure *s;
+  guint64 frames_allocated, frames_reused;
+
+  __gst_video_codec_frame_pool_get_stats (encoder->priv->frame_pool,
+      &frames_allocated, &frames_reused);
+
+  s = gst_structure_new ("GstVideoEncoderPoolStats",
+      "frames-allocated", G_TYPE_UINT64, frames_allocated,
+      "frames-reused", G_TYPE_UINT64, frames_reused, NULL);
+
+  return s;
+}
+
+static void
+gst_video_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoEncoder *encoder = GST_VIDEO_ENCODER (object);
+
+  switch (prop_id) {
+    case PROP_POOL_STATS:
+      g_value_take_boxed (value, gst_video_encoder_get_pool_stats (encoder));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_video_encoder_finalize (GObject * object)
 {
@@ -856,6 +919,9 @@ gst_video_encoder_finalize (GObject * object)
   encoder = GST_VIDEO_ENCODER (object);
   g_rec_mutex_clear (&encoder->stream_lock);
 
+  g_hash_table_unref (encoder->priv->frames_index);
+  __gst_video_codec_frame_pool_unref (encoder->priv->frame_pool);
+
   if (encoder->priv->allocator) {
     gst_object_unref (encoder->priv->allocator);
     encoder->priv->allocator = NULL;
@@ -1312,9 +1378,7 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
   GstVideoEncoderPrivate *priv = encoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = __gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -1446,7 +1510,9 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_OBJECT_UNLOCK (encoder);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
 
   /* new data, more finish needed */
   priv->drained = FALSE;
@@ -1631,7 +1697,7 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = encoder->priv->frames ? encoder->priv->frames->data : NULL;
+  frame = g_queue_peek_head (&encoder->priv->frames);
   if (frame || encoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -1856,10 +1922,13 @@ gst_video_encoder_release_frame (GstVideoEncoder * enc,
   GList *link;
 
   /* unref once from the list */
-  link = g_list_find (enc->priv->frames, frame);
-  if (link) {
+  link = g_hash_table_lookup (enc->priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  if (link && link->data == frame) {
     gst_video_codec_frame_unref (frame);
-    enc->priv->frames = g_list_delete_link (enc->priv->frames, link);
+    g_hash_table_remove (enc->priv->frames_index,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    g_queue_delete_link (&enc->priv->frames, link);
   }
   /* unref because this function takes ownership */
   gst_video_codec_frame_unref (frame);
@@ -1979,7 +2048,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     goto no_output_state;
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2087,7 +2156,7 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2348,8 +2417,8 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  if (encoder->priv->frames)
-    frame = gst_video_codec_frame_ref (encoder->priv->frames->data);
+  if (encoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (encoder->priv->frames.head->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -2373,14 +2442,10 @@ gst_video_encoder_get_frame (GstVideoEncoder * encoder, int frame_number)
   GST_DEBUG_OBJECT (encoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  for (g = encoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  g = g_hash_table_lookup (encoder->priv->frames_index,
+      GUINT_TO_POINTER (frame_number));
+  if (g)
+    frame = gst_video_codec_frame_ref (g->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return frame;
@@ -2400,7 +2465,7 @@ gst_video_encoder_get_frames (GstVideoEncoder * encoder)
   GList *frames;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  frames = g_list_copy (encoder->priv->frames);
+  frames = g_list_copy (encoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -25,6 +25,7 @@
 
 #include <gst/video/video.h>
 #include "gstvideoutils.h"
+#include "gstvideoutilsprivate.h"
 
 #include <string.h>
 
@@ -53,7 +54,10 @@ _gst_video_codec_frame_free (GstVideoCodecFrame * frame)
   if (frame->user_data_destroy_notify)
     frame->user_data_destroy_notify (frame->user_data);
 
-  g_slice_free (GstVideoCodecFrame, frame);
+  if (frame->abidata.ABI.pool)
+    __gst_video_codec_frame_pool_release (frame->abidata.ABI.pool, frame);
+  else
+    g_slice_free (GstVideoCodecFrame, frame);
 }
 
 /**
@@ -26,6 +26,8 @@
 #include <gst/video/video.h>
 #include "gstvideoutilsprivate.h"
 
+#include <string.h>
+
 /*
  * Takes caps and copies its video fields to tmpl_caps
  */
@@ -255,3 +257,114 @@ __gst_video_encoded_video_convert (gint64 bytes, gint64 time,
 exit:
   return res;
 }
+
+/* Cache of freed frames shared by a codec element and its frames. Every
+ * frame taken from the pool holds a reference to it so that frames can
+ * outlive the element. */
+#define FRAME_POOL_MAX_FREE 64
+
+struct _GstVideoCodecFramePool
+{
+  gint ref_count;
+
+  GMutex lock;
+  /* linked through the user_data field */
+  GstVideoCodecFrame *free_frames;
+  guint n_free;
+
+  guint64 allocated;
+  guint64 reused;
+};
+
+GstVideoCodecFramePool *
+__gst_video_codec_frame_pool_new (void)
+{
+  GstVideoCodecFramePool *pool;
+
+  pool = g_slice_new0 (GstVideoCodecFramePool);
+  pool->ref_count = 1;
+  g_mutex_init (&pool->lock);
+
+  return pool;
+}
+
+GstVideoCodecFramePool *
+__gst_video_codec_frame_pool_ref (GstVideoCodecFramePool * pool)
+{
+  g_atomic_int_inc (&pool->ref_count);
+
+  return pool;
+}
+
+void
+__gst_video_codec_frame_pool_unref (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frame;
+
+  if (!g_atomic_int_dec_and_test (&pool->ref_count))
+    return;
+
+  while ((frame = pool->free_frames)) {
+    pool->free_frames = frame->user_data;
+    g_slice_free (GstVideoCodecFrame, frame);
+  }
+  g_mutex_clear (&pool->lock);
+  g_slice_free (GstVideoCodecFramePool, pool);
+}
+
+GstVideoCodecFrame *
+__gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frame;
+
+  g_mutex_lock (&pool->lock);
+  frame = pool->free_frames;
+  if (frame) {
+    pool->free_frames = frame->user_data;
+    pool->n_free--;
+    pool->reused++;
+  } else {
+    pool->allocated++;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (frame)
+    memset (frame, 0, sizeof (GstVideoCodecFrame));
+  else
+    frame = g_slice_new0 (GstVideoCodecFrame);
+
+  frame->ref_count = 1;
+  frame->abidata.ABI.pool = __gst_video_codec_frame_pool_ref (pool);
+
+  return frame;
+}
+
+/* takes a frame whose contents were already freed */
+void
+__gst_video_codec_frame_pool_release (GstVideoCodecFramePool * pool,
+    GstVideoCodecFrame * frame)
+{
+  g_mutex_lock (&pool->lock);
+  if (pool->n_free < FRAME_POOL_MAX_FREE) {
+    frame->user_data = pool->free_frames;
+    pool->free_frames = frame;
+    pool->n_free++;
+    frame = NULL;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (frame)
+    g_slice_free (GstVideoCodecFrame, frame);
+
+  __gst_video_codec_frame_pool_unref (pool);
+}
+
+void
+__gst_video_codec_frame_pool_get_stats (GstVideoCodecFramePool * pool,
+    guint64 * allocated, guint64 * reused)
+{
+  g_mutex_lock (&pool->lock);
+  *allocated = pool->allocated;
+  *reused = pool->reused;
+  g_mutex_unlock (&pool->lock);
+}
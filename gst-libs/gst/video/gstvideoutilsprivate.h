@@ -46,6 +46,29 @@ gboolean __gst_video_rawvideo_convert (GstVideoCodecState * state, GstFormat src
                                        gint64 src_value, GstFormat * dest_format,
                                        gint64 * dest_value);
 
+/* Frame pool of the codec base classes */
+typedef struct _GstVideoCodecFramePool GstVideoCodecFramePool;
+
+G_GNUC_INTERNAL
+GstVideoCodecFramePool *__gst_video_codec_frame_pool_new (void);
+
+G_GNUC_INTERNAL
+GstVideoCodecFramePool *__gst_video_codec_frame_pool_ref (GstVideoCodecFramePool * pool);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_pool_unref (GstVideoCodecFramePool * pool);
+
+G_GNUC_INTERNAL
+GstVideoCodecFrame *__gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_pool_release (GstVideoCodecFramePool * pool,
+                                           GstVideoCodecFrame * frame);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_pool_get_stats (GstVideoCodecFramePool * pool,
+                                             guint64 * allocated, guint64 * reused);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,34 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_CONVERTER_PRIVATE_H__
+#define __GST_VIDEO_CONVERTER_PRIVATE_H__
+
+#include <gst/video/video-converter.h>
+
+G_BEGIN_DECLS
+
+/* only for the unit tests and benchmarks */
+const GstStructure * _gst_video_converter_get_path (GstVideoConverter * convert);
+
+gconstpointer _gst_video_converter_get_plan (GstVideoConverter * convert);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_CONVERTER_PRIVATE_H__ */
@@ -29,6 +29,8 @@
 #include <math.h>
 
 #include "video-orc.h"
+#include "video-scaler-private.h"
+#include "video-converter-private.h"
 
 /**
  * SECTION:videoconverter
@@ -118,6 +120,8 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
+#include "gst/parallelized-task-runner-private.h"
+
 typedef struct _GstLineCache GstLineCache;
 
 #define SCALE    (8)
@@ -150,6 +154,18 @@ struct _GammaData
   void (*gamma_func) (GammaData * data, gpointer dest, gpointer src);
 };
 
+typedef struct _ColorLutData ColorLutData;
+
+struct _ColorLutData
+{
+  /* number of points on each axis */
+  gint size;
+  /* size * size * size points of 3 components, in 16 bits */
+  guint16 *table;
+  gint width;
+  void (*lut_func) (ColorLutData * data, gpointer dest, gpointer src);
+};
+
 typedef enum
 {
   ALPHA_MODE_NONE = 0,
@@ -169,7 +185,46 @@ typedef struct
 } ConverterAlloc;
 
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height);
+
+typedef struct _ConverterPlan ConverterPlan;
+
+/* The parts of a converter that only depend on the input and output info
+ * and the configuration and that are expensive to calculate. Plans are
+ * shared between converters through a small LRU cache. Once a plan is
+ * in the cache it is never modified again. */
+struct _ConverterPlan
+{
+  gint refcount;
+
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  GstStructure *config;
+
+  /* TRUE when the plan is shared and must not be modified */
+  gboolean complete;
+
+  /* index in transforms or -1 when there is no fastpath */
+  gint fastpath;
+
+  gpointer gamma_dec_table;
+  gpointer gamma_enc_table;
+  guint16 *color_lut_table;
+
+  /* list of PlanScaler */
+  GList *scalers;
+};
+
+typedef struct
+{
+  GstVideoResamplerMethod method;
+  GstVideoScalerFlags flags;
+  guint n_taps;
+  guint in_size;
+  guint out_size;
+  GstVideoScaler *scaler;
+} PlanScaler;
 
 struct _GstVideoConverter
 {
@@ -198,8 +253,18 @@ struct _GstVideoConverter
   gint current_bits;
 
   GstStructure *config;
+  ConverterPlan *plan;
+
+  /* description of the chosen conversion path */
+  GstStructure *path;
+
+  GstParallelizedTaskRunner *conversion_runner;
+
+  /* width of the vertical strips converted by the generic path, 0 when
+   * complete lines are converted */
+  gint tile_width;
 
-  guint16 *tmpline;
+  guint16 **tmpline;
 
   gboolean fill_border;
   gpointer borderline;
@@ -212,7 +277,7 @@ struct _GstVideoConverter
       GstVideoFrame * dest);
 
   /* data for unpack */
-  GstLineCache *unpack_lines;
+  GstLineCache **unpack_lines;
   GstVideoFormat unpack_format;
   guint unpack_bits;
   gboolean unpack_rgb;
@@ -220,7 +285,7 @@ struct _GstVideoConverter
   gint unpack_pstride;
 
   /* chroma upsample */
-  GstLineCache *upsample_lines;
+  GstLineCache **upsample_lines;
   GstVideoChromaResample *upsample;
   GstVideoChromaResample *upsample_p;
   GstVideoChromaResample *upsample_i;
@@ -228,40 +293,44 @@ struct _GstVideoConverter
   gint up_offset;
 
   /* to R'G'B */
-  GstLineCache *to_RGB_lines;
+  GstLineCache **to_RGB_lines;
   MatrixData to_RGB_matrix;
   /* gamma decode */
   GammaData gamma_dec;
 
   /* scaling */
-  GstLineCache *hscale_lines;
-  GstVideoScaler *h_scaler;
+  GstLineCache **hscale_lines;
+  GstVideoScaler **h_scaler;
   gint h_scale_format;
-  GstLineCache *vscale_lines;
-  GstVideoScaler *v_scaler;
-  GstVideoScaler *v_scaler_p;
-  GstVideoScaler *v_scaler_i;
+  GstLineCache **vscale_lines;
+  GstVideoScaler **v_scaler;
+  GstVideoScaler **v_scaler_p;
+  GstVideoScaler **v_scaler_i;
   gint v_scale_width;
   gint v_scale_format;
 
   /* color space conversion */
-  GstLineCache *convert_lines;
+  GstLineCache **convert_lines;
   MatrixData convert_matrix;
   gint in_bits;
   gint out_bits;
 
   /* alpha correction */
-  GstLineCache *alpha_lines;
+  GstLineCache **alpha_lines;
   void (*alpha_func) (GstVideoConverter * convert, gpointer pixels, gint width);
 
   /* gamma encode */
   GammaData gamma_enc;
   /* to Y'CbCr */
-  GstLineCache *to_YUV_lines;
+  GstLineCache **to_YUV_lines;
   MatrixData to_YUV_matrix;
 
+  /* complete color conversion with a lookup table */
+  GstLineCache **color_lut_lines;
+  ColorLutData color_lut;
+
   /* chroma downsample */
-  GstLineCache *downsample_lines;
+  GstLineCache **downsample_lines;
   GstVideoChromaResample *downsample;
   GstVideoChromaResample *downsample_p;
   GstVideoChromaResample *downsample_i;
@@ -269,11 +338,11 @@ struct _GstVideoConverter
   gint down_offset;
 
   /* dither */
-  GstLineCache *dither_lines;
-  GstVideoDither *dither;
+  GstLineCache **dither_lines;
+  GstVideoDither **dither;
 
   /* pack */
-  GstLineCache *pack_lines;
+  GstLineCache **pack_lines;
   guint pack_nlines;
   GstVideoFormat pack_format;
   guint pack_bits;
@@ -296,14 +365,174 @@ struct _GstVideoConverter
   gint fout_height[4];
   gint fsplane[4];
   gint ffill[4];
-  GstVideoScaler *fh_scaler[4];
-  GstVideoScaler *fv_scaler[4];
+  GstVideoScaler **fh_scaler[4];
+  GstVideoScaler **fv_scaler[4];
   FastConvertFunc fconvert[4];
 };
 
+/* maximum number of plans kept in the cache */
+#define PLAN_CACHE_SIZE 8
+
+static GMutex plan_cache_lock;
+static GQueue plan_cache = G_QUEUE_INIT;
+
+static ConverterPlan *
+converter_plan_new (const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info, const GstStructure * config)
+{
+  ConverterPlan *plan;
+
+  plan = g_slice_new0 (ConverterPlan);
+  plan->refcount = 1;
+  plan->in_info = *in_info;
+  plan->out_info = *out_info;
+  plan->config = gst_structure_copy (config);
+  plan->fastpath = -1;
+
+  return plan;
+}
+
+static ConverterPlan *
+converter_plan_ref (ConverterPlan * plan)
+{
+  g_atomic_int_inc (&plan->refcount);
+  return plan;
+}
+
+static void
+plan_scaler_free (PlanScaler * ps)
+{
+  gst_video_scaler_free (ps->scaler);
+  g_slice_free (PlanScaler, ps);
+}
+
+static void
+converter_plan_unref (ConverterPlan * plan)
+{
+  if (!g_atomic_int_dec_and_test (&plan->refcount))
+    return;
+
+  g_free (plan->gamma_dec_table);
+  g_free (plan->gamma_enc_table);
+  g_free (plan->color_lut_table);
+  g_list_free_full (plan->scalers, (GDestroyNotify) plan_scaler_free);
+  gst_structure_free (plan->config);
+  g_slice_free (ConverterPlan, plan);
+}
+
+static gboolean
+converter_plan_matches (ConverterPlan * plan, const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info, const GstStructure * config)
+{
+  return gst_video_info_is_equal (&plan->in_info, in_info) &&
+      gst_video_info_is_equal (&plan->out_info, out_info) &&
+      gst_structure_is_equal (plan->config, config);
+}
+
+/* find a plan for the given configuration or make a new one that will be
+ * filled up while the converter is set up */
+static ConverterPlan *
+converter_plan_get (const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info, const GstStructure * config)
+{
+  ConverterPlan *plan = NULL;
+  GList *walk;
+
+  g_mutex_lock (&plan_cache_lock);
+  for (walk = plan_cache.head; walk; walk = walk->next) {
+    ConverterPlan *p = walk->data;
+
+    if (converter_plan_matches (p, in_info, out_info, config)) {
+      /* move to the front, it's the most recently used now */
+      g_queue_unlink (&plan_cache, walk);
+      g_queue_push_head_link (&plan_cache, walk);
+      plan = converter_plan_ref (p);
+      break;
+    }
+  }
+  g_mutex_unlock (&plan_cache_lock);
+
+  if (plan) {
+    GST_DEBUG ("reusing cached plan %p", plan);
+    return plan;
+  }
+  return converter_plan_new (in_info, out_info, config);
+}
+
+/* make @plan available to other converters */
+static void
+converter_plan_publish (ConverterPlan * plan)
+{
+  GList *walk;
+
+  if (plan->complete)
+    return;
+
+  g_mutex_lock (&plan_cache_lock);
+  plan->complete = TRUE;
+
+  /* someone else might have made the same plan in the meantime */
+  for (walk = plan_cache.head; walk; walk = walk->next) {
+    ConverterPlan *p = walk->data;
+
+    if (converter_plan_matches (p, &plan->in_info, &plan->out_info,
+            plan->config))
+      break;
+  }
+  if (walk == NULL) {
+    GST_DEBUG ("adding plan %p to cache", plan);
+    g_queue_push_head (&plan_cache, converter_plan_ref (plan));
+    while (g_queue_get_length (&plan_cache) > PLAN_CACHE_SIZE)
+      converter_plan_unref (g_queue_pop_tail (&plan_cache));
+  }
+  g_mutex_unlock (&plan_cache_lock);
+}
+
+/* get a scaler for the converter, the filter coefficients are taken from
+ * the plan when possible */
+static GstVideoScaler *
+converter_plan_get_scaler (GstVideoConverter * convert,
+    GstVideoResamplerMethod method, GstVideoScalerFlags flags, guint n_taps,
+    guint in_size, guint out_size, GstStructure * options)
+{
+  ConverterPlan *plan = convert->plan;
+  PlanScaler *ps = NULL;
+  GList *walk;
+
+  for (walk = plan->scalers; walk; walk = walk->next) {
+    PlanScaler *p = walk->data;
+
+    if (p->method == method && p->flags == flags && p->n_taps == n_taps &&
+        p->in_size == in_size && p->out_size == out_size) {
+      ps = p;
+      break;
+    }
+  }
+
+  if (ps == NULL) {
+    GstVideoScaler *scaler;
+
+    scaler = gst_video_scaler_new (method, flags, n_taps, in_size, out_size,
+        options);
+    /* shared plans can't be modified anymore */
+    if (plan->complete)
+      return scaler;
+
+    ps = g_slice_new (PlanScaler);
+    ps->method = method;
+    ps->flags = flags;
+    ps->n_taps = n_taps;
+    ps->in_size = in_size;
+    ps->out_size = out_size;
+    ps->scaler = scaler;
+    plan->scalers = g_list_prepend (plan->scalers, ps);
+  }
+  return __gst_video_scaler_copy (ps->scaler);
+}
+
 typedef gpointer (*GstLineCacheAllocLineFunc) (GstLineCache * cache, gint idx,
     gpointer user_data);
-typedef gboolean (*GstLineCacheNeedLineFunc) (GstLineCache * cache,
+typedef gboolean (*GstLineCacheNeedLineFunc) (GstLineCache * cache, gint idx,
     gint out_line, gint in_line, gpointer user_data);
 
 struct _GstLineCache
@@ -385,19 +614,21 @@ gst_line_cache_set_alloc_line_func (GstLineCache * cache,
 #define BACKLOG 2
 
 static gpointer *
-gst_line_cache_get_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gint n_lines)
+gst_line_cache_get_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gint n_lines)
 {
-  if (cache->first + cache->backlog < in_line) {
+  if (cache->lines->len == 0 || in_line < cache->first) {
+    /* start from scratch, also when a thread starts in the middle of
+     * the frame */
+    gst_line_cache_clear (cache);
+    cache->first = in_line;
+  } else if (cache->first + cache->backlog < in_line) {
     gint to_remove =
         MIN (in_line - (cache->first + cache->backlog), cache->lines->len);
     if (to_remove > 0) {
       g_ptr_array_remove_range (cache->lines, 0, to_remove);
     }
     cache->first += to_remove;
-  } else if (in_line < cache->first) {
-    gst_line_cache_clear (cache);
-    cache->first = in_line;
   }
 
   while (TRUE) {
@@ -413,7 +644,7 @@ gst_line_cache_get_lines (GstLineCache * cache, gint out_line, gint in_line,
 
     oline = out_line + cache->first + cache->lines->len - in_line;
 
-    if (!cache->need_line (cache, oline, cache->first + cache->lines->len,
+    if (!cache->need_line (cache, idx, oline, cache->first + cache->lines->len,
             cache->need_line_data))
       break;
   }
@@ -453,26 +684,28 @@ static void video_converter_compute_resample (GstVideoConverter * convert);
 static gpointer get_dest_line (GstLineCache * cache, gint idx,
     gpointer user_data);
 
-static gboolean do_unpack_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_downsample_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_convert_to_RGB_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_convert_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_alpha_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_convert_to_YUV_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_upsample_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_vscale_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_hscale_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
-static gboolean do_dither_lines (GstLineCache * cache, gint out_line,
-    gint in_line, gpointer user_data);
+static gboolean do_unpack_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_downsample_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_convert_to_RGB_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_convert_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_alpha_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_convert_to_YUV_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_color_lut_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_upsample_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_vscale_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_hscale_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
+static gboolean do_dither_lines (GstLineCache * cache, gint idx,
+    gint out_line, gint in_line, gpointer user_data);
 
 static ConverterAlloc *
 converter_alloc_new (guint stride, guint n_lines, gpointer user_data,
@@ -605,6 +838,10 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_RESAMPLER_TAPS 0
 #define DEFAULT_OPT_DITHER_METHOD GST_VIDEO_DITHER_BAYER
 #define DEFAULT_OPT_DITHER_QUANTIZATION 1
+#define DEFAULT_OPT_THREADS 1
+#define DEFAULT_OPT_TILE_WIDTH 0
+#define DEFAULT_OPT_COLOR_LUT_SIZE 0
+#define DEFAULT_OPT_FAST_MATRIX FALSE
 
 #define GET_OPT_FILL_BORDER(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_FILL_BORDER, DEFAULT_OPT_FILL_BORDER)
@@ -635,6 +872,14 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_DITHER_METHOD)
 #define GET_OPT_DITHER_QUANTIZATION(c) get_opt_uint(c, \
     GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, DEFAULT_OPT_DITHER_QUANTIZATION)
+#define GET_OPT_THREADS(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_THREADS, DEFAULT_OPT_THREADS)
+#define GET_OPT_TILE_WIDTH(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_TILE_WIDTH, DEFAULT_OPT_TILE_WIDTH)
+#define GET_OPT_COLOR_LUT_SIZE(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_COLOR_LUT_SIZE, DEFAULT_OPT_COLOR_LUT_SIZE)
+#define GET_OPT_FAST_MATRIX(c) get_opt_bool(c, \
+    GST_VIDEO_CONVERTER_OPT_FAST_MATRIX, DEFAULT_OPT_FAST_MATRIX)
 
 #define CHECK_ALPHA_COPY(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_COPY)
 #define CHECK_ALPHA_SET(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_SET)
@@ -658,7 +903,7 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define CHECK_CHROMA_NONE(c) (GET_OPT_CHROMA_MODE(c) == GST_VIDEO_CHROMA_MODE_NONE)
 
 static GstLineCache *
-chain_unpack_line (GstVideoConverter * convert)
+chain_unpack_line (GstVideoConverter * convert, gint idx)
 {
   GstLineCache *prev;
   GstVideoInfo *info;
@@ -676,31 +921,31 @@ chain_unpack_line (GstVideoConverter * convert)
       gst_video_format_to_string (convert->current_format),
       convert->current_pstride, convert->identity_unpack);
 
-  prev = convert->unpack_lines = gst_line_cache_new (NULL);
+  prev = convert->unpack_lines[idx] = gst_line_cache_new (NULL);
   prev->write_input = FALSE;
   prev->pass_alloc = FALSE;
   prev->n_lines = 1;
   prev->stride = convert->current_pstride * convert->current_width;
-  gst_line_cache_set_need_line_func (convert->unpack_lines,
-      do_unpack_lines, convert, NULL);
+  gst_line_cache_set_need_line_func (prev, do_unpack_lines, convert, NULL);
 
-  return convert->unpack_lines;
+  return prev;
 }
 
 static GstLineCache *
-chain_upsample (GstVideoConverter * convert, GstLineCache * prev)
+chain_upsample (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
-  video_converter_compute_resample (convert);
+  /* the chroma resamplers have no state and are shared by all threads */
+  if (idx == 0)
+    video_converter_compute_resample (convert);
 
   if (convert->upsample_p || convert->upsample_i) {
     GST_DEBUG ("chain upsample");
-    prev = convert->upsample_lines = gst_line_cache_new (prev);
+    prev = convert->upsample_lines[idx] = gst_line_cache_new (prev);
     prev->write_input = TRUE;
     prev->pass_alloc = TRUE;
     prev->n_lines = 4;
     prev->stride = convert->current_pstride * convert->current_width;
-    gst_line_cache_set_need_line_func (convert->upsample_lines,
-        do_upsample_lines, convert, NULL);
+    gst_line_cache_set_need_line_func (prev, do_upsample_lines, convert, NULL);
   }
   return prev;
 }
@@ -1102,6 +1347,22 @@ is_no_clip_matrix (MatrixData * data)
   return TRUE;
 }
 
+/* the orc 8 bit matrix works on values around 128 and ignores the offsets,
+ * it's only usable when 128 stays 128 */
+static gboolean
+is_centered_matrix (MatrixData * data)
+{
+  gint i, c;
+
+  for (i = 0; i < 3; i++) {
+    c = (data->im[i][0] + data->im[i][1] + data->im[i][2]) * 128 +
+        data->im[i][3];
+    if (ABS (c - (128 << SCALE)) > (1 << (SCALE - 1)))
+      return FALSE;
+  }
+  return TRUE;
+}
+
 static void
 video_converter_matrix16 (MatrixData * data, gpointer pixels)
 {
@@ -1146,7 +1407,8 @@ prepare_matrix (GstVideoConverter * convert, MatrixData * data)
         && is_ayuv_to_rgb_matrix (data)) {
       GST_DEBUG ("use fast AYUV -> RGB matrix");
       data->matrix_func = video_converter_matrix8_AYUV_ARGB;
-    } else if (is_no_clip_matrix (data)) {
+    } else if (!(GET_OPT_FAST_MATRIX (convert) && is_centered_matrix (data))
+        && is_no_clip_matrix (data)) {
       GST_DEBUG ("use 8bit table");
       data->matrix_func = video_converter_matrix8_table;
       videoconvert_convert_init_tables (data);
@@ -1179,6 +1441,21 @@ prepare_matrix (GstVideoConverter * convert, MatrixData * data)
   }
 }
 
+static const gchar *
+matrix_name (MatrixData * data)
+{
+  if (data->matrix_func == NULL)
+    return "none";
+  else if (data->matrix_func == video_converter_matrix8_AYUV_ARGB)
+    return "8bit-ayuv-argb";
+  else if (data->matrix_func == video_converter_matrix8_table)
+    return "8bit-table";
+  else if (data->matrix_func == video_converter_matrix8)
+    return "8bit";
+  else
+    return "16bit";
+}
+
 static void
 compute_matrix_to_RGB (GstVideoConverter * convert, MatrixData * data)
 {
@@ -1251,6 +1528,34 @@ compute_matrix_to_YUV (GstVideoConverter * convert, MatrixData * data,
   color_matrix_debug (data);
 }
 
+static void
+compute_matrix_primaries (GstVideoConverter * convert, MatrixData * data)
+{
+  const GstVideoColorPrimariesInfo *pi;
+  MatrixData p1, p2;
+
+  pi = gst_video_color_primaries_get_info (convert->in_info.colorimetry.
+      primaries);
+  color_matrix_RGB_to_XYZ (&p1, pi->Rx, pi->Ry, pi->Gx, pi->Gy, pi->Bx,
+      pi->By, pi->Wx, pi->Wy);
+  GST_DEBUG ("to XYZ matrix");
+  color_matrix_debug (&p1);
+  GST_DEBUG ("current matrix");
+  color_matrix_multiply (data, data, &p1);
+  color_matrix_debug (data);
+
+  pi = gst_video_color_primaries_get_info (convert->out_info.colorimetry.
+      primaries);
+  color_matrix_RGB_to_XYZ (&p2, pi->Rx, pi->Ry, pi->Gx, pi->Gy, pi->Bx,
+      pi->By, pi->Wx, pi->Wy);
+  color_matrix_invert (&p2, &p2);
+  GST_DEBUG ("to RGB matrix");
+  color_matrix_debug (&p2);
+  color_matrix_multiply (data, data, &p2);
+  GST_DEBUG ("current matrix");
+  color_matrix_debug (data);
+}
+
 
 static void
 gamma_convert_u8_u16 (GammaData * data, gpointer dest, gpointer src)
@@ -1307,6 +1612,7 @@ static void
 setup_gamma_decode (GstVideoConverter * convert)
 {
   GstVideoTransferFunction func;
+  ConverterPlan *plan = convert->plan;
   guint16 *t;
   gint i;
 
@@ -1316,38 +1622,61 @@ setup_gamma_decode (GstVideoConverter * convert)
   if (convert->current_bits == 8) {
     GST_DEBUG ("gamma decode 8->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u8_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 256);
+  } else {
+    GST_DEBUG ("gamma decode 16->16: %d", func);
+    convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
+  }
+
+  /* the table is only made once per plan */
+  if (plan->gamma_dec_table) {
+    convert->gamma_dec.gamma_table = plan->gamma_dec_table;
+    return;
+  }
+
+  if (convert->current_bits == 8) {
+    t = g_malloc (sizeof (guint16) * 256);
 
     for (i = 0; i < 256; i++)
       t[i] = rint (gst_video_color_transfer_decode (func, i / 255.0) * 65535.0);
   } else {
-    GST_DEBUG ("gamma decode 16->16: %d", func);
-    convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
-    t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 65536);
+    t = g_malloc (sizeof (guint16) * 65536);
 
     for (i = 0; i < 65536; i++)
       t[i] =
           rint (gst_video_color_transfer_decode (func, i / 65535.0) * 65535.0);
   }
-  convert->current_bits = 16;
-  convert->current_pstride = 8;
-  convert->current_format = GST_VIDEO_FORMAT_ARGB64;
+  convert->gamma_dec.gamma_table = t;
+  if (!plan->complete)
+    plan->gamma_dec_table = t;
 }
 
 static void
 setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
 {
   GstVideoTransferFunction func;
+  ConverterPlan *plan = convert->plan;
   gint i;
 
   func = convert->out_info.colorimetry.transfer;
 
   convert->gamma_enc.width = convert->current_width;
   if (target_bits == 8) {
-    guint8 *t;
-
     GST_DEBUG ("gamma encode 16->8: %d", func);
     convert->gamma_enc.gamma_func = gamma_convert_u16_u8;
+  } else {
+    GST_DEBUG ("gamma encode 16->16: %d", func);
+    convert->gamma_enc.gamma_func = gamma_convert_u16_u16;
+  }
+
+  /* the table is only made once per plan */
+  if (plan->gamma_enc_table) {
+    convert->gamma_enc.gamma_table = plan->gamma_enc_table;
+    return;
+  }
+
+  if (target_bits == 8) {
+    guint8 *t;
+
     t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint8) * 65536);
 
     for (i = 0; i < 65536; i++)
@@ -1355,134 +1684,470 @@ setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
   } else {
     guint16 *t;
 
-    GST_DEBUG ("gamma encode 16->16: %d", func);
-    convert->gamma_enc.gamma_func = gamma_convert_u16_u16;
     t = convert->gamma_enc.gamma_table = g_malloc (sizeof (guint16) * 65536);
 
     for (i = 0; i < 65536; i++)
       t[i] =
           rint (gst_video_color_transfer_encode (func, i / 65535.0) * 65535.0);
   }
+  if (!plan->complete)
+    plan->gamma_enc_table = convert->gamma_enc.gamma_table;
+}
+
+/* interpolate the 16 bits color @c0, @c1, @c2 from the 4 points of the
+ * tetrahedron around it in the table */
+static inline void
+color_lut_lookup (ColorLutData * data, guint c0, guint c1, guint c2,
+    guint out[3])
+{
+  const guint16 *p;
+  guint n = data->size - 1;
+  guint p0, p1, p2, f0, f1, f2;
+  guint s0, s1, s2, n1, n2, n3;
+  guint w0, w1, w2, w3;
+  gint k;
+
+  /* map 0..65535 to 0..n in 16.16 fixed point */
+  p0 = c0 * n;
+  p0 += p0 >> 16;
+  p1 = c1 * n;
+  p1 += p1 >> 16;
+  p2 = c2 * n;
+  p2 += p2 >> 16;
+  f0 = p0 & 0xffff;
+  f1 = p1 & 0xffff;
+  f2 = p2 & 0xffff;
+
+  s2 = 3;
+  s1 = s2 * data->size;
+  s0 = s1 * data->size;
+  p = data->table + (p0 >> 16) * s0 + (p1 >> 16) * s1 + (p2 >> 16) * s2;
+  n3 = s0 + s1 + s2;
+
+  if (f0 >= f1) {
+    if (f1 >= f2) {
+      n1 = s0;
+      n2 = s0 + s1;
+      w0 = 65536 - f0;
+      w1 = f0 - f1;
+      w2 = f1 - f2;
+      w3 = f2;
+    } else if (f0 >= f2) {
+      n1 = s0;
+      n2 = s0 + s2;
+      w0 = 65536 - f0;
+      w1 = f0 - f2;
+      w2 = f2 - f1;
+      w3 = f1;
+    } else {
+      n1 = s2;
+      n2 = s0 + s2;
+      w0 = 65536 - f2;
+      w1 = f2 - f0;
+      w2 = f0 - f1;
+      w3 = f1;
+    }
+  } else {
+    if (f2 >= f1) {
+      n1 = s2;
+      n2 = s1 + s2;
+      w0 = 65536 - f2;
+      w1 = f2 - f1;
+      w2 = f1 - f0;
+      w3 = f0;
+    } else if (f2 >= f0) {
+      n1 = s1;
+      n2 = s1 + s2;
+      w0 = 65536 - f1;
+      w1 = f1 - f2;
+      w2 = f2 - f0;
+      w3 = f0;
+    } else {
+      n1 = s1;
+      n2 = s0 + s1;
+      w0 = 65536 - f1;
+      w1 = f1 - f0;
+      w2 = f0 - f2;
+      w3 = f2;
+    }
+  }
+
+  for (k = 0; k < 3; k++)
+    out[k] = (w0 * p[k] + w1 * p[n1 + k] + w2 * p[n2 + k] +
+        w3 * p[n3 + k] + 32768) >> 16;
 }
 
-static GstLineCache *
-chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev)
+static void
+color_lut_u8_u8 (ColorLutData * data, gpointer dest, gpointer src)
 {
-  gboolean do_gamma;
-
-  do_gamma = CHECK_GAMMA_REMAP (convert);
+  gint i;
+  guint8 *s = src;
+  guint8 *d = dest;
+  gint width = data->width * 4;
+  guint out[3];
 
-  if (do_gamma) {
-    gint scale;
+  for (i = 0; i < width; i += 4) {
+    color_lut_lookup (data, s[i + 1] * 257, s[i + 2] * 257, s[i + 3] * 257,
+        out);
+    d[i + 0] = s[i + 0];
+    d[i + 1] = (out[0] + 128) >> 8;
+    d[i + 2] = (out[1] + 128) >> 8;
+    d[i + 3] = (out[2] + 128) >> 8;
+  }
+}
 
-    if (!convert->unpack_rgb) {
-      color_matrix_set_identity (&convert->to_RGB_matrix);
-      compute_matrix_to_RGB (convert, &convert->to_RGB_matrix);
+static void
+color_lut_u8_u16 (ColorLutData * data, gpointer dest, gpointer src)
+{
+  gint i;
+  guint8 *s = src;
+  guint16 *d = dest;
+  gint width = data->width * 4;
+  guint out[3];
 
-      /* matrix is in 0..1 range, scale to current bits */
-      GST_DEBUG ("chain RGB convert");
-      scale = 1 << convert->current_bits;
-      color_matrix_scale_components (&convert->to_RGB_matrix,
-          (float) scale, (float) scale, (float) scale);
+  for (i = 0; i < width; i += 4) {
+    color_lut_lookup (data, s[i + 1] * 257, s[i + 2] * 257, s[i + 3] * 257,
+        out);
+    d[i + 0] = s[i + 0] * 257;
+    d[i + 1] = out[0];
+    d[i + 2] = out[1];
+    d[i + 3] = out[2];
+  }
+}
 
-      prepare_matrix (convert, &convert->to_RGB_matrix);
+static void
+color_lut_u16_u8 (ColorLutData * data, gpointer dest, gpointer src)
+{
+  gint i;
+  guint16 *s = src;
+  guint8 *d = dest;
+  gint width = data->width * 4;
+  guint out[3];
 
-      if (convert->current_bits == 8)
-        convert->current_format = GST_VIDEO_FORMAT_ARGB;
-      else
-        convert->current_format = GST_VIDEO_FORMAT_ARGB64;
-    }
+  for (i = 0; i < width; i += 4) {
+    color_lut_lookup (data, s[i + 1], s[i + 2], s[i + 3], out);
+    d[i + 0] = s[i + 0] >> 8;
+    d[i + 1] = (out[0] + 128) >> 8;
+    d[i + 2] = (out[1] + 128) >> 8;
+    d[i + 3] = (out[2] + 128) >> 8;
+  }
+}
 
-    prev = convert->to_RGB_lines = gst_line_cache_new (prev);
-    prev->write_input = TRUE;
-    prev->pass_alloc = FALSE;
-    prev->n_lines = 1;
-    prev->stride = convert->current_pstride * convert->current_width;
-    gst_line_cache_set_need_line_func (convert->to_RGB_lines,
-        do_convert_to_RGB_lines, convert, NULL);
+static void
+color_lut_u16_u16 (ColorLutData * data, gpointer dest, gpointer src)
+{
+  gint i;
+  guint16 *s = src;
+  guint16 *d = dest;
+  gint width = data->width * 4;
+  guint out[3];
 
-    GST_DEBUG ("chain gamma decode");
-    setup_gamma_decode (convert);
+  for (i = 0; i < width; i += 4) {
+    color_lut_lookup (data, s[i + 1], s[i + 2], s[i + 3], out);
+    d[i + 0] = s[i + 0];
+    d[i + 1] = out[0];
+    d[i + 2] = out[1];
+    d[i + 3] = out[2];
   }
-  return prev;
 }
 
-static GstLineCache *
-chain_hscale (GstVideoConverter * convert, GstLineCache * prev)
+static void
+color_matrix_apply (MatrixData * m, gdouble v[3])
 {
-  gint method;
-  guint taps;
+  gdouble t[3];
+  gint i;
 
-  method = GET_OPT_RESAMPLER_METHOD (convert);
-  taps = GET_OPT_RESAMPLER_TAPS (convert);
+  for (i = 0; i < 3; i++)
+    t[i] = m->dm[i][0] * v[0] + m->dm[i][1] * v[1] + m->dm[i][2] * v[2] +
+        m->dm[i][3];
+  for (i = 0; i < 3; i++)
+    v[i] = t[i];
+}
 
-  convert->h_scaler =
-      gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
-      convert->in_width, convert->out_width, convert->config);
+static void
+color_clamp (gdouble v[3], gdouble max)
+{
+  gint i;
 
-  gst_video_scaler_get_coeff (convert->h_scaler, 0, NULL, &taps);
+  for (i = 0; i < 3; i++)
+    v[i] = CLAMP (v[i], 0.0, max);
+}
 
-  GST_DEBUG ("chain hscale %d->%d, taps %d, method %d",
-      convert->in_width, convert->out_width, taps, method);
+/* run the steps of the generic path on all points of the table, in double
+ * precision */
+static guint16 *
+compute_color_lut (GstVideoConverter * convert, gint size)
+{
+  GstVideoTransferFunction in_func, out_func;
+  MatrixData to_RGB, convert_matrix, to_YUV;
+  gboolean do_gamma;
+  gdouble in_max, out_max, out_scale;
+  guint16 *table, *t;
+  gint i, j, k, c;
 
-  convert->current_width = convert->out_width;
-  convert->h_scale_format = convert->current_format;
+  do_gamma = CHECK_GAMMA_REMAP (convert);
+  in_func = convert->in_info.colorimetry.transfer;
+  out_func = convert->out_info.colorimetry.transfer;
+  in_max = (1 << convert->unpack_bits) - 1;
+  out_max = (1 << convert->pack_bits) - 1;
+  /* the table is in 16 bits */
+  out_scale = 1 << (16 - convert->pack_bits);
+
+  color_matrix_set_identity (&convert_matrix);
+  if (!CHECK_PRIMARIES_NONE (convert) &&
+      convert->in_info.colorimetry.primaries !=
+      convert->out_info.colorimetry.primaries)
+    compute_matrix_primaries (convert, &convert_matrix);
 
-  prev = convert->hscale_lines = gst_line_cache_new (prev);
-  prev->write_input = FALSE;
-  prev->pass_alloc = FALSE;
-  prev->n_lines = 1;
-  prev->stride = convert->current_pstride * convert->current_width;
-  gst_line_cache_set_need_line_func (convert->hscale_lines,
-      do_hscale_lines, convert, NULL);
+  if (do_gamma) {
+    color_matrix_set_identity (&to_RGB);
+    compute_matrix_to_RGB (convert, &to_RGB);
+    color_matrix_set_identity (&to_YUV);
+    compute_matrix_to_YUV (convert, &to_YUV, FALSE);
+  } else {
+    /* combine everything into 1 matrix like chain_convert */
+    compute_matrix_to_RGB (convert, &convert_matrix);
+    compute_matrix_to_YUV (convert, &convert_matrix, FALSE);
+  }
 
-  return prev;
+  table = t = g_malloc (sizeof (guint16) * 3 * size * size * size);
+
+  for (i = 0; i < size; i++) {
+    for (j = 0; j < size; j++) {
+      for (k = 0; k < size; k++) {
+        gdouble v[3];
+
+        v[0] = i * in_max / (size - 1);
+        v[1] = j * in_max / (size - 1);
+        v[2] = k * in_max / (size - 1);
+
+        if (do_gamma) {
+          color_matrix_apply (&to_RGB, v);
+          color_clamp (v, 1.0);
+          for (c = 0; c < 3; c++)
+            v[c] = gst_video_color_transfer_decode (in_func, v[c]);
+          color_matrix_apply (&convert_matrix, v);
+          color_clamp (v, 1.0);
+          for (c = 0; c < 3; c++)
+            v[c] = gst_video_color_transfer_encode (out_func, v[c]);
+          color_matrix_apply (&to_YUV, v);
+        } else {
+          color_matrix_apply (&convert_matrix, v);
+        }
+        color_clamp (v, out_max);
+
+        for (c = 0; c < 3; c++)
+          *t++ = rint (v[c] * out_scale);
+      }
+    }
+  }
+  return table;
 }
 
-static GstLineCache *
-chain_vscale (GstVideoConverter * convert, GstLineCache * prev)
+static void
+setup_color_lut (GstVideoConverter * convert)
 {
-  gint method;
-  guint taps, taps_i = 0;
-  gint backlog = 0;
-
-  method = GET_OPT_RESAMPLER_METHOD (convert);
-  taps = GET_OPT_RESAMPLER_TAPS (convert);
+  ConverterPlan *plan = convert->plan;
+  gboolean same_primaries;
+  guint size;
 
-  if (GST_VIDEO_INFO_IS_INTERLACED (&convert->in_info)) {
-    convert->v_scaler_i =
-        gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_INTERLACED,
-        taps, convert->in_height, convert->out_height, convert->config);
+  size = GET_OPT_COLOR_LUT_SIZE (convert);
+  if (size == 0)
+    return;
 
-    gst_video_scaler_get_coeff (convert->v_scaler_i, 0, NULL, &taps_i);
-    backlog = taps_i;
+  /* the table replaces the conversions before and after scaling */
+  if (convert->in_width != convert->out_width ||
+      convert->in_height != convert->out_height) {
+    GST_DEBUG ("can't use a color lookup table with scaling");
+    return;
   }
-  convert->v_scaler_p =
-      gst_video_scaler_new (method, 0, taps, convert->in_height,
-      convert->out_height, convert->config);
-  convert->v_scale_width = convert->current_width;
-  convert->v_scale_format = convert->current_format;
-  convert->current_height = convert->out_height;
 
-  gst_video_scaler_get_coeff (convert->v_scaler_p, 0, NULL, &taps);
+  same_primaries = CHECK_PRIMARIES_NONE (convert) ||
+      convert->in_info.colorimetry.primaries ==
+      convert->out_info.colorimetry.primaries;
 
-  GST_DEBUG ("chain vscale %d->%d, taps %d, method %d, backlog %d",
-      convert->in_height, convert->out_height, taps, method, backlog);
+  /* a matrix is faster for the other conversions */
+  if (!CHECK_GAMMA_REMAP (convert) && same_primaries) {
+    GST_DEBUG ("no need for a color lookup table");
+    return;
+  }
+
+  size = CLAMP (size, 2, 65);
+
+  if (convert->unpack_bits == 8) {
+    if (convert->pack_bits == 8)
+      convert->color_lut.lut_func = color_lut_u8_u8;
+    else
+      convert->color_lut.lut_func = color_lut_u8_u16;
+  } else {
+    if (convert->pack_bits == 8)
+      convert->color_lut.lut_func = color_lut_u16_u8;
+    else
+      convert->color_lut.lut_func = color_lut_u16_u16;
+  }
+  convert->color_lut.size = size;
+  convert->color_lut.width = convert->in_width;
+
+  /* the table is only made once per plan */
+  if (plan->color_lut_table) {
+    convert->color_lut.table = plan->color_lut_table;
+  } else {
+    GST_DEBUG ("compute color lookup table of %u points", size);
+    convert->color_lut.table = compute_color_lut (convert, size);
+    if (!plan->complete)
+      plan->color_lut_table = convert->color_lut.table;
+  }
+}
+
+static GstLineCache *
+chain_color_lut (GstVideoConverter * convert, GstLineCache * prev, gint idx)
+{
+  gboolean same_bits = convert->current_bits == convert->pack_bits;
+
+  GST_DEBUG ("chain color lookup table");
+  convert->current_bits = convert->pack_bits;
+  convert->current_pstride = convert->current_bits >> 1;
+  convert->current_format = convert->pack_format;
+
+  prev = convert->color_lut_lines[idx] = gst_line_cache_new (prev);
+  /* convert in place when the bits don't change */
+  prev->write_input = same_bits;
+  prev->pass_alloc = same_bits;
+  prev->n_lines = 1;
+  prev->stride = convert->current_pstride * convert->current_width;
+  gst_line_cache_set_need_line_func (prev, do_color_lut_lines, convert, NULL);
+
+  return prev;
+}
+
+static GstLineCache *
+chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev,
+    gint idx)
+{
+  gboolean do_gamma;
+
+  do_gamma = CHECK_GAMMA_REMAP (convert);
+
+  if (do_gamma) {
+    gint scale;
+
+    if (!convert->unpack_rgb) {
+      /* the matrix is shared, only compute it for the first thread */
+      if (idx == 0) {
+        color_matrix_set_identity (&convert->to_RGB_matrix);
+        compute_matrix_to_RGB (convert, &convert->to_RGB_matrix);
+
+        /* matrix is in 0..1 range, scale to current bits */
+        GST_DEBUG ("chain RGB convert");
+        scale = 1 << convert->current_bits;
+        color_matrix_scale_components (&convert->to_RGB_matrix,
+            (float) scale, (float) scale, (float) scale);
+
+        prepare_matrix (convert, &convert->to_RGB_matrix);
+      }
+
+      if (convert->current_bits == 8)
+        convert->current_format = GST_VIDEO_FORMAT_ARGB;
+      else
+        convert->current_format = GST_VIDEO_FORMAT_ARGB64;
+    }
+
+    prev = convert->to_RGB_lines[idx] = gst_line_cache_new (prev);
+    prev->write_input = TRUE;
+    prev->pass_alloc = FALSE;
+    prev->n_lines = 1;
+    prev->stride = convert->current_pstride * convert->current_width;
+    gst_line_cache_set_need_line_func (prev,
+        do_convert_to_RGB_lines, convert, NULL);
+
+    if (idx == 0) {
+      GST_DEBUG ("chain gamma decode");
+      setup_gamma_decode (convert);
+    }
+    convert->current_bits = 16;
+    convert->current_pstride = 8;
+    convert->current_format = GST_VIDEO_FORMAT_ARGB64;
+  }
+  return prev;
+}
+
+static GstLineCache *
+chain_hscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
+{
+  gint method;
+  guint taps;
+
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+  taps = GET_OPT_RESAMPLER_TAPS (convert);
+
+  /* scalers keep temporary lines, each thread needs its own */
+  convert->h_scaler[idx] =
+      converter_plan_get_scaler (convert, method, GST_VIDEO_SCALER_FLAG_NONE,
+      taps, convert->in_width, convert->out_width, convert->config);
+
+  gst_video_scaler_get_coeff (convert->h_scaler[idx], 0, NULL, &taps);
+
+  GST_DEBUG ("chain hscale %d->%d, taps %d, method %d",
+      convert->in_width, convert->out_width, taps, method);
+
+  convert->current_width = convert->out_width;
+  convert->h_scale_format = convert->current_format;
+
+  prev = convert->hscale_lines[idx] = gst_line_cache_new (prev);
+  prev->write_input = FALSE;
+  prev->pass_alloc = FALSE;
+  prev->n_lines = 1;
+  prev->stride = convert->current_pstride * convert->current_width;
+  gst_line_cache_set_need_line_func (prev, do_hscale_lines, convert, NULL);
+
+  return prev;
+}
+
+static GstLineCache *
+chain_vscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
+{
+  gint method;
+  guint taps, taps_i = 0;
+  gint backlog = 0;
+
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+  taps = GET_OPT_RESAMPLER_TAPS (convert);
+
+  if (GST_VIDEO_INFO_IS_INTERLACED (&convert->in_info)) {
+    convert->v_scaler_i[idx] =
+        converter_plan_get_scaler (convert, method,
+        GST_VIDEO_SCALER_FLAG_INTERLACED, taps, convert->in_height,
+        convert->out_height, convert->config);
+
+    gst_video_scaler_get_coeff (convert->v_scaler_i[idx], 0, NULL, &taps_i);
+    backlog = taps_i;
+  }
+  convert->v_scaler_p[idx] =
+      converter_plan_get_scaler (convert, method, 0, taps, convert->in_height,
+      convert->out_height, convert->config);
+  convert->v_scale_width = convert->current_width;
+  convert->v_scale_format = convert->current_format;
+  convert->current_height = convert->out_height;
+
+  gst_video_scaler_get_coeff (convert->v_scaler_p[idx], 0, NULL, &taps);
+
+  GST_DEBUG ("chain vscale %d->%d, taps %d, method %d, backlog %d",
+      convert->in_height, convert->out_height, taps, method, backlog);
 
   prev->backlog = backlog;
-  prev = convert->vscale_lines = gst_line_cache_new (prev);
+  prev = convert->vscale_lines[idx] = gst_line_cache_new (prev);
   prev->pass_alloc = (taps == 1);
   prev->write_input = FALSE;
   prev->n_lines = MAX (taps_i, taps);
   prev->stride = convert->current_pstride * convert->current_width;
-  gst_line_cache_set_need_line_func (convert->vscale_lines,
-      do_vscale_lines, convert, NULL);
+  gst_line_cache_set_need_line_func (prev, do_vscale_lines, convert, NULL);
 
   return prev;
 }
 
 static GstLineCache *
-chain_scale (GstVideoConverter * convert, GstLineCache * prev, gboolean force)
+chain_scale (GstVideoConverter * convert, GstLineCache * prev, gboolean force,
+    gint idx)
 {
   gint s0, s1, s2, s3;
 
@@ -1501,26 +2166,25 @@ chain_scale (GstVideoConverter * convert, GstLineCache * prev, gboolean force)
     if (s1 <= s2) {
       /* h scaling first produces less pixels */
       if (convert->current_width != convert->out_width)
-        prev = chain_hscale (convert, prev);
+        prev = chain_hscale (convert, prev, idx);
       if (convert->current_height != convert->out_height)
-        prev = chain_vscale (convert, prev);
+        prev = chain_vscale (convert, prev, idx);
     } else {
       /* v scaling first produces less pixels */
       if (convert->current_height != convert->out_height)
-        prev = chain_vscale (convert, prev);
+        prev = chain_vscale (convert, prev, idx);
       if (convert->current_width != convert->out_width)
-        prev = chain_hscale (convert, prev);
+        prev = chain_hscale (convert, prev, idx);
     }
   }
   return prev;
 }
 
 static GstLineCache *
-chain_convert (GstVideoConverter * convert, GstLineCache * prev)
+chain_convert (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
   gboolean do_gamma, do_conversion, pass_alloc = FALSE;
   gboolean same_matrix, same_primaries, same_bits;
-  MatrixData p1, p2;
 
   same_bits = convert->unpack_bits == convert->pack_bits;
   if (CHECK_MATRIX_NONE (convert)) {
@@ -1546,33 +2210,12 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev)
   GST_DEBUG ("primaries %d -> %d (%d)", convert->in_info.colorimetry.primaries,
       convert->out_info.colorimetry.primaries, same_primaries);
 
-  color_matrix_set_identity (&convert->convert_matrix);
-
-  if (!same_primaries) {
-    const GstVideoColorPrimariesInfo *pi;
-
-    pi = gst_video_color_primaries_get_info (convert->in_info.colorimetry.
-        primaries);
-    color_matrix_RGB_to_XYZ (&p1, pi->Rx, pi->Ry, pi->Gx, pi->Gy, pi->Bx,
-        pi->By, pi->Wx, pi->Wy);
-    GST_DEBUG ("to XYZ matrix");
-    color_matrix_debug (&p1);
-    GST_DEBUG ("current matrix");
-    color_matrix_multiply (&convert->convert_matrix, &convert->convert_matrix,
-        &p1);
-    color_matrix_debug (&convert->convert_matrix);
-
-    pi = gst_video_color_primaries_get_info (convert->out_info.colorimetry.
-        primaries);
-    color_matrix_RGB_to_XYZ (&p2, pi->Rx, pi->Ry, pi->Gx, pi->Gy, pi->Bx,
-        pi->By, pi->Wx, pi->Wy);
-    color_matrix_invert (&p2, &p2);
-    GST_DEBUG ("to RGB matrix");
-    color_matrix_debug (&p2);
-    color_matrix_multiply (&convert->convert_matrix, &convert->convert_matrix,
-        &p2);
-    GST_DEBUG ("current matrix");
-    color_matrix_debug (&convert->convert_matrix);
+  /* the matrix is shared between all threads, only compute it once */
+  if (idx == 0) {
+    color_matrix_set_identity (&convert->convert_matrix);
+
+    if (!same_primaries)
+      compute_matrix_primaries (convert, &convert->convert_matrix);
   }
 
   do_gamma = CHECK_GAMMA_REMAP (convert);
@@ -1582,31 +2225,34 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev)
     convert->out_bits = convert->pack_bits;
 
     if (!same_bits || !same_matrix || !same_primaries) {
-      /* no gamma, combine all conversions into 1 */
-      if (convert->in_bits < convert->out_bits) {
-        gint scale = 1 << (convert->out_bits - convert->in_bits);
-        color_matrix_scale_components (&convert->convert_matrix,
-            1 / (float) scale, 1 / (float) scale, 1 / (float) scale);
-      }
-      GST_DEBUG ("to RGB matrix");
-      compute_matrix_to_RGB (convert, &convert->convert_matrix);
-      GST_DEBUG ("current matrix");
-      color_matrix_debug (&convert->convert_matrix);
-
-      GST_DEBUG ("to YUV matrix");
-      compute_matrix_to_YUV (convert, &convert->convert_matrix, FALSE);
-      GST_DEBUG ("current matrix");
-      color_matrix_debug (&convert->convert_matrix);
-      if (convert->in_bits > convert->out_bits) {
-        gint scale = 1 << (convert->in_bits - convert->out_bits);
-        color_matrix_scale_components (&convert->convert_matrix,
-            (float) scale, (float) scale, (float) scale);
+      if (idx == 0) {
+        /* no gamma, combine all conversions into 1 */
+        if (convert->in_bits < convert->out_bits) {
+          gint scale = 1 << (convert->out_bits - convert->in_bits);
+          color_matrix_scale_components (&convert->convert_matrix,
+              1 / (float) scale, 1 / (float) scale, 1 / (float) scale);
+        }
+        GST_DEBUG ("to RGB matrix");
+        compute_matrix_to_RGB (convert, &convert->convert_matrix);
+        GST_DEBUG ("current matrix");
+        color_matrix_debug (&convert->convert_matrix);
+
+        GST_DEBUG ("to YUV matrix");
+        compute_matrix_to_YUV (convert, &convert->convert_matrix, FALSE);
+        GST_DEBUG ("current matrix");
+        color_matrix_debug (&convert->convert_matrix);
+        if (convert->in_bits > convert->out_bits) {
+          gint scale = 1 << (convert->in_bits - convert->out_bits);
+          color_matrix_scale_components (&convert->convert_matrix,
+              (float) scale, (float) scale, (float) scale);
+        }
+
+        if (!same_matrix || !same_primaries)
+          prepare_matrix (convert, &convert->convert_matrix);
       }
       convert->current_bits = MAX (convert->in_bits, convert->out_bits);
 
       do_conversion = TRUE;
-      if (!same_matrix || !same_primaries)
-        prepare_matrix (convert, &convert->convert_matrix);
       if (convert->in_bits == convert->out_bits)
         pass_alloc = TRUE;
     } else
@@ -1620,7 +2266,8 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev)
     if (same_primaries) {
       do_conversion = FALSE;
     } else {
-      prepare_matrix (convert, &convert->convert_matrix);
+      if (idx == 0)
+        prepare_matrix (convert, &convert->convert_matrix);
       convert->in_bits = convert->out_bits = 16;
       pass_alloc = TRUE;
       do_conversion = TRUE;
@@ -1629,13 +2276,12 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev)
 
   if (do_conversion) {
     GST_DEBUG ("chain conversion");
-    prev = convert->convert_lines = gst_line_cache_new (prev);
+    prev = convert->convert_lines[idx] = gst_line_cache_new (prev);
     prev->write_input = TRUE;
     prev->pass_alloc = pass_alloc;
     prev->n_lines = 1;
     prev->stride = convert->current_pstride * convert->current_width;
-    gst_line_cache_set_need_line_func (convert->convert_lines,
-        do_convert_lines, convert, NULL);
+    gst_line_cache_set_need_line_func (prev, do_convert_lines, convert, NULL);
   }
   return prev;
 }
@@ -1693,7 +2339,7 @@ convert_mult_alpha_u16 (GstVideoConverter * convert, gpointer pixels,
 }
 
 static GstLineCache *
-chain_alpha (GstVideoConverter * convert, GstLineCache * prev)
+chain_alpha (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
   switch (convert->alpha_mode) {
     case ALPHA_MODE_NONE:
@@ -1715,19 +2361,19 @@ chain_alpha (GstVideoConverter * convert, GstLineCache * prev)
   }
 
   GST_DEBUG ("chain alpha mode %d", convert->alpha_mode);
-  prev = convert->alpha_lines = gst_line_cache_new (prev);
+  prev = convert->alpha_lines[idx] = gst_line_cache_new (prev);
   prev->write_input = TRUE;
   prev->pass_alloc = TRUE;
   prev->n_lines = 1;
   prev->stride = convert->current_pstride * convert->current_width;
-  gst_line_cache_set_need_line_func (convert->alpha_lines,
-      do_alpha_lines, convert, NULL);
+  gst_line_cache_set_need_line_func (prev, do_alpha_lines, convert, NULL);
 
   return prev;
 }
 
 static GstLineCache *
-chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev)
+chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev,
+    gint idx)
 {
   gboolean do_gamma;
 
@@ -1736,13 +2382,15 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev)
   if (do_gamma) {
     gint scale;
 
-    GST_DEBUG ("chain gamma encode");
-    setup_gamma_encode (convert, convert->pack_bits);
+    if (idx == 0) {
+      GST_DEBUG ("chain gamma encode");
+      setup_gamma_encode (convert, convert->pack_bits);
+    }
 
     convert->current_bits = convert->pack_bits;
     convert->current_pstride = convert->current_bits >> 1;
 
-    if (!convert->pack_rgb) {
+    if (idx == 0 && !convert->pack_rgb) {
       color_matrix_set_identity (&convert->to_YUV_matrix);
       compute_matrix_to_YUV (convert, &convert->to_YUV_matrix, FALSE);
 
@@ -1755,12 +2403,12 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev)
     }
     convert->current_format = convert->pack_format;
 
-    prev = convert->to_YUV_lines = gst_line_cache_new (prev);
+    prev = convert->to_YUV_lines[idx] = gst_line_cache_new (prev);
     prev->write_input = FALSE;
     prev->pass_alloc = FALSE;
     prev->n_lines = 1;
     prev->stride = convert->current_pstride * convert->current_width;
-    gst_line_cache_set_need_line_func (convert->to_YUV_lines,
+    gst_line_cache_set_need_line_func (prev,
         do_convert_to_YUV_lines, convert, NULL);
   }
 
@@ -1768,23 +2416,23 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev)
 }
 
 static GstLineCache *
-chain_downsample (GstVideoConverter * convert, GstLineCache * prev)
+chain_downsample (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
   if (convert->downsample_p || convert->downsample_i) {
     GST_DEBUG ("chain downsample");
-    prev = convert->downsample_lines = gst_line_cache_new (prev);
+    prev = convert->downsample_lines[idx] = gst_line_cache_new (prev);
     prev->write_input = TRUE;
     prev->pass_alloc = TRUE;
     prev->n_lines = 4;
     prev->stride = convert->current_pstride * convert->current_width;
-    gst_line_cache_set_need_line_func (convert->downsample_lines,
+    gst_line_cache_set_need_line_func (prev,
         do_downsample_lines, convert, NULL);
   }
   return prev;
 }
 
 static GstLineCache *
-chain_dither (GstVideoConverter * convert, GstLineCache * prev)
+chain_dither (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
   gint i;
   gboolean do_dither = FALSE;
@@ -1833,10 +2481,11 @@ chain_dither (GstVideoConverter * convert, GstLineCache * prev)
   if (do_dither) {
     GST_DEBUG ("chain dither");
 
-    convert->dither = gst_video_dither_new (method,
+    /* error diffusion keeps state, each thread needs its own ditherer */
+    convert->dither[idx] = gst_video_dither_new (method,
         flags, convert->pack_format, quant, convert->current_width);
 
-    prev = convert->dither_lines = gst_line_cache_new (prev);
+    prev = convert->dither_lines[idx] = gst_line_cache_new (prev);
     prev->write_input = TRUE;
     prev->pass_alloc = TRUE;
     prev->n_lines = 1;
@@ -1847,13 +2496,14 @@ chain_dither (GstVideoConverter * convert, GstLineCache * prev)
 }
 
 static GstLineCache *
-chain_pack (GstVideoConverter * convert, GstLineCache * prev)
+chain_pack (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
   convert->pack_nlines = convert->out_info.finfo->pack_lines;
   convert->pack_pstride = convert->current_pstride;
+  /* in tiled mode, lines are packed without the margins around the strip */
   convert->identity_pack =
       (convert->out_info.finfo->format ==
-      convert->out_info.finfo->unpack_format);
+      convert->out_info.finfo->unpack_format) && convert->tile_width == 0;
   GST_DEBUG ("chain pack line format %s, pstride %d, identity_pack %d (%d %d)",
       gst_video_format_to_string (convert->current_format),
       convert->current_pstride, convert->identity_pack,
@@ -1862,8 +2512,73 @@ chain_pack (GstVideoConverter * convert, GstLineCache * prev)
   return prev;
 }
 
+/* strips start at a multiple of this, it is a multiple of the pixel groups
+ * and the chroma subsampling of all the formats that can be tiled */
+#define TILE_ALIGN 48
+/* pixels converted on both sides of a strip so that the chroma resamplers
+ * see the same neighbours as when converting complete lines */
+#define TILE_MARGIN 16
+
+static gboolean
+format_can_tile (const GstVideoFormatInfo * finfo)
+{
+  gint i;
+
+  if (finfo->flags & (GST_VIDEO_FORMAT_FLAG_COMPLEX |
+          GST_VIDEO_FORMAT_FLAG_TILED | GST_VIDEO_FORMAT_FLAG_PALETTE))
+    return FALSE;
+
+  /* we need to be able to point to the first pixel of a strip */
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++)
+    if (GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i) == 0)
+      return FALSE;
+
+  return TRUE;
+}
+
+static void
+setup_tiling (GstVideoConverter * convert)
+{
+  guint tile_width;
+
+  tile_width = GET_OPT_TILE_WIDTH (convert);
+  if (tile_width == 0)
+    return;
+
+  tile_width = GST_ROUND_UP_N (tile_width, TILE_ALIGN);
+
+  if (tile_width >= convert->out_width) {
+    GST_DEBUG ("tile width %u covers the complete width", tile_width);
+    return;
+  }
+  /* the strips only map to each other without horizontal scaling */
+  if (convert->in_width != convert->out_width) {
+    GST_DEBUG ("can't use tiles with horizontal scaling");
+    return;
+  }
+  /* the left and right borders are packed together with the lines */
+  if (convert->fill_border && convert->out_width < convert->out_maxwidth) {
+    GST_DEBUG ("can't use tiles with left or right borders");
+    return;
+  }
+  if (convert->out_x % TILE_ALIGN) {
+    GST_DEBUG ("can't use tiles, dest x %d is not aligned", convert->out_x);
+    return;
+  }
+  if (!format_can_tile (convert->in_info.finfo) ||
+      !format_can_tile (convert->out_info.finfo)) {
+    GST_DEBUG ("can't use tiles with format %s -> %s",
+        GST_VIDEO_INFO_NAME (&convert->in_info),
+        GST_VIDEO_INFO_NAME (&convert->out_info));
+    return;
+  }
+
+  GST_DEBUG ("using tiles of %u pixels", tile_width);
+  convert->tile_width = tile_width;
+}
+
 static void
-setup_allocators (GstVideoConverter * convert)
+setup_allocators (GstVideoConverter * convert, gint idx)
 {
   GstLineCache *cache;
   GstLineCacheAllocLineFunc alloc_line;
@@ -1896,7 +2611,7 @@ setup_allocators (GstVideoConverter * convert)
 
   /* now walk backwards, we try to write into the dest lines directly
    * and keep track if the source needs to be writable */
-  for (cache = convert->pack_lines; cache; cache = cache->prev) {
+  for (cache = convert->pack_lines[idx]; cache; cache = cache->prev) {
     gst_line_cache_set_alloc_line_func (cache, alloc_line, user_data, notify);
     cache->alloc_writable = alloc_writable;
     n_lines = MAX (n_lines, cache->n_lines);
@@ -2053,6 +2768,7 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   GstLineCache *prev;
   const GstVideoFormatInfo *fin, *fout, *finfo;
   gdouble alpha_value;
+  gint n_threads, i;
 
   g_return_val_if_fail (in_info != NULL, NULL);
   g_return_val_if_fail (out_info != NULL, NULL);
@@ -2076,6 +2792,9 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
   if (config)
     gst_video_converter_set_config (convert, config);
 
+  /* reuse what previous converters with the same setup calculated */
+  convert->plan = converter_plan_get (in_info, out_info, convert->config);
+
   convert->in_maxwidth = GST_VIDEO_INFO_WIDTH (in_info);
   convert->in_maxheight = GST_VIDEO_INFO_HEIGHT (in_info);
   convert->out_maxwidth = GST_VIDEO_INFO_WIDTH (out_info);
@@ -2149,6 +2868,11 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
     convert->out_info.colorimetry.matrix = GST_VIDEO_COLOR_MATRIX_RGB;
   }
 
+  convert->conversion_runner =
+      gst_parallelized_task_runner_new ("videoconvert",
+      GET_OPT_THREADS (convert));
+  n_threads = convert->conversion_runner->n_threads;
+
   if (video_converter_lookup_fastpath (convert))
     goto done;
 
@@ -2160,38 +2884,91 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
 
   convert->convert = video_converter_generic;
 
-  convert->current_format = GST_VIDEO_INFO_FORMAT (in_info);
-  convert->current_width = convert->in_width;
-  convert->current_height = convert->in_height;
-
-  /* unpack */
-  prev = chain_unpack_line (convert);
-  /* upsample chroma */
-  prev = chain_upsample (convert, prev);
-  /* convert to gamma decoded RGB */
-  prev = chain_convert_to_RGB (convert, prev);
-  /* do all downscaling */
-  prev = chain_scale (convert, prev, FALSE);
-  /* do conversion between color spaces */
-  prev = chain_convert (convert, prev);
-  /* do alpha channels */
-  prev = chain_alpha (convert, prev);
-  /* do all remaining (up)scaling */
-  prev = chain_scale (convert, prev, TRUE);
-  /* convert to gamma encoded Y'Cb'Cr' */
-  prev = chain_convert_to_YUV (convert, prev);
-  /* downsample chroma */
-  prev = chain_downsample (convert, prev);
-  /* dither */
-  prev = chain_dither (convert, prev);
-  /* pack into final format */
-  convert->pack_lines = chain_pack (convert, prev);
+  setup_tiling (convert);
+  setup_color_lut (convert);
+
+  convert->unpack_lines = g_new0 (GstLineCache *, n_threads);
+  convert->upsample_lines = g_new0 (GstLineCache *, n_threads);
+  convert->to_RGB_lines = g_new0 (GstLineCache *, n_threads);
+  convert->hscale_lines = g_new0 (GstLineCache *, n_threads);
+  convert->vscale_lines = g_new0 (GstLineCache *, n_threads);
+  convert->convert_lines = g_new0 (GstLineCache *, n_threads);
+  convert->alpha_lines = g_new0 (GstLineCache *, n_threads);
+  convert->to_YUV_lines = g_new0 (GstLineCache *, n_threads);
+  convert->color_lut_lines = g_new0 (GstLineCache *, n_threads);
+  convert->downsample_lines = g_new0 (GstLineCache *, n_threads);
+  convert->dither_lines = g_new0 (GstLineCache *, n_threads);
+  convert->pack_lines = g_new0 (GstLineCache *, n_threads);
+  convert->h_scaler = g_new0 (GstVideoScaler *, n_threads);
+  convert->v_scaler_p = g_new0 (GstVideoScaler *, n_threads);
+  convert->v_scaler_i = g_new0 (GstVideoScaler *, n_threads);
+  convert->dither = g_new0 (GstVideoDither *, n_threads);
+
+  /* every thread gets its own chain of line caches, the shared tables and
+   * matrices are only computed when building the first one */
+  for (i = 0; i < n_threads; i++) {
+    convert->current_format = GST_VIDEO_INFO_FORMAT (in_info);
+    convert->current_width = convert->in_width;
+    convert->current_height = convert->in_height;
+
+    /* unpack */
+    prev = chain_unpack_line (convert, i);
+    /* upsample chroma */
+    prev = chain_upsample (convert, prev, i);
+    if (convert->color_lut.table) {
+      /* do the complete color conversion with the lookup table, there is
+       * no scaling */
+      prev = chain_color_lut (convert, prev, i);
+      /* do alpha channels */
+      prev = chain_alpha (convert, prev, i);
+    } else {
+      /* convert to gamma decoded RGB */
+      prev = chain_convert_to_RGB (convert, prev, i);
+      /* do all downscaling */
+      prev = chain_scale (convert, prev, FALSE, i);
+      /* do conversion between color spaces */
+      prev = chain_convert (convert, prev, i);
+      /* do alpha channels */
+      prev = chain_alpha (convert, prev, i);
+      /* do all remaining (up)scaling */
+      prev = chain_scale (convert, prev, TRUE, i);
+      /* convert to gamma encoded Y'Cb'Cr' */
+      prev = chain_convert_to_YUV (convert, prev, i);
+    }
+    /* downsample chroma */
+    prev = chain_downsample (convert, prev, i);
+    /* dither */
+    prev = chain_dither (convert, prev, i);
+    /* pack into final format */
+    convert->pack_lines[i] = chain_pack (convert, prev, i);
+  }
+
+  /* the ditherers keep their state for complete lines */
+  if (convert->tile_width && convert->dither[0]) {
+    GST_DEBUG ("can't use tiles with dithering");
+    convert->tile_width = 0;
+  }
+  if (convert->tile_width)
+    GST_INFO ("using generic path, tiles of %d pixels", convert->tile_width);
+  else
+    GST_INFO ("using generic path");
+
+  convert->path = gst_structure_new ("generic",
+      "tile-width", G_TYPE_INT, convert->tile_width,
+      "color-lut", G_TYPE_BOOLEAN, convert->color_lut.table != NULL,
+      "to-rgb-matrix", G_TYPE_STRING, matrix_name (&convert->to_RGB_matrix),
+      "matrix", G_TYPE_STRING, matrix_name (&convert->convert_matrix),
+      "to-yuv-matrix", G_TYPE_STRING, matrix_name (&convert->to_YUV_matrix),
+      NULL);
 
   setup_borderline (convert);
   /* now figure out allocators */
-  setup_allocators (convert);
+  for (i = 0; i < n_threads; i++)
+    setup_allocators (convert, i);
 
 done:
+  converter_plan_publish (convert->plan);
+
   return convert;
 
   /* ERRORS */
@@ -2230,10 +3007,55 @@ clear_matrix_data (MatrixData * data)
 void
 gst_video_converter_free (GstVideoConverter * convert)
 {
-  gint i;
+  guint i, j;
 
   g_return_if_fail (convert != NULL);
 
+  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+    if (convert->v_scaler_p && convert->v_scaler_p[i])
+      gst_video_scaler_free (convert->v_scaler_p[i]);
+    if (convert->v_scaler_i && convert->v_scaler_i[i])
+      gst_video_scaler_free (convert->v_scaler_i[i]);
+    if (convert->h_scaler && convert->h_scaler[i])
+      gst_video_scaler_free (convert->h_scaler[i]);
+
+    if (convert->unpack_lines && convert->unpack_lines[i])
+      gst_line_cache_free (convert->unpack_lines[i]);
+    if (convert->upsample_lines && convert->upsample_lines[i])
+      gst_line_cache_free (convert->upsample_lines[i]);
+    if (convert->to_RGB_lines && convert->to_RGB_lines[i])
+      gst_line_cache_free (convert->to_RGB_lines[i]);
+    if (convert->hscale_lines && convert->hscale_lines[i])
+      gst_line_cache_free (convert->hscale_lines[i]);
+    if (convert->vscale_lines && convert->vscale_lines[i])
+      gst_line_cache_free (convert->vscale_lines[i]);
+    if (convert->convert_lines && convert->convert_lines[i])
+      gst_line_cache_free (convert->convert_lines[i]);
+    if (convert->alpha_lines && convert->alpha_lines[i])
+      gst_line_cache_free (convert->alpha_lines[i]);
+    if (convert->to_YUV_lines && convert->to_YUV_lines[i])
+      gst_line_cache_free (convert->to_YUV_lines[i]);
+    if (convert->color_lut_lines && convert->color_lut_lines[i])
+      gst_line_cache_free (convert->color_lut_lines[i]);
+    if (convert->downsample_lines && convert->downsample_lines[i])
+      gst_line_cache_free (convert->downsample_lines[i]);
+    if (convert->dither_lines && convert->dither_lines[i])
+      gst_line_cache_free (convert->dither_lines[i]);
+
+    if (convert->dither && convert->dither[i])
+      gst_video_dither_free (convert->dither[i]);
+
+    if (convert->tmpline)
+      g_free (convert->tmpline[i]);
+
+    for (j = 0; j < 4; j++) {
+      if (convert->fv_scaler[j] && convert->fv_scaler[j][i])
+        gst_video_scaler_free (convert->fv_scaler[j][i]);
+      if (convert->fh_scaler[j] && convert->fh_scaler[j][i])
+        gst_video_scaler_free (convert->fh_scaler[j][i]);
+    }
+  }
+
   if (convert->upsample_p)
     gst_video_chroma_resample_free (convert->upsample_p);
   if (convert->upsample_i)
@@ -2242,56 +3064,53 @@ gst_video_converter_free (GstVideoConverter * convert)
     gst_video_chroma_resample_free (convert->downsample_p);
   if (convert->downsample_i)
     gst_video_chroma_resample_free (convert->downsample_i);
-  if (convert->v_scaler_p)
-    gst_video_scaler_free (convert->v_scaler_p);
-  if (convert->v_scaler_i)
-    gst_video_scaler_free (convert->v_scaler_i);
-  if (convert->h_scaler)
-    gst_video_scaler_free (convert->h_scaler);
-
-  if (convert->unpack_lines)
-    gst_line_cache_free (convert->unpack_lines);
-  if (convert->upsample_lines)
-    gst_line_cache_free (convert->upsample_lines);
-  if (convert->to_RGB_lines)
-    gst_line_cache_free (convert->to_RGB_lines);
-  if (convert->hscale_lines)
-    gst_line_cache_free (convert->hscale_lines);
-  if (convert->vscale_lines)
-    gst_line_cache_free (convert->vscale_lines);
-  if (convert->convert_lines)
-    gst_line_cache_free (convert->convert_lines);
-  if (convert->alpha_lines)
-    gst_line_cache_free (convert->alpha_lines);
-  if (convert->to_YUV_lines)
-    gst_line_cache_free (convert->to_YUV_lines);
-  if (convert->downsample_lines)
-    gst_line_cache_free (convert->downsample_lines);
-  if (convert->dither_lines)
-    gst_line_cache_free (convert->dither_lines);
-
-  if (convert->dither)
-    gst_video_dither_free (convert->dither);
-
-  g_free (convert->gamma_dec.gamma_table);
-  g_free (convert->gamma_enc.gamma_table);
+
+  g_free (convert->v_scaler_p);
+  g_free (convert->v_scaler_i);
+  g_free (convert->h_scaler);
+
+  g_free (convert->unpack_lines);
+  g_free (convert->pack_lines);
+  g_free (convert->upsample_lines);
+  g_free (convert->to_RGB_lines);
+  g_free (convert->hscale_lines);
+  g_free (convert->vscale_lines);
+  g_free (convert->convert_lines);
+  g_free (convert->alpha_lines);
+  g_free (convert->to_YUV_lines);
+  g_free (convert->color_lut_lines);
+  g_free (convert->downsample_lines);
+  g_free (convert->dither_lines);
+
+  g_free (convert->dither);
+
+  /* gamma tables are owned by the plan unless it was already shared */
+  if (convert->gamma_dec.gamma_table != convert->plan->gamma_dec_table)
+    g_free (convert->gamma_dec.gamma_table);
+  if (convert->gamma_enc.gamma_table != convert->plan->gamma_enc_table)
+    g_free (convert->gamma_enc.gamma_table);
+  if (convert->color_lut.table != convert->plan->color_lut_table)
+    g_free (convert->color_lut.table);
 
   g_free (convert->tmpline);
   g_free (convert->borderline);
 
   if (convert->config)
     gst_structure_free (convert->config);
+  if (convert->path)
+    gst_structure_free (convert->path);
 
   for (i = 0; i < 4; i++) {
-    if (convert->fv_scaler[i])
-      gst_video_scaler_free (convert->fv_scaler[i]);
-    if (convert->fh_scaler[i])
-      gst_video_scaler_free (convert->fh_scaler[i]);
+    g_free (convert->fv_scaler[i]);
+    g_free (convert->fh_scaler[i]);
   }
   clear_matrix_data (&convert->to_RGB_matrix);
   clear_matrix_data (&convert->convert_matrix);
   clear_matrix_data (&convert->to_YUV_matrix);
 
+  gst_parallelized_task_runner_free (convert->conversion_runner);
+  converter_plan_unref (convert->plan);
+
   g_slice_free (GstVideoConverter, convert);
 }
 
@@ -2502,8 +3321,8 @@ get_dest_line (GstLineCache * cache, gint idx, gpointer user_data)
 }
 
 static gboolean
-do_unpack_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_unpack_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   gpointer tmpline;
@@ -2527,8 +3346,8 @@ do_unpack_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_upsample_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_upsample_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines;
@@ -2542,7 +3361,9 @@ do_upsample_lines (GstLineCache * cache, gint out_line, gint in_line,
   }
 
   /* get the lines needed for chroma upsample */
-  lines = gst_line_cache_get_lines (cache->prev, out_line, start_line, n_lines);
+  lines =
+      gst_line_cache_get_lines (cache->prev, idx, out_line, start_line,
+      n_lines);
 
   if (convert->upsample) {
     GST_DEBUG ("doing upsample %d-%d %p", start_line, start_line + n_lines - 1,
@@ -2557,14 +3378,14 @@ do_upsample_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_convert_to_RGB_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_convert_to_RGB_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   MatrixData *data = &convert->to_RGB_matrix;
   gpointer *lines, destline;
 
-  lines = gst_line_cache_get_lines (cache->prev, out_line, in_line, 1);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
   if (data->matrix_func) {
@@ -2583,18 +3404,18 @@ do_convert_to_RGB_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_hscale_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_hscale_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines, destline;
 
-  lines = gst_line_cache_get_lines (cache->prev, out_line, in_line, 1);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
 
   destline = gst_line_cache_alloc_line (cache, out_line);
 
   GST_DEBUG ("hresample line %d %p->%p", in_line, lines[0], destline);
-  gst_video_scaler_horizontal (convert->h_scaler, convert->h_scale_format,
+  gst_video_scaler_horizontal (convert->h_scaler[idx], convert->h_scale_format,
       lines[0], destline, 0, convert->out_width);
 
   gst_line_cache_add_line (cache, in_line, destline);
@@ -2603,8 +3424,8 @@ do_hscale_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_vscale_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_vscale_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines, destline;
@@ -2613,15 +3434,16 @@ do_vscale_lines (GstLineCache * cache, gint out_line, gint in_line,
 
   cline = CLAMP (in_line, 0, convert->out_height - 1);
 
-  gst_video_scaler_get_coeff (convert->v_scaler, cline, &sline, &n_lines);
-  lines = gst_line_cache_get_lines (cache->prev, out_line, sline, n_lines);
+  gst_video_scaler_get_coeff (convert->v_scaler[idx], cline, &sline, &n_lines);
+  lines =
+      gst_line_cache_get_lines (cache->prev, idx, out_line, sline, n_lines);
 
   destline = gst_line_cache_alloc_line (cache, out_line);
 
   GST_DEBUG ("vresample line %d %d-%d %p->%p", in_line, sline,
       sline + n_lines - 1, lines[0], destline);
-  gst_video_scaler_vertical (convert->v_scaler, convert->v_scale_format, lines,
-      destline, cline, convert->v_scale_width);
+  gst_video_scaler_vertical (convert->v_scaler[idx], convert->v_scale_format,
+      lines, destline, cline, convert->v_scale_width);
 
   gst_line_cache_add_line (cache, in_line, destline);
 
@@ -2629,8 +3451,8 @@ do_vscale_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_convert_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_convert_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   MatrixData *data = &convert->convert_matrix;
@@ -2638,7 +3460,7 @@ do_convert_lines (GstLineCache * cache, gint out_line, gint in_line,
   guint in_bits, out_bits;
   gint width;
 
-  lines = gst_line_cache_get_lines (cache->prev, out_line, in_line, 1);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
 
   destline = lines[0];
 
@@ -2682,14 +3504,14 @@ do_convert_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_alpha_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_alpha_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   gpointer *lines, destline;
   GstVideoConverter *convert = user_data;
   gint width = MIN (convert->in_width, convert->out_width);
 
-  lines = gst_line_cache_get_lines (cache->prev, out_line, in_line, 1);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
   GST_DEBUG ("alpha line %d %p", in_line, destline);
@@ -2701,14 +3523,14 @@ do_alpha_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_convert_to_YUV_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_convert_to_YUV_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   MatrixData *data = &convert->to_YUV_matrix;
   gpointer *lines, destline;
 
-  lines = gst_line_cache_get_lines (cache->prev, out_line, in_line, 1);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
   if (convert->gamma_enc.gamma_func) {
@@ -2727,8 +3549,30 @@ do_convert_to_YUV_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_downsample_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_color_lut_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
+{
+  GstVideoConverter *convert = user_data;
+  gpointer *lines, destline;
+
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
+
+  if (cache->write_input)
+    destline = lines[0];
+  else
+    destline = gst_line_cache_alloc_line (cache, out_line);
+
+  GST_DEBUG ("color lookup line %d %p->%p", in_line, lines[0], destline);
+  convert->color_lut.lut_func (&convert->color_lut, destline, lines[0]);
+
+  gst_line_cache_add_line (cache, in_line, destline);
+
+  return TRUE;
+}
+
+static gboolean
+do_downsample_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines;
@@ -2740,7 +3584,9 @@ do_downsample_lines (GstLineCache * cache, gint out_line, gint in_line,
     start_line += convert->down_offset;
 
   /* get the lines needed for chroma downsample */
-  lines = gst_line_cache_get_lines (cache->prev, out_line, start_line, n_lines);
+  lines =
+      gst_line_cache_get_lines (cache->prev, idx, out_line, start_line,
+      n_lines);
 
   if (convert->downsample) {
     GST_DEBUG ("downsample line %d %d-%d %p", in_line, start_line,
@@ -2755,18 +3601,18 @@ do_downsample_lines (GstLineCache * cache, gint out_line, gint in_line,
 }
 
 static gboolean
-do_dither_lines (GstLineCache * cache, gint out_line, gint in_line,
-    gpointer user_data)
+do_dither_lines (GstLineCache * cache, gint idx, gint out_line,
+    gint in_line, gpointer user_data)
 {
   GstVideoConverter *convert = user_data;
   gpointer *lines, destline;
 
-  lines = gst_line_cache_get_lines (cache->prev, out_line, in_line, 1);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, in_line, 1);
   destline = lines[0];
 
-  if (convert->dither) {
+  if (convert->dither[idx]) {
     GST_DEBUG ("Dither line %d %p", in_line, destline);
-    gst_video_dither_line (convert->dither, destline, 0, out_line,
+    gst_video_dither_line (convert->dither[idx], destline, 0, out_line,
         convert->out_width);
   }
   gst_line_cache_add_line (cache, in_line, destline);
@@ -2774,6 +3620,96 @@ do_dither_lines (GstLineCache * cache, gint out_line, gint in_line,
   return TRUE;
 }
 
+typedef struct
+{
+  GstLineCache *pack_lines;
+  gint idx;
+  gint h_0, h_1;
+  gint pack_lines_count;
+  gint out_y;
+  gboolean identity_pack;
+  gint lb_width, out_maxwidth;
+  GstVideoFrame *dest;
+
+  /* tiled mode */
+  gpointer *tile_data;
+  gint tile_offset, tile_width;
+} ConvertTask;
+
+static void
+convert_generic_task (ConvertTask * task)
+{
+  GstLineCache *cache;
+  gint i;
+
+  /* forget the lines of the previous frame */
+  for (cache = task->pack_lines; cache; cache = cache->prev)
+    gst_line_cache_clear (cache);
+
+  for (i = task->h_0; i < task->h_1; i += task->pack_lines_count) {
+    gpointer *lines;
+
+    /* load the lines needed to pack */
+    lines =
+        gst_line_cache_get_lines (task->pack_lines, task->idx, i + task->out_y,
+        i, task->pack_lines_count);
+
+    if (task->tile_data) {
+      /* take away the margin and pack the strip */
+      guint8 *l = ((guint8 *) lines[0]) + task->tile_offset;
+      const GstVideoFormatInfo *finfo = task->dest->info.finfo;
+
+      GST_DEBUG ("pack strip line %d %p", i + task->out_y, l);
+      finfo->pack_func (finfo, (GST_VIDEO_FRAME_IS_INTERLACED (task->dest) ?
+              GST_VIDEO_PACK_FLAG_INTERLACED : GST_VIDEO_PACK_FLAG_NONE),
+          l, 0, task->tile_data, task->dest->info.stride,
+          task->dest->info.chroma_site, i + task->out_y, task->tile_width);
+    } else if (!task->identity_pack) {
+      /* take away the border */
+      guint8 *l = ((guint8 *) lines[0]) - task->lb_width;
+      /* and pack into destination */
+      GST_DEBUG ("pack line %d %p (%p)", i + task->out_y, lines[0], l);
+      PACK_FRAME (task->dest, l, i + task->out_y, task->out_maxwidth);
+    }
+  }
+}
+
+/* make the stages of the generic path convert @width pixels starting at
+ * @in_x, the input and output width are the same in tiled mode */
+static void
+converter_set_strip (GstVideoConverter * convert, gint in_x, gint width)
+{
+  convert->in_x = in_x;
+  convert->in_width = width;
+  convert->out_width = width;
+  convert->v_scale_width = width;
+  convert->to_RGB_matrix.width = width;
+  convert->convert_matrix.width = width;
+  convert->to_YUV_matrix.width = width;
+  convert->gamma_dec.width = width;
+  convert->gamma_enc.width = width;
+  convert->color_lut.width = width;
+}
+
+/* get the plane pointers of @frame so that pixel @x is the first one */
+static void
+get_strip_planes (GstVideoFrame * frame, gint x,
+    gpointer data[GST_VIDEO_MAX_PLANES])
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  gint i, plane;
+
+  for (i = 0; i < GST_VIDEO_MAX_PLANES; i++)
+    data[i] = frame->data[i];
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    plane = GST_VIDEO_FORMAT_INFO_PLANE (finfo, i);
+    data[plane] = (guint8 *) frame->data[plane] +
+        GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i, x) *
+        GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i);
+  }
+}
+
 static void
 video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
@@ -2783,6 +3719,10 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
   gint out_x, out_y, out_height;
   gint pack_lines, pstride;
   gint lb_width;
+  ConvertTask *tasks;
+  ConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
 
   out_height = convert->out_height;
   out_maxwidth = convert->out_maxwidth;
@@ -2831,20 +3771,65 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
   }
 
-  for (i = 0; i < out_height; i += pack_lines) {
-    gpointer *lines;
-
-    /* load the lines needed to pack */
-    lines = gst_line_cache_get_lines (convert->pack_lines, i + out_y,
-        i, pack_lines);
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (ConvertTask, n_threads);
+  tasks_p = g_newa (ConvertTask *, n_threads);
+
+  /* keep the bands aligned to a multiple of 4 lines so that chroma
+   * resampling and packing of (interlaced) subsampled formats never has to
+   * cross a band boundary */
+  lines_per_thread =
+      GST_ROUND_UP_N ((out_height + n_threads - 1) / n_threads,
+      MAX (pack_lines, 4));
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].dest = dest;
+    tasks[i].pack_lines = convert->pack_lines[i];
+    tasks[i].idx = i;
+    tasks[i].pack_lines_count = pack_lines;
+    tasks[i].out_y = out_y;
+    tasks[i].identity_pack = convert->identity_pack;
+    tasks[i].lb_width = lb_width;
+    tasks[i].out_maxwidth = out_maxwidth;
+
+    tasks[i].h_0 = MIN (i * lines_per_thread, out_height);
+    tasks[i].h_1 = MIN ((i + 1) * lines_per_thread, out_height);
+    tasks[i].tile_data = NULL;
+
+    tasks_p[i] = &tasks[i];
+  }
 
-    if (!convert->identity_pack) {
-      /* take away the border */
-      guint8 *l = ((guint8 *) lines[0]) - lb_width;
-      /* and pack into destination */
-      GST_DEBUG ("pack line %d %p (%p)", i + out_y, lines[0], l);
-      PACK_FRAME (dest, l, i + out_y, out_maxwidth);
+  if (convert->tile_width == 0) {
+    gst_parallelized_task_runner_run (convert->conversion_runner,
+        (GstParallelizedTaskFunc) convert_generic_task, (gpointer) tasks_p);
+  } else {
+    gpointer tile_data[GST_VIDEO_MAX_PLANES];
+    gint in_x, width, margin, x0, x1, ml, mr;
+
+    in_x = convert->in_x;
+    width = convert->out_width;
+    margin = (convert->upsample || convert->downsample) ? TILE_MARGIN : 0;
+
+    /* convert vertical strips so that the lines of all stages stay in
+     * the cache, all threads work on the same strip */
+    for (x0 = 0; x0 < width; x0 = x1) {
+      x1 = MIN (x0 + convert->tile_width, width);
+      ml = MIN (margin, x0);
+      mr = MIN (margin, width - x1);
+
+      GST_DEBUG ("strip %d-%d, margins %d %d", x0, x1, ml, mr);
+      converter_set_strip (convert, in_x + x0 - ml, x1 - x0 + ml + mr);
+      get_strip_planes (dest, out_x + x0, tile_data);
+
+      for (i = 0; i < n_threads; i++) {
+        tasks[i].tile_data = tile_data;
+        tasks[i].tile_offset = ml * pstride;
+        tasks[i].tile_width = x1 - x0;
+      }
+      gst_parallelized_task_runner_run (convert->conversion_runner,
+          (GstParallelizedTaskFunc) convert_generic_task, (gpointer) tasks_p);
     }
+    converter_set_strip (convert, in_x, width);
   }
 
   if (convert->borderline) {
@@ -2871,821 +3856,1432 @@ static void convert_fill_border (GstVideoConverter * convert,
       l2 = l1 + 1;                              \
     }
 
-static void
-convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+typedef struct
 {
-  int i;
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  gboolean interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src);
-  gint l1, l2;
+  const GstVideoFrame *src;
+  GstVideoFrame *dest;
+  gint height_0, height_1;
 
-  for (i = 0; i < GST_ROUND_DOWN_2 (height); i += 2) {
-    GET_LINE_OFFSETS (interlaced, i, l1, l2);
+  /* parameters */
+  gboolean interlaced;
+  gint width;
+  gint alpha;
+  MatrixData *data;
+  gint in_x, in_y;
+  gint out_x, out_y;
+  gpointer tmpline;
+  GstVideoDitherMethod dither;
+} FConvertTask;
 
-    video_orc_convert_I420_YUY2 (FRAME_GET_LINE (dest, l1),
-        FRAME_GET_LINE (dest, l2),
-        FRAME_GET_Y_LINE (src, l1),
-        FRAME_GET_Y_LINE (src, l2),
-        FRAME_GET_U_LINE (src, i >> 1),
-        FRAME_GET_V_LINE (src, i >> 1), (width + 1) / 2);
+/* split @height lines in bands of a multiple of @align lines, one for
+ * each thread, and run @func on all of them */
+static void
+convert_fast_run_tasks (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest, gint height, gint align,
+    GstParallelizedTaskFunc func)
+{
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint i, n_threads, lines_per_thread;
+  GstVideoDitherMethod dither;
+
+  n_threads = convert->conversion_runner->n_threads;
+  dither = GET_OPT_DITHER_METHOD (convert);
+  tasks = g_newa (FConvertTask, n_threads);
+  tasks_p = g_newa (FConvertTask *, n_threads);
+
+  lines_per_thread =
+      GST_ROUND_UP_N ((height + n_threads - 1) / n_threads, align);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src);
+    tasks[i].width = convert->in_width;
+    tasks[i].alpha = MIN (convert->alpha_value, 255);
+    tasks[i].data = &convert->convert_matrix;
+    tasks[i].in_x = convert->in_x;
+    tasks[i].in_y = convert->in_y;
+    tasks[i].out_x = convert->out_x;
+    tasks[i].out_y = convert->out_y;
+    tasks[i].tmpline = convert->tmpline[i];
+    tasks[i].dither = dither;
+
+    tasks[i].height_0 = MIN (i * lines_per_thread, height);
+    tasks[i].height_1 = MIN (tasks[i].height_0 + lines_per_thread, height);
+
+    tasks_p[i] = &tasks[i];
   }
 
-  /* now handle last line */
-  if (height & 1) {
-    UNPACK_FRAME (src, convert->tmpline, height - 1, convert->in_x, width);
-    PACK_FRAME (dest, convert->tmpline, height - 1, width);
-  }
+  gst_parallelized_task_runner_run (convert->conversion_runner, func,
+      (gpointer) tasks_p);
 }
 
+/* I420 has half as many chroma lines, as such we have to always merge two
+ * into one. For non-interlaced these are the two next to each other, for
+ * interlaced one is skipped in between so bands need to be aligned to 4
+ * lines to keep both lines of a field pair in the same band */
+#define I420_BAND_ALIGN(interlaced) ((interlaced) ? 4 : 2)
+
 static void
-convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_I420_YUY2_task (FConvertTask * task)
 {
-  int i;
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  gboolean interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src);
+  gint i;
   gint l1, l2;
 
-  for (i = 0; i < GST_ROUND_DOWN_2 (height); i += 2) {
-    GET_LINE_OFFSETS (interlaced, i, l1, l2);
-
-    video_orc_convert_I420_UYVY (FRAME_GET_LINE (dest, l1),
-        FRAME_GET_LINE (dest, l2),
-        FRAME_GET_Y_LINE (src, l1),
-        FRAME_GET_Y_LINE (src, l2),
-        FRAME_GET_U_LINE (src, i >> 1),
-        FRAME_GET_V_LINE (src, i >> 1), (width + 1) / 2);
-  }
+  for (i = task->height_0; i < task->height_1; i += 2) {
+    GET_LINE_OFFSETS (task->interlaced, i, l1, l2);
 
-  /* now handle last line */
-  if (height & 1) {
-    UNPACK_FRAME (src, convert->tmpline, height - 1, convert->in_x, width);
-    PACK_FRAME (dest, convert->tmpline, height - 1, width);
+    video_orc_convert_I420_YUY2 (FRAME_GET_LINE (task->dest, l1),
+        FRAME_GET_LINE (task->dest, l2),
+        FRAME_GET_Y_LINE (task->src, l1),
+        FRAME_GET_Y_LINE (task->src, l2),
+        FRAME_GET_U_LINE (task->src, i >> 1),
+        FRAME_GET_V_LINE (task->src, i >> 1), (task->width + 1) / 2);
   }
 }
 
 static void
-convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  int i;
   gint width = convert->in_width;
   gint height = convert->in_height;
-  gboolean interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src);
-  guint8 alpha = MIN (convert->alpha_value, 255);
-  gint l1, l2;
 
-  for (i = 0; i < GST_ROUND_DOWN_2 (height); i += 2) {
-    GET_LINE_OFFSETS (interlaced, i, l1, l2);
-
-    video_orc_convert_I420_AYUV (FRAME_GET_LINE (dest, l1),
-        FRAME_GET_LINE (dest, l2),
-        FRAME_GET_Y_LINE (src, l1),
-        FRAME_GET_Y_LINE (src, l2),
-        FRAME_GET_U_LINE (src, i >> 1), FRAME_GET_V_LINE (src, i >> 1),
-        alpha, width);
-  }
+  convert_fast_run_tasks (convert, src, dest, GST_ROUND_DOWN_2 (height),
+      I420_BAND_ALIGN (GST_VIDEO_FRAME_IS_INTERLACED (src)),
+      (GstParallelizedTaskFunc) convert_I420_YUY2_task);
 
   /* now handle last line */
   if (height & 1) {
-    UNPACK_FRAME (src, convert->tmpline, height - 1, convert->in_x, width);
-    if (alpha != 0xff)
-      convert_set_alpha_u8 (convert, convert->tmpline, width);
-    PACK_FRAME (dest, convert->tmpline, height - 1, width);
+    UNPACK_FRAME (src, convert->tmpline[0], height - 1, convert->in_x, width);
+    PACK_FRAME (dest, convert->tmpline[0], height - 1, width);
   }
 }
 
 static void
-convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_I420_UYVY_task (FConvertTask * task)
 {
-  int i;
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  gboolean interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src);
+  gint i;
   gint l1, l2;
 
-  for (i = 0; i < GST_ROUND_DOWN_2 (height); i += 2) {
-    GET_LINE_OFFSETS (interlaced, i, l1, l2);
+  for (i = task->height_0; i < task->height_1; i += 2) {
+    GET_LINE_OFFSETS (task->interlaced, i, l1, l2);
 
-    video_orc_convert_YUY2_I420 (FRAME_GET_Y_LINE (dest, l1),
-        FRAME_GET_Y_LINE (dest, l2),
-        FRAME_GET_U_LINE (dest, i >> 1),
-        FRAME_GET_V_LINE (dest, i >> 1),
-        FRAME_GET_LINE (src, l1), FRAME_GET_LINE (src, l2), (width + 1) / 2);
+    video_orc_convert_I420_UYVY (FRAME_GET_LINE (task->dest, l1),
+        FRAME_GET_LINE (task->dest, l2),
+        FRAME_GET_Y_LINE (task->src, l1),
+        FRAME_GET_Y_LINE (task->src, l2),
+        FRAME_GET_U_LINE (task->src, i >> 1),
+        FRAME_GET_V_LINE (task->src, i >> 1), (task->width + 1) / 2);
   }
+}
+
+static void
+convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+
+  convert_fast_run_tasks (convert, src, dest, GST_ROUND_DOWN_2 (height),
+      I420_BAND_ALIGN (GST_VIDEO_FRAME_IS_INTERLACED (src)),
+      (GstParallelizedTaskFunc) convert_I420_UYVY_task);
 
   /* now handle last line */
   if (height & 1) {
-    UNPACK_FRAME (src, convert->tmpline, height - 1, convert->in_x, width);
-    PACK_FRAME (dest, convert->tmpline, height - 1, width);
+    UNPACK_FRAME (src, convert->tmpline[0], height - 1, convert->in_x, width);
+    PACK_FRAME (dest, convert->tmpline[0], height - 1, width);
   }
 }
 
 static void
-convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_I420_AYUV_task (FConvertTask * task)
+{
+  gint i;
+  gint l1, l2;
+
+  for (i = task->height_0; i < task->height_1; i += 2) {
+    GET_LINE_OFFSETS (task->interlaced, i, l1, l2);
+
+    video_orc_convert_I420_AYUV (FRAME_GET_LINE (task->dest, l1),
+        FRAME_GET_LINE (task->dest, l2),
+        FRAME_GET_Y_LINE (task->src, l1),
+        FRAME_GET_Y_LINE (task->src, l2),
+        FRAME_GET_U_LINE (task->src, i >> 1),
+        FRAME_GET_V_LINE (task->src, i >> 1), task->alpha, task->width);
+  }
+}
+
+static void
+convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
   gint width = convert->in_width;
   gint height = convert->in_height;
-  guint8 *s, *d;
   guint8 alpha = MIN (convert->alpha_value, 255);
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (convert->out_x * 4);
+  convert_fast_run_tasks (convert, src, dest, GST_ROUND_DOWN_2 (height),
+      I420_BAND_ALIGN (GST_VIDEO_FRAME_IS_INTERLACED (src)),
+      (GstParallelizedTaskFunc) convert_I420_AYUV_task);
+
+  /* now handle last line */
+  if (height & 1) {
+    UNPACK_FRAME (src, convert->tmpline[0], height - 1, convert->in_x, width);
+    if (alpha != 0xff)
+      convert_set_alpha_u8 (convert, convert->tmpline[0], width);
+    PACK_FRAME (dest, convert->tmpline[0], height - 1, width);
+  }
+}
+
+static void
+convert_YUY2_I420_task (FConvertTask * task)
+{
+  gint i;
+  gint l1, l2;
 
-  video_orc_convert_YUY2_AYUV (d, FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), alpha, (width + 1) / 2, height);
+  for (i = task->height_0; i < task->height_1; i += 2) {
+    GET_LINE_OFFSETS (task->interlaced, i, l1, l2);
 
-  convert_fill_border (convert, dest);
+    video_orc_convert_YUY2_I420 (FRAME_GET_Y_LINE (task->dest, l1),
+        FRAME_GET_Y_LINE (task->dest, l2),
+        FRAME_GET_U_LINE (task->dest, i >> 1),
+        FRAME_GET_V_LINE (task->dest, i >> 1),
+        FRAME_GET_LINE (task->src, l1), FRAME_GET_LINE (task->src, l2),
+        (task->width + 1) / 2);
+  }
 }
 
 static void
-convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
   gint width = convert->in_width;
   gint height = convert->in_height;
-  guint8 *s, *dy, *du, *dv;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
+  convert_fast_run_tasks (convert, src, dest, GST_ROUND_DOWN_2 (height),
+      I420_BAND_ALIGN (GST_VIDEO_FRAME_IS_INTERLACED (src)),
+      (GstParallelizedTaskFunc) convert_YUY2_I420_task);
+
+  /* now handle last line */
+  if (height & 1) {
+    UNPACK_FRAME (src, convert->tmpline[0], height - 1, convert->in_x, width);
+    PACK_FRAME (dest, convert->tmpline[0], height - 1, width);
+  }
+}
+
+static void
+convert_YUY2_AYUV_task (FConvertTask * task)
+{
+  guint8 *s, *d;
 
-  dy = FRAME_GET_Y_LINE (dest, convert->out_y);
-  dy += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y);
-  du += convert->out_x >> 1;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y);
-  dv += convert->out_x >> 1;
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (task->out_x * 4);
 
-  video_orc_convert_YUY2_Y42B (dy, FRAME_GET_Y_STRIDE (dest), du,
-      FRAME_GET_U_STRIDE (dest), dv, FRAME_GET_V_STRIDE (dest),
-      s, FRAME_GET_STRIDE (src), (width + 1) / 2, height);
+  video_orc_convert_YUY2_AYUV (d, FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), task->alpha, (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_YUY2_AYUV_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_YUY2_Y42B_task (FConvertTask * task)
+{
+  guint8 *s, *dy, *du, *dv;
+
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
+
+  dy = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0);
+  dy += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, task->out_y + task->height_0);
+  du += task->out_x >> 1;
+  dv = FRAME_GET_V_LINE (task->dest, task->out_y + task->height_0);
+  dv += task->out_x >> 1;
+
+  video_orc_convert_YUY2_Y42B (dy, FRAME_GET_Y_STRIDE (task->dest), du,
+      FRAME_GET_U_STRIDE (task->dest), dv, FRAME_GET_V_STRIDE (task->dest),
+      s, FRAME_GET_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_YUY2_Y42B_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_YUY2_Y444_task (FConvertTask * task)
+{
   guint8 *s, *dy, *du, *dv;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
 
-  dy = FRAME_GET_Y_LINE (dest, convert->out_y);
-  dy += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y);
-  du += convert->out_x;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y);
-  dv += convert->out_x;
+  dy = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0);
+  dy += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, task->out_y + task->height_0);
+  du += task->out_x;
+  dv = FRAME_GET_V_LINE (task->dest, task->out_y + task->height_0);
+  dv += task->out_x;
 
   video_orc_convert_YUY2_Y444 (dy,
-      FRAME_GET_COMP_STRIDE (dest, 0), du,
-      FRAME_GET_COMP_STRIDE (dest, 1), dv,
-      FRAME_GET_COMP_STRIDE (dest, 2), s,
-      FRAME_GET_STRIDE (src), (width + 1) / 2, height);
+      FRAME_GET_COMP_STRIDE (task->dest, 0), du,
+      FRAME_GET_COMP_STRIDE (task->dest, 1), dv,
+      FRAME_GET_COMP_STRIDE (task->dest, 2), s,
+      FRAME_GET_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_YUY2_Y444_task);
 
   convert_fill_border (convert, dest);
 }
 
+static void
+convert_UYVY_I420_task (FConvertTask * task)
+{
+  gint i;
+  gint l1, l2;
+
+  for (i = task->height_0; i < task->height_1; i += 2) {
+    GET_LINE_OFFSETS (task->interlaced, i, l1, l2);
+
+    video_orc_convert_UYVY_I420 (FRAME_GET_COMP_LINE (task->dest, 0, l1),
+        FRAME_GET_COMP_LINE (task->dest, 0, l2),
+        FRAME_GET_COMP_LINE (task->dest, 1, i >> 1),
+        FRAME_GET_COMP_LINE (task->dest, 2, i >> 1),
+        FRAME_GET_LINE (task->src, l1), FRAME_GET_LINE (task->src, l2),
+        (task->width + 1) / 2);
+  }
+}
 
 static void
 convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  int i;
   gint width = convert->in_width;
   gint height = convert->in_height;
-  gboolean interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src);
-  gint l1, l2;
 
-  for (i = 0; i < GST_ROUND_DOWN_2 (height); i += 2) {
-    GET_LINE_OFFSETS (interlaced, i, l1, l2);
-
-    video_orc_convert_UYVY_I420 (FRAME_GET_COMP_LINE (dest, 0, l1),
-        FRAME_GET_COMP_LINE (dest, 0, l2),
-        FRAME_GET_COMP_LINE (dest, 1, i >> 1),
-        FRAME_GET_COMP_LINE (dest, 2, i >> 1),
-        FRAME_GET_LINE (src, l1), FRAME_GET_LINE (src, l2), (width + 1) / 2);
-  }
+  convert_fast_run_tasks (convert, src, dest, GST_ROUND_DOWN_2 (height),
+      I420_BAND_ALIGN (GST_VIDEO_FRAME_IS_INTERLACED (src)),
+      (GstParallelizedTaskFunc) convert_UYVY_I420_task);
 
   /* now handle last line */
   if (height & 1) {
-    UNPACK_FRAME (src, convert->tmpline, height - 1, convert->in_x, width);
-    PACK_FRAME (dest, convert->tmpline, height - 1, width);
+    UNPACK_FRAME (src, convert->tmpline[0], height - 1, convert->in_x, width);
+    PACK_FRAME (dest, convert->tmpline[0], height - 1, width);
   }
 }
 
 static void
-convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_UYVY_AYUV_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *d;
-  guint8 alpha = MIN (convert->alpha_value, 255);
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (convert->out_x * 4);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (task->out_x * 4);
 
   video_orc_convert_UYVY_AYUV (d,
-      FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), alpha, (width + 1) / 2, height);
+      FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), task->alpha, (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_UYVY_AYUV_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_UYVY_YUY2_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *d;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
 
   video_orc_convert_UYVY_YUY2 (d,
-      FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), (width + 1) / 2, height);
+      FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_UYVY_YUY2_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_UYVY_Y42B_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *dy, *du, *dv;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
 
-  dy = FRAME_GET_Y_LINE (dest, convert->out_y);
-  dy += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y);
-  du += convert->out_x >> 1;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y);
-  dv += convert->out_x >> 1;
+  dy = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0);
+  dy += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, task->out_y + task->height_0);
+  du += task->out_x >> 1;
+  dv = FRAME_GET_V_LINE (task->dest, task->out_y + task->height_0);
+  dv += task->out_x >> 1;
 
   video_orc_convert_UYVY_Y42B (dy,
-      FRAME_GET_Y_STRIDE (dest), du,
-      FRAME_GET_U_STRIDE (dest), dv,
-      FRAME_GET_V_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), (width + 1) / 2, height);
+      FRAME_GET_Y_STRIDE (task->dest), du,
+      FRAME_GET_U_STRIDE (task->dest), dv,
+      FRAME_GET_V_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_UYVY_Y42B_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_UYVY_Y444_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *dy, *du, *dv;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (GST_ROUND_UP_2 (convert->in_x) * 2);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (GST_ROUND_UP_2 (task->in_x) * 2);
 
-  dy = FRAME_GET_Y_LINE (dest, convert->out_y);
-  dy += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y);
-  du += convert->out_x;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y);
-  dv += convert->out_x;
+  dy = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0);
+  dy += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, task->out_y + task->height_0);
+  du += task->out_x;
+  dv = FRAME_GET_V_LINE (task->dest, task->out_y + task->height_0);
+  dv += task->out_x;
 
   video_orc_convert_UYVY_Y444 (dy,
-      FRAME_GET_Y_STRIDE (dest), du,
-      FRAME_GET_U_STRIDE (dest), dv,
-      FRAME_GET_V_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), (width + 1) / 2, height);
+      FRAME_GET_Y_STRIDE (task->dest), du,
+      FRAME_GET_U_STRIDE (task->dest), dv,
+      FRAME_GET_V_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_UYVY_Y444_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_UYVY_GRAY8_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint16 *s;
   guint8 *d;
 
-  s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
+  s = (guint16 *) FRAME_GET_LINE (task->src, task->height_0);
+  d = FRAME_GET_LINE (task->dest, task->height_0);
 
   video_orc_convert_UYVY_GRAY8 (d,
-      FRAME_GET_STRIDE (dest), s, FRAME_GET_STRIDE (src), width, height);
+      FRAME_GET_STRIDE (task->dest), s, FRAME_GET_STRIDE (task->src),
+      task->width, task->height_1 - task->height_0);
+}
+
+static void
+convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_UYVY_GRAY8_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_I420_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s1, *s2, *dy1, *dy2, *du, *dv;
 
-  s1 = FRAME_GET_LINE (src, convert->in_y + 0);
-  s1 += convert->in_x * 4;
-  s2 = FRAME_GET_LINE (src, convert->in_y + 1);
-  s2 += convert->in_x * 4;
+  s1 = FRAME_GET_LINE (task->src, task->in_y + task->height_0 + 0);
+  s1 += task->in_x * 4;
+  s2 = FRAME_GET_LINE (task->src, task->in_y + task->height_0 + 1);
+  s2 += task->in_x * 4;
 
-  dy1 = FRAME_GET_Y_LINE (dest, convert->out_y + 0);
-  dy1 += convert->out_x;
-  dy2 = FRAME_GET_Y_LINE (dest, convert->out_y + 1);
-  dy2 += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y >> 1);
-  du += convert->out_x >> 1;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y >> 1);
-  dv += convert->out_x >> 1;
+  dy1 = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0 + 0);
+  dy1 += task->out_x;
+  dy2 = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0 + 1);
+  dy2 += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, (task->out_y + task->height_0) >> 1);
+  du += task->out_x >> 1;
+  dv = FRAME_GET_V_LINE (task->dest, (task->out_y + task->height_0) >> 1);
+  dv += task->out_x >> 1;
 
   /* only for even width/height */
   video_orc_convert_AYUV_I420 (dy1,
-      2 * FRAME_GET_Y_STRIDE (dest), dy2,
-      2 * FRAME_GET_Y_STRIDE (dest), du,
-      FRAME_GET_U_STRIDE (dest), dv,
-      FRAME_GET_V_STRIDE (dest), s1,
-      2 * FRAME_GET_STRIDE (src), s2,
-      2 * FRAME_GET_STRIDE (src), width / 2, height / 2);
+      2 * FRAME_GET_Y_STRIDE (task->dest), dy2,
+      2 * FRAME_GET_Y_STRIDE (task->dest), du,
+      FRAME_GET_U_STRIDE (task->dest), dv,
+      FRAME_GET_V_STRIDE (task->dest), s1,
+      2 * FRAME_GET_STRIDE (task->src), s2,
+      2 * FRAME_GET_STRIDE (task->src), task->width / 2,
+      (task->height_1 - task->height_0) / 2);
+}
+
+static void
+convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 2,
+      (GstParallelizedTaskFunc) convert_AYUV_I420_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_YUY2_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *d;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += convert->in_x * 4;
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += task->in_x * 4;
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
 
   /* only for even width */
   video_orc_convert_AYUV_YUY2 (d,
-      FRAME_GET_STRIDE (dest), s, FRAME_GET_STRIDE (src), width / 2, height);
+      FRAME_GET_STRIDE (task->dest), s, FRAME_GET_STRIDE (task->src),
+      task->width / 2, task->height_1 - task->height_0);
+}
+
+static void
+convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_YUY2_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_UYVY_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *d;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += convert->in_x * 4;
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += task->in_x * 4;
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
 
   /* only for even width */
   video_orc_convert_AYUV_UYVY (d,
-      FRAME_GET_STRIDE (dest), s, FRAME_GET_STRIDE (src), width / 2, height);
+      FRAME_GET_STRIDE (task->dest), s, FRAME_GET_STRIDE (task->src),
+      task->width / 2, task->height_1 - task->height_0);
+}
+
+static void
+convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_UYVY_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_Y42B_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *dy, *du, *dv;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += convert->in_x * 4;
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += task->in_x * 4;
 
-  dy = FRAME_GET_Y_LINE (dest, convert->out_y);
-  dy += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y);
-  du += convert->out_x >> 1;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y);
-  dv += convert->out_x >> 1;
+  dy = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0);
+  dy += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, task->out_y + task->height_0);
+  du += task->out_x >> 1;
+  dv = FRAME_GET_V_LINE (task->dest, task->out_y + task->height_0);
+  dv += task->out_x >> 1;
 
   /* only works for even width */
   video_orc_convert_AYUV_Y42B (dy,
-      FRAME_GET_Y_STRIDE (dest), du,
-      FRAME_GET_U_STRIDE (dest), dv,
-      FRAME_GET_V_STRIDE (dest), s, FRAME_GET_STRIDE (src), width / 2, height);
+      FRAME_GET_Y_STRIDE (task->dest), du,
+      FRAME_GET_U_STRIDE (task->dest), dv,
+      FRAME_GET_V_STRIDE (task->dest), s, FRAME_GET_STRIDE (task->src),
+      task->width / 2, task->height_1 - task->height_0);
+}
+
+static void
+convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_Y42B_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_Y444_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *s, *dy, *du, *dv;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += convert->in_x * 4;
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += task->in_x * 4;
 
-  dy = FRAME_GET_Y_LINE (dest, convert->out_y);
-  dy += convert->out_x;
-  du = FRAME_GET_U_LINE (dest, convert->out_y);
-  du += convert->out_x;
-  dv = FRAME_GET_V_LINE (dest, convert->out_y);
-  dv += convert->out_x;
+  dy = FRAME_GET_Y_LINE (task->dest, task->out_y + task->height_0);
+  dy += task->out_x;
+  du = FRAME_GET_U_LINE (task->dest, task->out_y + task->height_0);
+  du += task->out_x;
+  dv = FRAME_GET_V_LINE (task->dest, task->out_y + task->height_0);
+  dv += task->out_x;
 
-  video_orc_convert_AYUV_Y444 (FRAME_GET_Y_LINE (dest, 0),
-      FRAME_GET_Y_STRIDE (dest), FRAME_GET_U_LINE (dest, 0),
-      FRAME_GET_U_STRIDE (dest), FRAME_GET_V_LINE (dest, 0),
-      FRAME_GET_V_STRIDE (dest), FRAME_GET_LINE (src, 0),
-      FRAME_GET_STRIDE (src), width, height);
+  video_orc_convert_AYUV_Y444 (dy,
+      FRAME_GET_Y_STRIDE (task->dest), du,
+      FRAME_GET_U_STRIDE (task->dest), dv,
+      FRAME_GET_V_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), task->width,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_Y444_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_Y42B_YUY2_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *sy, *su, *sv, *d;
 
-  sy = FRAME_GET_Y_LINE (src, convert->in_y);
-  sy += convert->in_x;
-  su = FRAME_GET_U_LINE (src, convert->in_y);
-  su += convert->in_x >> 1;
-  sv = FRAME_GET_V_LINE (src, convert->in_y);
-  sv += convert->in_x >> 1;
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y + task->height_0);
+  sy += task->in_x;
+  su = FRAME_GET_U_LINE (task->src, task->in_y + task->height_0);
+  su += task->in_x >> 1;
+  sv = FRAME_GET_V_LINE (task->src, task->in_y + task->height_0);
+  sv += task->in_x >> 1;
 
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
 
   video_orc_convert_Y42B_YUY2 (d,
-      FRAME_GET_STRIDE (dest), sy,
-      FRAME_GET_Y_STRIDE (src), su,
-      FRAME_GET_U_STRIDE (src), sv,
-      FRAME_GET_V_STRIDE (src), (width + 1) / 2, height);
+      FRAME_GET_STRIDE (task->dest), sy,
+      FRAME_GET_Y_STRIDE (task->src), su,
+      FRAME_GET_U_STRIDE (task->src), sv,
+      FRAME_GET_V_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_Y42B_YUY2_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_Y42B_UYVY_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *sy, *su, *sv, *d;
 
-  sy = FRAME_GET_Y_LINE (src, convert->in_y);
-  sy += convert->in_x;
-  su = FRAME_GET_U_LINE (src, convert->in_y);
-  su += convert->in_x >> 1;
-  sv = FRAME_GET_V_LINE (src, convert->in_y);
-  sv += convert->in_x >> 1;
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y + task->height_0);
+  sy += task->in_x;
+  su = FRAME_GET_U_LINE (task->src, task->in_y + task->height_0);
+  su += task->in_x >> 1;
+  sv = FRAME_GET_V_LINE (task->src, task->in_y + task->height_0);
+  sv += task->in_x >> 1;
 
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
 
   video_orc_convert_Y42B_UYVY (d,
-      FRAME_GET_STRIDE (dest), sy,
-      FRAME_GET_Y_STRIDE (src), su,
-      FRAME_GET_U_STRIDE (src), sv,
-      FRAME_GET_V_STRIDE (src), (width + 1) / 2, height);
+      FRAME_GET_STRIDE (task->dest), sy,
+      FRAME_GET_Y_STRIDE (task->src), su,
+      FRAME_GET_U_STRIDE (task->src), sv,
+      FRAME_GET_V_STRIDE (task->src), (task->width + 1) / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_Y42B_UYVY_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_Y42B_AYUV_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
   guint8 *sy, *su, *sv, *d;
-  guint8 alpha = MIN (convert->alpha_value, 255);
 
-  sy = FRAME_GET_Y_LINE (src, convert->in_y);
-  sy += convert->in_x;
-  su = FRAME_GET_U_LINE (src, convert->in_y);
-  su += convert->in_x >> 1;
-  sv = FRAME_GET_V_LINE (src, convert->in_y);
-  sv += convert->in_x >> 1;
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y + task->height_0);
+  sy += task->in_x;
+  su = FRAME_GET_U_LINE (task->src, task->in_y + task->height_0);
+  su += task->in_x >> 1;
+  sv = FRAME_GET_V_LINE (task->src, task->in_y + task->height_0);
+  sv += task->in_x >> 1;
 
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += convert->out_x * 4;
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += task->out_x * 4;
 
   /* only for even width */
   video_orc_convert_Y42B_AYUV (d,
-      FRAME_GET_STRIDE (dest), sy,
-      FRAME_GET_Y_STRIDE (src), su,
-      FRAME_GET_U_STRIDE (src), sv,
-      FRAME_GET_V_STRIDE (src), alpha, width / 2, height);
+      FRAME_GET_STRIDE (task->dest), sy,
+      FRAME_GET_Y_STRIDE (task->src), su,
+      FRAME_GET_U_STRIDE (task->src), sv,
+      FRAME_GET_V_STRIDE (task->src), task->alpha, task->width / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_Y42B_AYUV_task);
 
   convert_fill_border (convert, dest);
 }
 
+static void
+convert_Y444_YUY2_task (FConvertTask * task)
+{
+  guint8 *sy, *su, *sv, *d;
+
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y + task->height_0);
+  sy += task->in_x;
+  su = FRAME_GET_U_LINE (task->src, task->in_y + task->height_0);
+  su += task->in_x;
+  sv = FRAME_GET_V_LINE (task->src, task->in_y + task->height_0);
+  sv += task->in_x;
+
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
+
+  video_orc_convert_Y444_YUY2 (d,
+      FRAME_GET_STRIDE (task->dest), sy,
+      FRAME_GET_Y_STRIDE (task->src), su,
+      FRAME_GET_U_STRIDE (task->src), sv,
+      FRAME_GET_V_STRIDE (task->src), task->width / 2,
+      task->height_1 - task->height_0);
+}
+
 static void
 convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_Y444_YUY2_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_Y444_UYVY_task (FConvertTask * task)
+{
   guint8 *sy, *su, *sv, *d;
 
-  sy = FRAME_GET_Y_LINE (src, convert->in_y);
-  sy += convert->in_x;
-  su = FRAME_GET_U_LINE (src, convert->in_y);
-  su += convert->in_x;
-  sv = FRAME_GET_V_LINE (src, convert->in_y);
-  sv += convert->in_x;
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y + task->height_0);
+  sy += task->in_x;
+  su = FRAME_GET_U_LINE (task->src, task->in_y + task->height_0);
+  su += task->in_x;
+  sv = FRAME_GET_V_LINE (task->src, task->in_y + task->height_0);
+  sv += task->in_x;
 
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (GST_ROUND_UP_2 (task->out_x) * 2);
 
-  video_orc_convert_Y444_YUY2 (d,
-      FRAME_GET_STRIDE (dest), sy,
-      FRAME_GET_Y_STRIDE (src), su,
-      FRAME_GET_U_STRIDE (src), sv,
-      FRAME_GET_V_STRIDE (src), width / 2, height);
+  video_orc_convert_Y444_UYVY (d,
+      FRAME_GET_STRIDE (task->dest), sy,
+      FRAME_GET_Y_STRIDE (task->src), su,
+      FRAME_GET_U_STRIDE (task->src), sv,
+      FRAME_GET_V_STRIDE (task->src), task->width / 2,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_Y444_UYVY_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_Y444_AYUV_task (FConvertTask * task)
+{
+  guint8 *sy, *su, *sv, *d;
+
+  sy = FRAME_GET_Y_LINE (task->src, task->in_y + task->height_0);
+  sy += task->in_x;
+  su = FRAME_GET_U_LINE (task->src, task->in_y + task->height_0);
+  su += task->in_x;
+  sv = FRAME_GET_V_LINE (task->src, task->in_y + task->height_0);
+  sv += task->in_x;
+
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += task->out_x * 4;
+
+  video_orc_convert_Y444_AYUV (d,
+      FRAME_GET_STRIDE (task->dest), sy,
+      FRAME_GET_Y_STRIDE (task->src), su,
+      FRAME_GET_U_STRIDE (task->src), sv, FRAME_GET_V_STRIDE (task->src),
+      task->alpha, task->width, task->height_1 - task->height_0);
+}
+
+static void
+convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_Y444_AYUV_task);
+
+  convert_fill_border (convert, dest);
+}
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+static void
+convert_AYUV_ARGB_task (FConvertTask * task)
+{
+  MatrixData *data = task->data;
+  guint8 *s, *d;
+
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (task->in_x * 4);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (task->out_x * 4);
+
+  video_orc_convert_AYUV_ARGB (d, FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), data->im[0][0], data->im[0][2],
+      data->im[2][1], data->im[1][1], data->im[1][2], task->width,
+      task->height_1 - task->height_0);
+}
+
+static void
+convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_ARGB_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_BGRA_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  guint8 *sy, *su, *sv, *d;
-
-  sy = FRAME_GET_Y_LINE (src, convert->in_y);
-  sy += convert->in_x;
-  su = FRAME_GET_U_LINE (src, convert->in_y);
-  su += convert->in_x;
-  sv = FRAME_GET_V_LINE (src, convert->in_y);
-  sv += convert->in_x;
-
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (GST_ROUND_UP_2 (convert->out_x) * 2);
+  MatrixData *data = task->data;
+  guint8 *s, *d;
 
-  video_orc_convert_Y444_UYVY (d,
-      FRAME_GET_STRIDE (dest), sy,
-      FRAME_GET_Y_STRIDE (src), su,
-      FRAME_GET_U_STRIDE (src), sv,
-      FRAME_GET_V_STRIDE (src), width / 2, height);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (task->in_x * 4);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (task->out_x * 4);
 
-  convert_fill_border (convert, dest);
+  video_orc_convert_AYUV_BGRA (d, FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), data->im[0][0], data->im[0][2],
+      data->im[2][1], data->im[1][1], data->im[1][2], task->width,
+      task->height_1 - task->height_0);
 }
 
 static void
-convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  guint8 *sy, *su, *sv, *d;
-  guint8 alpha = MIN (convert->alpha_value, 255);
-
-  sy = FRAME_GET_Y_LINE (src, convert->in_y);
-  sy += convert->in_x;
-  su = FRAME_GET_U_LINE (src, convert->in_y);
-  su += convert->in_x;
-  sv = FRAME_GET_V_LINE (src, convert->in_y);
-  sv += convert->in_x;
-
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += convert->out_x * 4;
-
-  video_orc_convert_Y444_AYUV (d,
-      FRAME_GET_STRIDE (dest), sy,
-      FRAME_GET_Y_STRIDE (src), su,
-      FRAME_GET_U_STRIDE (src), sv, FRAME_GET_V_STRIDE (src), alpha, width,
-      height);
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_BGRA_task);
 
   convert_fill_border (convert, dest);
 }
 
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
 static void
-convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_ABGR_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
+  MatrixData *data = task->data;
   guint8 *s, *d;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (convert->in_x * 4);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (convert->out_x * 4);
-
-  video_orc_convert_AYUV_ARGB (d, FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), data->im[0][0], data->im[0][2],
-      data->im[2][1], data->im[1][1], data->im[1][2], width, height);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (task->in_x * 4);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (task->out_x * 4);
 
-  convert_fill_border (convert, dest);
+  video_orc_convert_AYUV_ABGR (d, FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), data->im[0][0], data->im[0][2],
+      data->im[2][1], data->im[1][1], data->im[1][2], task->width,
+      task->height_1 - task->height_0);
 }
 
 static void
-convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
-  guint8 *s, *d;
-
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (convert->in_x * 4);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (convert->out_x * 4);
-
-  video_orc_convert_AYUV_BGRA (d, FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), data->im[0][0], data->im[0][2],
-      data->im[2][1], data->im[1][1], data->im[1][2], width, height);
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_ABGR_task);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_AYUV_RGBA_task (FConvertTask * task)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
+  MatrixData *data = task->data;
   guint8 *s, *d;
 
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (convert->in_x * 4);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (convert->out_x * 4);
+  s = FRAME_GET_LINE (task->src, task->in_y + task->height_0);
+  s += (task->in_x * 4);
+  d = FRAME_GET_LINE (task->dest, task->out_y + task->height_0);
+  d += (task->out_x * 4);
 
-  video_orc_convert_AYUV_ABGR (d, FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), data->im[0][0], data->im[0][2],
-      data->im[2][1], data->im[1][1], data->im[1][2], width, height);
-
-  convert_fill_border (convert, dest);
+  video_orc_convert_AYUV_RGBA (d, FRAME_GET_STRIDE (task->dest), s,
+      FRAME_GET_STRIDE (task->src), data->im[0][0], data->im[0][2],
+      data->im[2][1], data->im[1][1], data->im[1][2], task->width,
+      task->height_1 - task->height_0);
 }
 
 static void
 convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
-  guint8 *s, *d;
-
-  s = FRAME_GET_LINE (src, convert->in_y);
-  s += (convert->in_x * 4);
-  d = FRAME_GET_LINE (dest, convert->out_y);
-  d += (convert->out_x * 4);
-
-  video_orc_convert_AYUV_RGBA (d, FRAME_GET_STRIDE (dest), s,
-      FRAME_GET_STRIDE (src), data->im[0][0], data->im[0][2],
-      data->im[2][1], data->im[1][1], data->im[1][2], width, height);
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_AYUV_RGBA_task);
 
   convert_fill_border (convert, dest);
 }
 #endif
 
 static void
-convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_I420_BGRA_task (FConvertTask * task)
 {
-  int i;
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
+  gint i;
+  MatrixData *data = task->data;
 
-  for (i = 0; i < height; i++) {
+  for (i = task->height_0; i < task->height_1; i++) {
     guint8 *sy, *su, *sv, *d;
 
-    d = FRAME_GET_LINE (dest, i + convert->out_y);
-    d += (convert->out_x * 4);
-    sy = FRAME_GET_Y_LINE (src, i + convert->in_y);
-    sy += convert->in_x;
-    su = FRAME_GET_U_LINE (src, (i + convert->in_y) >> 1);
-    su += (convert->in_x >> 1);
-    sv = FRAME_GET_V_LINE (src, (i + convert->in_y) >> 1);
-    sv += (convert->in_x >> 1);
+    d = FRAME_GET_LINE (task->dest, i + task->out_y);
+    d += (task->out_x * 4);
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    su = FRAME_GET_U_LINE (task->src, (i + task->in_y) >> 1);
+    su += (task->in_x >> 1);
+    sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
+    sv += (task->in_x >> 1);
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
     video_orc_convert_I420_BGRA (d, sy, su, sv,
         data->im[0][0], data->im[0][2],
-        data->im[2][1], data->im[1][1], data->im[1][2], width);
+        data->im[2][1], data->im[1][1], data->im[1][2], task->width);
 #else
     video_orc_convert_I420_ARGB (d, sy, su, sv,
         data->im[0][0], data->im[0][2],
-        data->im[2][1], data->im[1][1], data->im[1][2], width);
+        data->im[2][1], data->im[1][1], data->im[1][2], task->width);
 #endif
   }
-  convert_fill_border (convert, dest);
 }
 
 static void
-convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  int i;
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_I420_BGRA_task);
 
-  for (i = 0; i < height; i++) {
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_I420_ARGB_task (FConvertTask * task)
+{
+  gint i;
+  MatrixData *data = task->data;
+
+  for (i = task->height_0; i < task->height_1; i++) {
     guint8 *sy, *su, *sv, *d;
 
-    d = FRAME_GET_LINE (dest, i + convert->out_y);
-    d += (convert->out_x * 4);
-    sy = FRAME_GET_Y_LINE (src, i + convert->in_y);
-    sy += convert->in_x;
-    su = FRAME_GET_U_LINE (src, (i + convert->in_y) >> 1);
-    su += (convert->in_x >> 1);
-    sv = FRAME_GET_V_LINE (src, (i + convert->in_y) >> 1);
-    sv += (convert->in_x >> 1);
+    d = FRAME_GET_LINE (task->dest, i + task->out_y);
+    d += (task->out_x * 4);
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    su = FRAME_GET_U_LINE (task->src, (i + task->in_y) >> 1);
+    su += (task->in_x >> 1);
+    sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
+    sv += (task->in_x >> 1);
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
     video_orc_convert_I420_ARGB (d, sy, su, sv,
         data->im[0][0], data->im[0][2],
-        data->im[2][1], data->im[1][1], data->im[1][2], width);
+        data->im[2][1], data->im[1][1], data->im[1][2], task->width);
 #else
     video_orc_convert_I420_BGRA (d, sy, su, sv,
         data->im[0][0], data->im[0][2],
-        data->im[2][1], data->im[1][1], data->im[1][2], width);
+        data->im[2][1], data->im[1][1], data->im[1][2], task->width);
 #endif
   }
-  convert_fill_border (convert, dest);
 }
 
 static void
-convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
-  int i;
-  gint width = convert->in_width;
-  gint height = convert->in_height;
-  MatrixData *data = &convert->convert_matrix;
-  gpointer tmp = convert->tmpline;
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_I420_ARGB_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_I420_pack_ARGB_task (FConvertTask * task)
+{
+  gint i;
+  MatrixData *data = task->data;
+  gpointer tmp = task->tmpline;
   gpointer d[GST_VIDEO_MAX_PLANES];
-  gint pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (dest->info.finfo, 0);
+  gint pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (task->dest->info.finfo, 0);
 
-  d[0] = FRAME_GET_LINE (dest, 0);
-  d[0] = (guint8 *) d[0] + convert->out_x * pstride;
+  d[0] = FRAME_GET_LINE (task->dest, 0);
+  d[0] = (guint8 *) d[0] + task->out_x * pstride;
 
-  for (i = 0; i < height; i++) {
+  for (i = task->height_0; i < task->height_1; i++) {
     guint8 *sy, *su, *sv;
 
-    sy = FRAME_GET_Y_LINE (src, i + convert->in_y);
-    sy += convert->in_x;
-    su = FRAME_GET_U_LINE (src, (i + convert->in_y) >> 1);
-    su += (convert->in_x >> 1);
-    sv = FRAME_GET_V_LINE (src, (i + convert->in_y) >> 1);
-    sv += (convert->in_x >> 1);
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    su = FRAME_GET_U_LINE (task->src, (i + task->in_y) >> 1);
+    su += (task->in_x >> 1);
+    sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
+    sv += (task->in_x >> 1);
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
     video_orc_convert_I420_ARGB (tmp, sy, su, sv,
         data->im[0][0], data->im[0][2],
-        data->im[2][1], data->im[1][1], data->im[1][2], width);
+        data->im[2][1], data->im[1][1], data->im[1][2], task->width);
 #else
     video_orc_convert_I420_BGRA (tmp, sy, su, sv,
         data->im[0][0], data->im[0][2],
-        data->im[2][1], data->im[1][1], data->im[1][2], width);
+        data->im[2][1], data->im[1][1], data->im[1][2], task->width);
 #endif
-    dest->info.finfo->pack_func (dest->info.finfo,
-        (GST_VIDEO_FRAME_IS_INTERLACED (dest) ?
+    task->dest->info.finfo->pack_func (task->dest->info.finfo,
+        (GST_VIDEO_FRAME_IS_INTERLACED (task->dest) ?
             GST_VIDEO_PACK_FLAG_INTERLACED :
             GST_VIDEO_PACK_FLAG_NONE),
-        tmp, 0, d, dest->info.stride,
-        dest->info.chroma_site, i + convert->out_y, width);
+        tmp, 0, d, task->dest->info.stride,
+        task->dest->info.chroma_site, i + task->out_y, task->width);
+  }
+}
+
+static void
+convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_I420_pack_ARGB_task);
+
+  convert_fill_border (convert, dest);
+}
+
+/* 10 bit formats, these are converted in one pass without going through
+ * the 16 bit AYUV64 lines of the generic path */
+
+static void
+convert_P010_10LE_I420_10LE_task (FConvertTask * task)
+{
+  gint i, j, cwidth;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    const guint16 *s;
+    guint16 *d;
+
+    s = FRAME_GET_PLANE_LINE (task->src, 0, i + task->in_y);
+    s += task->in_x;
+    d = FRAME_GET_PLANE_LINE (task->dest, 0, i + task->out_y);
+    d += task->out_x;
+
+    for (j = 0; j < task->width; j++)
+      d[j] = GUINT16_TO_LE (GUINT16_FROM_LE (s[j]) >> 6);
+  }
+
+  /* bands are a multiple of 2 lines so each band has its own chroma lines */
+  cwidth = (task->width + 1) >> 1;
+  for (i = task->height_0 >> 1; i < (task->height_1 + 1) >> 1; i++) {
+    const guint16 *s;
+    guint16 *du, *dv;
+
+    s = FRAME_GET_PLANE_LINE (task->src, 1, i + (task->in_y >> 1));
+    s += (task->in_x >> 1) * 2;
+    du = FRAME_GET_PLANE_LINE (task->dest, 1, i + (task->out_y >> 1));
+    du += task->out_x >> 1;
+    dv = FRAME_GET_PLANE_LINE (task->dest, 2, i + (task->out_y >> 1));
+    dv += task->out_x >> 1;
+
+    for (j = 0; j < cwidth; j++) {
+      du[j] = GUINT16_TO_LE (GUINT16_FROM_LE (s[2 * j + 0]) >> 6);
+      dv[j] = GUINT16_TO_LE (GUINT16_FROM_LE (s[2 * j + 1]) >> 6);
+    }
+  }
+}
+
+static void
+convert_P010_10LE_I420_10LE (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 2,
+      (GstParallelizedTaskFunc) convert_P010_10LE_I420_10LE_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_I420_10LE_P010_10LE_task (FConvertTask * task)
+{
+  gint i, j, cwidth;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    const guint16 *s;
+    guint16 *d;
+
+    s = FRAME_GET_PLANE_LINE (task->src, 0, i + task->in_y);
+    s += task->in_x;
+    d = FRAME_GET_PLANE_LINE (task->dest, 0, i + task->out_y);
+    d += task->out_x;
+
+    for (j = 0; j < task->width; j++)
+      d[j] = GUINT16_TO_LE (GUINT16_FROM_LE (s[j]) << 6);
+  }
+
+  cwidth = (task->width + 1) >> 1;
+  for (i = task->height_0 >> 1; i < (task->height_1 + 1) >> 1; i++) {
+    const guint16 *su, *sv;
+    guint16 *d;
+
+    su = FRAME_GET_PLANE_LINE (task->src, 1, i + (task->in_y >> 1));
+    su += task->in_x >> 1;
+    sv = FRAME_GET_PLANE_LINE (task->src, 2, i + (task->in_y >> 1));
+    sv += task->in_x >> 1;
+    d = FRAME_GET_PLANE_LINE (task->dest, 1, i + (task->out_y >> 1));
+    d += (task->out_x >> 1) * 2;
+
+    for (j = 0; j < cwidth; j++) {
+      d[2 * j + 0] = GUINT16_TO_LE (GUINT16_FROM_LE (su[j]) << 6);
+      d[2 * j + 1] = GUINT16_TO_LE (GUINT16_FROM_LE (sv[j]) << 6);
+    }
+  }
+}
+
+static void
+convert_I420_10LE_P010_10LE (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 2,
+      (GstParallelizedTaskFunc) convert_I420_10LE_P010_10LE_task);
+
+  convert_fill_border (convert, dest);
+}
+
+/* 4x4 ordered dither matrix, used to drop the 2 lowest bits when going
+ * from 10 to 8 bits */
+static const guint8 dither_bayer_4x4[4][4] = {
+  {0, 8, 2, 10},
+  {12, 4, 14, 6},
+  {3, 11, 1, 9},
+  {15, 7, 13, 5}
+};
+
+static inline guint8
+dither_u10_u8 (guint v, guint bias)
+{
+  v = ((v & 0x3ff) << 2) + bias;
+  return MIN (v >> 4, 255);
+}
+
+static void
+convert_I420_10LE_NV12_task (FConvertTask * task)
+{
+  gint i, j, cwidth;
+  gboolean dither = task->dither != GST_VIDEO_DITHER_NONE;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    const guint16 *s;
+    const guint8 *b;
+    guint8 *d;
+
+    s = FRAME_GET_PLANE_LINE (task->src, 0, i + task->in_y);
+    s += task->in_x;
+    d = FRAME_GET_PLANE_LINE (task->dest, 0, i + task->out_y);
+    d += task->out_x;
+
+    if (dither) {
+      b = dither_bayer_4x4[i & 3];
+      for (j = 0; j < task->width; j++)
+        d[j] = dither_u10_u8 (GUINT16_FROM_LE (s[j]), b[j & 3]);
+    } else {
+      for (j = 0; j < task->width; j++)
+        d[j] = (GUINT16_FROM_LE (s[j]) & 0x3ff) >> 2;
+    }
+  }
+
+  /* bands are a multiple of 2 lines so each band has its own chroma lines */
+  cwidth = (task->width + 1) >> 1;
+  for (i = task->height_0 >> 1; i < (task->height_1 + 1) >> 1; i++) {
+    const guint16 *su, *sv;
+    const guint8 *b;
+    guint8 *d;
+
+    su = FRAME_GET_PLANE_LINE (task->src, 1, i + (task->in_y >> 1));
+    su += task->in_x >> 1;
+    sv = FRAME_GET_PLANE_LINE (task->src, 2, i + (task->in_y >> 1));
+    sv += task->in_x >> 1;
+    d = FRAME_GET_PLANE_LINE (task->dest, 1, i + (task->out_y >> 1));
+    d += (task->out_x >> 1) * 2;
+
+    if (dither) {
+      b = dither_bayer_4x4[i & 3];
+      for (j = 0; j < cwidth; j++) {
+        d[2 * j + 0] = dither_u10_u8 (GUINT16_FROM_LE (su[j]), b[j & 3]);
+        d[2 * j + 1] = dither_u10_u8 (GUINT16_FROM_LE (sv[j]), b[j & 3]);
+      }
+    } else {
+      for (j = 0; j < cwidth; j++) {
+        d[2 * j + 0] = (GUINT16_FROM_LE (su[j]) & 0x3ff) >> 2;
+        d[2 * j + 1] = (GUINT16_FROM_LE (sv[j]) & 0x3ff) >> 2;
+      }
+    }
+  }
+}
+
+static void
+convert_I420_10LE_NV12 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 2,
+      (GstParallelizedTaskFunc) convert_I420_10LE_NV12_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_v210_I422_10LE_task (FConvertTask * task)
+{
+  gint i, j, k;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    const guint8 *s;
+    guint16 *dy, *du, *dv;
+    guint16 y[6], u[3], v[3];
+
+    s = FRAME_GET_LINE (task->src, i + task->in_y);
+    dy = FRAME_GET_PLANE_LINE (task->dest, 0, i + task->out_y);
+    dy += task->out_x;
+    du = FRAME_GET_PLANE_LINE (task->dest, 1, i + task->out_y);
+    du += task->out_x >> 1;
+    dv = FRAME_GET_PLANE_LINE (task->dest, 2, i + task->out_y);
+    dv += task->out_x >> 1;
+
+    /* 6 pixels in 4 words */
+    for (j = 0; j < task->width; j += 6) {
+      guint32 a0, a1, a2, a3;
+
+      a0 = GST_READ_UINT32_LE (s + 0);
+      a1 = GST_READ_UINT32_LE (s + 4);
+      a2 = GST_READ_UINT32_LE (s + 8);
+      a3 = GST_READ_UINT32_LE (s + 12);
+      s += 16;
+
+      u[0] = (a0 >> 0) & 0x3ff;
+      y[0] = (a0 >> 10) & 0x3ff;
+      v[0] = (a0 >> 20) & 0x3ff;
+      y[1] = (a1 >> 0) & 0x3ff;
+      u[1] = (a1 >> 10) & 0x3ff;
+      y[2] = (a1 >> 20) & 0x3ff;
+      v[1] = (a2 >> 0) & 0x3ff;
+      y[3] = (a2 >> 10) & 0x3ff;
+      u[2] = (a2 >> 20) & 0x3ff;
+      y[4] = (a3 >> 0) & 0x3ff;
+      v[2] = (a3 >> 10) & 0x3ff;
+      y[5] = (a3 >> 20) & 0x3ff;
+
+      /* the width is even so the last group has 2, 4 or 6 pixels */
+      for (k = 0; k < 6 && j + k < task->width; k += 2) {
+        dy[j + k + 0] = GUINT16_TO_LE (y[k + 0]);
+        dy[j + k + 1] = GUINT16_TO_LE (y[k + 1]);
+        du[(j + k) >> 1] = GUINT16_TO_LE (u[k >> 1]);
+        dv[(j + k) >> 1] = GUINT16_TO_LE (v[k >> 1]);
+      }
+    }
+  }
+}
+
+static void
+convert_v210_I422_10LE (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_v210_I422_10LE_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_I422_10LE_v210_task (FConvertTask * task)
+{
+  gint i, j, k;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    const guint16 *sy, *su, *sv;
+    guint8 *d;
+    guint32 y[6], u[3], v[3];
+
+    sy = FRAME_GET_PLANE_LINE (task->src, 0, i + task->in_y);
+    sy += task->in_x;
+    su = FRAME_GET_PLANE_LINE (task->src, 1, i + task->in_y);
+    su += task->in_x >> 1;
+    sv = FRAME_GET_PLANE_LINE (task->src, 2, i + task->in_y);
+    sv += task->in_x >> 1;
+    d = FRAME_GET_LINE (task->dest, i + task->out_y);
+
+    for (j = 0; j < task->width; j += 6) {
+      /* the width is even so the last group has 2, 4 or 6 pixels, the
+       * missing pixels are filled with the last one like pack_v210 */
+      for (k = 0; k < 6; k += 2) {
+        if (j + k < task->width) {
+          y[k + 0] = GUINT16_FROM_LE (sy[j + k + 0]) & 0x3ff;
+          y[k + 1] = GUINT16_FROM_LE (sy[j + k + 1]) & 0x3ff;
+          u[k >> 1] = GUINT16_FROM_LE (su[(j + k) >> 1]) & 0x3ff;
+          v[k >> 1] = GUINT16_FROM_LE (sv[(j + k) >> 1]) & 0x3ff;
+        } else {
+          y[k + 0] = y[k + 1] = y[k - 1];
+          u[k >> 1] = u[(k >> 1) - 1];
+          v[k >> 1] = v[(k >> 1) - 1];
+        }
+      }
+
+      GST_WRITE_UINT32_LE (d + 0, u[0] | (y[0] << 10) | (v[0] << 20));
+      GST_WRITE_UINT32_LE (d + 4, y[1] | (u[1] << 10) | (y[2] << 20));
+      GST_WRITE_UINT32_LE (d + 8, v[1] | (y[3] << 10) | (u[2] << 20));
+      GST_WRITE_UINT32_LE (d + 12, y[4] | (v[2] << 10) | (y[5] << 20));
+      d += 16;
+    }
+  }
+}
+
+static void
+convert_I422_10LE_v210 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_I422_10LE_v210_task);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_P010_10LE_BGRA_task (FConvertTask * task)
+{
+  gint i, j, k;
+  MatrixData *data = task->data;
+  gint m[3][4];
+
+  /* the matrix goes from 16 bits AYUV64 to 8 bits RGB scaled by SCALE,
+   * make it take 10 bits samples and give 8 bits RGB in 16.16 fixed
+   * point */
+  for (k = 0; k < 3; k++) {
+    m[k][0] = rint (data->dm[k][0] * (1 << 14));
+    m[k][1] = rint (data->dm[k][1] * (1 << 14));
+    m[k][2] = rint (data->dm[k][2] * (1 << 14));
+    m[k][3] = rint (data->dm[k][3] * (1 << 8)) + (1 << 15);
+  }
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    const guint16 *sy, *suv;
+    guint8 *d;
+
+    sy = FRAME_GET_PLANE_LINE (task->src, 0, i + task->in_y);
+    sy += task->in_x;
+    suv = FRAME_GET_PLANE_LINE (task->src, 1, (i + task->in_y) >> 1);
+    suv += (task->in_x >> 1) * 2;
+    d = FRAME_GET_LINE (task->dest, i + task->out_y);
+    d += task->out_x * 4;
+
+    for (j = 0; j < task->width; j++) {
+      gint y, u, v, r, g, b;
+
+      y = GUINT16_FROM_LE (sy[j]) >> 6;
+      u = GUINT16_FROM_LE (suv[(j >> 1) * 2 + 0]) >> 6;
+      v = GUINT16_FROM_LE (suv[(j >> 1) * 2 + 1]) >> 6;
+
+      r = (m[0][0] * y + m[0][1] * u + m[0][2] * v + m[0][3]) >> 16;
+      g = (m[1][0] * y + m[1][1] * u + m[1][2] * v + m[1][3]) >> 16;
+      b = (m[2][0] * y + m[2][1] * u + m[2][2] * v + m[2][3]) >> 16;
+
+      d[4 * j + 0] = CLAMP (b, 0, 255);
+      d[4 * j + 1] = CLAMP (g, 0, 255);
+      d[4 * j + 2] = CLAMP (r, 0, 255);
+      d[4 * j + 3] = 0xff;
+    }
   }
+}
+
+static void
+convert_P010_10LE_BGRA (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_fast_run_tasks (convert, src, dest, convert->in_height, 1,
+      (GstParallelizedTaskFunc) convert_P010_10LE_BGRA_task);
+
   convert_fill_border (convert, dest);
 }
 
@@ -3836,143 +5432,149 @@ convert_fill_border (GstVideoConverter * convert, GstVideoFrame * dest)
 
 static void
 convert_plane_fill (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
-  guint8 *s, *d;
-  gint splane = convert->fsplane[plane];
+  guint8 *d;
 
-  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
-  s += convert->fin_x[splane];
-  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d += convert->fout_x[plane];
 
   video_orc_memset_2d (d, FRAME_GET_PLANE_STRIDE (dest, plane),
-      convert->ffill[plane],
-      convert->fout_width[plane], convert->fout_height[plane]);
+      convert->ffill[plane], convert->fout_width[plane], height);
 }
 
 static void
 convert_plane_h_double (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
   guint8 *s, *d;
   gint splane = convert->fsplane[plane];
 
-  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
+  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + y);
   s += convert->fin_x[splane];
-  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d += convert->fout_x[plane];
 
   video_orc_planar_chroma_422_444 (d,
       FRAME_GET_PLANE_STRIDE (dest, plane), s,
       FRAME_GET_PLANE_STRIDE (src, splane), convert->fout_width[plane] / 2,
-      convert->fout_height[plane]);
+      height);
 }
 
 static void
 convert_plane_h_halve (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
   guint8 *s, *d;
   gint splane = convert->fsplane[plane];
 
-  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
+  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + y);
   s += convert->fin_x[splane];
-  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d += convert->fout_x[plane];
 
   video_orc_planar_chroma_444_422 (d,
       FRAME_GET_PLANE_STRIDE (dest, plane), s,
       FRAME_GET_PLANE_STRIDE (src, splane), convert->fout_width[plane],
-      convert->fout_height[plane]);
+      height);
 }
 
 static void
 convert_plane_v_double (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
   guint8 *s, *d1, *d2;
   gint ds, splane = convert->fsplane[plane];
 
-  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
+  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + y / 2);
   s += convert->fin_x[splane];
-  d1 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d1 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d1 += convert->fout_x[plane];
-  d2 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + 1);
+  d2 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y + 1);
   d2 += convert->fout_x[plane];
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
   video_orc_planar_chroma_420_422 (d1, 2 * ds, d2, 2 * ds,
       s, FRAME_GET_PLANE_STRIDE (src, splane), convert->fout_width[plane],
-      convert->fout_height[plane] / 2);
+      height / 2);
 }
 
 static void
 convert_plane_v_halve (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
   guint8 *s1, *s2, *d;
   gint ss, ds, splane = convert->fsplane[plane];
 
-  s1 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
+  s1 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + y * 2);
   s1 += convert->fin_x[splane];
-  s2 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + 1);
+  s2 = FRAME_GET_PLANE_LINE (src, splane,
+      convert->fin_y[splane] + y * 2 + 1);
   s2 += convert->fin_x[splane];
-  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d += convert->fout_x[plane];
 
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
   video_orc_planar_chroma_422_420 (d, ds, s1, 2 * ss, s2, 2 * ss,
-      convert->fout_width[plane], convert->fout_height[plane]);
+      convert->fout_width[plane], height);
 }
 
 static void
 convert_plane_hv_double (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
   guint8 *s, *d1, *d2;
   gint ss, ds, splane = convert->fsplane[plane];
 
-  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
+  s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + y / 2);
   s += convert->fin_x[splane];
-  d1 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d1 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d1 += convert->fout_x[plane];
-  d2 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + 1);
+  d2 = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y + 1);
   d2 += convert->fout_x[plane];
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
   video_orc_planar_chroma_420_444 (d1, 2 * ds, d2, 2 * ds, s, ss,
-      (convert->fout_width[plane] + 1) / 2, convert->fout_height[plane] / 2);
+      (convert->fout_width[plane] + 1) / 2, height / 2);
 }
 
 static void
 convert_plane_hv_halve (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
   guint8 *s1, *s2, *d;
   gint ss, ds, splane = convert->fsplane[plane];
 
-  s1 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
+  s1 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + y * 2);
   s1 += convert->fin_x[splane];
-  s2 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane] + 1);
+  s2 = FRAME_GET_PLANE_LINE (src, splane,
+      convert->fin_y[splane] + y * 2 + 1);
   s2 += convert->fin_x[splane];
-  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
+  d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane] + y);
   d += convert->fout_x[plane];
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
   video_orc_planar_chroma_444_420 (d, ds, s1, 2 * ss, s2, 2 * ss,
-      convert->fout_width[plane], convert->fout_height[plane]);
+      convert->fout_width[plane], height);
 }
 
 static void
 convert_plane_hv (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest, gint plane)
+    const GstVideoFrame * src, GstVideoFrame * dest, gint plane, gint idx,
+    gint y, gint height)
 {
-  gint in_x, in_y, out_x, out_y, out_width, out_height;
+  gint in_x, in_y, out_x, out_y, out_width;
   GstVideoFormat format;
   GstVideoScaler *h_scaler, *v_scaler;
   gint splane = convert->fsplane[plane];
@@ -3983,11 +5585,10 @@ convert_plane_hv (GstVideoConverter * convert,
   out_x = convert->fout_x[plane];
   out_y = convert->fout_y[plane];
   out_width = convert->fout_width[plane];
-  out_height = convert->fout_height[plane];
   format = convert->fformat[plane];
 
-  h_scaler = convert->fh_scaler[plane];
-  v_scaler = convert->fv_scaler[plane];
+  h_scaler = convert->fh_scaler[plane] ? convert->fh_scaler[plane][idx] : NULL;
+  v_scaler = convert->fv_scaler[plane] ? convert->fv_scaler[plane][idx] : NULL;
 
   s = FRAME_GET_PLANE_LINE (src, splane, in_y);
   s += in_x;
@@ -3996,19 +5597,64 @@ convert_plane_hv (GstVideoConverter * convert,
 
   gst_video_scaler_2d (h_scaler, v_scaler, format,
       s, FRAME_GET_PLANE_STRIDE (src, splane),
-      d, FRAME_GET_PLANE_STRIDE (dest, plane), 0, 0, out_width, out_height);
+      d, FRAME_GET_PLANE_STRIDE (dest, plane), 0, y, out_width, height);
+}
+
+typedef struct
+{
+  GstVideoConverter *convert;
+  const GstVideoFrame *src;
+  GstVideoFrame *dest;
+  gint plane;
+  gint idx;
+  gint height_0, height_1;
+} FConvertPlaneTask;
+
+static void
+convert_scale_plane_task (FConvertPlaneTask * task)
+{
+  task->convert->fconvert[task->plane] (task->convert, task->src, task->dest,
+      task->plane, task->idx, task->height_0,
+      task->height_1 - task->height_0);
 }
 
 static void
 convert_scale_planes (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest)
 {
-  int i, n_planes;
+  int i, j, n_planes, n_threads, height, lines_per_thread;
+  FConvertPlaneTask *tasks;
+  FConvertPlaneTask **tasks_p;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (FConvertPlaneTask, n_threads);
+  tasks_p = g_newa (FConvertPlaneTask *, n_threads);
 
   n_planes = GST_VIDEO_FRAME_N_PLANES (dest);
   for (i = 0; i < n_planes; i++) {
-    if (convert->fconvert[i])
-      convert->fconvert[i] (convert, src, dest, i);
+    if (!convert->fconvert[i])
+      continue;
+
+    /* the doubling functions produce lines in pairs */
+    height = convert->fout_height[i];
+    lines_per_thread =
+        GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+    for (j = 0; j < n_threads; j++) {
+      tasks[j].convert = convert;
+      tasks[j].src = src;
+      tasks[j].dest = dest;
+      tasks[j].plane = i;
+      tasks[j].idx = j;
+      tasks[j].height_0 = MIN (j * lines_per_thread, height);
+      tasks[j].height_1 = MIN (tasks[j].height_0 + lines_per_thread, height);
+
+      tasks_p[j] = &tasks[j];
+    }
+
+    gst_parallelized_task_runner_run (convert->conversion_runner,
+        (GstParallelizedTaskFunc) convert_scale_plane_task,
+        (gpointer) tasks_p);
   }
   convert_fill_border (convert, dest);
 }
@@ -4118,7 +5764,7 @@ is_merge_yuv (GstVideoInfo * info)
 static gboolean
 setup_scale (GstVideoConverter * convert)
 {
-  int i, n_planes;
+  int i, j, n_planes, n_threads;
   gint method, cr_method, stride, in_width, in_height, out_width, out_height;
   guint taps;
   GstVideoInfo *in_info, *out_info;
@@ -4132,6 +5778,7 @@ setup_scale (GstVideoConverter * convert)
   out_finfo = out_info->finfo;
 
   n_planes = GST_VIDEO_INFO_N_PLANES (out_info);
+  n_threads = convert->conversion_runner->n_threads;
 
   method = GET_OPT_RESAMPLER_METHOD (convert);
   if (method == GST_VIDEO_RESAMPLER_METHOD_NEAREST)
@@ -4177,24 +5824,29 @@ setup_scale (GstVideoConverter * convert)
       GstVideoScaler *y_scaler, *uv_scaler;
 
       if (in_width != out_width) {
-        y_scaler =
-            gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
-            GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_Y,
-                in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo,
-                GST_VIDEO_COMP_Y, out_width), convert->config);
-        uv_scaler =
-            gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE,
-            gst_video_scaler_get_max_taps (y_scaler),
-            GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_U,
-                in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo,
-                GST_VIDEO_COMP_U, out_width), convert->config);
-
-        convert->fh_scaler[0] =
-            gst_video_scaler_combine_packed_YUV (y_scaler, uv_scaler,
-            in_format, out_format);
-
-        gst_video_scaler_free (y_scaler);
-        gst_video_scaler_free (uv_scaler);
+        convert->fh_scaler[0] = g_new (GstVideoScaler *, n_threads);
+        for (j = 0; j < n_threads; j++) {
+          y_scaler =
+              converter_plan_get_scaler (convert, method,
+              GST_VIDEO_SCALER_FLAG_NONE, taps,
+              GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_Y,
+                  in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo,
+                  GST_VIDEO_COMP_Y, out_width), convert->config);
+          uv_scaler =
+              converter_plan_get_scaler (convert, method,
+              GST_VIDEO_SCALER_FLAG_NONE,
+              gst_video_scaler_get_max_taps (y_scaler),
+              GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (in_finfo, GST_VIDEO_COMP_U,
+                  in_width), GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (out_finfo,
+                  GST_VIDEO_COMP_U, out_width), convert->config);
+
+          convert->fh_scaler[0][j] =
+              gst_video_scaler_combine_packed_YUV (y_scaler, uv_scaler,
+              in_format, out_format);
+
+          gst_video_scaler_free (y_scaler);
+          gst_video_scaler_free (uv_scaler);
+        }
       } else
         convert->fh_scaler[0] = NULL;
 
@@ -4203,11 +5855,15 @@ setup_scale (GstVideoConverter * convert)
       convert->fout_x[0] = GST_ROUND_UP_2 (convert->out_x) * pstride;
 
     } else {
-      if (in_width != out_width && in_width != 0 && out_width != 0)
-        convert->fh_scaler[0] =
-            gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
-            in_width, out_width, convert->config);
-      else
+      if (in_width != out_width && in_width != 0 && out_width != 0) {
+        convert->fh_scaler[0] = g_new (GstVideoScaler *, n_threads);
+        for (j = 0; j < n_threads; j++) {
+          convert->fh_scaler[0][j] =
+              converter_plan_get_scaler (convert, method,
+              GST_VIDEO_SCALER_FLAG_NONE, taps, in_width, out_width,
+              convert->config);
+        }
+      } else
         convert->fh_scaler[0] = NULL;
 
       pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (out_finfo, GST_VIDEO_COMP_R);
@@ -4218,9 +5874,13 @@ setup_scale (GstVideoConverter * convert)
     stride = MAX (stride, GST_VIDEO_INFO_PLANE_STRIDE (out_info, 0));
 
     if (in_height != out_height && in_height != 0 && out_height != 0) {
-      convert->fv_scaler[0] =
-          gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
-          in_height, out_height, convert->config);
+      convert->fv_scaler[0] = g_new (GstVideoScaler *, n_threads);
+      for (j = 0; j < n_threads; j++) {
+        convert->fv_scaler[0][j] =
+            converter_plan_get_scaler (convert, method,
+            GST_VIDEO_SCALER_FLAG_NONE, taps, in_height, out_height,
+            convert->config);
+      }
     } else {
       convert->fv_scaler[0] = NULL;
     }
@@ -4234,7 +5894,7 @@ setup_scale (GstVideoConverter * convert)
     convert->fsplane[0] = 0;
   } else {
     for (i = 0; i < n_planes; i++) {
-      gint comp, n_comp, j, iw, ih, ow, oh, pstride;
+      gint comp, n_comp, iw, ih, ow, oh, pstride;
       gboolean need_v_scaler, need_h_scaler;
       GstStructure *config;
       gint resample_method;
@@ -4359,14 +6019,22 @@ setup_scale (GstVideoConverter * convert)
       }
 
       if (need_h_scaler && iw != 0 && ow != 0) {
-        convert->fh_scaler[i] = gst_video_scaler_new (resample_method,
-            GST_VIDEO_SCALER_FLAG_NONE, taps, iw, ow, config);
+        convert->fh_scaler[i] = g_new (GstVideoScaler *, n_threads);
+        for (j = 0; j < n_threads; j++) {
+          convert->fh_scaler[i][j] = converter_plan_get_scaler (convert,
+              resample_method, GST_VIDEO_SCALER_FLAG_NONE, taps, iw, ow,
+              config);
+        }
       } else
         convert->fh_scaler[i] = NULL;
 
       if (need_v_scaler && ih != 0 && oh != 0) {
-        convert->fv_scaler[i] = gst_video_scaler_new (resample_method,
-            GST_VIDEO_SCALER_FLAG_NONE, taps, ih, oh, config);
+        convert->fv_scaler[i] = g_new (GstVideoScaler *, n_threads);
+        for (j = 0; j < n_threads; j++) {
+          convert->fv_scaler[i][j] = converter_plan_get_scaler (convert,
+              resample_method, GST_VIDEO_SCALER_FLAG_NONE, taps, ih, oh,
+              config);
+        }
       } else
         convert->fv_scaler[i] = NULL;
 
@@ -4758,6 +6426,22 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_BGR16, FALSE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_pack_ARGB},
 
+  /* 10 bits */
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_P010_10LE_I420_10LE},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_10LE_P010_10LE},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE,
+      TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_10LE_NV12},
+  {GST_VIDEO_FORMAT_v210, GST_VIDEO_FORMAT_I422_10LE, TRUE, FALSE, TRUE,
+      FALSE, TRUE, FALSE, FALSE, FALSE, 1, 0, convert_v210_I422_10LE},
+  {GST_VIDEO_FORMAT_I422_10LE, GST_VIDEO_FORMAT_v210, TRUE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, FALSE, 1, 0, convert_I422_10LE_v210},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_BGRA, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_P010_10LE_BGRA},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_BGRx, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_P010_10LE_BGRA},
+
   /* scalers */
   {GST_VIDEO_FORMAT_GBR, GST_VIDEO_FORMAT_GBR, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -4814,7 +6498,7 @@ static const VideoTransform transforms[] = {
 static gboolean
 video_converter_lookup_fastpath (GstVideoConverter * convert)
 {
-  int i;
+  int i, j, n_threads;
   GstVideoFormat in_format, out_format;
   GstVideoTransferFunction in_transf, out_transf;
   gboolean interlaced, same_matrix, same_primaries, same_size, crop, border;
@@ -4823,6 +6507,7 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
 
   width = GST_VIDEO_INFO_WIDTH (&convert->in_info);
   height = GST_VIDEO_INFO_HEIGHT (&convert->in_info);
+  n_threads = convert->conversion_runner->n_threads;
 
   if (GET_OPT_DITHER_QUANTIZATION (convert) != 1)
     return FALSE;
@@ -4875,32 +6560,73 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       || convert->out_width < convert->out_maxwidth
       || convert->out_height < convert->out_maxheight;
 
-  for (i = 0; i < sizeof (transforms) / sizeof (transforms[0]); i++) {
-    if (transforms[i].in_format == in_format &&
-        transforms[i].out_format == out_format &&
-        (transforms[i].keeps_interlaced || !interlaced) &&
-        (transforms[i].needs_color_matrix || (same_matrix && same_primaries))
-        && (!transforms[i].keeps_size || same_size)
-        && (transforms[i].width_align & width) == 0
-        && (transforms[i].height_align & height) == 0
-        && (transforms[i].do_crop || !crop)
-        && (transforms[i].do_border || !border)
-        && (transforms[i].alpha_copy || !need_copy)
-        && (transforms[i].alpha_set || !need_set)
-        && (transforms[i].alpha_mult || !need_mult)) {
-      GST_DEBUG ("using fastpath");
-      if (transforms[i].needs_color_matrix)
-        video_converter_compute_matrix (convert);
-      convert->convert = transforms[i].convert;
-      convert->tmpline = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
-      if (!transforms[i].keeps_size)
-        if (!setup_scale (convert))
-          return FALSE;
-      if (border)
-        setup_borderline (convert);
-      return TRUE;
+  if (convert->plan->complete) {
+    /* we already know what fastpath to use, if any */
+    i = convert->plan->fastpath;
+  } else {
+    for (i = 0; i < G_N_ELEMENTS (transforms); i++) {
+      if (transforms[i].in_format == in_format &&
+          transforms[i].out_format == out_format &&
+          (transforms[i].keeps_interlaced || !interlaced) &&
+          (transforms[i].needs_color_matrix || (same_matrix && same_primaries))
+          && (!transforms[i].keeps_size || same_size)
+          && (transforms[i].width_align & width) == 0
+          && (transforms[i].height_align & height) == 0
+          && (transforms[i].do_crop || !crop)
+          && (transforms[i].do_border || !border)
+          && (transforms[i].alpha_copy || !need_copy)
+          && (transforms[i].alpha_set || !need_set)
+          && (transforms[i].alpha_mult || !need_mult))
+        break;
     }
+    if (i == G_N_ELEMENTS (transforms))
+      i = -1;
+    convert->plan->fastpath = i;
+  }
+
+  if (i < 0) {
+    GST_DEBUG ("no fastpath found");
+    return FALSE;
   }
-  GST_DEBUG ("no fastpath found");
-  return FALSE;
+
+  GST_INFO ("using fastpath %d, %s -> %s", i,
+      gst_video_format_to_string (in_format),
+      gst_video_format_to_string (out_format));
+  if (transforms[i].needs_color_matrix)
+    video_converter_compute_matrix (convert);
+  convert->convert = transforms[i].convert;
+  convert->tmpline = g_new (guint16 *, n_threads);
+  for (j = 0; j < n_threads; j++)
+    convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
+  if (!transforms[i].keeps_size)
+    if (!setup_scale (convert))
+      return FALSE;
+  if (border)
+    setup_borderline (convert);
+
+  convert->path = gst_structure_new ("fastpath",
+      "index", G_TYPE_INT, i,
+      "matrix", G_TYPE_STRING, matrix_name (&convert->convert_matrix), NULL);
+
+  return TRUE;
+}
+
+/* Only for the unit tests and benchmarks. Returns a structure named
+ * "fastpath" or "generic" that describes how @convert converts frames. */
+const GstStructure *
+_gst_video_converter_get_path (GstVideoConverter * convert)
+{
+  g_return_val_if_fail (convert != NULL, NULL);
+
+  return convert->path;
+}
+
+/* Only for the unit tests. Converters made for the same setup return the
+ * same plan while it is cached. */
+gconstpointer
+_gst_video_converter_get_plan (GstVideoConverter * convert)
+{
+  g_return_val_if_fail (convert != NULL, NULL);
+
+  return convert->plan;
 }
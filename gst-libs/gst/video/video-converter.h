@@ -265,6 +265,53 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE   "GstVideoConverter.primaries-mode"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_THREADS:
+ *
+ * #G_TYPE_UINT, maximum number of threads to use. Default 1, 0 for the number
+ * of cores.
+ *
+ * Since: 1.12
+ */
+#define GST_VIDEO_CONVERTER_OPT_THREADS   "GstVideoConverter.threads"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_TILE_WIDTH:
+ *
+ * #G_TYPE_UINT, convert the image in vertical strips of this many pixels
+ * so that the intermediate lines stay in the CPU cache. Only used for
+ * conversions without a fast path, horizontal scaling or dithering.
+ * Default 0, convert complete lines.
+ *
+ * Since: 1.12
+ */
+#define GST_VIDEO_CONVERTER_OPT_TILE_WIDTH   "GstVideoConverter.tile-width"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_COLOR_LUT_SIZE:
+ *
+ * #G_TYPE_UINT, number of points on each axis of a 3D lookup table that
+ * does the complete color conversion, including gamma remapping and
+ * primaries conversion. The table is only used when gamma remapping or
+ * primaries conversion is needed and the image is not scaled.
+ * Default 0, no lookup table. 17 and 33 are good values.
+ *
+ * Since: 1.12
+ */
+#define GST_VIDEO_CONVERTER_OPT_COLOR_LUT_SIZE   "GstVideoConverter.color-lut-size"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_FAST_MATRIX:
+ *
+ * #G_TYPE_BOOLEAN, use the SIMD 8 bit color matrix for 8 bit conversions
+ * that keep the middle of the value range in place, such as conversions
+ * between YUV color matrices. Its results can be off by 1, rarely 2, from
+ * the exact conversion. Default %FALSE.
+ *
+ * Since: 1.12
+ */
+#define GST_VIDEO_CONVERTER_OPT_FAST_MATRIX   "GstVideoConverter.fast-matrix"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
 GstVideoConverter *  gst_video_converter_new            (GstVideoInfo *in_info,
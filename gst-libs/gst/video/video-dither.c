@@ -246,6 +246,27 @@ static const guint16 bayer_map[16][16] = {
   {255, 145, 223, 95, 247, 119, 215, 87, 253, 143, 221, 93, 245, 117, 213, 85}
 };
 
+/* 16x16 threshold map made with the void-and-cluster method, it has the
+ * energy of the pattern in the high frequencies (blue noise) */
+static const guint16 blue_noise_map[16][16] = {
+  {120, 61, 134, 223, 84, 33, 168, 12, 113, 225, 63, 246, 185, 233, 88, 169},
+  {23, 206, 181, 17, 109, 214, 58, 140, 201, 24, 161, 93, 34, 133, 14, 221},
+  {144, 73, 250, 49, 158, 187, 81, 251, 100, 51, 142, 210, 172, 57, 191, 106},
+  {42, 167, 101, 126, 220, 3, 121, 40, 170, 231, 82, 8, 114, 254, 80, 232},
+  {212, 11, 195, 31, 72, 239, 152, 196, 16, 127, 188, 222, 45, 157, 26, 128},
+  {154, 87, 235, 143, 179, 94, 54, 108, 237, 65, 29, 105, 139, 207, 184, 66},
+  {248, 47, 115, 62, 209, 20, 164, 217, 79, 146, 178, 243, 69, 90, 1, 118},
+  {30, 190, 173, 6, 131, 255, 41, 136, 10, 204, 43, 159, 22, 229, 162, 218},
+  {77, 148, 99, 226, 74, 182, 117, 192, 86, 247, 119, 97, 197, 130, 53, 103},
+  {242, 19, 198, 44, 155, 96, 59, 230, 28, 165, 60, 5, 240, 39, 175, 202},
+  {137, 64, 122, 238, 25, 211, 0, 149, 104, 224, 135, 183, 151, 71, 112, 9},
+  {91, 213, 166, 85, 186, 111, 249, 174, 48, 75, 208, 32, 89, 205, 236, 160},
+  {37, 252, 18, 55, 138, 38, 78, 123, 194, 13, 107, 253, 124, 15, 56, 189},
+  {76, 145, 110, 228, 203, 163, 219, 21, 241, 141, 171, 50, 156, 227, 102, 129},
+  {2, 199, 176, 68, 7, 98, 52, 150, 92, 36, 215, 83, 200, 27, 177, 216},
+  {244, 95, 35, 153, 245, 125, 193, 234, 70, 180, 132, 4, 116, 67, 147, 46}
+};
+
 static void
 dither_ordered_u8 (GstVideoDither * dither, gpointer pixels, guint x, guint y,
     guint width)
@@ -288,7 +309,7 @@ alloc_errors (GstVideoDither * dither, guint lines)
 }
 
 static void
-setup_bayer (GstVideoDither * dither)
+setup_ordered (GstVideoDither * dither, const guint16 map[16][16])
 {
   guint i, j, k, width, n_comp, errdepth;
   guint8 *shift;
@@ -317,7 +338,7 @@ setup_bayer (GstVideoDither * dither)
       guint8 *p = (guint8 *) dither->errors + (n_comp * width * i), v;
       for (j = 0; j < width; j++) {
         for (k = 0; k < n_comp; k++) {
-          v = bayer_map[i & 15][j & 15];
+          v = map[i & 15][j & 15];
           if (shift[k] < 8)
             v = v >> (8 - shift[k]);
           p[n_comp * j + k] = v;
@@ -329,7 +350,7 @@ setup_bayer (GstVideoDither * dither)
       guint16 *p = (guint16 *) dither->errors + (n_comp * width * i), v;
       for (j = 0; j < width; j++) {
         for (k = 0; k < n_comp; k++) {
-          v = bayer_map[i & 15][j & 15];
+          v = map[i & 15][j & 15];
           if (shift[k] < 8)
             v = v >> (8 - shift[k]);
           p[n_comp * j + k] = v;
@@ -448,7 +469,10 @@ gst_video_dither_new (GstVideoDitherMethod method, GstVideoDitherFlags flags,
         dither->func = dither_sierra_lite_u16;
       break;
     case GST_VIDEO_DITHER_BAYER:
-      setup_bayer (dither);
+      setup_ordered (dither, bayer_map);
+      break;
+    case GST_VIDEO_DITHER_BLUE_NOISE:
+      setup_ordered (dither, blue_noise_map);
       break;
   }
   return dither;
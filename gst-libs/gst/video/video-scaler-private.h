@@ -0,0 +1,36 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_SCALER_PRIVATE_H__
+#define __GST_VIDEO_SCALER_PRIVATE_H__
+
+#include <gst/video/video-scaler.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+GstVideoScaler * __gst_video_scaler_copy (GstVideoScaler * scale);
+
+/* only for the unit tests: #G_TYPE_STRING, the kernels a new scaler uses,
+ * "orc" or the name of an instruction set like "sse41" or "avx2". When they
+ * are not available the best kernels for the CPU are used. */
+#define GST_VIDEO_SCALER_OPT_KERNELS "GstVideoScaler.kernels"
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_SCALER_PRIVATE_H__ */
@@ -0,0 +1,244 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-scaler-x86-avx2.h"
+#include "video-scaler-x86-common.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* Same as the SSE4.1 kernels but with twice the vector width. The 256 bit
+ * pack instructions work per 128 bit lane so the packed result needs to be
+ * permuted back into the right order before storing. */
+
+#define PACK_FIXUP(v) _mm256_permute4x64_epi64 (v, 0xd8)
+
+void
+video_scale_resample_h_ntap_u8_lq_avx2 (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count)
+{
+  guint8 *dp = d;
+  const guint8 *p = pixels;
+  const __m256i round = _mm256_set1_epi16 (32);
+  gint i, j;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m256i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *s = p + j * count + i;
+      const gint16 *t = taps + j * count + i;
+      __m256i p0, p1, t0, t1;
+
+      p0 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) s));
+      p1 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (s +
+                  16)));
+      t0 = _mm256_loadu_si256 ((const __m256i *) t);
+      t1 = _mm256_loadu_si256 ((const __m256i *) (t + 16));
+
+      lo = _mm256_add_epi16 (lo, _mm256_mullo_epi16 (p0, t0));
+      hi = _mm256_add_epi16 (hi, _mm256_mullo_epi16 (p1, t1));
+    }
+    lo = _mm256_srai_epi16 (lo, 6);
+    hi = _mm256_srai_epi16 (hi, 6);
+    _mm256_storeu_si256 ((__m256i *) (dp + i),
+        PACK_FIXUP (_mm256_packus_epi16 (lo, hi)));
+  }
+  video_scale_h_ntap_u8_lq_tail (dp, p, taps, n_taps, i, count);
+}
+
+void
+video_scale_resample_h_ntap_u16_avx2 (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count)
+{
+  guint16 *dp = d;
+  const guint16 *p = pixels;
+  /* the 2 tap ORC function rounds with 4096, the n-tap one with 4095 */
+  guint32 r = n_taps == 2 ? 4096 : 4095;
+  const __m256i round = _mm256_set1_epi32 (r);
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *s = p + j * count + i;
+      const gint16 *t = taps + j * count + i;
+      __m256i p0, p1, t0, t1;
+
+      p0 = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) s));
+      p1 = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (s +
+                  8)));
+      t0 = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) t));
+      t1 = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) (t +
+                  8)));
+
+      lo = _mm256_add_epi32 (lo, _mm256_mullo_epi32 (p0, t0));
+      hi = _mm256_add_epi32 (hi, _mm256_mullo_epi32 (p1, t1));
+    }
+    lo = _mm256_srai_epi32 (lo, 12);
+    hi = _mm256_srai_epi32 (hi, 12);
+    _mm256_storeu_si256 ((__m256i *) (dp + i),
+        PACK_FIXUP (_mm256_packus_epi32 (lo, hi)));
+  }
+  video_scale_h_ntap_u16_tail (dp, p, taps, n_taps, r, i, count);
+}
+
+void
+video_scale_resample_v_2tap_u8_lq_avx2 (gpointer d, gpointer s1,
+    gpointer s2, gint16 p1, gint count)
+{
+  guint8 *dp = d;
+  const guint8 *sp1 = s1, *sp2 = s2;
+  const __m256i tap = _mm256_set1_epi16 (p1);
+  const __m256i round = _mm256_set1_epi16 (128);
+  const __m256i mask = _mm256_set1_epi16 (0xff);
+  gint i;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m256i alo, ahi, wlo, whi;
+
+    alo = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (sp1 +
+                i)));
+    ahi = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (sp1 +
+                i + 16)));
+    wlo = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (sp2 +
+                i)));
+    whi = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (sp2 +
+                i + 16)));
+
+    wlo = _mm256_mullo_epi16 (_mm256_sub_epi16 (wlo, alo), tap);
+    whi = _mm256_mullo_epi16 (_mm256_sub_epi16 (whi, ahi), tap);
+    wlo = _mm256_srli_epi16 (_mm256_add_epi16 (wlo, round), 8);
+    whi = _mm256_srli_epi16 (_mm256_add_epi16 (whi, round), 8);
+
+    /* wrapping byte add of the high byte to s1 */
+    wlo = _mm256_and_si256 (_mm256_add_epi16 (wlo, alo), mask);
+    whi = _mm256_and_si256 (_mm256_add_epi16 (whi, ahi), mask);
+    _mm256_storeu_si256 ((__m256i *) (dp + i),
+        PACK_FIXUP (_mm256_packus_epi16 (wlo, whi)));
+  }
+  video_scale_v_2tap_u8_lq_tail (dp, sp1, sp2, p1, i, count);
+}
+
+void
+video_scale_resample_v_4tap_u8_lq_avx2 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  guint8 *dp = d;
+  const guint8 *s[4];
+  __m256i t[4];
+  const __m256i round = _mm256_set1_epi16 (32);
+  gint i, j;
+
+  for (j = 0; j < 4; j++) {
+    s[j] = srcs[j * src_inc];
+    t[j] = _mm256_set1_epi16 (taps[j]);
+  }
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m256i lo = round, hi = round;
+
+    for (j = 0; j < 4; j++) {
+      __m256i p0, p1;
+
+      p0 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (s[j] +
+                  i)));
+      p1 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (s[j] +
+                  i + 16)));
+      lo = _mm256_add_epi16 (lo, _mm256_mullo_epi16 (p0, t[j]));
+      hi = _mm256_add_epi16 (hi, _mm256_mullo_epi16 (p1, t[j]));
+    }
+    lo = _mm256_srai_epi16 (lo, 6);
+    hi = _mm256_srai_epi16 (hi, 6);
+    _mm256_storeu_si256 ((__m256i *) (dp + i),
+        PACK_FIXUP (_mm256_packus_epi16 (lo, hi)));
+  }
+  video_scale_v_ntap_u8_lq_tail (dp, srcs, src_inc, taps, 4, i, count);
+}
+
+void
+video_scale_resample_v_ntap_u8_lq_avx2 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  guint8 *dp = d;
+  const __m256i round = _mm256_set1_epi16 (32);
+  gint i, j;
+
+  for (i = 0; i + 32 <= count; i += 32) {
+    __m256i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *s = (const guint8 *) srcs[j * src_inc] + i;
+      const __m256i t = _mm256_set1_epi16 (taps[j]);
+      __m256i p0, p1;
+
+      p0 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) s));
+      p1 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (s +
+                  16)));
+      lo = _mm256_add_epi16 (lo, _mm256_mullo_epi16 (p0, t));
+      hi = _mm256_add_epi16 (hi, _mm256_mullo_epi16 (p1, t));
+    }
+    lo = _mm256_srai_epi16 (lo, 6);
+    hi = _mm256_srai_epi16 (hi, 6);
+    _mm256_storeu_si256 ((__m256i *) (dp + i),
+        PACK_FIXUP (_mm256_packus_epi16 (lo, hi)));
+  }
+  video_scale_v_ntap_u8_lq_tail (dp, srcs, src_inc, taps, n_taps, i, count);
+}
+
+void
+video_scale_resample_v_ntap_u16_avx2 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  guint16 *dp = d;
+  const __m256i round = _mm256_set1_epi32 (4095);
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m256i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *s = (const guint16 *) srcs[j * src_inc] + i;
+      const __m256i t = _mm256_set1_epi32 (taps[j]);
+      __m256i p0, p1;
+
+      p0 = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) s));
+      p1 = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (s +
+                  8)));
+      lo = _mm256_add_epi32 (lo, _mm256_mullo_epi32 (p0, t));
+      hi = _mm256_add_epi32 (hi, _mm256_mullo_epi32 (p1, t));
+    }
+    lo = _mm256_srai_epi32 (lo, 12);
+    hi = _mm256_srai_epi32 (hi, 12);
+    _mm256_storeu_si256 ((__m256i *) (dp + i),
+        PACK_FIXUP (_mm256_packus_epi32 (lo, hi)));
+  }
+  video_scale_v_ntap_u16_tail (dp, srcs, src_inc, taps, n_taps, i, count);
+}
+
+#endif
@@ -0,0 +1,46 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VIDEO_SCALER_X86_AVX2_H
+#define VIDEO_SCALER_X86_AVX2_H
+
+#include <glib.h>
+
+G_GNUC_INTERNAL void
+video_scale_resample_h_ntap_u8_lq_avx2 (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count);
+G_GNUC_INTERNAL void
+video_scale_resample_h_ntap_u16_avx2 (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count);
+G_GNUC_INTERNAL void
+video_scale_resample_v_2tap_u8_lq_avx2 (gpointer d, gpointer s1,
+    gpointer s2, gint16 p1, gint count);
+G_GNUC_INTERNAL void
+video_scale_resample_v_4tap_u8_lq_avx2 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count);
+G_GNUC_INTERNAL void
+video_scale_resample_v_ntap_u8_lq_avx2 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count);
+G_GNUC_INTERNAL void
+video_scale_resample_v_ntap_u16_avx2 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count);
+
+#endif /* VIDEO_SCALER_X86_AVX2_H */
@@ -0,0 +1,122 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef VIDEO_SCALER_X86_COMMON_H
+#define VIDEO_SCALER_X86_COMMON_H
+
+#include <glib.h>
+
+/* Scalar versions of the resample kernels, used by the SIMD implementations
+ * for the elements that don't fill a complete vector. The arithmetic must
+ * stay bit-exact with the ORC versions in video-orc.orc: the LQ 8 bit
+ * kernels accumulate in wrapping 16 bits and the 16 bit kernels in wrapping
+ * 32 bits. */
+
+static inline guint8
+video_scale_clamp_u8_lq (guint16 acc)
+{
+  gint16 v = ((gint16) acc) >> 6;
+
+  return CLAMP (v, 0, 255);
+}
+
+static inline guint16
+video_scale_clamp_u16 (guint32 acc)
+{
+  gint32 v = ((gint32) acc) >> 12;
+
+  return CLAMP (v, 0, 65535);
+}
+
+static inline void
+video_scale_h_ntap_u8_lq_tail (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint n_taps, gint i, gint count)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint16 acc = 32;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint16) (pixels[j * count + i] * taps[j * count + i]);
+
+    d[i] = video_scale_clamp_u8_lq (acc);
+  }
+}
+
+static inline void
+video_scale_h_ntap_u16_tail (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint n_taps, guint32 round, gint i, gint count)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint32 acc = round;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint32) (pixels[j * count + i] * taps[j * count + i]);
+
+    d[i] = video_scale_clamp_u16 (acc);
+  }
+}
+
+static inline void
+video_scale_v_2tap_u8_lq_tail (guint8 * d, const guint8 * s1,
+    const guint8 * s2, gint16 p1, gint i, gint count)
+{
+  for (; i < count; i++) {
+    guint16 w = (guint16) ((s2[i] - s1[i]) * p1 + 128);
+
+    d[i] = (guint8) ((w >> 8) + s1[i]);
+  }
+}
+
+static inline void
+video_scale_v_ntap_u8_lq_tail (guint8 * d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint n_taps, gint i, gint count)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint16 acc = 32;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint16) (((guint8 *) srcs[j * src_inc])[i] * taps[j]);
+
+    d[i] = video_scale_clamp_u8_lq (acc);
+  }
+}
+
+static inline void
+video_scale_v_ntap_u16_tail (guint16 * d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint n_taps, gint i, gint count)
+{
+  gint j;
+
+  for (; i < count; i++) {
+    guint32 acc = 4095;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (guint32) (((guint16 *) srcs[j * src_inc])[i] * taps[j]);
+
+    d[i] = video_scale_clamp_u16 (acc);
+  }
+}
+
+#endif /* VIDEO_SCALER_X86_COMMON_H */
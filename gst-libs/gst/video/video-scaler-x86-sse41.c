@@ -0,0 +1,243 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-scaler-x86-sse41.h"
+#include "video-scaler-x86-common.h"
+
+#if defined (HAVE_SMMINTRIN_H) && defined (HAVE_EMMINTRIN_H) && \
+    defined (__SSE4_1__)
+
+#include <emmintrin.h>
+#include <smmintrin.h>
+
+/* All kernels compute the sum of the products first and apply the rounding
+ * and the shift at the end. Because the ORC versions accumulate with
+ * wrapping adds, the result does not depend on the order of the taps and
+ * the output is bit-exact with the ORC and C versions. */
+
+void
+video_scale_resample_h_ntap_u8_lq_sse41 (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count)
+{
+  guint8 *dp = d;
+  const guint8 *p = pixels;
+  const __m128i round = _mm_set1_epi16 (32);
+  const __m128i zero = _mm_setzero_si128 ();
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m128i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *s = p + j * count + i;
+      const gint16 *t = taps + j * count + i;
+      __m128i pix, t0, t1;
+
+      pix = _mm_loadu_si128 ((const __m128i *) s);
+      t0 = _mm_loadu_si128 ((const __m128i *) t);
+      t1 = _mm_loadu_si128 ((const __m128i *) (t + 8));
+
+      lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_cvtepu8_epi16 (pix), t0));
+      hi = _mm_add_epi16 (hi,
+          _mm_mullo_epi16 (_mm_unpackhi_epi8 (pix, zero), t1));
+    }
+    lo = _mm_srai_epi16 (lo, 6);
+    hi = _mm_srai_epi16 (hi, 6);
+    _mm_storeu_si128 ((__m128i *) (dp + i), _mm_packus_epi16 (lo, hi));
+  }
+  video_scale_h_ntap_u8_lq_tail (dp, p, taps, n_taps, i, count);
+}
+
+void
+video_scale_resample_h_ntap_u16_sse41 (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count)
+{
+  guint16 *dp = d;
+  const guint16 *p = pixels;
+  /* the 2 tap ORC function rounds with 4096, the n-tap one with 4095 */
+  guint32 r = n_taps == 2 ? 4096 : 4095;
+  const __m128i round = _mm_set1_epi32 (r);
+  const __m128i zero = _mm_setzero_si128 ();
+  gint i, j;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    __m128i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *s = p + j * count + i;
+      const gint16 *t = taps + j * count + i;
+      __m128i pix, tv;
+
+      pix = _mm_loadu_si128 ((const __m128i *) s);
+      tv = _mm_loadu_si128 ((const __m128i *) t);
+
+      lo = _mm_add_epi32 (lo, _mm_mullo_epi32 (_mm_cvtepu16_epi32 (pix),
+              _mm_cvtepi16_epi32 (tv)));
+      hi = _mm_add_epi32 (hi,
+          _mm_mullo_epi32 (_mm_unpackhi_epi16 (pix, zero),
+              _mm_cvtepi16_epi32 (_mm_unpackhi_epi64 (tv, tv))));
+    }
+    lo = _mm_srai_epi32 (lo, 12);
+    hi = _mm_srai_epi32 (hi, 12);
+    _mm_storeu_si128 ((__m128i *) (dp + i), _mm_packus_epi32 (lo, hi));
+  }
+  video_scale_h_ntap_u16_tail (dp, p, taps, n_taps, r, i, count);
+}
+
+void
+video_scale_resample_v_2tap_u8_lq_sse41 (gpointer d, gpointer s1,
+    gpointer s2, gint16 p1, gint count)
+{
+  guint8 *dp = d;
+  const guint8 *sp1 = s1, *sp2 = s2;
+  const __m128i tap = _mm_set1_epi16 (p1);
+  const __m128i round = _mm_set1_epi16 (128);
+  const __m128i mask = _mm_set1_epi16 (0xff);
+  const __m128i zero = _mm_setzero_si128 ();
+  gint i;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m128i a, b, alo, ahi, wlo, whi;
+
+    a = _mm_loadu_si128 ((const __m128i *) (sp1 + i));
+    b = _mm_loadu_si128 ((const __m128i *) (sp2 + i));
+
+    alo = _mm_cvtepu8_epi16 (a);
+    ahi = _mm_unpackhi_epi8 (a, zero);
+
+    wlo = _mm_sub_epi16 (_mm_cvtepu8_epi16 (b), alo);
+    whi = _mm_sub_epi16 (_mm_unpackhi_epi8 (b, zero), ahi);
+    wlo = _mm_add_epi16 (_mm_mullo_epi16 (wlo, tap), round);
+    whi = _mm_add_epi16 (_mm_mullo_epi16 (whi, tap), round);
+
+    /* take the high byte and add it to s1 with a wrapping byte add */
+    wlo = _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (wlo, 8), alo), mask);
+    whi = _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (whi, 8), ahi), mask);
+    _mm_storeu_si128 ((__m128i *) (dp + i), _mm_packus_epi16 (wlo, whi));
+  }
+  video_scale_v_2tap_u8_lq_tail (dp, sp1, sp2, p1, i, count);
+}
+
+void
+video_scale_resample_v_4tap_u8_lq_sse41 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  guint8 *dp = d;
+  const guint8 *s1 = srcs[0], *s2 = srcs[1 * src_inc];
+  const guint8 *s3 = srcs[2 * src_inc], *s4 = srcs[3 * src_inc];
+  const __m128i t1 = _mm_set1_epi16 (taps[0]);
+  const __m128i t2 = _mm_set1_epi16 (taps[1]);
+  const __m128i t3 = _mm_set1_epi16 (taps[2]);
+  const __m128i t4 = _mm_set1_epi16 (taps[3]);
+  const __m128i round = _mm_set1_epi16 (32);
+  const __m128i zero = _mm_setzero_si128 ();
+  gint i;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m128i p1, p2, p3, p4, lo, hi;
+
+    p1 = _mm_loadu_si128 ((const __m128i *) (s1 + i));
+    p2 = _mm_loadu_si128 ((const __m128i *) (s2 + i));
+    p3 = _mm_loadu_si128 ((const __m128i *) (s3 + i));
+    p4 = _mm_loadu_si128 ((const __m128i *) (s4 + i));
+
+    lo = _mm_add_epi16 (round, _mm_mullo_epi16 (_mm_cvtepu8_epi16 (p1), t1));
+    lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_cvtepu8_epi16 (p2), t2));
+    lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_cvtepu8_epi16 (p3), t3));
+    lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_cvtepu8_epi16 (p4), t4));
+
+    hi = _mm_add_epi16 (round,
+        _mm_mullo_epi16 (_mm_unpackhi_epi8 (p1, zero), t1));
+    hi = _mm_add_epi16 (hi, _mm_mullo_epi16 (_mm_unpackhi_epi8 (p2, zero), t2));
+    hi = _mm_add_epi16 (hi, _mm_mullo_epi16 (_mm_unpackhi_epi8 (p3, zero), t3));
+    hi = _mm_add_epi16 (hi, _mm_mullo_epi16 (_mm_unpackhi_epi8 (p4, zero), t4));
+
+    lo = _mm_srai_epi16 (lo, 6);
+    hi = _mm_srai_epi16 (hi, 6);
+    _mm_storeu_si128 ((__m128i *) (dp + i), _mm_packus_epi16 (lo, hi));
+  }
+  video_scale_v_ntap_u8_lq_tail (dp, srcs, src_inc, taps, 4, i, count);
+}
+
+void
+video_scale_resample_v_ntap_u8_lq_sse41 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  guint8 *dp = d;
+  const __m128i round = _mm_set1_epi16 (32);
+  const __m128i zero = _mm_setzero_si128 ();
+  gint i, j;
+
+  for (i = 0; i + 16 <= count; i += 16) {
+    __m128i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *s = (const guint8 *) srcs[j * src_inc] + i;
+      const __m128i t = _mm_set1_epi16 (taps[j]);
+      __m128i pix;
+
+      pix = _mm_loadu_si128 ((const __m128i *) s);
+      lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_cvtepu8_epi16 (pix), t));
+      hi = _mm_add_epi16 (hi,
+          _mm_mullo_epi16 (_mm_unpackhi_epi8 (pix, zero), t));
+    }
+    lo = _mm_srai_epi16 (lo, 6);
+    hi = _mm_srai_epi16 (hi, 6);
+    _mm_storeu_si128 ((__m128i *) (dp + i), _mm_packus_epi16 (lo, hi));
+  }
+  video_scale_v_ntap_u8_lq_tail (dp, srcs, src_inc, taps, n_taps, i, count);
+}
+
+void
+video_scale_resample_v_ntap_u16_sse41 (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  guint16 *dp = d;
+  const __m128i round = _mm_set1_epi32 (4095);
+  const __m128i zero = _mm_setzero_si128 ();
+  gint i, j;
+
+  for (i = 0; i + 8 <= count; i += 8) {
+    __m128i lo = round, hi = round;
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *s = (const guint16 *) srcs[j * src_inc] + i;
+      const __m128i t = _mm_set1_epi32 (taps[j]);
+      __m128i pix;
+
+      pix = _mm_loadu_si128 ((const __m128i *) s);
+      lo = _mm_add_epi32 (lo, _mm_mullo_epi32 (_mm_cvtepu16_epi32 (pix), t));
+      hi = _mm_add_epi32 (hi,
+          _mm_mullo_epi32 (_mm_unpackhi_epi16 (pix, zero), t));
+    }
+    lo = _mm_srai_epi32 (lo, 12);
+    hi = _mm_srai_epi32 (hi, 12);
+    _mm_storeu_si128 ((__m128i *) (dp + i), _mm_packus_epi32 (lo, hi));
+  }
+  video_scale_v_ntap_u16_tail (dp, srcs, src_inc, taps, n_taps, i, count);
+}
+
+#endif
@@ -0,0 +1,90 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "video-scaler-x86-sse41.h"
+#include "video-scaler-x86-avx2.h"
+
+#if defined (HAVE_SMMINTRIN_H) && defined (HAVE_EMMINTRIN_H) && HAVE_SSE41
+static const GstVideoScalerKernels video_scaler_sse41_kernels = {
+  "sse41",
+  video_scale_resample_h_ntap_u8_lq_sse41,
+  video_scale_resample_h_ntap_u16_sse41,
+  video_scale_resample_v_2tap_u8_lq_sse41,
+  video_scale_resample_v_4tap_u8_lq_sse41,
+  video_scale_resample_v_ntap_u8_lq_sse41,
+  video_scale_resample_v_ntap_u16_sse41
+};
+#endif
+
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && defined (__GNUC__)
+static const GstVideoScalerKernels video_scaler_avx2_kernels = {
+  "avx2",
+  video_scale_resample_h_ntap_u8_lq_avx2,
+  video_scale_resample_h_ntap_u16_avx2,
+  video_scale_resample_v_2tap_u8_lq_avx2,
+  video_scale_resample_v_4tap_u8_lq_avx2,
+  video_scale_resample_v_ntap_u8_lq_avx2,
+  video_scale_resample_v_ntap_u16_avx2
+};
+#endif
+
+/* the @name kernels, or %NULL when they are not available */
+static const GstVideoScalerKernels *
+video_scaler_get_x86_kernels (const gchar * name)
+{
+  if (!strcmp (name, "sse41")) {
+#if defined (HAVE_SMMINTRIN_H) && defined (HAVE_EMMINTRIN_H) && HAVE_SSE41
+#ifdef __GNUC__
+    if (!__builtin_cpu_supports ("sse4.1"))
+      return NULL;
+#endif
+    return &video_scaler_sse41_kernels;
+#endif
+  } else if (!strcmp (name, "avx2")) {
+    /* ORC has no flag for AVX2, ask the CPU directly */
+#if defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && defined (__GNUC__)
+    if (__builtin_cpu_supports ("avx2"))
+      return &video_scaler_avx2_kernels;
+#endif
+  }
+  return NULL;
+}
+
+static void
+video_scaler_check_x86 (const gchar * option)
+{
+  if (!strcmp (option, "sse41")) {
+    const GstVideoScalerKernels *kernels;
+
+    if ((kernels = video_scaler_get_x86_kernels ("sse41"))) {
+      GST_DEBUG ("enable SSE41 optimisations");
+      video_scaler_default_kernels = kernels;
+    } else {
+      GST_DEBUG ("SSE41 optimisations not enabled");
+    }
+
+    /* every CPU with AVX2 also has SSE4.1 so this is only checked here */
+    if ((kernels = video_scaler_get_x86_kernels ("avx2"))) {
+      GST_DEBUG ("enable AVX2 optimisations");
+      video_scaler_default_kernels = kernels;
+    } else {
+      GST_DEBUG ("AVX2 optimisations not enabled or not supported");
+    }
+  }
+}
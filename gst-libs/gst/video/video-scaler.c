@@ -40,8 +40,13 @@
 #define orc_memcpy memcpy
 #endif
 
+#if defined HAVE_ORC && !defined DISABLE_ORC
+#include <orc/orc.h>
+#endif
+
 #include "video-orc.h"
 #include "video-scaler.h"
+#include "video-scaler-private.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -81,6 +86,28 @@ typedef void (*GstVideoScalerVFunc) (GstVideoScaler * scale,
     gpointer srcs[], gpointer dest, guint dest_offset, guint width,
     guint n_elems);
 
+/* the inner kernels of the n-tap scalers, these can be replaced with
+ * optimized versions at runtime */
+typedef void (*GstVideoScalerHNtapFunc) (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count);
+typedef void (*GstVideoScalerV2tapFunc) (gpointer d, gpointer s1,
+    gpointer s2, gint16 p1, gint count);
+typedef void (*GstVideoScalerVNtapFunc) (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count);
+
+/* a set of kernels, every scaler picks one when it is made */
+typedef struct
+{
+  const gchar *name;
+  GstVideoScalerHNtapFunc h_ntap_u8_lq;
+  GstVideoScalerHNtapFunc h_ntap_u16;
+  GstVideoScalerV2tapFunc v_2tap_u8_lq;
+  GstVideoScalerVNtapFunc v_4tap_u8_lq;
+  GstVideoScalerVNtapFunc v_ntap_u8_lq;
+  GstVideoScalerVNtapFunc v_ntap_u16;
+} GstVideoScalerKernels;
+
 struct _GstVideoScaler
 {
   GstVideoResamplerMethod method;
@@ -102,6 +129,8 @@ struct _GstVideoScaler
   gint tmpwidth;
   gpointer tmpline1;
   gpointer tmpline2;
+
+  const GstVideoScalerKernels *kernels;
 };
 
 static void
@@ -187,6 +216,241 @@ scaler_dump (GstVideoScaler * scale)
 
 #define INTERLACE_SHIFT 0.5
 
+/* default implementations of the n-tap kernels, using ORC */
+static void
+video_scale_resample_h_ntap_u8_lq_orc (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count)
+{
+  guint8 *p = pixels;
+  gint16 *t = (gint16 *) taps;
+  gint max_taps = n_taps;
+
+  if (max_taps == 2) {
+    video_orc_resample_h_2tap_u8_lq (d, p, p + count, t, t + count, count);
+  } else {
+    /* first pixels with first tap to temp */
+    if (max_taps >= 3) {
+      video_orc_resample_h_multaps3_u8_lq (temp, p, p + count,
+          p + count * 2, t, t + count, t + count * 2, count);
+      max_taps -= 3;
+      p += count * 3;
+      t += count * 3;
+    } else {
+      gint first = max_taps % 3;
+
+      video_orc_resample_h_multaps_u8_lq (temp, p, t, count);
+      video_orc_resample_h_muladdtaps_u8_lq (temp, 0, p + count, count,
+          t + count, count * 2, count, first - 1);
+      max_taps -= first;
+      p += count * first;
+      t += count * first;
+    }
+    while (max_taps > 3) {
+      if (max_taps >= 6) {
+        video_orc_resample_h_muladdtaps3_u8_lq (temp, p, p + count,
+            p + count * 2, t, t + count, t + count * 2, count);
+        max_taps -= 3;
+        p += count * 3;
+        t += count * 3;
+      } else {
+        video_orc_resample_h_muladdtaps_u8_lq (temp, 0, p, count,
+            t, count * 2, count, max_taps - 3);
+        p += count * (max_taps - 3);
+        t += count * (max_taps - 3);
+        max_taps = 3;
+      }
+    }
+    if (max_taps == 3) {
+      video_orc_resample_h_muladdscaletaps3_u8_lq (d, p, p + count,
+          p + count * 2, t, t + count, t + count * 2, temp, count);
+    } else {
+      if (max_taps) {
+        /* add other pixels with other taps to t4 */
+        video_orc_resample_h_muladdtaps_u8_lq (temp, 0, p, count,
+            t, count * 2, count, max_taps);
+      }
+      /* scale and write final result */
+      video_orc_resample_scaletaps_u8_lq (d, temp, count);
+    }
+  }
+}
+
+static void
+video_scale_resample_h_ntap_u16_orc (gpointer d, gpointer pixels,
+    const gint16 * taps, gint n_taps, gpointer temp, gint count)
+{
+  guint16 *p = pixels;
+
+  if (n_taps == 2) {
+    video_orc_resample_h_2tap_u16 (d, p, p + count, taps, taps + count,
+        count);
+  } else {
+    /* first pixels with first tap to t4 */
+    video_orc_resample_h_multaps_u16 (temp, p, taps, count);
+    /* add other pixels with other taps to t4 */
+    video_orc_resample_h_muladdtaps_u16 (temp, 0, p + count, count * 2,
+        taps + count, count * 2, count, n_taps - 1);
+    /* scale and write final result */
+    video_orc_resample_scaletaps_u16 (d, temp, count);
+  }
+}
+
+static void
+video_scale_resample_v_2tap_u8_lq_orc (gpointer d, gpointer s1,
+    gpointer s2, gint16 p1, gint count)
+{
+  video_orc_resample_v_2tap_u8_lq (d, s1, s2, p1, count);
+}
+
+static void
+video_scale_resample_v_4tap_u8_lq_orc (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  video_orc_resample_v_4tap_u8_lq (d, srcs[0], srcs[1 * src_inc],
+      srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
+      taps[3], count);
+}
+
+static void
+video_scale_resample_v_ntap_u8_lq_orc (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  gint i, max_taps = n_taps;
+
+  if (max_taps >= 4) {
+    video_orc_resample_v_multaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
+        srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
+        taps[3], count);
+    max_taps -= 4;
+    srcs += 4 * src_inc;
+    taps += 4;
+  } else {
+    gint first = (max_taps % 4);
+
+    video_orc_resample_v_multaps_u8_lq (temp, srcs[0], taps[0], count);
+    for (i = 1; i < first; i++) {
+      video_orc_resample_v_muladdtaps_u8_lq (temp, srcs[i * src_inc], taps[i],
+          count);
+    }
+    max_taps -= first;
+    srcs += first * src_inc;
+    taps += first;
+  }
+  while (max_taps > 4) {
+    if (max_taps >= 8) {
+      video_orc_resample_v_muladdtaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
+          srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
+          taps[3], count);
+      max_taps -= 4;
+      srcs += 4 * src_inc;
+      taps += 4;
+    } else {
+      for (i = 0; i < max_taps - 4; i++)
+        video_orc_resample_v_muladdtaps_u8_lq (temp, srcs[i * src_inc], taps[i],
+            count);
+      srcs += (max_taps - 4) * src_inc;
+      taps += (max_taps - 4);
+      max_taps = 4;
+    }
+  }
+  if (max_taps == 4) {
+    video_orc_resample_v_muladdscaletaps4_u8_lq (d, srcs[0], srcs[1 * src_inc],
+        srcs[2 * src_inc], srcs[3 * src_inc], temp, taps[0], taps[1], taps[2],
+        taps[3], count);
+  } else {
+    for (i = 0; i < max_taps; i++)
+      video_orc_resample_v_muladdtaps_u8_lq (temp, srcs[i * src_inc], taps[i],
+          count);
+    video_orc_resample_scaletaps_u8_lq (d, temp, count);
+  }
+}
+
+static void
+video_scale_resample_v_ntap_u16_orc (gpointer d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gpointer temp,
+    gint count)
+{
+  gint i;
+
+  video_orc_resample_v_multaps_u16 (temp, srcs[0], taps[0], count);
+  for (i = 1; i < n_taps; i++) {
+    video_orc_resample_v_muladdtaps_u16 (temp, srcs[i * src_inc], taps[i],
+        count);
+  }
+  video_orc_resample_scaletaps_u16 (d, temp, count);
+}
+
+static const GstVideoScalerKernels video_scaler_orc_kernels = {
+  "orc",
+  video_scale_resample_h_ntap_u8_lq_orc,
+  video_scale_resample_h_ntap_u16_orc,
+  video_scale_resample_v_2tap_u8_lq_orc,
+  video_scale_resample_v_4tap_u8_lq_orc,
+  video_scale_resample_v_ntap_u8_lq_orc,
+  video_scale_resample_v_ntap_u16_orc
+};
+
+/* the best kernels for the CPU, set once at init */
+static const GstVideoScalerKernels *video_scaler_default_kernels =
+    &video_scaler_orc_kernels;
+
+#if defined HAVE_ORC && !defined DISABLE_ORC
+# if defined (__i386__) || defined (__x86_64__)
+#  define CHECK_X86
+#  include "video-scaler-x86.h"
+# endif
+#endif
+
+/* the kernels called @name, or %NULL when they are not available */
+static const GstVideoScalerKernels *
+video_scaler_find_kernels (const gchar * name)
+{
+  if (!strcmp (name, "orc"))
+    return &video_scaler_orc_kernels;
+#ifdef CHECK_X86
+  return video_scaler_get_x86_kernels (name);
+#else
+  return NULL;
+#endif
+}
+
+static void
+video_scaler_init (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#if defined HAVE_ORC && !defined DISABLE_ORC
+    OrcTarget *target;
+
+    orc_init ();
+
+    target = orc_target_get_default ();
+    if (target) {
+      const gchar *name;
+      unsigned int flags = orc_target_get_default_flags (target);
+      gint i;
+
+      for (i = 0; i < 32; ++i) {
+        if (!(flags & (1U << i)))
+          continue;
+
+        name = orc_target_get_flag_name (target, i);
+        GST_DEBUG ("target flag %s", name);
+#ifdef CHECK_X86
+        if (name)
+          video_scaler_check_x86 (name);
+#endif
+      }
+    }
+#endif
+    GST_DEBUG ("using %s kernels", video_scaler_default_kernels->name);
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
 /**
  * gst_video_scaler_new: (skip)
  * @method: a #GstVideoResamplerMethod
@@ -214,6 +478,8 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   g_return_val_if_fail (in_size != 0, NULL);
   g_return_val_if_fail (out_size != 0, NULL);
 
+  video_scaler_init ();
+
   scale = g_slice_new0 (GstVideoScaler);
 
   GST_DEBUG ("%d %u  %u->%u", method, n_taps, in_size, out_size);
@@ -221,6 +487,22 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   scale->method = method;
   scale->flags = flags;
 
+  scale->kernels = video_scaler_default_kernels;
+  if (options) {
+    const gchar *name;
+
+    name = gst_structure_get_string (options, GST_VIDEO_SCALER_OPT_KERNELS);
+    if (name) {
+      const GstVideoScalerKernels *kernels = video_scaler_find_kernels (name);
+
+      if (kernels)
+        scale->kernels = kernels;
+      else
+        GST_INFO ("%s kernels not available, using %s", name,
+            scale->kernels->name);
+    }
+  }
+
   if (flags & GST_VIDEO_SCALER_FLAG_INTERLACED) {
     GstVideoResampler tresamp, bresamp;
     gdouble shift;
@@ -277,6 +559,41 @@ gst_video_scaler_free (GstVideoScaler * scale)
   g_slice_free (GstVideoScaler, scale);
 }
 
+/* Make a copy of @scale with the same filter coefficients. This is a lot
+ * cheaper than calculating the coefficients again with
+ * gst_video_scaler_new(). The temporary lines are not copied so the copy
+ * can be used from another thread. */
+GstVideoScaler *
+__gst_video_scaler_copy (GstVideoScaler * scale)
+{
+  GstVideoScaler *copy;
+  GstVideoResampler *r, *cr;
+
+  g_return_val_if_fail (scale != NULL, NULL);
+
+  copy = g_slice_new0 (GstVideoScaler);
+  copy->method = scale->method;
+  copy->flags = scale->flags;
+  copy->merged = scale->merged;
+  copy->in_y_offset = scale->in_y_offset;
+  copy->out_y_offset = scale->out_y_offset;
+  copy->inc = scale->inc;
+  copy->kernels = scale->kernels;
+
+  r = &scale->resampler;
+  cr = &copy->resampler;
+  cr->in_size = r->in_size;
+  cr->out_size = r->out_size;
+  cr->max_taps = r->max_taps;
+  cr->n_phases = r->n_phases;
+  cr->offset = g_memdup (r->offset, sizeof (guint32) * r->out_size);
+  cr->phase = g_memdup (r->phase, sizeof (guint32) * r->out_size);
+  cr->n_taps = g_memdup (r->n_taps, sizeof (guint32) * r->out_size);
+  cr->taps = g_memdup (r->taps, sizeof (gdouble) * r->max_taps * r->n_phases);
+
+  return copy;
+}
+
 /**
  * gst_video_scaler_get_max_taps:
  * @scale: a #GstVideoScaler
@@ -693,56 +1010,7 @@ video_scale_h_ntap_u8 (GstVideoScaler * scale,
   count = width * n_elems;
 
 #ifdef LQ
-  if (max_taps == 2) {
-    video_orc_resample_h_2tap_u8_lq (d, pixels, pixels + count, taps,
-        taps + count, count);
-  } else {
-    /* first pixels with first tap to temp */
-    if (max_taps >= 3) {
-      video_orc_resample_h_multaps3_u8_lq (temp, pixels, pixels + count,
-          pixels + count * 2, taps, taps + count, taps + count * 2, count);
-      max_taps -= 3;
-      pixels += count * 3;
-      taps += count * 3;
-    } else {
-      gint first = max_taps % 3;
-
-      video_orc_resample_h_multaps_u8_lq (temp, pixels, taps, count);
-      video_orc_resample_h_muladdtaps_u8_lq (temp, 0, pixels + count, count,
-          taps + count, count * 2, count, first - 1);
-      max_taps -= first;
-      pixels += count * first;
-      taps += count * first;
-    }
-    while (max_taps > 3) {
-      if (max_taps >= 6) {
-        video_orc_resample_h_muladdtaps3_u8_lq (temp, pixels, pixels + count,
-            pixels + count * 2, taps, taps + count, taps + count * 2, count);
-        max_taps -= 3;
-        pixels += count * 3;
-        taps += count * 3;
-      } else {
-        video_orc_resample_h_muladdtaps_u8_lq (temp, 0, pixels, count,
-            taps, count * 2, count, max_taps - 3);
-        pixels += count * (max_taps - 3);
-        taps += count * (max_taps - 3);
-        max_taps = 3;
-      }
-    }
-    if (max_taps == 3) {
-      video_orc_resample_h_muladdscaletaps3_u8_lq (d, pixels, pixels + count,
-          pixels + count * 2, taps, taps + count, taps + count * 2, temp,
-          count);
-    } else {
-      if (max_taps) {
-        /* add other pixels with other taps to t4 */
-        video_orc_resample_h_muladdtaps_u8_lq (temp, 0, pixels, count,
-            taps, count * 2, count, max_taps);
-      }
-      /* scale and write final result */
-      video_orc_resample_scaletaps_u8_lq (d, temp, count);
-    }
-  }
+  scale->kernels->h_ntap_u8_lq (d, pixels, taps, max_taps, temp, count);
 #else
   /* first pixels with first tap to t4 */
   video_orc_resample_h_multaps_u8 (temp, pixels, taps, count);
@@ -806,18 +1074,7 @@ video_scale_h_ntap_u16 (GstVideoScaler * scale,
   taps = scale->taps_s16_4;
   count = width * n_elems;
 
-  if (max_taps == 2) {
-    video_orc_resample_h_2tap_u16 (d, pixels, pixels + count, taps,
-        taps + count, count);
-  } else {
-    /* first pixels with first tap to t4 */
-    video_orc_resample_h_multaps_u16 (temp, pixels, taps, count);
-    /* add other pixels with other taps to t4 */
-    video_orc_resample_h_muladdtaps_u16 (temp, 0, pixels + count, count * 2,
-        taps + count, count * 2, count, max_taps - 1);
-    /* scale and write final result */
-    video_orc_resample_scaletaps_u16 (d, temp, count);
-  }
+  scale->kernels->h_ntap_u16 (d, pixels, taps, max_taps, temp, count);
 }
 
 static void
@@ -867,7 +1124,7 @@ video_scale_v_2tap_u8 (GstVideoScaler * scale,
   p1 = scale->taps_s16[dest_offset * max_taps + 1];
 
 #ifdef LQ
-  video_orc_resample_v_2tap_u8_lq (d, s1, s2, p1, width * n_elems);
+  scale->kernels->v_2tap_u8_lq (d, s1, s2, p1, width * n_elems);
 #else
   video_orc_resample_v_2tap_u8 (d, s1, s2, p1, width * n_elems);
 #endif
@@ -939,10 +1196,12 @@ video_scale_v_4tap_u8 (GstVideoScaler * scale,
     gpointer srcs[], gpointer dest, guint dest_offset, guint width,
     guint n_elems)
 {
-  gint max_taps;
-  guint8 *s1, *s2, *s3, *s4, *d;
-  gint p1, p2, p3, p4, src_inc;
+  gint max_taps, src_inc;
   gint16 *taps;
+#ifndef LQ
+  guint8 *s1, *s2, *s3, *s4, *d;
+  gint p1, p2, p3, p4;
+#endif
 
   if (scale->taps_s16 == NULL)
 #ifdef LQ
@@ -959,6 +1218,10 @@ video_scale_v_4tap_u8 (GstVideoScaler * scale,
   else
     src_inc = 1;
 
+#ifdef LQ
+  scale->kernels->v_4tap_u8_lq (dest, srcs, src_inc, taps, 4,
+      scale->tmpline2, width * n_elems);
+#else
   d = (guint8 *) dest;
   s1 = (guint8 *) srcs[0 * src_inc];
   s2 = (guint8 *) srcs[1 * src_inc];
@@ -969,10 +1232,6 @@ video_scale_v_4tap_u8 (GstVideoScaler * scale,
   p3 = taps[2];
   p4 = taps[3];
 
-#ifdef LQ
-  video_orc_resample_v_4tap_u8_lq (d, s1, s2, s3, s4, p1, p2, p3, p4,
-      width * n_elems);
-#else
   video_orc_resample_v_4tap_u8 (d, s1, s2, s3, s4, p1, p2, p3, p4,
       width * n_elems);
 #endif
@@ -984,9 +1243,12 @@ video_scale_v_ntap_u8 (GstVideoScaler * scale,
     guint n_elems)
 {
   gint16 *taps;
-  gint i, max_taps, count, src_inc;
+  gint max_taps, count, src_inc;
   gpointer d;
   gint16 *temp;
+#ifndef LQ
+  gint i;
+#endif
 
   if (scale->taps_s16 == NULL)
 #ifdef LQ
@@ -1009,53 +1271,8 @@ video_scale_v_ntap_u8 (GstVideoScaler * scale,
   count = width * n_elems;
 
 #ifdef LQ
-  if (max_taps >= 4) {
-    video_orc_resample_v_multaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
-        srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
-        taps[3], count);
-    max_taps -= 4;
-    srcs += 4 * src_inc;
-    taps += 4;
-  } else {
-    gint first = (max_taps % 4);
-
-    video_orc_resample_v_multaps_u8_lq (temp, srcs[0], taps[0], count);
-    for (i = 1; i < first; i++) {
-      video_orc_resample_v_muladdtaps_u8_lq (temp, srcs[i * src_inc], taps[i],
-          count);
-    }
-    max_taps -= first;
-    srcs += first * src_inc;
-    taps += first;
-  }
-  while (max_taps > 4) {
-    if (max_taps >= 8) {
-      video_orc_resample_v_muladdtaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
-          srcs[2 * src_inc], srcs[3 * src_inc], taps[0], taps[1], taps[2],
-          taps[3], count);
-      max_taps -= 4;
-      srcs += 4 * src_inc;
-      taps += 4;
-    } else {
-      for (i = 0; i < max_taps - 4; i++)
-        video_orc_resample_v_muladdtaps_u8_lq (temp, srcs[i * src_inc], taps[i],
-            count);
-      srcs += (max_taps - 4) * src_inc;
-      taps += (max_taps - 4);
-      max_taps = 4;
-    }
-  }
-  if (max_taps == 4) {
-    video_orc_resample_v_muladdscaletaps4_u8_lq (d, srcs[0], srcs[1 * src_inc],
-        srcs[2 * src_inc], srcs[3 * src_inc], temp, taps[0], taps[1], taps[2],
-        taps[3], count);
-  } else {
-    for (i = 0; i < max_taps; i++)
-      video_orc_resample_v_muladdtaps_u8_lq (temp, srcs[i * src_inc], taps[i],
-          count);
-    video_orc_resample_scaletaps_u8_lq (d, temp, count);
-  }
-
+  scale->kernels->v_ntap_u8_lq (d, srcs, src_inc, taps, max_taps, temp,
+      count);
 #else
   video_orc_resample_v_multaps_u8 (temp, srcs[0], taps[0], count);
   for (i = 1; i < max_taps; i++) {
@@ -1072,7 +1289,7 @@ video_scale_v_ntap_u16 (GstVideoScaler * scale,
     guint n_elems)
 {
   gint16 *taps;
-  gint i, max_taps, count, src_inc;
+  gint max_taps, count, src_inc;
   gpointer d;
   gint32 *temp;
 
@@ -1092,12 +1309,8 @@ video_scale_v_ntap_u16 (GstVideoScaler * scale,
   temp = (gint32 *) scale->tmpline2;
   count = width * n_elems;
 
-  video_orc_resample_v_multaps_u16 (temp, srcs[0], taps[0], count);
-  for (i = 1; i < max_taps; i++) {
-    video_orc_resample_v_muladdtaps_u16 (temp, srcs[i * src_inc], taps[i],
-        count);
-  }
-  video_orc_resample_scaletaps_u16 (d, temp, count);
+  scale->kernels->v_ntap_u16 (d, srcs, src_inc, taps, max_taps, temp,
+      count);
 }
 
 static gint
@@ -1147,6 +1360,7 @@ gst_video_scaler_combine_packed_YUV (GstVideoScaler * y_scale,
   scale->method = y_scale->method;
   scale->flags = y_scale->flags;
   scale->merged = TRUE;
+  scale->kernels = y_scale->kernels;
 
   resampler = &scale->resampler;
 
@@ -1468,7 +1682,7 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
       d = LINE (dest, dest_stride, y) + xo;
 
       /* no scaling, do memcpy */
-      for (i = y; i < height; i++) {
+      for (i = y; i < y + height; i++) {
         memcpy (d, s, xw);
         d += dest_stride;
         s += src_stride;
@@ -1478,7 +1692,7 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
         realloc_tmplines (hscale, n_elems, width);
 
       /* only horizontal scaling */
-      for (i = y; i < height; i++) {
+      for (i = y; i < y + height; i++) {
         hfunc (hscale, LINE (src, src_stride, i), LINE (dest, dest_stride, i),
             x, width, n_elems);
       }
@@ -1495,7 +1709,7 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
 
     if (hscale == NULL) {
       /* only vertical scaling */
-      for (i = y; i < height; i++) {
+      for (i = y; i < y + height; i++) {
         guint in, j;
 
         in = vscale->resampler.offset[i];
@@ -1505,17 +1719,17 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
         vfunc (vscale, lines, LINE (dest, dest_stride, i), i, width, n_elems);
       }
     } else {
-      gint tmp_in = y;
+      gint tmp_in = vscale->resampler.offset[y];
       gint s1, s2;
 
       if (hscale->tmpwidth < width)
         realloc_tmplines (hscale, n_elems, width);
 
-      s1 = width * vscale->resampler.offset[height - 1];
+      s1 = width * vscale->resampler.offset[y + height - 1];
       s2 = width * height;
 
       if (s1 <= s2) {
-        for (i = y; i < height; i++) {
+        for (i = y; i < y + height; i++) {
           guint in, j;
 
           in = vscale->resampler.offset[i];
@@ -1560,7 +1774,7 @@ gst_video_scaler_2d (GstVideoScaler * hscale, GstVideoScaler * vscale,
         if (vscale->tmpwidth < vw)
           realloc_tmplines (vscale, n_elems, vw);
 
-        for (i = y; i < height; i++) {
+        for (i = y; i < y + height; i++) {
           guint in, j;
 
           in = vscale->resampler.offset[i];
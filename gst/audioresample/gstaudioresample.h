@@ -68,6 +68,7 @@ struct _GstAudioResample {
   GstAudioResamplerFilterMode sinc_filter_mode;
   guint32 sinc_filter_auto_threshold;
   GstAudioResamplerFilterInterpolation sinc_filter_interpolation;
+  guint n_threads;
 
   /* state */
   GstAudioInfo in;
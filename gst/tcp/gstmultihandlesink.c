@@ -302,6 +302,12 @@ find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction);
 #define find_next_syncframe(s,i) 	find_syncframe(s,i,1)
 #define find_prev_syncframe(s,i) 	find_syncframe(s,i,-1)
 static gboolean is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer);
+static void gst_multi_handle_sink_index_init (GstMultiHandleSinkIndex * index);
+static void gst_multi_handle_sink_index_free (GstMultiHandleSinkIndex * index);
+static void gst_multi_handle_sink_index_clear (GstMultiHandleSinkIndex * index);
+static void gst_multi_handle_sink_index_push (GstMultiHandleSink * sink,
+    GstBuffer * buffer);
+static void gst_multi_handle_sink_index_pop (GstMultiHandleSink * sink);
 static gboolean gst_multi_handle_sink_stop (GstBaseSink * bsink);
 static gboolean gst_multi_handle_sink_start (GstBaseSink * bsink);
 static gint get_buffers_max (GstMultiHandleSink * sink, gint64 max);
@@ -494,6 +500,7 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   this->clients = NULL;
 
   this->bufqueue = g_array_new (FALSE, TRUE, sizeof (GstBuffer *));
+  gst_multi_handle_sink_index_init (&this->bufindex);
   this->unit_format = DEFAULT_UNIT_FORMAT;
   this->units_max = DEFAULT_UNITS_MAX;
   this->units_soft_max = DEFAULT_UNITS_SOFT_MAX;
@@ -522,6 +529,7 @@ gst_multi_handle_sink_finalize (GObject * object)
 
   CLIENTS_LOCK_CLEAR (this);
   g_array_free (this->bufqueue, TRUE);
+  gst_multi_handle_sink_index_free (&this->bufindex);
   g_hash_table_destroy (this->handle_hash);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1146,6 +1154,240 @@ is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer)
   return TRUE;
 }
 
+/* The bufqueue has the newest buffer at index 0, so the index of a queued
+ * buffer changes with every new buffer. The index on the bufqueue numbers the
+ * buffers in the order they were queued instead: the buffer at index i has
+ * number bufindex.seq - i. For the queued buffers, oldest first, it keeps:
+ *
+ *  - the number of bytes queued until each buffer, so that the bytes in any
+ *    range of buffers are one subtraction and byte limits a binary search.
+ *  - the numbers of the sync frames, so that the sync frame closest to an
+ *    index is a binary search.
+ *  - the timestamps of the buffers with a lower timestamp than all newer
+ *    buffers. These increase with the buffer number, also when the
+ *    timestamps of the stream don't, and the newest buffer with a timestamp
+ *    below a given time is always one of them.
+ *
+ * The index is updated with the clients lock when a buffer is queued or
+ * removed from the bufqueue, so that finding the position of a new client
+ * does not need to scan the queue.
+ */
+typedef struct
+{
+  guint64 seq;
+  GstClockTime timestamp;
+} GstMultiHandleSinkIndexTime;
+
+#define INDEX_LEN(array,start)          ((array)->len - (start))
+#define INDEX_SEQ(array,start,i)        g_array_index (array, guint64, (start) + (i))
+#define INDEX_TIME(array,start,i) \
+    g_array_index (array, GstMultiHandleSinkIndexTime, (start) + (i))
+
+static void
+gst_multi_handle_sink_index_init (GstMultiHandleSinkIndex * index)
+{
+  index->seq = 0;
+  index->bytes = g_array_new (FALSE, FALSE, sizeof (guint64));
+  index->bytes_start = 0;
+  index->bytes_base = 0;
+  index->syncframes = g_array_new (FALSE, FALSE, sizeof (guint64));
+  index->syncframes_start = 0;
+  index->times =
+      g_array_new (FALSE, FALSE, sizeof (GstMultiHandleSinkIndexTime));
+  index->times_start = 0;
+}
+
+static void
+gst_multi_handle_sink_index_free (GstMultiHandleSinkIndex * index)
+{
+  g_array_free (index->bytes, TRUE);
+  g_array_free (index->syncframes, TRUE);
+  g_array_free (index->times, TRUE);
+}
+
+static void
+gst_multi_handle_sink_index_clear (GstMultiHandleSinkIndex * index)
+{
+  g_array_set_size (index->bytes, 0);
+  index->bytes_start = 0;
+  index->bytes_base = 0;
+  g_array_set_size (index->syncframes, 0);
+  index->syncframes_start = 0;
+  g_array_set_size (index->times, 0);
+  index->times_start = 0;
+}
+
+/* drop the first element of an index array, the remaining elements are
+ * moved to the front once the dropped ones take half of the array */
+static void
+index_array_drop_first (GArray * array, guint * start)
+{
+  (*start)++;
+  if (*start == array->len) {
+    g_array_set_size (array, 0);
+    *start = 0;
+  } else if (*start >= 64 && *start >= array->len / 2) {
+    g_array_remove_range (array, 0, *start);
+    *start = 0;
+  }
+}
+
+/* add the buffer that was just queued at index 0 */
+static void
+gst_multi_handle_sink_index_push (GstMultiHandleSink * sink,
+    GstBuffer * buffer)
+{
+  GstMultiHandleSinkIndex *index = &sink->bufindex;
+  GstClockTime timestamp;
+  guint64 bytes;
+
+  index->seq++;
+
+  if (INDEX_LEN (index->bytes, index->bytes_start) > 0)
+    bytes = g_array_index (index->bytes, guint64, index->bytes->len - 1);
+  else
+    bytes = index->bytes_base;
+  bytes += gst_buffer_get_size (buffer);
+  g_array_append_val (index->bytes, bytes);
+
+  if (is_sync_frame (sink, buffer))
+    g_array_append_val (index->syncframes, index->seq);
+
+  timestamp = GST_BUFFER_TIMESTAMP (buffer);
+  if (timestamp != -1) {
+    GstMultiHandleSinkIndexTime time;
+
+    /* older buffers with a timestamp that is not lower are not needed
+     * anymore, this buffer is newer and comes first */
+    while (INDEX_LEN (index->times, index->times_start) > 0 &&
+        g_array_index (index->times, GstMultiHandleSinkIndexTime,
+            index->times->len - 1).timestamp >= timestamp)
+      g_array_set_size (index->times, index->times->len - 1);
+
+    time.seq = index->seq;
+    time.timestamp = timestamp;
+    g_array_append_val (index->times, time);
+  }
+}
+
+/* remove the oldest buffer, before it is removed from the bufqueue */
+static void
+gst_multi_handle_sink_index_pop (GstMultiHandleSink * sink)
+{
+  GstMultiHandleSinkIndex *index = &sink->bufindex;
+  guint64 oldest;
+
+  g_return_if_fail (INDEX_LEN (index->bytes, index->bytes_start) > 0);
+
+  oldest = index->seq - INDEX_LEN (index->bytes, index->bytes_start) + 1;
+
+  index->bytes_base = INDEX_SEQ (index->bytes, index->bytes_start, 0);
+  index_array_drop_first (index->bytes, &index->bytes_start);
+
+  if (INDEX_LEN (index->syncframes, index->syncframes_start) > 0 &&
+      INDEX_SEQ (index->syncframes, index->syncframes_start, 0) == oldest)
+    index_array_drop_first (index->syncframes, &index->syncframes_start);
+
+  if (INDEX_LEN (index->times, index->times_start) > 0 &&
+      INDEX_TIME (index->times, index->times_start, 0).seq == oldest)
+    index_array_drop_first (index->times, &index->times_start);
+}
+
+/* find the lowest index so that the buffers from index 0 up to it hold at
+ * least @bytes bytes, or more than @bytes bytes when @above is set.
+ * Returns: the index or -1 if there is not enough data in the queue.
+ */
+static gint
+index_find_bytes (GstMultiHandleSink * sink, guint64 bytes, gboolean above)
+{
+  GstMultiHandleSinkIndex *index = &sink->bufindex;
+  guint64 total, upto;
+  gint len, lo, hi;
+
+  len = INDEX_LEN (index->bytes, index->bytes_start);
+  if (len == 0)
+    return -1;
+
+  total = INDEX_SEQ (index->bytes, index->bytes_start, len - 1);
+  upto = total - index->bytes_base;
+  if (above ? upto <= bytes : upto < bytes)
+    return -1;
+
+  /* the last entry, oldest first, from which the newer buffers still hold
+   * enough bytes */
+  lo = 0;
+  hi = len - 1;
+  while (lo < hi) {
+    gint mid = (lo + hi + 1) / 2;
+
+    upto = total - INDEX_SEQ (index->bytes, index->bytes_start, mid - 1);
+    if (above ? upto > bytes : upto >= bytes)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return len - 1 - lo;
+}
+
+/* find the lowest index of a buffer with a timestamp of at most @time.
+ * Returns: the index or -1 if there is no such buffer.
+ */
+static gint
+index_find_time (GstMultiHandleSink * sink, GstClockTime time)
+{
+  GstMultiHandleSinkIndex *index = &sink->bufindex;
+  gint len, lo, hi;
+
+  len = INDEX_LEN (index->times, index->times_start);
+  if (len == 0 || INDEX_TIME (index->times, index->times_start, 0).timestamp >
+      time)
+    return -1;
+
+  /* the timestamps increase, take the last one that is not above @time */
+  lo = 0;
+  hi = len - 1;
+  while (lo < hi) {
+    gint mid = (lo + hi + 1) / 2;
+
+    if (INDEX_TIME (index->times, index->times_start, mid).timestamp <= time)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  return index->seq - INDEX_TIME (index->times, index->times_start, lo).seq;
+}
+
+/* the timestamp of the newest buffer that has one */
+static GstClockTime
+index_first_time (GstMultiHandleSink * sink)
+{
+  GstMultiHandleSinkIndex *index = &sink->bufindex;
+  gint len;
+
+  len = INDEX_LEN (index->times, index->times_start);
+  if (len == 0)
+    return GST_CLOCK_TIME_NONE;
+
+  return INDEX_TIME (index->times, index->times_start, len - 1).timestamp;
+}
+
+/* find the index of the first buffer, starting from index 0, that satisfies
+ * the time limit @limit, or @len when there is none */
+static gint
+index_find_time_limit (GstMultiHandleSink * sink, GstClockTime limit,
+    gint len)
+{
+  GstClockTime first;
+  gint idx;
+
+  first = index_first_time (sink);
+  if (first == GST_CLOCK_TIME_NONE || first < limit)
+    return len;
+
+  idx = index_find_time (sink, first - limit);
+  return idx == -1 ? len : idx;
+}
+
 /* find the keyframe in the list of buffers starting the
  * search from @idx. @direction as -1 will search backwards, 
  * 1 will search forwards.
@@ -1154,26 +1396,46 @@ is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer)
 gint
 find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction)
 {
-  gint i, len, result;
+  GstMultiHandleSinkIndex *index = &sink->bufindex;
+  gint len, n, lo, hi, result;
+  guint64 seq;
 
   /* take length of queued buffers */
   len = sink->bufqueue->len;
+  if (idx < 0 || idx >= len)
+    return -1;
+
+  /* searching forwards goes to older buffers with lower numbers */
+  seq = index->seq - idx;
+  n = INDEX_LEN (index->syncframes, index->syncframes_start);
+
+  /* the first sync frame with a number of at least @seq */
+  lo = 0;
+  hi = n;
+  while (lo < hi) {
+    gint mid = (lo + hi) / 2;
+
+    if (INDEX_SEQ (index->syncframes, index->syncframes_start, mid) < seq)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
 
-  /* assume we don't find a keyframe */
-  result = -1;
+  if (direction < 0) {
+    if (lo == n)
+      return -1;
+  } else if (lo == n
+      || INDEX_SEQ (index->syncframes, index->syncframes_start, lo) != seq) {
+    if (lo == 0)
+      return -1;
+    lo--;
+  }
 
-  /* then loop over all buffers to find the first keyframe */
-  for (i = idx; i >= 0 && i < len; i += direction) {
-    GstBuffer *buf;
+  result = index->seq - INDEX_SEQ (index->syncframes, index->syncframes_start,
+      lo);
+  GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
+      result, idx, direction);
 
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-    if (is_sync_frame (sink, buf)) {
-      GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
-          i, idx, direction);
-      result = i;
-      break;
-    }
-  }
   return result;
 }
 
@@ -1189,45 +1451,24 @@ get_buffers_max (GstMultiHandleSink * sink, gint64 max)
       return max;
     case GST_FORMAT_TIME:
     {
-      GstBuffer *buf;
-      int i;
-      int len;
-      gint64 diff;
-      GstClockTime first = GST_CLOCK_TIME_NONE;
-
-      len = sink->bufqueue->len;
-
-      for (i = 0; i < len; i++) {
-        buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-        if (GST_BUFFER_TIMESTAMP_IS_VALID (buf)) {
-          if (first == -1)
-            first = GST_BUFFER_TIMESTAMP (buf);
+      GstClockTime first;
+      gint idx;
 
-          diff = first - GST_BUFFER_TIMESTAMP (buf);
+      /* the first buffer that is more than max older than the newest
+       * timestamp */
+      first = index_first_time (sink);
+      if (first == GST_CLOCK_TIME_NONE || first <= max)
+        return sink->bufqueue->len + 1;
 
-          if (diff > max)
-            return i + 1;
-        }
-      }
-      return len + 1;
+      idx = index_find_time (sink, first - max - 1);
+      return idx == -1 ? sink->bufqueue->len + 1 : idx + 1;
     }
     case GST_FORMAT_BYTES:
     {
-      GstBuffer *buf;
-      int i;
-      int len;
-      gint acc = 0;
-
-      len = sink->bufqueue->len;
+      gint idx;
 
-      for (i = 0; i < len; i++) {
-        buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-        acc += gst_buffer_get_size (buf);
-
-        if (acc > max)
-          return i + 1;
-      }
-      return len + 1;
+      idx = index_find_bytes (sink, max, TRUE);
+      return idx == -1 ? sink->bufqueue->len + 1 : idx + 1;
     }
     default:
       return max;
@@ -1251,9 +1492,8 @@ find_limits (GstMultiHandleSink * sink,
     gint * min_idx, gint bytes_min, gint buffers_min, gint64 time_min,
     gint * max_idx, gint bytes_max, gint buffers_max, gint64 time_max)
 {
-  GstClockTime first, time;
-  gint i, len, bytes;
-  gboolean result, max_hit;
+  gint len, min, max, idx;
+  gboolean result;
 
   /* take length of queue */
   len = sink->bufqueue->len;
@@ -1274,76 +1514,39 @@ find_limits (GstMultiHandleSink * sink,
     return FALSE;
   }
 
-  result = FALSE;
-  /* else count bytes and time */
-  first = -1;
-  bytes = 0;
-  /* unset limits */
-  *min_idx = -1;
-  *max_idx = -1;
-  max_hit = FALSE;
-
-  i = 0;
-  /* loop through the buffers, when a limit is ok, mark it 
-   * as -1, we have at least one buffer in the queue. */
-  do {
-    GstBuffer *buf;
-
-    /* if we checked all min limits, update result */
-    if (bytes_min == -1 && time_min == -1 && *min_idx == -1) {
-      /* don't go below 0 */
-      *min_idx = MAX (i - 1, 0);
-    }
-    /* if we reached one max limit break out */
-    if (max_hit) {
-      /* i > 0 when we get here, we subtract one to get the position
-       * of the previous buffer. */
-      *max_idx = i - 1;
-      /* we have valid complete result if we found a min_idx too */
-      result = *min_idx != -1;
-      break;
-    }
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-
-    bytes += gst_buffer_get_size (buf);
-
-    /* take timestamp and save for the base first timestamp */
-    if ((time = GST_BUFFER_TIMESTAMP (buf)) != -1) {
-      GST_LOG_OBJECT (sink, "Ts %" GST_TIME_FORMAT " on buffer",
-          GST_TIME_ARGS (time));
-      if (first == -1)
-        first = time;
-
-      /* increase max usage if we did not fill enough. Note that
-       * buffers are sorted from new to old, so the first timestamp is
-       * bigger than the next one. */
-      if (time_min != -1 && first - time >= time_min)
-        time_min = -1;
-      if (time_max != -1 && first - time >= time_max)
-        max_hit = TRUE;
-    } else {
-      GST_LOG_OBJECT (sink, "No timestamp on buffer");
-    }
-    /* time is OK or unknown, check and increase if not enough bytes */
-    if (bytes_min != -1) {
-      if (bytes >= bytes_min)
-        bytes_min = -1;
-    }
-    if (bytes_max != -1) {
-      if (bytes >= bytes_max) {
-        max_hit = TRUE;
-      }
-    }
-    i++;
+  /* the index of the buffer where each limit is satisfied, len when no
+   * buffer satisfies it. Unset min limits are satisfied before the first
+   * buffer. */
+  min = -1;
+  max = len;
+  if (bytes_min != -1) {
+    idx = index_find_bytes (sink, bytes_min, FALSE);
+    min = MAX (min, idx == -1 ? len : idx);
   }
-  while (i < len);
-
-  /* if we did not hit the max or min limit, set to buffer size */
-  if (*max_idx == -1)
+  if (time_min != -1)
+    min = MAX (min, index_find_time_limit (sink, time_min, len));
+  if (bytes_max != -1) {
+    idx = index_find_bytes (sink, bytes_max, FALSE);
+    max = MIN (max, idx == -1 ? len : idx);
+  }
+  if (time_max != -1)
+    max = MIN (max, index_find_time_limit (sink, time_max, len));
+
+  GST_LOG_OBJECT (sink, "min limits at %d, max limit at %d", min, max);
+
+  /* the buffers up to the one that hit a max limit can be used, unless it is
+   * the last buffer, then we did not have enough data to hit the max. We
+   * have a valid complete result if the min limits are satisfied before the
+   * max. */
+  if (max < len - 1) {
+    *max_idx = max;
+    result = min <= max;
+  } else {
     *max_idx = len - 1;
-  /* make sure min does not exceed max */
-  if (*min_idx == -1)
-    *min_idx = *max_idx;
+    result = FALSE;
+  }
+  /* make sure min does not exceed max, don't go below 0 */
+  *min_idx = MIN (MAX (min, 0), *max_idx);
 
   return result;
 }
@@ -1632,16 +1835,8 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
       newbufpos = MIN (sink->bufqueue->len - 1,
           get_buffers_max (sink, sink->units_soft_max) - 1);
 
-      while (newbufpos >= 0) {
-        GstBuffer *buf;
-
-        buf = g_array_index (sink->bufqueue, GstBuffer *, newbufpos);
-        if (is_sync_frame (sink, buf)) {
-          /* found a buffer that is not a delta unit */
-          break;
-        }
-        newbufpos--;
-      }
+      if (newbufpos >= 0)
+        newbufpos = find_prev_syncframe (sink, newbufpos);
       break;
     default:
       /* unknown recovery procedure */
@@ -1689,6 +1884,7 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   CLIENTS_LOCK (mhsink);
   /* add buffer to queue */
   g_array_prepend_val (mhsink->bufqueue, buffer);
+  gst_multi_handle_sink_index_push (mhsink, buffer);
   queuelen = mhsink->bufqueue->len;
 
   if (mhsink->units_max > 0)
@@ -1794,7 +1990,6 @@ restart:
       mhsink->def_sync_method == GST_SYNC_METHOD_BURST_KEYFRAME) {
     /* no point in searching beyond the queue length */
     gint limit = queuelen;
-    GstBuffer *buf;
 
     /* no point in searching beyond the soft-max if any. */
     if (soft_max_buffers > 0) {
@@ -1803,14 +1998,11 @@ restart:
     GST_LOG_OBJECT (sink,
         "extending queue to include sync point, now at %d, limit is %d",
         max_buffer_usage, limit);
-    for (i = 0; i < limit; i++) {
-      buf = g_array_index (mhsink->bufqueue, GstBuffer *, i);
-      if (is_sync_frame (mhsink, buf)) {
-        /* found a sync frame, now extend the buffer usage to
-         * include at least this frame. */
-        max_buffer_usage = MAX (max_buffer_usage, i);
-        break;
-      }
+    i = find_next_syncframe (mhsink, 0);
+    if (i != -1 && i < limit) {
+      /* found a sync frame, now extend the buffer usage to
+       * include at least this frame. */
+      max_buffer_usage = MAX (max_buffer_usage, i);
     }
     GST_LOG_OBJECT (sink, "max buffer usage is now %d", max_buffer_usage);
   }
@@ -1826,6 +2018,7 @@ restart:
     /* queue exceeded max size */
     queuelen--;
     old = g_array_index (mhsink->bufqueue, GstBuffer *, i);
+    gst_multi_handle_sink_index_pop (mhsink);
     mhsink->bufqueue = g_array_remove_index (mhsink->bufqueue, i);
 
     /* unref tail buffer */
@@ -2204,6 +2397,7 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
       gst_buffer_unref (buf);
       mhsink->bufqueue = g_array_remove_index (mhsink->bufqueue, i);
     }
+    gst_multi_handle_sink_index_clear (&mhsink->bufindex);
     /* freeing the array is done in _finalize */
   }
   GST_OBJECT_FLAG_UNSET (mhsink, GST_MULTI_HANDLE_SINK_OPEN);
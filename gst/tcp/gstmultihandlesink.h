@@ -171,6 +171,24 @@ typedef struct {
   guint64 last_buffer_ts;
 } GstMultiHandleClient;
 
+/* index on the global queue of buffers, see gstmultihandlesink.c
+ */
+typedef struct {
+  guint64 seq;                  /* number of the newest queued buffer */
+
+  GArray *bytes;                /* bytes queued until each buffer, oldest
+                                   buffer first */
+  guint bytes_start;
+  guint64 bytes_base;           /* bytes queued before the oldest buffer */
+
+  GArray *syncframes;           /* numbers of the queued sync frames */
+  guint syncframes_start;
+
+  GArray *times;                /* timestamps that are lower than the ones
+                                   of all newer buffers */
+  guint times_start;
+} GstMultiHandleSinkIndex;
+
 #define CLIENTS_LOCK_INIT(mhsink)       (g_rec_mutex_init(&(mhsink)->clientslock))
 #define CLIENTS_LOCK_CLEAR(mhsink)      (g_rec_mutex_clear(&(mhsink)->clientslock))
 #define CLIENTS_LOCK(mhsink)            (g_rec_mutex_lock(&(mhsink)->clientslock))
@@ -205,6 +223,7 @@ struct _GstMultiHandleSink {
   gint qos_dscp;
 
   GArray *bufqueue;     /* global queue of buffers */
+  GstMultiHandleSinkIndex bufindex; /* index on the bufqueue */
 
   gboolean running;     /* the thread state */
   GThread *thread;      /* the sender thread */
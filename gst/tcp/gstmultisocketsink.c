@@ -105,6 +105,7 @@
 #include <gst/gst-i18n-plugin.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
 
+#include <limits.h>
 #include <string.h>
 
 #include "gstmultisocketsink.h"
@@ -113,6 +114,12 @@
 #include <netinet/in.h>
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 #define NOT_IMPLEMENTED 0
 
 GST_DEBUG_CATEGORY_STATIC (multisocketsink_debug);
@@ -138,15 +145,38 @@ enum
 
 #define DEFAULT_SEND_DISPATCHED FALSE
 #define DEFAULT_SEND_MESSAGES   FALSE
+#define DEFAULT_IO_MODE         GST_MULTI_SOCKET_SINK_IO_MODE_MAIN_CONTEXT
+#define DEFAULT_N_THREADS       1
 
 enum
 {
   PROP_0,
   PROP_SEND_DISPATCHED,
   PROP_SEND_MESSAGES,
+  PROP_IO_MODE,
+  PROP_N_THREADS,
   PROP_LAST
 };
 
+GType
+gst_multi_socket_sink_io_mode_get_type (void)
+{
+  static GType io_mode_type = 0;
+  static const GEnumValue io_mode[] = {
+    {GST_MULTI_SOCKET_SINK_IO_MODE_MAIN_CONTEXT,
+        "One main context source per client", "main-context"},
+    {GST_MULTI_SOCKET_SINK_IO_MODE_EPOLL,
+        "Edge-triggered epoll (Linux only)", "epoll"},
+    {0, NULL, NULL},
+  };
+
+  if (!io_mode_type) {
+    io_mode_type =
+        g_enum_register_static ("GstMultiSocketSinkIOMode", io_mode);
+  }
+  return io_mode_type;
+}
+
 static void gst_multi_socket_sink_finalize (GObject * object);
 
 static void gst_multi_socket_sink_add (GstMultiSocketSink * sink,
@@ -185,6 +215,7 @@ static void gst_multi_socket_sink_hash_adding (GstMultiHandleSink * mhsink,
     GstMultiHandleClient * mhclient);
 static void gst_multi_socket_sink_hash_removing (GstMultiHandleSink * mhsink,
     GstMultiHandleClient * mhclient);
+static void gst_multi_socket_sink_hash_changed (GstMultiHandleSink * mhsink);
 static void gst_multi_socket_sink_stop_sending (GstMultiSocketSink * sink,
     GstSocketClient * client);
 
@@ -259,6 +290,42 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
       g_param_spec_boolean ("send-messages", "Send Messages",
           "If GstNetworkMessage events should be pushed", DEFAULT_SEND_MESSAGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMultiSocketSink:io-mode:
+   *
+   * How to wait for the client sockets. By default every client socket gets
+   * its own #GSource, which makes every wakeup cost proportional to the
+   * number of clients. In epoll mode all client sockets are registered
+   * edge-triggered in one epoll set and the ready clients are handled in
+   * batches, which scales to many thousands of clients. Epoll is only
+   * available on Linux, elsewhere the main context mode is used.
+   *
+   * The mode is picked up when the element goes to READY.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_IO_MODE,
+      g_param_spec_enum ("io-mode", "IO mode",
+          "How to wait for the client sockets",
+          GST_TYPE_MULTI_SOCKET_SINK_IO_MODE, DEFAULT_IO_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstMultiSocketSink:n-threads:
+   *
+   * Number of threads that serve the clients. Every client is assigned to
+   * the thread with the fewest clients and the threads write to their
+   * clients in parallel, so that one slow client does not hold up the
+   * others. 0 uses one thread per core.
+   *
+   * The number of threads is picked up when the element goes to READY.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Number of threads serving the clients (0 = number of cores)",
+          0, G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   /**
    * GstMultiSocketSink::add:
@@ -333,6 +400,9 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
    *     disconnected/removed, time the client is/was active, last activity
    *     time (in epoch seconds), number of buffers dropped.
    *     All times are expressed in nanoseconds (GstClockTime).
+   *     Since 1.12 it also contains the number of writes to the socket
+   *     ("writes") and the number of buffers that were written along with
+   *     another buffer instead of with a write of their own ("writes-saved").
    */
   gst_multi_socket_sink_signals[SIGNAL_GET_STATS] =
       g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
@@ -435,6 +505,8 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
       GST_DEBUG_FUNCPTR (gst_multi_socket_sink_hash_adding);
   gstmultihandlesink_class->hash_removing =
       GST_DEBUG_FUNCPTR (gst_multi_socket_sink_hash_removing);
+  gstmultihandlesink_class->hash_changed =
+      GST_DEBUG_FUNCPTR (gst_multi_socket_sink_hash_changed);
 
   GST_DEBUG_CATEGORY_INIT (multisocketsink_debug, "multisocketsink", 0,
       "Multi socket sink");
@@ -450,6 +522,8 @@ gst_multi_socket_sink_init (GstMultiSocketSink * this)
   this->cancellable = g_cancellable_new ();
   this->send_dispatched = DEFAULT_SEND_DISPATCHED;
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->io_mode = DEFAULT_IO_MODE;
+  this->n_threads = DEFAULT_N_THREADS;
 }
 
 static void
@@ -528,17 +602,47 @@ gst_multi_socket_sink_remove_flush (GstMultiSocketSink * sink, GSocket * socket)
 static GstStructure *
 gst_multi_socket_sink_get_stats (GstMultiSocketSink * sink, GSocket * socket)
 {
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiSinkHandle handle;
+  GstStructure *result;
+  GList *clink;
 
   handle.socket = socket;
-  return gst_multi_handle_sink_get_stats (GST_MULTI_HANDLE_SINK_CAST (sink),
-      handle);
+  result = gst_multi_handle_sink_get_stats (mhsink, handle);
+
+  CLIENTS_LOCK (mhsink);
+  clink = g_hash_table_lookup (mhsink->handle_hash, socket);
+  if (clink != NULL) {
+    GstSocketClient *client = clink->data;
+
+    gst_structure_set (result,
+        "writes", G_TYPE_UINT64, client->writes,
+        "writes-saved", G_TYPE_UINT64, client->writes_saved, NULL);
+  }
+  CLIENTS_UNLOCK (mhsink);
+
+  return result;
+}
+
+/* the shard with the fewest clients, called with the clients lock */
+static GstMultiSocketSinkShard *
+gst_multi_socket_sink_pick_shard (GstMultiSocketSink * sink)
+{
+  GstMultiSocketSinkShard *shard = NULL;
+  guint i;
+
+  for (i = 0; i < sink->n_shards; i++) {
+    if (shard == NULL || sink->shards[i].n_clients < shard->n_clients)
+      shard = &sink->shards[i];
+  }
+  return shard;
 }
 
 static GstMultiHandleClient *
 gst_multi_socket_sink_new_client (GstMultiHandleSink * mhsink,
     GstMultiSinkHandle handle, GstSyncMethod sync_method)
 {
+  GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GstSocketClient *client;
   GstMultiHandleClient *mhclient;
   GstMultiHandleSinkClass *mhsinkclass =
@@ -549,6 +653,11 @@ gst_multi_socket_sink_new_client (GstMultiHandleSink * mhsink,
   client = g_new0 (GstSocketClient, 1);
   mhclient = (GstMultiHandleClient *) client;
 
+  client->shard = gst_multi_socket_sink_pick_shard (sink);
+  if (client->shard)
+    client->shard->n_clients++;
+  client->serial = sink->client_serial++;
+
   mhclient->handle.socket = G_SOCKET (g_object_ref (handle.socket));
 
   gst_multi_handle_sink_client_init (mhclient, sync_method);
@@ -773,29 +882,218 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
 
 #define CMSG_MAX 255
 
+/* a client that is behind gets several queued buffers in one write, up to
+ * this many memories and about this many bytes */
+#if defined (IOV_MAX) && IOV_MAX < 64
+#define WRITE_MAX_VECTORS IOV_MAX
+#else
+#define WRITE_MAX_VECTORS 64
+#endif
+#define WRITE_MAX_BYTES (64 * 1024)
+
+/* Write @n_buffers buffers, starting at @bufoffset in the first one, with a
+ * single vectored write. Only the control messages of the first buffer are
+ * sent, so buffers with control messages must be written on their own. */
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
-    GSocket * sock, GstBuffer * buffer, gsize bufoffset,
+    GSocket * sock, GstBuffer ** buffers, guint n_buffers, gsize bufoffset,
     GCancellable * cancellable, GError ** err)
 {
-  GstMapInfo maps[8];
-  GOutputVector vec[8];
-  guint mems_mapped;
+  GstMapInfo maps[WRITE_MAX_VECTORS];
+  GOutputVector vec[WRITE_MAX_VECTORS];
+  guint mems_mapped = 0, i, j;
   gssize wrote;
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
 
-  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
+  for (i = 0; i < n_buffers && mems_mapped < WRITE_MAX_VECTORS; i++) {
+    gsize offset = i == 0 ? bufoffset : 0;
+    gsize left = gst_buffer_get_size (buffers[i]) - offset;
+    guint n;
+
+    if (left == 0)
+      continue;
 
-  msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
+    n = map_n_memory_output_vector (buffers[i], offset, vec + mems_mapped,
+        maps + mems_mapped, WRITE_MAX_VECTORS - mems_mapped);
+    for (j = 0; j < n; j++)
+      left -= vec[mems_mapped + j].size;
+    mems_mapped += n;
+
+    /* the rest of the buffer did not fit, the next one can't follow */
+    if (left > 0)
+      break;
+  }
+
+  msg_count = gst_buffer_get_cmsg_list (buffers[0], cmsgs, CMSG_MAX);
 
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
       cancellable, err);
-  unmap_n_memorys (maps, mems_mapped);
+  if (mems_mapped > 0)
+    unmap_n_memorys (maps, mems_mapped);
   return wrote;
 }
 
+/* Write the first buffers of the sending queue of the client. With more than
+ * one shard the clients lock is released while writing, so that the other
+ * shards can serve their clients in the meantime. The clients lock must be
+ * held once, not recursively.
+ *
+ * Returns FALSE when the client was removed while the lock was released, the
+ * client must not be touched anymore in that case. */
+static gboolean
+gst_multi_socket_sink_client_write (GstMultiSocketSink * sink,
+    GstSocketClient * client, GstBuffer ** buffers, guint n_buffers,
+    gssize * wrote, GError ** err)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GSocket *socket;
+  GCancellable *cancellable;
+  gsize bufoffset;
+  guint serial, i;
+  GList *clink;
+  gboolean alive;
+
+  if (sink->n_shards <= 1) {
+    *wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket,
+        buffers, n_buffers, mhclient->bufoffset, sink->cancellable, err);
+    return TRUE;
+  }
+
+  /* keep everything we need alive, the client can be removed meanwhile */
+  socket = g_object_ref (mhclient->handle.socket);
+  cancellable = g_object_ref (sink->cancellable);
+  for (i = 0; i < n_buffers; i++)
+    gst_buffer_ref (buffers[i]);
+  bufoffset = mhclient->bufoffset;
+  serial = client->serial;
+
+  CLIENTS_UNLOCK (mhsink);
+  *wrote = gst_multi_socket_sink_write (sink, socket, buffers, n_buffers,
+      bufoffset, cancellable, err);
+  CLIENTS_LOCK (mhsink);
+
+  /* the socket can't be reused by another client while we hold a ref, but
+   * the client can have been removed and the socket added again */
+  clink = g_hash_table_lookup (mhsink->handle_hash, socket);
+  alive = clink != NULL && clink->data == client && client->serial == serial
+      && !mhclient->currently_removing;
+  if (!alive) {
+    GST_DEBUG_OBJECT (sink, "client on socket %p removed while writing",
+        socket);
+    g_clear_error (err);
+  }
+
+  for (i = 0; i < n_buffers; i++)
+    gst_buffer_unref (buffers[i]);
+  g_object_unref (cancellable);
+  g_object_unref (socket);
+
+  return alive;
+}
+
+/* Move the next buffer of the global queue to the sending queue of the
+ * client. Returns FALSE when the client has no buffer to pick. */
+static gboolean
+gst_multi_socket_sink_client_pick_buffer (GstMultiSocketSink * sink,
+    GstSocketClient * client, gboolean flushing)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  GstBuffer *buf;
+  GstClockTime timestamp;
+
+  if (mhclient->bufpos == -1)
+    return FALSE;
+
+  /* for new connections, we need to find a good spot in the
+   * bufqueue to start streaming from */
+  if (mhclient->new_connection && !flushing) {
+    gint position = gst_multi_handle_sink_new_client_position (mhsink, mhclient);
+
+    if (position < 0)
+      return FALSE;
+
+    /* we got a valid spot in the queue */
+    mhclient->new_connection = FALSE;
+    mhclient->bufpos = position;
+  }
+
+  /* we flushed all remaining buffers, no need to get a new one */
+  if (mhclient->flushcount == 0)
+    return FALSE;
+
+  /* grab buffer */
+  buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
+  mhclient->bufpos--;
+
+  /* update stats */
+  timestamp = GST_BUFFER_TIMESTAMP (buf);
+  if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
+    mhclient->first_buffer_ts = timestamp;
+  if (timestamp != -1)
+    mhclient->last_buffer_ts = timestamp;
+
+  /* decrease flushcount */
+  if (mhclient->flushcount != -1)
+    mhclient->flushcount--;
+
+  GST_LOG_OBJECT (sink, "%s client %p at position %d",
+      mhclient->debug, client, mhclient->bufpos);
+
+  /* queueing a buffer will ref it */
+  mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+
+  return TRUE;
+}
+
+/* Pick more buffers from the global queue until the sending queue of the
+ * client holds enough to fill one write, and collect the buffers to write
+ * into @buffers. A buffer with control messages is written on its own.
+ *
+ * Returns the number of buffers in @buffers, 0 when the client has nothing
+ * to send. */
+static guint
+gst_multi_socket_sink_client_gather (GstMultiSocketSink * sink,
+    GstSocketClient * client, gboolean flushing, GstBuffer ** buffers)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GSList *walk = mhclient->sending, *last = NULL;
+  gsize bytes = 0;
+  guint n_buffers = 0;
+
+  while (TRUE) {
+    for (; walk; last = walk, walk = walk->next) {
+      GstBuffer *buf = walk->data;
+
+      if (n_buffers == WRITE_MAX_VECTORS || bytes >= WRITE_MAX_BYTES)
+        return n_buffers;
+
+      if (gst_buffer_get_meta (buf, GST_NET_CONTROL_MESSAGE_META_API_TYPE)) {
+        if (n_buffers == 0)
+          buffers[n_buffers++] = buf;
+        return n_buffers;
+      }
+
+      buffers[n_buffers++] = buf;
+      bytes += gst_buffer_get_size (buf);
+      if (n_buffers == 1)
+        bytes -= mhclient->bufoffset;
+    }
+
+    if (n_buffers == WRITE_MAX_VECTORS || bytes >= WRITE_MAX_BYTES
+        || !gst_multi_socket_sink_client_pick_buffer (sink, client, flushing))
+      return n_buffers;
+
+    /* continue with the buffers that were just queued */
+    walk = last ? last->next : mhclient->sending;
+  }
+}
+
 /* Handle a write on a client,
  * which indicates a read request from a client.
  *
@@ -805,18 +1103,21 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
  * We first check to see if we need to send streamheaders. If so, we queue them.
  *
  * Then we run into the main loop that tries to send as many buffers as
- * possible. It will first exhaust the mhclient->sending queue and if the queue
- * is empty, it will pick a buffer from the global queue.
+ * possible. It picks buffers from the global queue into the mhclient->sending
+ * queue until there is enough data for one write, so that a client that is
+ * behind catches up with a few large writes instead of one write per buffer.
  *
  * Sending the buffers from the mhclient->sending queue is basically writing
  * the bytes to the socket and maintaining a count of the bytes that were
- * sent. When the buffer is completely sent, it is removed from the
- * mhclient->sending queue and we try to pick a new buffer for sending.
+ * sent. When a buffer is completely sent, it is removed from the
+ * mhclient->sending queue and we try to pick new buffers for sending.
  *
  * When the sending returns a partial buffer we stop sending more data as
  * the next send operation could block.
  *
- * This functions returns FALSE if some error occured.
+ * This functions returns FALSE if some error occured. When the client was
+ * removed by another thread while writing, TRUE is returned and the client
+ * must not be touched anymore.
  */
 static gboolean
 gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
@@ -829,9 +1130,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   GError *err = NULL;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
-
 
   g_get_current_time (&nowtv);
   now = GST_TIMEVAL_TO_TIME (nowtv);
@@ -840,120 +1138,81 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
 
   more = TRUE;
   do {
-    if (!mhclient->sending) {
-      /* client is not working on a buffer */
-      if (mhclient->bufpos == -1) {
-        /* client is too fast, remove from write queue until new buffer is
-         * available */
-        gst_multi_socket_sink_stop_sending (sink, client);
-
-        /* if we flushed out all of the client buffers, we can stop */
-        if (mhclient->flushcount == 0)
-          goto flushed;
-
-        return TRUE;
-      } else {
-        /* client can pick a buffer from the global queue */
-        GstBuffer *buf;
-        GstClockTime timestamp;
-
-        /* for new connections, we need to find a good spot in the
-         * bufqueue to start streaming from */
-        if (mhclient->new_connection && !flushing) {
-          gint position =
-              gst_multi_handle_sink_new_client_position (mhsink, mhclient);
-
-          if (position >= 0) {
-            /* we got a valid spot in the queue */
-            mhclient->new_connection = FALSE;
-            mhclient->bufpos = position;
-          } else {
-            /* cannot send data to this client yet */
-            gst_multi_socket_sink_stop_sending (sink, client);
-            return TRUE;
-          }
-        }
-
-        /* we flushed all remaining buffers, no need to get a new one */
-        if (mhclient->flushcount == 0)
-          goto flushed;
-
-        /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
-
-        /* update stats */
-        timestamp = GST_BUFFER_TIMESTAMP (buf);
-        if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
-          mhclient->first_buffer_ts = timestamp;
-        if (timestamp != -1)
-          mhclient->last_buffer_ts = timestamp;
-
-        /* decrease flushcount */
-        if (mhclient->flushcount != -1)
-          mhclient->flushcount--;
-
-        GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
-
-        /* queueing a buffer will ref it */
-        mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+    GstBuffer *buffers[WRITE_MAX_VECTORS];
+    guint n_buffers;
+    gssize wrote;
+
+    n_buffers =
+        gst_multi_socket_sink_client_gather (sink, client, flushing, buffers);
+    if (n_buffers == 0) {
+      /* client is too fast or can't start yet, remove from write queue until
+       * new buffer is available */
+      gst_multi_socket_sink_stop_sending (sink, client);
+
+      /* if we flushed out all of the client buffers, we can stop */
+      if (mhclient->flushcount == 0)
+        goto flushed;
+
+      return TRUE;
+    }
 
-        /* need to start from the first byte for this new buffer */
-        mhclient->bufoffset = 0;
-      }
+    if (!gst_multi_socket_sink_client_write (sink, client, buffers, n_buffers,
+            &wrote, &err)) {
+      /* removed by another thread, nothing left to do */
+      return TRUE;
     }
 
-    /* see if we need to send something */
-    if (mhclient->sending) {
-      gssize wrote;
-      GstBuffer *head;
-
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
-
-      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
-          mhclient->bufoffset, sink->cancellable, &err);
-
-      if (wrote < 0) {
-        /* hmm error.. */
-        if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CLOSED)) {
-          goto connection_reset;
-        } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
-          /* write would block, try again later */
-          GST_LOG_OBJECT (sink, "write would block %p",
-              mhclient->handle.socket);
-          more = FALSE;
-          g_clear_error (&err);
-        } else {
-          goto write_error;
-        }
+    if (wrote < 0) {
+      /* hmm error.. */
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CLOSED)) {
+        goto connection_reset;
+      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        /* write would block, try again later */
+        GST_LOG_OBJECT (sink, "write would block %p", mhclient->handle.socket);
+        client->writable = FALSE;
+        more = FALSE;
+        g_clear_error (&err);
       } else {
-        if (wrote < (gst_buffer_get_size (head) - mhclient->bufoffset)) {
+        goto write_error;
+      }
+    } else {
+      gsize left = wrote;
+      guint i;
+
+      for (i = 0; i < n_buffers; i++) {
+        GstBuffer *head = buffers[i];
+        gsize size = gst_buffer_get_size (head) - mhclient->bufoffset;
+
+        if (left < size) {
           /* partial write, try again now */
           GST_LOG_OBJECT (sink,
               "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
               mhclient->handle.socket, wrote);
-          mhclient->bufoffset += wrote;
-        } else {
-          if (sink->send_dispatched) {
-            gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
-                gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
-                    gst_structure_new ("GstNetworkMessageDispatched",
-                        "object", G_TYPE_OBJECT, mhclient->handle.socket,
-                        "buffer", GST_TYPE_BUFFER, head, NULL)));
-          }
-          /* complete buffer was written, we can proceed to the next one */
-          mhclient->sending = g_slist_remove (mhclient->sending, head);
-          gst_buffer_unref (head);
-          /* make sure we start from byte 0 for the next buffer */
-          mhclient->bufoffset = 0;
+          mhclient->bufoffset += left;
+          break;
+        }
+        left -= size;
+
+        if (sink->send_dispatched) {
+          gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
+              gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
+                  gst_structure_new ("GstNetworkMessageDispatched",
+                      "object", G_TYPE_OBJECT, mhclient->handle.socket,
+                      "buffer", GST_TYPE_BUFFER, head, NULL)));
         }
-        /* update stats */
-        mhclient->bytes_sent += wrote;
-        mhclient->last_activity_time = now;
-        mhsink->bytes_served += wrote;
+        /* complete buffer was written, we can proceed to the next one */
+        mhclient->sending = g_slist_remove (mhclient->sending, head);
+        gst_buffer_unref (head);
+        /* make sure we start from byte 0 for the next buffer */
+        mhclient->bufoffset = 0;
       }
+      /* update stats */
+      client->writes++;
+      if (i > 1)
+        client->writes_saved += i - 1;
+      mhclient->bytes_sent += wrote;
+      mhclient->last_activity_time = now;
+      mhsink->bytes_served += wrote;
     }
   } while (more);
 
@@ -998,13 +1257,13 @@ ensure_condition (GstMultiSocketSink * sink, GstSocketClient * client,
     g_source_destroy (client->source);
     g_source_unref (client->source);
   }
-  if (condition && sink->main_context) {
+  if (condition && client->shard) {
     client->source = g_socket_create_source (mhclient->handle.socket,
         condition, sink->cancellable);
     g_source_set_callback (client->source,
         (GSourceFunc) gst_multi_socket_sink_socket_condition,
         gst_object_ref (sink), (GDestroyNotify) gst_object_unref);
-    g_source_attach (client->source, sink->main_context);
+    g_source_attach (client->source, client->shard->main_context);
   } else {
     client->source = NULL;
     condition = 0;
@@ -1012,6 +1271,70 @@ ensure_condition (GstMultiSocketSink * sink, GstSocketClient * client,
   client->condition = condition;
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+/* In epoll mode the sockets are registered once, edge-triggered, for reading
+ * and writing. Instead of changing the registration when a client runs out of
+ * data, we remember if the socket is still writable and queue the client on
+ * the pending queue when new data arrives for it. Called with the clients
+ * lock. */
+static void
+epoll_client_add (GstMultiSocketSink * sink, GstSocketClient * client)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiSocketSinkShard *shard = client->shard;
+
+  if (shard == NULL)
+    return;
+
+  if (!client->registered) {
+    struct epoll_event ev;
+
+    ev.events = EPOLLIN | EPOLLPRI | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = mhclient->handle.socket;
+    if (epoll_ctl (shard->epoll_fd, EPOLL_CTL_ADD,
+            g_socket_get_fd (mhclient->handle.socket), &ev) < 0) {
+      GST_WARNING_OBJECT (sink, "%s could not add socket to epoll set: %s",
+          mhclient->debug, g_strerror (errno));
+      return;
+    }
+    client->registered = TRUE;
+    /* the current state is reported as the first edge */
+    client->writable = FALSE;
+  }
+
+  client->want_write = TRUE;
+  if (client->writable && !client->pending) {
+    client->pending_link.data = client;
+    g_queue_push_tail_link (&shard->epoll_pending, &client->pending_link);
+    client->pending = TRUE;
+    g_atomic_int_set (&shard->epoll_wakeup, 1);
+  }
+}
+
+static void
+epoll_client_remove (GstMultiSocketSink * sink, GstSocketClient * client)
+{
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiSocketSinkShard *shard = client->shard;
+
+  if (client->pending) {
+    g_queue_unlink (&shard->epoll_pending, &client->pending_link);
+    client->pending = FALSE;
+  }
+  if (client->registered) {
+    struct epoll_event ev = { 0, };
+
+    if (epoll_ctl (shard->epoll_fd, EPOLL_CTL_DEL,
+            g_socket_get_fd (mhclient->handle.socket), &ev) < 0)
+      GST_WARNING_OBJECT (sink, "%s could not remove socket from epoll set: "
+          "%s", mhclient->debug, g_strerror (errno));
+    client->registered = FALSE;
+  }
+  client->want_write = FALSE;
+  client->writable = FALSE;
+}
+#endif
+
 static void
 gst_multi_socket_sink_hash_adding (GstMultiHandleSink * mhsink,
     GstMultiHandleClient * mhclient)
@@ -1019,6 +1342,13 @@ gst_multi_socket_sink_hash_adding (GstMultiHandleSink * mhsink,
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GstSocketClient *client = (GstSocketClient *) (mhclient);
 
+#ifdef HAVE_SYS_EPOLL_H
+  if (sink->use_epoll) {
+    epoll_client_add (sink, client);
+    return;
+  }
+#endif
+
   ensure_condition (sink, client,
       G_IO_IN | G_IO_OUT | G_IO_PRI | G_IO_ERR | G_IO_HUP);
 }
@@ -1030,39 +1360,63 @@ gst_multi_socket_sink_hash_removing (GstMultiHandleSink * mhsink,
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GstSocketClient *client = (GstSocketClient *) (mhclient);
 
-  ensure_condition (sink, client, 0);
+#ifdef HAVE_SYS_EPOLL_H
+  if (sink->use_epoll)
+    epoll_client_remove (sink, client);
+  else
+#endif
+    ensure_condition (sink, client, 0);
+
+  if (client->shard) {
+    client->shard->n_clients--;
+    client->shard = NULL;
+  }
+}
+
+static void
+gst_multi_socket_sink_hash_changed (GstMultiHandleSink * mhsink)
+{
+  GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
+
+  guint i;
+
+  /* in epoll mode nothing is attached to the main context when a client
+   * can send again, so wake up the threads ourselves */
+  if (!sink->use_epoll)
+    return;
+
+  for (i = 0; i < sink->n_shards; i++) {
+    GstMultiSocketSinkShard *shard = &sink->shards[i];
+
+    if (g_atomic_int_get (&shard->epoll_wakeup))
+      g_main_context_wakeup (shard->main_context);
+  }
 }
 
 static void
 gst_multi_socket_sink_stop_sending (GstMultiSocketSink * sink,
     GstSocketClient * client)
 {
+  if (sink->use_epoll) {
+    client->want_write = FALSE;
+    return;
+  }
+
   ensure_condition (sink, client, G_IO_IN | G_IO_PRI | G_IO_ERR | G_IO_HUP);
 }
 
-/* Handle the clients. This is called when a socket becomes ready
- * to read or writable. Badly behaving clients are put on a
- * garbage list and removed.
+/* Handle the clients. This is called with the clients lock when a socket
+ * becomes ready to read or writable. Badly behaving clients are put on a
+ * garbage list and removed. Returns FALSE when the client was removed.
  */
 static gboolean
-gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
-    GIOCondition condition, GstMultiSocketSink * sink)
+gst_multi_socket_sink_handle_condition (GstMultiSocketSink * sink,
+    GList * clink, GIOCondition condition)
 {
-  GList *clink;
   GstSocketClient *client;
   gboolean ret = TRUE;
   GstMultiHandleClient *mhclient;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
-
-  CLIENTS_LOCK (mhsink);
-  clink = g_hash_table_lookup (mhsink->handle_hash,
-      mhsinkclass->handle_hash_key (handle));
-  if (clink == NULL) {
-    ret = FALSE;
-    goto done;
-  }
 
   client = clink->data;
   mhclient = (GstMultiHandleClient *) client;
@@ -1104,11 +1458,192 @@ gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
   }
 
 done:
+  return ret;
+}
+
+static gboolean
+gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
+    GIOCondition condition, GstMultiSocketSink * sink)
+{
+  GList *clink;
+  gboolean ret = FALSE;
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+
+  CLIENTS_LOCK (mhsink);
+  clink = g_hash_table_lookup (mhsink->handle_hash,
+      mhsinkclass->handle_hash_key (handle));
+  if (clink != NULL)
+    ret = gst_multi_socket_sink_handle_condition (sink, clink, condition);
   CLIENTS_UNLOCK (mhsink);
 
   return ret;
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+#define EPOLL_MAX_EVENTS 256
+
+/* one source for all the client sockets, dispatched when the epoll set has
+ * ready sockets or when clients were queued on the pending queue */
+typedef struct
+{
+  GSource source;
+
+  GstMultiSocketSinkShard *shard;
+  gpointer tag;
+} GstMultiSocketSinkEpollSource;
+
+static void
+gst_multi_socket_sink_epoll_dispatch (GstMultiSocketSinkShard * shard)
+{
+  GstMultiSocketSink *sink = shard->sink;
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  GstMultiSinkHandle handle;
+  GList *clink, *link;
+  gint i, n;
+
+  /* sockets that don't fit in this batch stay ready in the epoll set and are
+   * picked up in the next iteration */
+  n = epoll_wait (shard->epoll_fd, events, EPOLL_MAX_EVENTS, 0);
+  if (n < 0) {
+    if (errno != EINTR)
+      GST_WARNING_OBJECT (sink, "epoll_wait failed: %s", g_strerror (errno));
+    n = 0;
+  }
+  GST_LOG_OBJECT (sink, "%d sockets ready, %u clients pending", n,
+      shard->epoll_pending.length);
+
+  CLIENTS_LOCK (mhsink);
+  for (i = 0; i < n; i++) {
+    GstSocketClient *client;
+    GIOCondition condition = 0;
+    guint32 revents = events[i].events;
+
+    /* the client might have been removed while handling a previous one */
+    handle.socket = events[i].data.ptr;
+    clink = g_hash_table_lookup (mhsink->handle_hash,
+        mhsinkclass->handle_hash_key (handle));
+    if (clink == NULL)
+      continue;
+    client = clink->data;
+
+    if (revents & (EPOLLIN | EPOLLPRI))
+      condition |= G_IO_IN;
+    if (revents & EPOLLERR)
+      condition |= G_IO_ERR;
+    if (revents & (EPOLLHUP | EPOLLRDHUP))
+      condition |= G_IO_HUP;
+    if (revents & EPOLLOUT) {
+      client->writable = TRUE;
+      if (client->want_write)
+        condition |= G_IO_OUT;
+    }
+    if (condition)
+      gst_multi_socket_sink_handle_condition (sink, clink, condition);
+  }
+
+  /* clients that got new data while their socket was writable */
+  while ((link = g_queue_pop_head_link (&shard->epoll_pending))) {
+    GstSocketClient *client = link->data;
+
+    client->pending = FALSE;
+    if (!client->want_write || !client->writable)
+      continue;
+
+    handle = ((GstMultiHandleClient *) client)->handle;
+    clink = g_hash_table_lookup (mhsink->handle_hash,
+        mhsinkclass->handle_hash_key (handle));
+    if (clink != NULL)
+      gst_multi_socket_sink_handle_condition (sink, clink, G_IO_OUT);
+  }
+  g_atomic_int_set (&shard->epoll_wakeup, 0);
+  CLIENTS_UNLOCK (mhsink);
+}
+
+static gboolean
+gst_multi_socket_sink_epoll_prepare (GSource * source, gint * timeout)
+{
+  GstMultiSocketSinkEpollSource *esource =
+      (GstMultiSocketSinkEpollSource *) source;
+
+  *timeout = -1;
+
+  return g_atomic_int_get (&esource->shard->epoll_wakeup);
+}
+
+static gboolean
+gst_multi_socket_sink_epoll_check (GSource * source)
+{
+  GstMultiSocketSinkEpollSource *esource =
+      (GstMultiSocketSinkEpollSource *) source;
+
+  return (g_source_query_unix_fd (source, esource->tag) & G_IO_IN) ||
+      g_atomic_int_get (&esource->shard->epoll_wakeup);
+}
+
+static gboolean
+gst_multi_socket_sink_epoll_source_dispatch (GSource * source,
+    GSourceFunc callback, gpointer user_data)
+{
+  GstMultiSocketSinkEpollSource *esource =
+      (GstMultiSocketSinkEpollSource *) source;
+
+  gst_multi_socket_sink_epoll_dispatch (esource->shard);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs gst_multi_socket_sink_epoll_funcs = {
+  gst_multi_socket_sink_epoll_prepare,
+  gst_multi_socket_sink_epoll_check,
+  gst_multi_socket_sink_epoll_source_dispatch,
+  NULL
+};
+
+static gboolean
+gst_multi_socket_sink_epoll_start (GstMultiSocketSinkShard * shard)
+{
+  GstMultiSocketSinkEpollSource *esource;
+
+  shard->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+  if (shard->epoll_fd < 0) {
+    GST_WARNING_OBJECT (shard->sink, "could not create epoll set: %s",
+        g_strerror (errno));
+    shard->epoll_fd = -1;
+    return FALSE;
+  }
+
+  /* the source is destroyed in stop_post, before the sink goes away */
+  shard->epoll_source = g_source_new (&gst_multi_socket_sink_epoll_funcs,
+      sizeof (GstMultiSocketSinkEpollSource));
+  esource = (GstMultiSocketSinkEpollSource *) shard->epoll_source;
+  esource->shard = shard;
+  esource->tag = g_source_add_unix_fd (shard->epoll_source, shard->epoll_fd,
+      G_IO_IN);
+  g_source_attach (shard->epoll_source, shard->main_context);
+
+  return TRUE;
+}
+
+static void
+gst_multi_socket_sink_epoll_stop (GstMultiSocketSinkShard * shard)
+{
+  if (shard->epoll_source) {
+    g_source_destroy (shard->epoll_source);
+    g_source_unref (shard->epoll_source);
+    shard->epoll_source = NULL;
+  }
+  if (shard->epoll_fd != -1) {
+    close (shard->epoll_fd);
+    shard->epoll_fd = -1;
+  }
+}
+#endif
+
 static gboolean
 gst_multi_socket_sink_timeout (GstMultiSocketSink * sink)
 {
@@ -1138,13 +1673,32 @@ gst_multi_socket_sink_timeout (GstMultiSocketSink * sink)
   return FALSE;
 }
 
+/* serves the clients of the other shards */
+static gpointer
+gst_multi_socket_sink_shard_thread (GstMultiSocketSinkShard * shard)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (shard->sink);
+
+  while (mhsink->running)
+    g_main_context_iteration (shard->main_context, TRUE);
+
+  return NULL;
+}
+
 /* we handle the client communication in another thread so that we do not block
- * the gstreamer thread while we select() on the client fds */
+ * the gstreamer thread while we select() on the client fds. This thread
+ * serves the clients of the first shard and checks the timeouts. */
 static gpointer
 gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GSource *timeout = NULL;
+  guint i;
+
+  for (i = 1; i < sink->n_shards; i++) {
+    sink->shards[i].thread = g_thread_new ("multisocketsink",
+        (GThreadFunc) gst_multi_socket_sink_shard_thread, &sink->shards[i]);
+  }
 
   while (mhsink->running) {
     if (mhsink->timeout > 0) {
@@ -1168,6 +1722,11 @@ gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
     }
   }
 
+  for (i = 1; i < sink->n_shards; i++) {
+    g_thread_join (sink->shards[i].thread);
+    sink->shards[i].thread = NULL;
+  }
+
   return NULL;
 }
 
@@ -1184,6 +1743,12 @@ gst_multi_socket_sink_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       sink->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_IO_MODE:
+      sink->io_mode = g_value_get_enum (value);
+      break;
+    case PROP_N_THREADS:
+      sink->n_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1203,6 +1768,12 @@ gst_multi_socket_sink_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, sink->send_messages);
       break;
+    case PROP_IO_MODE:
+      g_value_set_enum (value, sink->io_mode);
+      break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, sink->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1216,18 +1787,53 @@ gst_multi_socket_sink_start_pre (GstMultiHandleSink * mhsink)
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
   GList *clients;
+  guint i;
 
   GST_INFO_OBJECT (mssink, "starting");
 
-  mssink->main_context = g_main_context_new ();
+  mssink->n_shards = mssink->n_threads;
+  if (mssink->n_shards == 0)
+    mssink->n_shards = g_get_num_processors ();
+
+  mssink->shards = g_new0 (GstMultiSocketSinkShard, mssink->n_shards);
+  for (i = 0; i < mssink->n_shards; i++) {
+    GstMultiSocketSinkShard *shard = &mssink->shards[i];
+
+    shard->sink = mssink;
+    shard->main_context = g_main_context_new ();
+    shard->epoll_fd = -1;
+    g_queue_init (&shard->epoll_pending);
+  }
+  mssink->main_context = mssink->shards[0].main_context;
+
+  mssink->use_epoll = FALSE;
+  if (mssink->io_mode == GST_MULTI_SOCKET_SINK_IO_MODE_EPOLL) {
+#ifdef HAVE_SYS_EPOLL_H
+    mssink->use_epoll = TRUE;
+    for (i = 0; i < mssink->n_shards && mssink->use_epoll; i++)
+      mssink->use_epoll = gst_multi_socket_sink_epoll_start (&mssink->shards[i]);
+    if (!mssink->use_epoll) {
+      for (i = 0; i < mssink->n_shards; i++)
+        gst_multi_socket_sink_epoll_stop (&mssink->shards[i]);
+    }
+#endif
+    if (!mssink->use_epoll)
+      GST_WARNING_OBJECT (mssink, "epoll not available, using main context");
+  }
+  GST_DEBUG_OBJECT (mssink, "using %s with %u threads",
+      mssink->use_epoll ? "epoll" : "main context", mssink->n_shards);
 
   CLIENTS_LOCK (mhsink);
   for (clients = mhsink->clients; clients; clients = clients->next) {
     GstSocketClient *client = clients->data;
     GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
 
-    if (client->source)
+    if (client->source || client->registered)
       continue;
+    if (client->shard == NULL) {
+      client->shard = gst_multi_socket_sink_pick_shard (mssink);
+      client->shard->n_clients++;
+    }
     mhsinkclass->hash_adding (mhsink, mhclient);
   }
   CLIENTS_UNLOCK (mhsink);
@@ -1245,20 +1851,31 @@ static void
 gst_multi_socket_sink_stop_pre (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
+  guint i;
 
-  if (mssink->main_context)
-    g_main_context_wakeup (mssink->main_context);
+  for (i = 0; i < mssink->n_shards; i++)
+    g_main_context_wakeup (mssink->shards[i].main_context);
 }
 
 static void
 gst_multi_socket_sink_stop_post (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
+  guint i;
 
-  if (mssink->main_context) {
-    g_main_context_unref (mssink->main_context);
-    mssink->main_context = NULL;
+  for (i = 0; i < mssink->n_shards; i++) {
+    GstMultiSocketSinkShard *shard = &mssink->shards[i];
+
+#ifdef HAVE_SYS_EPOLL_H
+    gst_multi_socket_sink_epoll_stop (shard);
+#endif
+    g_main_context_unref (shard->main_context);
   }
+  g_free (mssink->shards);
+  mssink->shards = NULL;
+  mssink->n_shards = 0;
+  mssink->main_context = NULL;
+  mssink->use_epoll = FALSE;
 
   g_hash_table_foreach_remove (mhsink->handle_hash, multisocketsink_hash_remove,
       mssink);
@@ -1268,13 +1885,14 @@ static gboolean
 gst_multi_socket_sink_unlock (GstBaseSink * bsink)
 {
   GstMultiSocketSink *sink;
+  guint i;
 
   sink = GST_MULTI_SOCKET_SINK (bsink);
 
   GST_DEBUG_OBJECT (sink, "set to flushing");
   g_cancellable_cancel (sink->cancellable);
-  if (sink->main_context)
-    g_main_context_wakeup (sink->main_context);
+  for (i = 0; i < sink->n_shards; i++)
+    g_main_context_wakeup (sink->shards[i].main_context);
 
   return TRUE;
 }
@@ -48,13 +48,60 @@ G_BEGIN_DECLS
 typedef struct _GstMultiSocketSink GstMultiSocketSink;
 typedef struct _GstMultiSocketSinkClass GstMultiSocketSinkClass;
 
+/**
+ * GstMultiSocketSinkIOMode:
+ * @GST_MULTI_SOCKET_SINK_IO_MODE_MAIN_CONTEXT: one #GSource per client
+ *     socket in a #GMainContext
+ * @GST_MULTI_SOCKET_SINK_IO_MODE_EPOLL: edge-triggered epoll, all client
+ *     sockets are watched by one #GSource
+ *
+ * How the readiness of the client sockets is waited for.
+ */
+typedef enum
+{
+  GST_MULTI_SOCKET_SINK_IO_MODE_MAIN_CONTEXT,
+  GST_MULTI_SOCKET_SINK_IO_MODE_EPOLL
+} GstMultiSocketSinkIOMode;
+
+/* the clients are divided between shards, each served by its own thread
+ */
+typedef struct {
+  GstMultiSocketSink *sink;
+
+  GMainContext *main_context;
+  GThread *thread;              /* NULL for the first shard, which runs in the
+                                   multihandlesink thread */
+  guint n_clients;
+
+  /* epoll mode */
+  gint epoll_fd;
+  GSource *epoll_source;
+  GQueue epoll_pending;         /* writable clients that got data to send */
+  gint epoll_wakeup;
+} GstMultiSocketSinkShard;
+
 /* structure for a client
  */
 typedef struct {
   GstMultiHandleClient client;
 
+  GstMultiSocketSinkShard *shard;
+  guint serial;                 /* tells clients apart that reuse the
+                                   same memory */
+
   GSource *source;
   GIOCondition condition;
+
+  /* epoll mode */
+  gboolean registered;          /* socket is in the epoll set */
+  gboolean writable;            /* no EAGAIN since the last EPOLLOUT */
+  gboolean want_write;          /* client has data to send */
+  gboolean pending;             /* pending_link is in the pending queue */
+  GList pending_link;
+
+  /* stats */
+  guint64 writes;               /* write calls */
+  guint64 writes_saved;         /* buffers written along with another one */
 } GstSocketClient;
 
 /**
@@ -70,6 +117,15 @@ struct _GstMultiSocketSink {
   GCancellable *cancellable;
   gboolean send_messages;
   gboolean send_dispatched;
+
+  GstMultiSocketSinkIOMode io_mode;
+  guint n_threads;
+
+  /* only used while running, main_context is the one of the first shard */
+  gboolean use_epoll;
+  GstMultiSocketSinkShard *shards;
+  guint n_shards;
+  guint client_serial;
 };
 
 struct _GstMultiSocketSinkClass {
@@ -90,6 +146,9 @@ struct _GstMultiSocketSinkClass {
 
 GType gst_multi_socket_sink_get_type (void);
 
+#define GST_TYPE_MULTI_SOCKET_SINK_IO_MODE (gst_multi_socket_sink_io_mode_get_type())
+GType gst_multi_socket_sink_io_mode_get_type (void);
+
 G_END_DECLS
 
 #endif /* __GST_MULTI_SOCKET_SINK_H__ */
@@ -90,6 +90,8 @@ GST_DEBUG_CATEGORY_STATIC (CAT_PERFORMANCE);
 #define DEFAULT_PROP_SUBMETHOD    1
 #define DEFAULT_PROP_ENVELOPE     2.0
 #define DEFAULT_PROP_GAMMA_DECODE FALSE
+#define DEFAULT_PROP_N_THREADS    1
+#define DEFAULT_PROP_ZERO_COPY_BORDERS FALSE
 
 enum
 {
@@ -102,6 +104,8 @@ enum
   PROP_SUBMETHOD,
   PROP_ENVELOPE,
   PROP_GAMMA_DECODE,
+  PROP_N_THREADS,
+  PROP_ZERO_COPY_BORDERS
 };
 
 #undef GST_VIDEO_SIZE_RANGE
@@ -194,6 +198,15 @@ static gboolean gst_video_scale_set_info (GstVideoFilter * filter,
 static GstFlowReturn gst_video_scale_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in, GstVideoFrame * out);
 
+static gboolean gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query);
+static gboolean gst_video_scale_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query);
+static GstFlowReturn gst_video_scale_prepare_output_buffer (GstBaseTransform *
+    trans, GstBuffer * input, GstBuffer ** outbuf);
+static GstFlowReturn gst_video_scale_transform (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer * outbuf);
+
 static void gst_video_scale_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_video_scale_get_property (GObject * object, guint prop_id,
@@ -260,6 +273,30 @@ gst_video_scale_class_init (GstVideoScaleClass * klass)
           "Decode gamma before scaling", DEFAULT_PROP_GAMMA_DECODE,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_PROP_N_THREADS,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoScale:zero-copy-borders:
+   *
+   * When the only work to do is adding black borders, propose a buffer pool
+   * upstream with the borders as padding around the picture and fill in the
+   * borders around it instead of copying the picture into a new buffer.
+   *
+   * This requires upstream to respect the #GstVideoMeta of the buffers it
+   * gets from the pool.
+   *
+   * Since: 1.12
+   */
+  g_object_class_install_property (gobject_class, PROP_ZERO_COPY_BORDERS,
+      g_param_spec_boolean ("zero-copy-borders", "Zero Copy Borders",
+          "Add borders by padding upstream buffers instead of copying them",
+          DEFAULT_PROP_ZERO_COPY_BORDERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
 
   gst_element_class_set_static_metadata (element_class,
       "Video scaler", "Filter/Converter/Video/Scaler",
@@ -274,6 +311,13 @@ gst_video_scale_class_init (GstVideoScaleClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_scale_transform_caps);
   trans_class->fixate_caps = GST_DEBUG_FUNCPTR (gst_video_scale_fixate_caps);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_scale_src_event);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_scale_propose_allocation);
+  trans_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_scale_decide_allocation);
+  trans_class->prepare_output_buffer =
+      GST_DEBUG_FUNCPTR (gst_video_scale_prepare_output_buffer);
+  trans_class->transform = GST_DEBUG_FUNCPTR (gst_video_scale_transform);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_scale_set_info);
   filter_class->transform_frame =
@@ -291,6 +335,8 @@ gst_video_scale_init (GstVideoScale * videoscale)
   videoscale->dither = DEFAULT_PROP_DITHER;
   videoscale->envelope = DEFAULT_PROP_ENVELOPE;
   videoscale->gamma_decode = DEFAULT_PROP_GAMMA_DECODE;
+  videoscale->n_threads = DEFAULT_PROP_N_THREADS;
+  videoscale->zero_copy_borders = DEFAULT_PROP_ZERO_COPY_BORDERS;
 }
 
 static void
@@ -298,6 +344,9 @@ gst_video_scale_finalize (GstVideoScale * videoscale)
 {
   if (videoscale->convert)
     gst_video_converter_free (videoscale->convert);
+  if (videoscale->borders_pool)
+    gst_object_unref (videoscale->borders_pool);
+  g_free (videoscale->borders_line);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (videoscale));
 }
@@ -350,6 +399,16 @@ gst_video_scale_set_property (GObject * object, guint prop_id,
       vscale->gamma_decode = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (vscale);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vscale);
+      vscale->n_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
+    case PROP_ZERO_COPY_BORDERS:
+      GST_OBJECT_LOCK (vscale);
+      vscale->zero_copy_borders = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -403,6 +462,16 @@ gst_video_scale_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_boolean (value, vscale->gamma_decode);
       GST_OBJECT_UNLOCK (vscale);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (vscale);
+      g_value_set_uint (value, vscale->n_threads);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
+    case PROP_ZERO_COPY_BORDERS:
+      GST_OBJECT_LOCK (vscale);
+      g_value_set_boolean (value, vscale->zero_copy_borders);
+      GST_OBJECT_UNLOCK (vscale);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -467,6 +536,148 @@ gst_video_scale_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+/* check if the borders can be added around the unscaled picture in a padded
+ * upstream buffer. The padding must respect the chroma subsampling, the
+ * output is then the padded buffer with the borders filled in. */
+static void
+gst_video_scale_setup_borders (GstVideoScale * videoscale,
+    GstVideoInfo * in_info, GstVideoInfo * out_info)
+{
+  const GstVideoFormatInfo *finfo = out_info->finfo;
+  const GstVideoFormatInfo *uinfo;
+  GstVideoAlignment *align = &videoscale->borders_align;
+  GstVideoInfo *line_info = &videoscale->borders_line_info;
+  gpointer data[GST_VIDEO_MAX_PLANES];
+  gpointer unpacked;
+  gint i, w_sub = 0, h_sub = 0, shift, black[4];
+
+  videoscale->borders_only = FALSE;
+  gst_object_replace ((GstObject **) & videoscale->borders_pool, NULL);
+  g_free (videoscale->borders_line);
+  videoscale->borders_line = NULL;
+
+  if (!videoscale->zero_copy_borders)
+    return;
+  if (videoscale->borders_w == 0 && videoscale->borders_h == 0)
+    return;
+  if (in_info->width != out_info->width - videoscale->borders_w ||
+      in_info->height != out_info->height - videoscale->borders_h)
+    return;
+  if (GST_VIDEO_INFO_FORMAT (in_info) != GST_VIDEO_INFO_FORMAT (out_info) ||
+      GST_VIDEO_INFO_IS_INTERLACED (in_info))
+    return;
+  if (GST_VIDEO_FORMAT_INFO_IS_COMPLEX (finfo) ||
+      GST_VIDEO_FORMAT_INFO_IS_TILED (finfo) ||
+      GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo))
+    return;
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    if (GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i) == 0)
+      return;
+    w_sub = MAX (w_sub, GST_VIDEO_FORMAT_INFO_W_SUB (finfo, i));
+    h_sub = MAX (h_sub, GST_VIDEO_FORMAT_INFO_H_SUB (finfo, i));
+  }
+
+  gst_video_alignment_reset (align);
+  align->padding_top = videoscale->borders_h / 2;
+  align->padding_bottom = videoscale->borders_h - align->padding_top;
+  align->padding_left = videoscale->borders_w / 2;
+  align->padding_right = videoscale->borders_w - align->padding_left;
+
+  if (((align->padding_top | align->padding_bottom) & ((1 << h_sub) - 1)) ||
+      ((align->padding_left | align->padding_right) & ((1 << w_sub) - 1))) {
+    GST_DEBUG_OBJECT (videoscale, "borders don't match the subsampling");
+    return;
+  }
+
+  videoscale->borders_info = *in_info;
+  gst_video_info_align (&videoscale->borders_info, align);
+
+  /* offset of the padded frame in each plane, when it has the same layout as
+   * a frame of the output size, downstream doesn't need to look at the
+   * video meta */
+  videoscale->borders_default_layout =
+      GST_VIDEO_INFO_SIZE (&videoscale->borders_info) ==
+      GST_VIDEO_INFO_SIZE (out_info);
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (out_info); i++) {
+    gint stride = GST_VIDEO_INFO_PLANE_STRIDE (&videoscale->borders_info, i);
+
+    videoscale->borders_delta[i] =
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i,
+        align->padding_top) * stride +
+        GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i,
+        align->padding_left) * GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i);
+
+    if (stride != GST_VIDEO_INFO_PLANE_STRIDE (out_info, i) ||
+        GST_VIDEO_INFO_PLANE_OFFSET (&videoscale->borders_info, i) -
+        videoscale->borders_delta[i] != GST_VIDEO_INFO_PLANE_OFFSET (out_info,
+            i))
+      videoscale->borders_default_layout = FALSE;
+  }
+
+  /* pack one line of black in the output format */
+  uinfo = gst_video_format_get_info (finfo->unpack_format);
+  shift = GST_VIDEO_FORMAT_INFO_BITS (uinfo) -
+      GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0);
+
+  black[0] = (1 << GST_VIDEO_FORMAT_INFO_BITS (uinfo)) - 1;
+  if (GST_VIDEO_FORMAT_INFO_IS_GRAY (finfo)) {
+    if (out_info->colorimetry.range == GST_VIDEO_COLOR_RANGE_16_235)
+      black[1] = 1 << (GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0) - 4);
+    else
+      black[1] = 0;
+    black[2] = black[3] = 0;
+  } else {
+    gint offset[GST_VIDEO_MAX_COMPONENTS], scale[GST_VIDEO_MAX_COMPONENTS];
+
+    gst_video_color_range_offsets (out_info->colorimetry.range, finfo, offset,
+        scale);
+    black[1] = offset[0];
+    black[2] = offset[1];
+    black[3] = offset[2];
+  }
+  for (i = 1; i < 4; i++)
+    black[i] <<= shift;
+
+  if (GST_VIDEO_FORMAT_INFO_BITS (uinfo) > 8) {
+    guint16 *p = unpacked = g_new (guint16, (out_info->width + 1) * 4);
+
+    for (i = 0; i < out_info->width + 1; i++) {
+      p[i * 4 + 0] = black[0];
+      p[i * 4 + 1] = black[1];
+      p[i * 4 + 2] = black[2];
+      p[i * 4 + 3] = black[3];
+    }
+  } else {
+    guint8 *p = unpacked = g_new (guint8, (out_info->width + 1) * 4);
+
+    for (i = 0; i < out_info->width + 1; i++) {
+      p[i * 4 + 0] = black[0];
+      p[i * 4 + 1] = black[1];
+      p[i * 4 + 2] = black[2];
+      p[i * 4 + 3] = black[3];
+    }
+  }
+
+  gst_video_info_set_format (line_info, GST_VIDEO_INFO_FORMAT (out_info),
+      out_info->width, 1);
+  videoscale->borders_line = g_malloc (GST_VIDEO_INFO_SIZE (line_info));
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (line_info); i++)
+    data[i] =
+        videoscale->borders_line + GST_VIDEO_INFO_PLANE_OFFSET (line_info, i);
+
+  finfo->pack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, unpacked, 0, data,
+      line_info->stride, out_info->chroma_site, 0, out_info->width);
+  g_free (unpacked);
+
+  videoscale->borders_only = TRUE;
+
+  GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, videoscale,
+      "borders %u-%ux%u-%u can be added without copying (default layout %d)",
+      align->padding_top, align->padding_left, align->padding_right,
+      align->padding_bottom, videoscale->borders_default_layout);
+}
+
 static gboolean
 gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info)
@@ -606,7 +817,9 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
         GST_VIDEO_MATRIX_MODE_NONE, GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
         GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_NONE,
         GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
-        GST_VIDEO_CHROMA_MODE_NONE, NULL);
+        GST_VIDEO_CHROMA_MODE_NONE,
+        GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, videoscale->n_threads,
+        NULL);
 
     if (videoscale->gamma_decode) {
       gst_structure_set (options,
@@ -619,6 +832,8 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     videoscale->convert = gst_video_converter_new (in_info, out_info, options);
   }
 
+  gst_video_scale_setup_borders (videoscale, in_info, out_info);
+
   GST_DEBUG_OBJECT (videoscale, "from=%dx%d (par=%d/%d dar=%d/%d), size %"
       G_GSIZE_FORMAT " -> to=%dx%d (par=%d/%d dar=%d/%d borders=%d:%d), "
       "size %" G_GSIZE_FORMAT,
@@ -1086,6 +1301,290 @@ gst_video_scale_transform_frame (GstVideoFilter * filter,
   return ret;
 }
 
+/* A video buffer pool that restores the geometry of the video meta when the
+ * buffer is returned, after we changed it to expose the borders */
+typedef struct
+{
+  GstVideoBufferPool parent;
+
+  GstVideoInfo info;
+} GstVideoScaleBorderPool;
+
+typedef struct
+{
+  GstVideoBufferPoolClass parent_class;
+} GstVideoScaleBorderPoolClass;
+
+static GType gst_video_scale_border_pool_get_type (void);
+
+G_DEFINE_TYPE (GstVideoScaleBorderPool, gst_video_scale_border_pool,
+    GST_TYPE_VIDEO_BUFFER_POOL);
+
+static void
+gst_video_scale_border_pool_reset_buffer (GstBufferPool * pool,
+    GstBuffer * buffer)
+{
+  GstVideoScaleBorderPool *bpool = (GstVideoScaleBorderPool *) pool;
+  GstVideoMeta *meta;
+  guint i;
+
+  meta = gst_buffer_get_video_meta (buffer);
+  if (meta) {
+    meta->width = GST_VIDEO_INFO_WIDTH (&bpool->info);
+    meta->height = GST_VIDEO_INFO_HEIGHT (&bpool->info);
+    for (i = 0; i < meta->n_planes; i++) {
+      meta->offset[i] = GST_VIDEO_INFO_PLANE_OFFSET (&bpool->info, i);
+      meta->stride[i] = GST_VIDEO_INFO_PLANE_STRIDE (&bpool->info, i);
+    }
+  }
+
+  GST_BUFFER_POOL_CLASS (gst_video_scale_border_pool_parent_class)->reset_buffer
+      (pool, buffer);
+}
+
+static void
+gst_video_scale_border_pool_class_init (GstVideoScaleBorderPoolClass * klass)
+{
+  GstBufferPoolClass *pool_class = (GstBufferPoolClass *) klass;
+
+  pool_class->reset_buffer = gst_video_scale_border_pool_reset_buffer;
+}
+
+static void
+gst_video_scale_border_pool_init (GstVideoScaleBorderPool * pool)
+{
+}
+
+static gboolean
+gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (trans);
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstCaps *caps;
+  GstVideoInfo info;
+  guint size, min = 0, max = 0;
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* passthrough or scaling, the video filter pool is fine */
+  if (decide_query == NULL || !videoscale->borders_only)
+    return TRUE;
+
+  gst_query_parse_allocation (query, &caps, NULL);
+  if (caps == NULL || !gst_video_info_from_caps (&info, caps))
+    return TRUE;
+
+  if (GST_VIDEO_INFO_FORMAT (&info) !=
+      GST_VIDEO_INFO_FORMAT (&videoscale->borders_info)
+      || info.width != videoscale->borders_info.width
+      || info.height != videoscale->borders_info.height)
+    return TRUE;
+
+  gst_allocation_params_init (&params);
+  if (gst_query_get_n_allocation_params (query) > 0)
+    gst_query_parse_nth_allocation_param (query, 0, &allocator, &params);
+
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, NULL, NULL, &min, &max);
+
+  pool = g_object_new (gst_video_scale_border_pool_get_type (), NULL);
+  ((GstVideoScaleBorderPool *) pool)->info = videoscale->borders_info;
+  size = GST_VIDEO_INFO_SIZE (&videoscale->borders_info);
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, size, min, max);
+  gst_buffer_pool_config_set_allocator (config, allocator, &params);
+  gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
+  gst_buffer_pool_config_set_video_alignment (config,
+      &videoscale->borders_align);
+
+  if (allocator)
+    gst_object_unref (allocator);
+
+  if (!gst_buffer_pool_set_config (pool, config))
+    goto config_failed;
+
+  GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, videoscale,
+      "proposing padded pool %" GST_PTR_FORMAT, pool);
+
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+  else
+    gst_query_add_allocation_pool (query, pool, size, min, max);
+
+  if (!gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL))
+    gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+  gst_object_replace ((GstObject **) & videoscale->borders_pool,
+      (GstObject *) pool);
+  gst_object_unref (pool);
+
+  return TRUE;
+
+  /* ERRORS */
+config_failed:
+  {
+    GST_WARNING_OBJECT (videoscale, "failed to set padded pool config");
+    gst_object_unref (pool);
+    return TRUE;
+  }
+}
+
+static gboolean
+gst_video_scale_decide_allocation (GstBaseTransform * trans, GstQuery * query)
+{
+  GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (trans);
+
+  videoscale->downstream_video_meta =
+      gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
+/* turn a buffer from our padded pool into an output frame by making the
+ * padding part of the picture */
+static gboolean
+gst_video_scale_expose_borders (GstVideoScale * videoscale, GstBuffer * buffer)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (videoscale);
+  GstVideoInfo *info = &videoscale->borders_info;
+  GstVideoMeta *meta;
+  guint i;
+
+  meta = gst_buffer_get_video_meta (buffer);
+  if (meta == NULL || meta->width != info->width
+      || meta->height != info->height)
+    return FALSE;
+
+  if (gst_buffer_get_size (buffer) < GST_VIDEO_INFO_SIZE (info))
+    return FALSE;
+
+  for (i = 0; i < meta->n_planes; i++) {
+    if (meta->offset[i] != GST_VIDEO_INFO_PLANE_OFFSET (info, i) ||
+        meta->stride[i] != GST_VIDEO_INFO_PLANE_STRIDE (info, i))
+      return FALSE;
+  }
+
+  meta->width = GST_VIDEO_INFO_WIDTH (&filter->out_info);
+  meta->height = GST_VIDEO_INFO_HEIGHT (&filter->out_info);
+  for (i = 0; i < meta->n_planes; i++)
+    meta->offset[i] -= videoscale->borders_delta[i];
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_video_scale_prepare_output_buffer (GstBaseTransform * trans,
+    GstBuffer * input, GstBuffer ** outbuf)
+{
+  GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (trans);
+
+  if (videoscale->borders_only && videoscale->borders_pool
+      && input->pool == videoscale->borders_pool
+      && (videoscale->downstream_video_meta
+          || videoscale->borders_default_layout)
+      && gst_buffer_is_writable (input)
+      && gst_video_scale_expose_borders (videoscale, input)) {
+    GST_CAT_LOG_OBJECT (CAT_PERFORMANCE, videoscale, "adding borders in place");
+    *outbuf = input;
+    return GST_FLOW_OK;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->prepare_output_buffer (trans,
+      input, outbuf);
+}
+
+static GstFlowReturn
+gst_video_scale_fill_borders (GstVideoScale * videoscale, GstBuffer * buffer)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (videoscale);
+  const GstVideoFormatInfo *finfo = filter->out_info.finfo;
+  GstVideoAlignment *align = &videoscale->borders_align;
+  GstVideoFrame frame;
+  gint i, j;
+
+  if (!gst_video_frame_map (&frame, &filter->out_info, buffer,
+          GST_MAP_READWRITE | GST_VIDEO_FRAME_MAP_FLAG_NO_REF))
+    goto invalid_buffer;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (&frame); i++) {
+    guint8 *data, *line;
+    gint stride, pstride, width, height, top, bottom, left, right;
+
+    data = GST_VIDEO_FRAME_PLANE_DATA (&frame, i);
+    stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, i);
+    line = videoscale->borders_line +
+        GST_VIDEO_INFO_PLANE_OFFSET (&videoscale->borders_line_info, i);
+
+    /* like gst_video_info_align(), we assume plane and component are the
+     * same for the dimensions */
+    pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i);
+    width = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i,
+        GST_VIDEO_FRAME_WIDTH (&frame)) * pstride;
+    height = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i,
+        GST_VIDEO_FRAME_HEIGHT (&frame));
+    top = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, align->padding_top);
+    bottom =
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, align->padding_bottom);
+    left = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i,
+        align->padding_left) * pstride;
+    right = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, i,
+        align->padding_right) * pstride;
+
+    for (j = 0; j < top; j++)
+      memcpy (data + j * stride, line, width);
+
+    if (left || right) {
+      for (j = top; j < height - bottom; j++) {
+        guint8 *row = data + j * stride;
+
+        memcpy (row, line, left);
+        memcpy (row + width - right, line + width - right, right);
+      }
+    }
+
+    for (j = height - bottom; j < height; j++)
+      memcpy (data + j * stride, line, width);
+  }
+
+  gst_video_frame_unmap (&frame);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+invalid_buffer:
+  {
+    GST_ELEMENT_WARNING (videoscale, CORE, NOT_IMPLEMENTED, (NULL),
+        ("invalid video buffer received"));
+    return GST_FLOW_OK;
+  }
+}
+
+static GstFlowReturn
+gst_video_scale_transform (GstBaseTransform * trans, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (trans);
+
+  /* the picture is already in place, only the borders are missing */
+  if (inbuf == outbuf) {
+    GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, trans, "filling borders");
+    return gst_video_scale_fill_borders (videoscale, outbuf);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->transform (trans, inbuf,
+      outbuf);
+}
+
 static gboolean
 gst_video_scale_src_event (GstBaseTransform * trans, GstEvent * event)
 {
@@ -88,11 +88,24 @@ struct _GstVideoScale {
   int submethod;
   double envelope;
   gboolean gamma_decode;
+  guint n_threads;
+  gboolean zero_copy_borders;
 
   GstVideoConverter *convert;
 
   gint borders_h;
   gint borders_w;
+
+  /* zero-copy borders */
+  gboolean borders_only;
+  gboolean borders_default_layout;
+  gboolean downstream_video_meta;
+  GstVideoAlignment borders_align;
+  GstVideoInfo borders_info;
+  gsize borders_delta[GST_VIDEO_MAX_PLANES];
+  GstBufferPool *borders_pool;
+  GstVideoInfo borders_line_info;
+  guint8 *borders_line;
 };
 
 struct _GstVideoScaleClass {
@@ -0,0 +1,216 @@
+/* GStreamer
+ *
+ * audio-channel-mixer.c: benchmark for GstAudioChannelMixer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures the speed of GstAudioChannelMixer for some common channel
+ * layouts in all formats it supports. For every case the number of input
+ * Mframes/s is printed together with the way the mixer applies the matrix,
+ * taken from its debug log. The largest layout uses all channel positions
+ * because unpositioned channels are not mixed.
+ *
+ *   audio-channel-mixer --frames=1024 --time=0.2
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_FRAMES 1024
+#define DEFAULT_TIME 0.2
+
+#define P(pos) GST_AUDIO_CHANNEL_POSITION_ ## pos
+
+static const GstAudioChannelPosition stereo[] = {
+  P (FRONT_LEFT), P (FRONT_RIGHT)
+};
+
+static const GstAudioChannelPosition surround51[] = {
+  P (FRONT_LEFT), P (FRONT_RIGHT), P (FRONT_CENTER), P (LFE1),
+  P (REAR_LEFT), P (REAR_RIGHT)
+};
+
+static const GstAudioChannelPosition surround71[] = {
+  P (FRONT_LEFT), P (FRONT_RIGHT), P (FRONT_CENTER), P (LFE1),
+  P (REAR_LEFT), P (REAR_RIGHT), P (SIDE_LEFT), P (SIDE_RIGHT)
+};
+
+typedef struct
+{
+  const gchar *name;
+  gint in_channels;
+  const GstAudioChannelPosition *in_position;
+  gint out_channels;
+  const GstAudioChannelPosition *out_position;
+} BenchLayout;
+
+static const BenchLayout layouts[] = {
+  {"7.1->2", 8, surround71, 2, stereo},
+  {"5.1->2", 6, surround51, 2, stereo},
+  {"2->5.1", 2, stereo, 6, surround51},
+  {"2->7.1", 2, stereo, 8, surround71},
+  {"28->2", 28, NULL, 2, stereo},
+};
+
+static const GstAudioFormat formats[] = {
+  GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32,
+  GST_AUDIO_FORMAT_F64
+};
+
+/* the way the last created mixer applies the matrix, from its debug log */
+static gchar *mixer_path = NULL;
+
+static void
+log_mixer_path (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message, gpointer user_data)
+{
+  const gchar *msg;
+
+  if (level != GST_LEVEL_DEBUG ||
+      strcmp (gst_debug_category_get_name (category),
+          "audio-channel-mixer") != 0)
+    return;
+
+  msg = gst_debug_message_get (message);
+  if (msg && g_str_has_prefix (msg, "using ")) {
+    g_free (mixer_path);
+    mixer_path = g_strdup (msg + strlen ("using "));
+  }
+}
+
+static gboolean
+run_case (const BenchLayout * layout, GstAudioFormat format, gint n_frames,
+    gdouble time)
+{
+  GstAudioChannelPosition all[28];
+  GstAudioChannelPosition *in_position;
+  GstAudioChannelMixer *mix;
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gint bps = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  gpointer in[1], out[1];
+  GTimer *timer;
+  gdouble elapsed;
+  gint i, count;
+
+  if (layout->in_position) {
+    in_position = (GstAudioChannelPosition *) layout->in_position;
+  } else {
+    for (i = 0; i < layout->in_channels; i++)
+      all[i] = P (FRONT_LEFT) + i;
+    in_position = all;
+  }
+
+  g_free (mixer_path);
+  mixer_path = NULL;
+
+  mix = gst_audio_channel_mixer_new (0, format, layout->in_channels,
+      in_position, layout->out_channels,
+      (GstAudioChannelPosition *) layout->out_position);
+  if (mix == NULL)
+    return FALSE;
+
+  in[0] = g_malloc0 ((gsize) n_frames * layout->in_channels * bps);
+  out[0] = g_malloc0 ((gsize) n_frames * layout->out_channels * bps);
+
+  /* warmup */
+  gst_audio_channel_mixer_samples (mix, in, out, n_frames);
+
+  timer = g_timer_new ();
+  count = 0;
+  while (TRUE) {
+    gst_audio_channel_mixer_samples (mix, in, out, n_frames);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= time)
+      break;
+  }
+  g_timer_destroy (timer);
+
+  g_print ("%-7s %-5s %10.2f Mframes/s  %s\n", layout->name,
+      gst_audio_format_to_string (format),
+      (gdouble) n_frames * count / elapsed / 1000000.0,
+      mixer_path ? mixer_path : "unknown");
+
+  g_free (in[0]);
+  g_free (out[0]);
+  gst_audio_channel_mixer_free (mix);
+
+  return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  gint n_frames = DEFAULT_FRAMES;
+  gdouble time = DEFAULT_TIME;
+  GOptionEntry options[] = {
+    {"frames", 'n', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames mixed per call (default 1024)", "N"},
+    {"time", 0, 0, G_OPTION_ARG_DOUBLE, &time,
+        "Seconds to run each case (default 0.2)", "SECONDS"},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  guint i, j;
+  gint ret = 0;
+
+  ctx = g_option_context_new ("- benchmark audio channel mixing");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (n_frames <= 0 || time <= 0.0) {
+    g_printerr ("invalid number of frames or time\n");
+    return 1;
+  }
+
+  /* find out how the mixers mix from their debug log, keep the log quiet
+   * unless it was asked for */
+  if (g_getenv ("GST_DEBUG") == NULL)
+    gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_log_function (log_mixer_path, NULL, NULL);
+  gst_debug_set_threshold_for_name ("audio-channel-mixer", GST_LEVEL_DEBUG);
+
+  for (i = 0; i < G_N_ELEMENTS (layouts) && ret == 0; i++) {
+    for (j = 0; j < G_N_ELEMENTS (formats); j++) {
+      if (!run_case (&layouts[i], formats[j], n_frames, time)) {
+        g_printerr ("could not make mixer for %s\n", layouts[i].name);
+        ret = 1;
+        break;
+      }
+    }
+  }
+  g_free (mixer_path);
+
+  return ret;
+}
@@ -0,0 +1,294 @@
+/* GStreamer
+ *
+ * audio-ringbuffer.c: benchmark for the wakeup latency of the audio
+ * ringbuffer writer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Pushes one segment worth of samples at a time into a dummy GstAudioSink
+ * whose device consumes a segment every latency-time. Once the ringbuffer
+ * is full every push has to wait for the device, and the time between the
+ * device finishing a segment and the push returning is measured. This is
+ * done with the default and with the lock free ringbuffer wakeups.
+ *
+ *   audio-ringbuffer --buffers=2000 --latency-time=2000 --buffer-time=6000
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_BUFFERS 2000
+#define DEFAULT_LATENCY_TIME 2000
+#define DEFAULT_BUFFER_TIME 6000
+
+#define BENCH_RATE 48000
+#define BENCH_CHANNELS 2
+#define BENCH_BPF (2 * BENCH_CHANNELS)
+
+static GMutex device_lock;
+static gint64 device_time;
+static gint64 device_deadline;
+static gint64 device_period;
+
+/* sink */
+typedef GstAudioSink BenchSink;
+typedef GstAudioSinkClass BenchSinkClass;
+
+static GType bench_sink_get_type (void);
+G_DEFINE_TYPE (BenchSink, bench_sink, GST_TYPE_AUDIO_SINK);
+
+static gboolean
+bench_sink_open (GstAudioSink * sink)
+{
+  return TRUE;
+}
+
+static gboolean
+bench_sink_prepare (GstAudioSink * sink, GstAudioRingBufferSpec * spec)
+{
+  device_period = spec->latency_time;
+  device_deadline = 0;
+  return TRUE;
+}
+
+static gboolean
+bench_sink_unprepare (GstAudioSink * sink)
+{
+  return TRUE;
+}
+
+static gboolean
+bench_sink_close (GstAudioSink * sink)
+{
+  return TRUE;
+}
+
+/* plays one segment per period, like a device would */
+static gint
+bench_sink_write (GstAudioSink * sink, gpointer data, guint length)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  if (device_deadline == 0)
+    device_deadline = now;
+  device_deadline += device_period;
+  if (device_deadline > now)
+    g_usleep (device_deadline - now);
+
+  g_mutex_lock (&device_lock);
+  device_time = g_get_monotonic_time ();
+  g_mutex_unlock (&device_lock);
+
+  return length;
+}
+
+static guint
+bench_sink_delay (GstAudioSink * sink)
+{
+  return 0;
+}
+
+static void
+bench_sink_reset (GstAudioSink * sink)
+{
+}
+
+static void
+bench_sink_class_init (BenchSinkClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAudioSinkClass *sink_class = GST_AUDIO_SINK_CLASS (klass);
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("audio/x-raw, format=(string)" GST_AUDIO_NE (S16)
+          ", layout=(string)interleaved, rate=(int)48000, channels=(int)2"));
+
+  gst_element_class_add_static_pad_template (element_class, &sink_templ);
+  gst_element_class_set_static_metadata (element_class, "Bench sink",
+      "Sink/Audio", "Dummy audio sink", "GStreamer");
+
+  sink_class->open = bench_sink_open;
+  sink_class->prepare = bench_sink_prepare;
+  sink_class->unprepare = bench_sink_unprepare;
+  sink_class->close = bench_sink_close;
+  sink_class->write = bench_sink_write;
+  sink_class->delay = bench_sink_delay;
+  sink_class->reset = bench_sink_reset;
+}
+
+static void
+bench_sink_init (BenchSink * sink)
+{
+}
+
+static gint
+compare_int64 (gconstpointer a, gconstpointer b)
+{
+  gint64 va = *(const gint64 *) a, vb = *(const gint64 *) b;
+
+  return va < vb ? -1 : va > vb ? 1 : 0;
+}
+
+static gboolean
+run_bench (gboolean lock_free, guint n_buffers, gint64 latency_time,
+    gint64 buffer_time)
+{
+  GstElement *sink;
+  GstAudioRingBuffer *ringbuffer;
+  GstPad *srcpad, *pad;
+  GstCaps *caps;
+  GstSegment segment;
+  gint64 *latencies;
+  guint i, n_latencies = 0, skip;
+  gsize size;
+  gdouble mean = 0.0, var = 0.0;
+  gboolean ok = TRUE;
+
+  sink = g_object_new (bench_sink_get_type (), "sync", FALSE,
+      "latency-time", latency_time, "buffer-time", buffer_time, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_element_set_state (sink, GST_STATE_READY);
+  ringbuffer = GST_AUDIO_BASE_SINK (sink)->ringbuffer;
+  if (!gst_audio_ring_buffer_set_lock_free (ringbuffer, lock_free)) {
+    g_printerr ("could not set lock free mode\n");
+    ok = FALSE;
+    goto done;
+  }
+  gst_element_set_state (sink, GST_STATE_PLAYING);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (S16),
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, BENCH_RATE, "channels", G_TYPE_INT, BENCH_CHANNELS,
+      NULL);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("bench"));
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+  gst_caps_unref (caps);
+
+  /* one segment per push, ignore the pushes that fill up the ringbuffer */
+  size = gst_util_uint64_scale (latency_time, BENCH_RATE, G_USEC_PER_SEC) *
+      BENCH_BPF;
+  skip = 2 * (buffer_time / latency_time) + 2;
+  latencies = g_new (gint64, n_buffers);
+
+  for (i = 0; i < n_buffers && ok; i++) {
+    GstBuffer *buffer;
+    gint64 start, end, dev;
+
+    buffer = gst_buffer_new_allocate (NULL, size, NULL);
+    gst_buffer_memset (buffer, 0, 0, size);
+
+    start = g_get_monotonic_time ();
+    ok = gst_pad_push (srcpad, buffer) == GST_FLOW_OK;
+    end = g_get_monotonic_time ();
+
+    g_mutex_lock (&device_lock);
+    dev = device_time;
+    g_mutex_unlock (&device_lock);
+
+    /* only pushes that had to wait for the device tell us something */
+    if (i >= skip && end - start > latency_time / 2 && dev > start)
+      latencies[n_latencies++] = end - dev;
+  }
+
+  if (!ok) {
+    g_printerr ("pushing buffers failed\n");
+  } else if (n_latencies == 0) {
+    g_printerr ("no push had to wait for the device\n");
+  } else {
+    for (i = 0; i < n_latencies; i++)
+      mean += latencies[i];
+    mean /= n_latencies;
+    for (i = 0; i < n_latencies; i++)
+      var += (latencies[i] - mean) * (latencies[i] - mean);
+    var /= n_latencies;
+
+    qsort (latencies, n_latencies, sizeof (gint64), compare_int64);
+
+    g_print ("%-9s: %5u waits, mean %7.1f us, stddev %7.1f us, "
+        "p99 %5" G_GINT64_FORMAT " us, max %5" G_GINT64_FORMAT " us\n",
+        lock_free ? "lock free" : "default", n_latencies, mean, sqrt (var),
+        latencies[(n_latencies * 99) / 100], latencies[n_latencies - 1]);
+  }
+  g_free (latencies);
+
+done:
+  gst_element_set_state (sink, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sink);
+
+  return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+  gint n_buffers = DEFAULT_BUFFERS;
+  gint64 latency_time = DEFAULT_LATENCY_TIME;
+  gint64 buffer_time = DEFAULT_BUFFER_TIME;
+  GOptionEntry options[] = {
+    {"buffers", 'n', 0, G_OPTION_ARG_INT, &n_buffers,
+        "Number of segments to push (default 2000)", "N"},
+    {"latency-time", 'l', 0, G_OPTION_ARG_INT64, &latency_time,
+        "Segment duration in microseconds (default 2000)", "US"},
+    {"buffer-time", 'b', 0, G_OPTION_ARG_INT64, &buffer_time,
+        "Ringbuffer duration in microseconds (default 6000)", "US"},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint ret = 0;
+
+  ctx = g_option_context_new ("- benchmark audio ringbuffer wakeups");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (n_buffers <= 0 || latency_time <= 0 || buffer_time < 2 * latency_time) {
+    g_printerr ("invalid options\n");
+    return 1;
+  }
+
+  if (!run_bench (FALSE, n_buffers, latency_time, buffer_time) ||
+      !run_bench (TRUE, n_buffers, latency_time, buffer_time))
+    ret = 1;
+
+  return ret;
+}
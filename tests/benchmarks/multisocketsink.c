@@ -0,0 +1,351 @@
+/* GStreamer
+ *
+ * multisocketsink.c: benchmark for serving many clients with multisocketsink
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Connects a number of loopback TCP clients to a multisocketsink and pushes
+ * buffers until every client received all of them. The clients are read by
+ * a separate process so that the CPU time used by this process is the cost
+ * of serving the clients. This is done for every io-mode of the sink, with
+ * the given number of sink threads.
+ *
+ *   multisocketsink --clients=4000 --buffers=500 --size=16384 --threads=4
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gio/gio.h>
+
+#ifdef G_OS_UNIX
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#define DEFAULT_CLIENTS 2000
+#define DEFAULT_BUFFERS 500
+#define DEFAULT_SIZE 16384
+#define DEFAULT_THREADS 1
+
+#define SERVE_TIMEOUT (120 * G_USEC_PER_SEC)
+
+#ifdef G_OS_UNIX
+static gint64
+get_cpu_time (void)
+{
+  struct rusage usage;
+
+  getrusage (RUSAGE_SELF, &usage);
+
+  return (gint64) usage.ru_utime.tv_sec * G_USEC_PER_SEC +
+      usage.ru_utime.tv_usec + (gint64) usage.ru_stime.tv_sec *
+      G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+}
+
+/* runs in the child process, reads all clients until they are closed */
+static void
+read_clients (struct pollfd *fds, guint n_fds)
+{
+  static gchar data[65536];
+  guint i, n_open = n_fds;
+
+  while (n_open > 0) {
+    if (poll (fds, n_fds, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    for (i = 0; i < n_fds; i++) {
+      ssize_t len;
+
+      if (fds[i].fd < 0 || fds[i].revents == 0)
+        continue;
+
+      len = read (fds[i].fd, data, sizeof (data));
+      if (len == 0 || (len < 0 && errno != EINTR && errno != EAGAIN)) {
+        close (fds[i].fd);
+        fds[i].fd = -1;
+        n_open--;
+      }
+    }
+  }
+  _exit (0);
+}
+
+static gboolean
+connect_clients (guint n_clients, GSocket ** servers, GSocket ** clients)
+{
+  GSocket *listener;
+  GInetAddress *loopback;
+  GSocketAddress *addr, *local;
+  GError *err = NULL;
+  gboolean ok = FALSE;
+  guint i;
+
+  listener = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &err);
+  if (listener == NULL)
+    goto error;
+
+  loopback = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (loopback, 0);
+  g_object_unref (loopback);
+  ok = g_socket_bind (listener, addr, TRUE, &err) &&
+      g_socket_listen (listener, &err);
+  g_object_unref (addr);
+  if (!ok)
+    goto error;
+
+  local = g_socket_get_local_address (listener, &err);
+  if (local == NULL)
+    goto error;
+
+  for (i = 0; i < n_clients && ok; i++) {
+    clients[i] = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+        G_SOCKET_PROTOCOL_TCP, &err);
+    ok = clients[i] != NULL && g_socket_connect (clients[i], local, NULL, &err)
+        && (servers[i] = g_socket_accept (listener, NULL, &err)) != NULL;
+  }
+  g_object_unref (local);
+  if (!ok)
+    goto error;
+
+  g_object_unref (listener);
+  return TRUE;
+
+error:
+  g_printerr ("could not connect clients: %s\n", GST_STR_NULL (err->message));
+  g_clear_error (&err);
+  if (listener)
+    g_object_unref (listener);
+  return FALSE;
+}
+
+static gboolean
+run_bench (const gchar * io_mode, guint n_threads, guint n_clients,
+    guint n_buffers, gsize size)
+{
+  GstElement *sink;
+  GstPad *srcpad, *pad;
+  GstCaps *caps;
+  GstSegment segment;
+  GSocket **servers, **clients;
+  struct pollfd *fds;
+  guint64 bytes, served = 0;
+  gint64 start, end, cpu_start, cpu_end, deadline;
+  gdouble gbits;
+  gboolean ok = TRUE;
+  pid_t pid;
+  guint i;
+
+  servers = g_new0 (GSocket *, n_clients);
+  clients = g_new0 (GSocket *, n_clients);
+  fds = g_new0 (struct pollfd, n_clients);
+
+  if (!connect_clients (n_clients, servers, clients)) {
+    ok = FALSE;
+    goto done;
+  }
+
+  for (i = 0; i < n_clients; i++) {
+    fds[i].fd = g_socket_get_fd (clients[i]);
+    fds[i].events = POLLIN;
+  }
+
+  pid = fork ();
+  if (pid < 0) {
+    g_printerr ("could not fork: %s\n", g_strerror (errno));
+    ok = FALSE;
+    goto done;
+  } else if (pid == 0) {
+    /* the sending side of the connections belongs to the parent */
+    for (i = 0; i < n_clients; i++)
+      close (g_socket_get_fd (servers[i]));
+    read_clients (fds, n_clients);
+  }
+  for (i = 0; i < n_clients; i++) {
+    g_object_unref (clients[i]);
+    clients[i] = NULL;
+  }
+
+  sink = gst_element_factory_make ("multisocketsink", NULL);
+  if (sink == NULL) {
+    g_printerr ("could not create multisocketsink\n");
+    ok = FALSE;
+    goto reap;
+  }
+  g_object_set (sink, "sync", FALSE, "n-threads", n_threads, NULL);
+  gst_util_set_object_arg (G_OBJECT (sink), "io-mode", io_mode);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  pad = gst_element_get_static_pad (sink, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_element_set_state (sink, GST_STATE_PLAYING);
+
+  caps = gst_caps_new_empty_simple ("application/x-bench");
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("bench"));
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+  gst_caps_unref (caps);
+
+  for (i = 0; i < n_clients; i++)
+    g_signal_emit_by_name (sink, "add", servers[i]);
+
+  bytes = (guint64) n_clients * n_buffers * size;
+
+  start = g_get_monotonic_time ();
+  cpu_start = get_cpu_time ();
+
+  for (i = 0; i < n_buffers && ok; i++) {
+    GstBuffer *buffer;
+
+    buffer = gst_buffer_new_allocate (NULL, size, NULL);
+    gst_buffer_memset (buffer, 0, i, size);
+    ok = gst_pad_push (srcpad, buffer) == GST_FLOW_OK;
+  }
+
+  deadline = start + SERVE_TIMEOUT;
+  while (ok) {
+    g_object_get (sink, "bytes-served", &served, NULL);
+    if (served >= bytes)
+      break;
+    if (g_get_monotonic_time () > deadline) {
+      g_printerr ("%s: timeout, served %" G_GUINT64_FORMAT " of %"
+          G_GUINT64_FORMAT " bytes\n", io_mode, served, bytes);
+      ok = FALSE;
+    }
+    g_usleep (1000);
+  }
+
+  cpu_end = get_cpu_time ();
+  end = g_get_monotonic_time ();
+
+  if (ok) {
+    gbits = bytes * 8.0 / 1e9;
+    g_print ("%-12s %2u threads %6u clients: %7.2f Gbit/s, "
+        "%7.3f CPU s per Gbit\n", io_mode, n_threads, n_clients,
+        gbits * G_USEC_PER_SEC / (end - start),
+        (cpu_end - cpu_start) / (gbits * G_USEC_PER_SEC));
+  } else {
+    g_printerr ("%s: pushing buffers failed\n", io_mode);
+  }
+
+  gst_element_set_state (sink, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sink);
+
+reap:
+  /* closing the sockets makes the reader exit */
+  for (i = 0; i < n_clients; i++) {
+    g_object_unref (servers[i]);
+    servers[i] = NULL;
+  }
+  waitpid (pid, NULL, 0);
+
+done:
+  for (i = 0; i < n_clients; i++) {
+    if (servers[i])
+      g_object_unref (servers[i]);
+    if (clients[i])
+      g_object_unref (clients[i]);
+  }
+  g_free (servers);
+  g_free (clients);
+  g_free (fds);
+
+  return ok;
+}
+#endif
+
+int
+main (int argc, char **argv)
+{
+  gint n_clients = DEFAULT_CLIENTS;
+  gint n_buffers = DEFAULT_BUFFERS;
+  gint size = DEFAULT_SIZE;
+  gint n_threads = DEFAULT_THREADS;
+  GOptionEntry options[] = {
+    {"clients", 'c', 0, G_OPTION_ARG_INT, &n_clients,
+        "Number of clients (default 2000)", "N"},
+    {"buffers", 'n', 0, G_OPTION_ARG_INT, &n_buffers,
+        "Number of buffers to send (default 500)", "N"},
+    {"size", 's', 0, G_OPTION_ARG_INT, &size,
+        "Size of the buffers (default 16384)", "BYTES"},
+    {"threads", 't', 0, G_OPTION_ARG_INT, &n_threads,
+        "Number of sink threads (default 1)", "N"},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint ret = 0;
+
+  ctx = g_option_context_new ("- benchmark multisocketsink clients");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (n_clients <= 0 || n_buffers <= 0 || size <= 0 || n_threads <= 0) {
+    g_printerr ("invalid options\n");
+    return 1;
+  }
+
+#ifdef G_OS_UNIX
+  {
+    struct rlimit limit;
+
+    /* every client needs two sockets until the reader is forked */
+    if (getrlimit (RLIMIT_NOFILE, &limit) == 0) {
+      limit.rlim_cur = limit.rlim_max;
+      setrlimit (RLIMIT_NOFILE, &limit);
+      if (limit.rlim_cur != RLIM_INFINITY &&
+          limit.rlim_cur < 2 * (rlim_t) n_clients + 64)
+        g_printerr ("warning: file descriptor limit %lu is too low for %d "
+            "clients\n", (gulong) limit.rlim_cur, n_clients);
+    }
+  }
+
+  if (!run_bench ("main-context", n_threads, n_clients, n_buffers, size) ||
+      !run_bench ("epoll", n_threads, n_clients, n_buffers, size))
+    ret = 1;
+#else
+  g_printerr ("this benchmark needs a unix system\n");
+  ret = 1;
+#endif
+
+  return ret;
+}
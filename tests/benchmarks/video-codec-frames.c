@@ -0,0 +1,316 @@
+/* GStreamer
+ *
+ * video-codec-frames.c: benchmark for the frame bookkeeping of the video
+ * decoder and encoder base classes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Pushes empty frames through a dummy GstVideoDecoder and GstVideoEncoder
+ * that keep a number of frames pending before finishing the oldest one,
+ * like codecs with a lot of latency. The time spent per frame is printed
+ * for a run of N frames and one of 4N frames; the time per frame should
+ * not grow with the length of the run.
+ *
+ *   video-codec-frames --frames=20000 --held=0,16,128,512
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define DEFAULT_FRAMES 10000
+#define DEFAULT_HELD "0,16,128,512"
+
+#define BENCH_WIDTH 16
+#define BENCH_HEIGHT 16
+
+static guint bench_held;
+
+/* decoder */
+typedef GstVideoDecoder BenchDec;
+typedef GstVideoDecoderClass BenchDecClass;
+
+static GType bench_dec_get_type (void);
+G_DEFINE_TYPE (BenchDec, bench_dec, GST_TYPE_VIDEO_DECODER);
+
+static gboolean
+bench_dec_set_format (GstVideoDecoder * dec, GstVideoCodecState * state)
+{
+  gst_video_codec_state_unref (gst_video_decoder_set_output_state (dec,
+          GST_VIDEO_FORMAT_GRAY8, BENCH_WIDTH, BENCH_HEIGHT, state));
+  return TRUE;
+}
+
+static GstFlowReturn
+bench_dec_handle_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
+{
+  guint32 number = frame->system_frame_number;
+  GstVideoCodecFrame *oldest;
+
+  gst_video_codec_frame_unref (frame);
+
+  if (number < bench_held)
+    return GST_FLOW_OK;
+
+  oldest = gst_video_decoder_get_frame (dec, number - bench_held);
+  if (oldest == NULL)
+    return GST_FLOW_ERROR;
+
+  oldest->output_buffer = gst_buffer_new ();
+  return gst_video_decoder_finish_frame (dec, oldest);
+}
+
+static void
+bench_dec_class_init (BenchDecClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS ("video/x-bench"));
+  static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS ("video/x-raw"));
+
+  gst_element_class_add_static_pad_template (element_class, &sink_templ);
+  gst_element_class_add_static_pad_template (element_class, &src_templ);
+  gst_element_class_set_static_metadata (element_class, "Bench decoder",
+      "Decoder/Video", "Dummy decoder", "GStreamer");
+
+  klass->set_format = bench_dec_set_format;
+  klass->handle_frame = bench_dec_handle_frame;
+}
+
+static void
+bench_dec_init (BenchDec * dec)
+{
+}
+
+/* encoder */
+typedef GstVideoEncoder BenchEnc;
+typedef GstVideoEncoderClass BenchEncClass;
+
+static GType bench_enc_get_type (void);
+G_DEFINE_TYPE (BenchEnc, bench_enc, GST_TYPE_VIDEO_ENCODER);
+
+static gboolean
+bench_enc_set_format (GstVideoEncoder * enc, GstVideoCodecState * state)
+{
+  gst_video_codec_state_unref (gst_video_encoder_set_output_state (enc,
+          gst_caps_new_empty_simple ("video/x-bench"), state));
+  return TRUE;
+}
+
+static GstFlowReturn
+bench_enc_handle_frame (GstVideoEncoder * enc, GstVideoCodecFrame * frame)
+{
+  guint32 number = frame->system_frame_number;
+  GstVideoCodecFrame *oldest;
+
+  gst_video_codec_frame_unref (frame);
+
+  if (number < bench_held)
+    return GST_FLOW_OK;
+
+  oldest = gst_video_encoder_get_frame (enc, number - bench_held);
+  if (oldest == NULL)
+    return GST_FLOW_ERROR;
+
+  oldest->output_buffer = gst_buffer_new ();
+  return gst_video_encoder_finish_frame (enc, oldest);
+}
+
+static void
+bench_enc_class_init (BenchEncClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS ("video/x-raw"));
+  static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS ("video/x-bench"));
+
+  gst_element_class_add_static_pad_template (element_class, &sink_templ);
+  gst_element_class_add_static_pad_template (element_class, &src_templ);
+  gst_element_class_set_static_metadata (element_class, "Bench encoder",
+      "Encoder/Video", "Dummy encoder", "GStreamer");
+
+  klass->set_format = bench_enc_set_format;
+  klass->handle_frame = bench_enc_handle_frame;
+}
+
+static void
+bench_enc_init (BenchEnc * enc)
+{
+}
+
+static GstFlowReturn
+sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static gboolean
+sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  gst_event_unref (event);
+  return TRUE;
+}
+
+/* returns the time per frame in ns, or a negative value on error */
+static gdouble
+run_frames (GType type, GstCaps * caps, guint n_frames)
+{
+  GstElement *element;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstSegment segment;
+  GstBuffer *buffer;
+  gint64 start, end;
+  gboolean ok = TRUE;
+  guint i;
+
+  element = g_object_new (type, NULL);
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, sink_chain);
+  gst_pad_set_event_function (sinkpad, sink_event);
+
+  pad = gst_element_get_static_pad (element, "sink");
+  gst_pad_link (srcpad, pad);
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (element, "src");
+  gst_pad_link (pad, sinkpad);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  gst_element_set_state (element, GST_STATE_PLAYING);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("bench"));
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < n_frames && ok; i++) {
+    buffer = gst_buffer_new ();
+    GST_BUFFER_PTS (buffer) = i * GST_MSECOND;
+    GST_BUFFER_DURATION (buffer) = GST_MSECOND;
+    ok = gst_pad_push (srcpad, buffer) == GST_FLOW_OK;
+  }
+  end = g_get_monotonic_time ();
+
+  gst_element_set_state (element, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (element);
+
+  if (!ok)
+    return -1.0;
+
+  return (end - start) * 1000.0 / n_frames;
+}
+
+static gboolean
+run_bench (const gchar * name, GType type, GstCaps * caps, guint n_frames,
+    guint held)
+{
+  gdouble short_run, long_run;
+
+  bench_held = held;
+  short_run = run_frames (type, caps, n_frames);
+  long_run = run_frames (type, caps, n_frames * 4);
+  if (short_run < 0.0 || long_run < 0.0) {
+    g_printerr ("%s: pushing frames failed\n", name);
+    return FALSE;
+  }
+
+  g_print ("%-8s held %5u: %8.1f ns/frame (%u frames) %8.1f ns/frame "
+      "(%u frames)\n", name, held, short_run, n_frames, long_run,
+      n_frames * 4);
+
+  return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  gchar *held_str = NULL;
+  gint n_frames = DEFAULT_FRAMES;
+  GOptionEntry options[] = {
+    {"frames", 'n', 0, G_OPTION_ARG_INT, &n_frames,
+        "Number of frames of the short run (default 10000)", "N"},
+    {"held", 0, 0, G_OPTION_ARG_STRING, &held_str,
+          "Comma separated numbers of pending frames (default " DEFAULT_HELD
+          ")", "HELD"},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GstCaps *raw_caps, *coded_caps;
+  gchar **held;
+  guint i;
+  gint ret = 0;
+
+  ctx = g_option_context_new ("- benchmark video codec frame bookkeeping");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (n_frames <= 0) {
+    g_printerr ("invalid number of frames\n");
+    return 1;
+  }
+
+  raw_caps = gst_caps_new_simple ("video/x-raw",
+      "format", G_TYPE_STRING, "GRAY8",
+      "width", G_TYPE_INT, BENCH_WIDTH, "height", G_TYPE_INT, BENCH_HEIGHT,
+      "framerate", GST_TYPE_FRACTION, 1000, 1, NULL);
+  coded_caps = gst_caps_new_simple ("video/x-bench",
+      "width", G_TYPE_INT, BENCH_WIDTH, "height", G_TYPE_INT, BENCH_HEIGHT,
+      "framerate", GST_TYPE_FRACTION, 1000, 1, NULL);
+
+  held = g_strsplit (held_str ? held_str : DEFAULT_HELD, ",", -1);
+  for (i = 0; held[i] && ret == 0; i++) {
+    guint n_held = atoi (held[i]);
+
+    if (!run_bench ("decoder", bench_dec_get_type (), coded_caps, n_frames,
+            n_held)
+        || !run_bench ("encoder", bench_enc_get_type (), raw_caps, n_frames,
+            n_held))
+      ret = 1;
+  }
+  g_strfreev (held);
+
+  gst_caps_unref (raw_caps);
+  gst_caps_unref (coded_caps);
+  g_free (held_str);
+
+  return ret;
+}
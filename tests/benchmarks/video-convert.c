@@ -0,0 +1,487 @@
+/* GStreamer
+ *
+ * video-convert.c: benchmark for GstVideoConverter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures the speed of GstVideoConverter for all combinations of input
+ * format, output format, size, resampler method and dither method given
+ * on the command line. For every combination the number of output
+ * Mpixels/s is printed together with the path the converter picked, a
+ * fastpath or the generic path.
+ *
+ * Without options, all formats are converted into each other at 1080p and
+ * from 1080p to 720p with all resampler methods. Use --json to write the
+ * results in a form that can be compared between commits, for example:
+ *
+ *   video-convert --in-formats=I420,NV12 --dither=all --json=results.json
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/video/video-converter-private.h>
+
+#define DEFAULT_SIZES "1920x1080,1920x1080:1280x720"
+#define DEFAULT_TIME 0.05
+
+typedef struct
+{
+  gint in_width, in_height;
+  gint out_width, out_height;
+} BenchSize;
+
+typedef struct
+{
+  GstVideoFormat in_format, out_format;
+  BenchSize size;
+  gint method;
+  gint dither;
+  gchar *path;
+  gdouble mpixels_sec;
+} BenchResult;
+
+/* describe the path @convert uses, a fastpath or the generic path with
+ * its options */
+static gchar *
+describe_path (GstVideoConverter * convert)
+{
+  const GstStructure *path = _gst_video_converter_get_path (convert);
+  GString *str;
+  const gchar *matrix;
+  gint tile_width;
+  gboolean color_lut;
+
+  if (path == NULL)
+    g_error ("the converter did not report the path it uses");
+
+  str = g_string_new (gst_structure_get_name (path));
+
+  if (gst_structure_get_int (path, "tile-width", &tile_width)
+      && tile_width > 0)
+    g_string_append_printf (str, " tiles=%d", tile_width);
+  if (gst_structure_get_boolean (path, "color-lut", &color_lut) && color_lut)
+    g_string_append (str, " lut");
+  matrix = gst_structure_get_string (path, "matrix");
+  if (matrix && strcmp (matrix, "none") != 0)
+    g_string_append_printf (str, " matrix=%s", matrix);
+
+  return g_string_free (str, FALSE);
+}
+
+static GArray *
+parse_formats (const gchar * str)
+{
+  GArray *formats;
+  gchar **names;
+  gint i;
+
+  formats = g_array_new (FALSE, FALSE, sizeof (GstVideoFormat));
+
+  if (g_strcmp0 (str, "all") == 0) {
+    GstVideoFormat format;
+
+    for (format = GST_VIDEO_FORMAT_I420;
+        gst_video_format_to_string (format) != NULL; format++)
+      g_array_append_val (formats, format);
+
+    return formats;
+  }
+
+  names = g_strsplit (str, ",", -1);
+  for (i = 0; names[i]; i++) {
+    GstVideoFormat format = gst_video_format_from_string (names[i]);
+
+    if (format == GST_VIDEO_FORMAT_UNKNOWN) {
+      g_printerr ("unknown format '%s'\n", names[i]);
+      g_array_free (formats, TRUE);
+      formats = NULL;
+      break;
+    }
+    g_array_append_val (formats, format);
+  }
+  g_strfreev (names);
+
+  return formats;
+}
+
+static GArray *
+parse_sizes (const gchar * str)
+{
+  GArray *sizes;
+  gchar **tokens;
+  gint i;
+
+  sizes = g_array_new (FALSE, FALSE, sizeof (BenchSize));
+
+  tokens = g_strsplit (str, ",", -1);
+  for (i = 0; tokens[i]; i++) {
+    BenchSize size;
+    gint n;
+
+    n = sscanf (tokens[i], "%dx%d:%dx%d", &size.in_width, &size.in_height,
+        &size.out_width, &size.out_height);
+    if (n == 2) {
+      size.out_width = size.in_width;
+      size.out_height = size.in_height;
+    } else if (n != 4) {
+      n = 0;
+    }
+    if (n == 0 || size.in_width <= 0 || size.in_height <= 0 ||
+        size.out_width <= 0 || size.out_height <= 0) {
+      g_printerr ("invalid size '%s', use WIDTHxHEIGHT or "
+          "WIDTHxHEIGHT:WIDTHxHEIGHT\n", tokens[i]);
+      g_array_free (sizes, TRUE);
+      sizes = NULL;
+      break;
+    }
+    g_array_append_val (sizes, size);
+  }
+  g_strfreev (tokens);
+
+  return sizes;
+}
+
+/* parse a list of nicks of the enum @type, the enum class is kept alive
+ * for enum_nick() */
+static GArray *
+parse_enum (GType type, const gchar * str)
+{
+  GEnumClass *klass;
+  GArray *values;
+  gchar **nicks;
+  gint i;
+
+  klass = g_type_class_ref (type);
+  values = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  if (g_strcmp0 (str, "all") == 0) {
+    for (i = 0; i < klass->n_values; i++)
+      g_array_append_val (values, klass->values[i].value);
+    return values;
+  }
+
+  nicks = g_strsplit (str, ",", -1);
+  for (i = 0; nicks[i]; i++) {
+    GEnumValue *value = g_enum_get_value_by_nick (klass, nicks[i]);
+
+    if (value == NULL) {
+      g_printerr ("unknown %s '%s'\n", g_type_name (type), nicks[i]);
+      g_array_free (values, TRUE);
+      values = NULL;
+      break;
+    }
+    g_array_append_val (values, value->value);
+  }
+  g_strfreev (nicks);
+
+  return values;
+}
+
+static const gchar *
+enum_nick (GType type, gint value)
+{
+  GEnumClass *klass;
+  GEnumValue *val;
+
+  klass = g_type_class_peek (type);
+  val = g_enum_get_value (klass, value);
+
+  return val ? val->value_nick : "unknown";
+}
+
+static gboolean
+can_convert (GstVideoFormat format)
+{
+  const GstVideoFormatInfo *finfo = gst_video_format_get_info (format);
+
+  return finfo->unpack_func != NULL && finfo->pack_func != NULL;
+}
+
+static gboolean
+run_case (BenchResult * res, guint n_threads, gdouble time)
+{
+  GstVideoInfo in_info, out_info;
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *in_buffer, *out_buffer;
+  GstVideoConverter *convert;
+  GstStructure *config;
+  GTimer *timer;
+  gdouble elapsed;
+  gint count;
+
+  gst_video_info_set_format (&in_info, res->in_format, res->size.in_width,
+      res->size.in_height);
+  gst_video_info_set_format (&out_info, res->out_format, res->size.out_width,
+      res->size.out_height);
+
+  config = gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      res->dither, GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, n_threads,
+      NULL);
+  if (res->method != -1)
+    gst_structure_set (config, GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+        GST_TYPE_VIDEO_RESAMPLER_METHOD, res->method, NULL);
+
+  convert = gst_video_converter_new (&in_info, &out_info, config);
+  if (convert == NULL)
+    return FALSE;
+
+  res->path = describe_path (convert);
+
+  in_buffer = gst_buffer_new_and_alloc (in_info.size);
+  gst_buffer_memset (in_buffer, 0, 0x80, -1);
+  out_buffer = gst_buffer_new_and_alloc (out_info.size);
+
+  gst_video_frame_map (&in_frame, &in_info, in_buffer, GST_MAP_READ);
+  gst_video_frame_map (&out_frame, &out_info, out_buffer, GST_MAP_WRITE);
+
+  /* warmup */
+  gst_video_converter_frame (convert, &in_frame, &out_frame);
+
+  timer = g_timer_new ();
+  count = 0;
+  while (TRUE) {
+    gst_video_converter_frame (convert, &in_frame, &out_frame);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= time)
+      break;
+  }
+  g_timer_destroy (timer);
+
+  res->mpixels_sec = (gdouble) res->size.out_width * res->size.out_height *
+      count / elapsed / 1000000.0;
+
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+  gst_buffer_unref (out_buffer);
+  gst_buffer_unref (in_buffer);
+  gst_video_converter_free (convert);
+
+  return TRUE;
+}
+
+static void
+print_result (const BenchResult * res)
+{
+  g_print ("%-10s %5dx%-5d -> %-10s %5dx%-5d %-8s %-11s %10.2f Mpixels/s  %s\n",
+      gst_video_format_to_string (res->in_format), res->size.in_width,
+      res->size.in_height, gst_video_format_to_string (res->out_format),
+      res->size.out_width, res->size.out_height,
+      res->method == -1 ? "-" : enum_nick (GST_TYPE_VIDEO_RESAMPLER_METHOD,
+          res->method), enum_nick (GST_TYPE_VIDEO_DITHER_METHOD, res->dither),
+      res->mpixels_sec, res->path);
+}
+
+static gboolean
+write_json (GArray * results, const gchar * filename, guint n_threads,
+    gdouble time)
+{
+  GString *json;
+  gboolean ret = TRUE;
+  gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+  guint i;
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json, "  \"version\": \"%s\",\n", PACKAGE_VERSION);
+  g_string_append_printf (json, "  \"threads\": %u,\n", n_threads);
+  g_string_append_printf (json, "  \"time\": %s,\n",
+      g_ascii_dtostr (buf, sizeof (buf), time));
+  g_string_append (json, "  \"results\": [");
+
+  for (i = 0; i < results->len; i++) {
+    BenchResult *res = &g_array_index (results, BenchResult, i);
+
+    g_string_append_printf (json, "%s\n    {", i == 0 ? "" : ",");
+    g_string_append_printf (json, "\"in-format\": \"%s\", ",
+        gst_video_format_to_string (res->in_format));
+    g_string_append_printf (json, "\"in-width\": %d, \"in-height\": %d, ",
+        res->size.in_width, res->size.in_height);
+    g_string_append_printf (json, "\"out-format\": \"%s\", ",
+        gst_video_format_to_string (res->out_format));
+    g_string_append_printf (json, "\"out-width\": %d, \"out-height\": %d, ",
+        res->size.out_width, res->size.out_height);
+    if (res->method == -1)
+      g_string_append (json, "\"resampler-method\": null, ");
+    else
+      g_string_append_printf (json, "\"resampler-method\": \"%s\", ",
+          enum_nick (GST_TYPE_VIDEO_RESAMPLER_METHOD, res->method));
+    g_string_append_printf (json, "\"dither-method\": \"%s\", ",
+        enum_nick (GST_TYPE_VIDEO_DITHER_METHOD, res->dither));
+    g_string_append_printf (json, "\"path\": \"%s\", ", res->path);
+    g_string_append_printf (json, "\"mpixels-per-sec\": %s}",
+        g_ascii_dtostr (buf, sizeof (buf), res->mpixels_sec));
+  }
+  g_string_append (json, "\n  ]\n}\n");
+
+  if (g_strcmp0 (filename, "-") == 0) {
+    g_print ("%s", json->str);
+  } else {
+    GError *err = NULL;
+
+    if (!g_file_set_contents (filename, json->str, json->len, &err)) {
+      g_printerr ("could not write %s: %s\n", filename, err->message);
+      g_error_free (err);
+      ret = FALSE;
+    }
+  }
+  g_string_free (json, TRUE);
+
+  return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+  gchar *in_formats_str = NULL, *out_formats_str = NULL, *sizes_str = NULL;
+  gchar *methods_str = NULL, *dithers_str = NULL, *json_file = NULL;
+  gdouble time = DEFAULT_TIME;
+  gint n_threads = 1;
+  GOptionEntry options[] = {
+    {"in-formats", 'i', 0, G_OPTION_ARG_STRING, &in_formats_str,
+        "Comma separated input formats (default all)", "FORMATS"},
+    {"out-formats", 'o', 0, G_OPTION_ARG_STRING, &out_formats_str,
+        "Comma separated output formats (default all)", "FORMATS"},
+    {"sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_str,
+          "Comma separated sizes, WIDTHxHEIGHT or WIDTHxHEIGHT:WIDTHxHEIGHT "
+          "to scale (default " DEFAULT_SIZES ")", "SIZES"},
+    {"methods", 'm', 0, G_OPTION_ARG_STRING, &methods_str,
+          "Comma separated resampler methods used when scaling (default all)",
+        "METHODS"},
+    {"dither", 'd', 0, G_OPTION_ARG_STRING, &dithers_str,
+        "Comma separated dither methods (default bayer)", "METHODS"},
+    {"threads", 't', 0, G_OPTION_ARG_INT, &n_threads,
+        "Number of threads, 0 for the number of cores (default 1)", "N"},
+    {"time", 0, 0, G_OPTION_ARG_DOUBLE, &time,
+        "Seconds to run each conversion (default 0.05)", "SECONDS"},
+    {"json", 'j', 0, G_OPTION_ARG_FILENAME, &json_file,
+        "Write the results as JSON to FILE, - for stdout", "FILE"},
+    {NULL}
+  };
+  GOptionContext *ctx;
+  GError *err = NULL;
+  GArray *in_formats = NULL, *out_formats = NULL, *sizes = NULL;
+  GArray *methods = NULL, *dithers = NULL, *results;
+  guint i, j, k, l, m;
+  gint ret = 1;
+
+  ctx = g_option_context_new ("- benchmark video conversions");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_clear_error (&err);
+    g_option_context_free (ctx);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  in_formats = parse_formats (in_formats_str ? in_formats_str : "all");
+  out_formats = parse_formats (out_formats_str ? out_formats_str : "all");
+  sizes = parse_sizes (sizes_str ? sizes_str : DEFAULT_SIZES);
+  methods = parse_enum (GST_TYPE_VIDEO_RESAMPLER_METHOD,
+      methods_str ? methods_str : "all");
+  dithers = parse_enum (GST_TYPE_VIDEO_DITHER_METHOD,
+      dithers_str ? dithers_str : "bayer");
+  if (!in_formats || !out_formats || !sizes || !methods || !dithers)
+    goto done;
+
+  if (n_threads < 0 || time <= 0.0) {
+    g_printerr ("invalid number of threads or time\n");
+    goto done;
+  }
+
+  results = g_array_new (FALSE, FALSE, sizeof (BenchResult));
+
+  for (i = 0; i < sizes->len; i++) {
+    BenchSize *size = &g_array_index (sizes, BenchSize, i);
+    gboolean scale = size->in_width != size->out_width ||
+        size->in_height != size->out_height;
+
+    for (j = 0; j < in_formats->len; j++) {
+      GstVideoFormat in_format = g_array_index (in_formats, GstVideoFormat, j);
+
+      if (!can_convert (in_format))
+        continue;
+
+      for (k = 0; k < out_formats->len; k++) {
+        GstVideoFormat out_format =
+            g_array_index (out_formats, GstVideoFormat, k);
+
+        if (!can_convert (out_format))
+          continue;
+
+        /* the resampler method only matters when scaling */
+        for (l = 0; l < (scale ? methods->len : 1); l++) {
+          for (m = 0; m < dithers->len; m++) {
+            BenchResult res;
+
+            res.in_format = in_format;
+            res.out_format = out_format;
+            res.size = *size;
+            res.method = scale ? g_array_index (methods, gint, l) : -1;
+            res.dither = g_array_index (dithers, gint, m);
+            res.path = NULL;
+
+            if (!run_case (&res, n_threads, time))
+              continue;
+
+            print_result (&res);
+            g_array_append_val (results, res);
+          }
+        }
+      }
+    }
+  }
+
+  ret = 0;
+  if (json_file && !write_json (results, json_file, n_threads, time))
+    ret = 1;
+
+  for (i = 0; i < results->len; i++)
+    g_free (g_array_index (results, BenchResult, i).path);
+  g_array_free (results, TRUE);
+
+done:
+  if (in_formats)
+    g_array_free (in_formats, TRUE);
+  if (out_formats)
+    g_array_free (out_formats, TRUE);
+  if (sizes)
+    g_array_free (sizes, TRUE);
+  if (methods)
+    g_array_free (methods, TRUE);
+  if (dithers)
+    g_array_free (dithers, TRUE);
+  g_free (in_formats_str);
+  g_free (out_formats_str);
+  g_free (sizes_str);
+  g_free (methods_str);
+  g_free (dithers_str);
+  g_free (json_file);
+
+  return ret;
+}
@@ -503,6 +503,64 @@ GST_START_TEST (test_pull_with_timeout)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_buffer_list)
+{
+  GstElement *sink;
+  GstSegment segment;
+  GstBufferList *list;
+  GstSample *s;
+  guint i;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 5; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (i + 1)) == GST_FLOW_OK);
+
+  /* the buffers after a new segment go in the next list */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.start = 2 * GST_SECOND;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 5; i < 7; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (i + 1)) == GST_FLOW_OK);
+
+  s = gst_app_sink_pull_buffer_list (GST_APP_SINK (sink));
+  fail_unless (s != NULL);
+  fail_unless (gst_sample_get_buffer (s) == NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless (list != NULL);
+  fail_unless_equals_int (gst_buffer_list_length (list), 5);
+  for (i = 0; i < 5; i++)
+    fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list,
+                i)), i + 1);
+  fail_if (gst_segment_is_equal (&segment, gst_sample_get_segment (s)));
+  gst_sample_unref (s);
+
+  g_signal_emit_by_name (sink, "try-pull-buffer-list", GST_SECOND / 20, &s);
+  fail_unless (s != NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless (list != NULL);
+  fail_unless_equals_int (gst_buffer_list_length (list), 2);
+  for (i = 0; i < 2; i++)
+    fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list,
+                i)), i + 6);
+  fail_unless (gst_segment_is_equal (&segment, gst_sample_get_segment (s)));
+  gst_sample_unref (s);
+
+  /* No waiting */
+  s = gst_app_sink_try_pull_buffer_list (GST_APP_SINK (sink), 0);
+  fail_unless (s == NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsink_suite (void)
 {
@@ -520,6 +578,7 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_buffer_list_signal);
   tcase_add_test (tc_chain, test_segment);
   tcase_add_test (tc_chain, test_pull_with_timeout);
+  tcase_add_test (tc_chain, test_pull_buffer_list);
 
   return s;
 }
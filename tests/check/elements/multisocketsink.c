@@ -917,6 +917,70 @@ GST_END_TEST;
 
 /* Check that we can get data when multisocketsink is configured in next-keyframe
  * mode */
+/* keep 100 ms and burst between 30 and 60 ms to a client, starting with a
+ * keyframe */
+GST_START_TEST (test_burst_client_time_keyframe)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *socket[2];
+  gint i;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "sync", FALSE, NULL);
+  g_object_set (sink, "time-min", (gint64) 100 * GST_MSECOND, NULL);
+
+  fail_unless (setup_handles (&socket[0], &socket[1]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_TIME);
+
+  /* 10 ms buffers, buffer 0 and 5 are keyframes */
+  for (i = 0; i < 10; i++) {
+    GstBuffer *buffer = gst_new_buffer (i);
+
+    GST_BUFFER_TIMESTAMP (buffer) = i * 10 * GST_MSECOND;
+    if (i % 5 != 0)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* 4 = burst_keyframe */
+  g_signal_emit_by_name (sink, "add_full", socket[0], 4,
+      GST_FORMAT_TIME, (guint64) 30 * GST_MSECOND, GST_FORMAT_TIME,
+      (guint64) 60 * GST_MSECOND);
+  fail_unless_num_handles (sink, 1);
+
+  for (i = 10; i < 11; i++) {
+    GstBuffer *buffer = gst_new_buffer (i);
+
+    GST_BUFFER_TIMESTAMP (buffer) = i * 10 * GST_MSECOND;
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* the keyframe between 30 and 60 ms back is buffer 5 */
+  fail_unless_read ("client", socket[1], 16, "deadbee00000005");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000006");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000007");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000008");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000009");
+  fail_unless_read ("client", socket[1], 16, "deadbee0000000a");
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  g_object_unref (socket[0]);
+  g_object_unref (socket[1]);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_client_next_keyframe)
 {
   GstElement *sink;
@@ -965,6 +1029,343 @@ GST_START_TEST (test_client_next_keyframe)
 
 GST_END_TEST;
 
+/* a client that bursts 5 buffers on connect gets them with fewer writes */
+GST_START_TEST (test_client_catch_up)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *socket[2];
+  GstStructure *stats;
+  guint64 writes, writes_saved;
+  gint i;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "bytes-min", 100, NULL);
+  g_object_set (sink, "sync-method", 3, NULL);  /* 3 = burst */
+  g_object_set (sink, "burst-format", GST_FORMAT_BYTES, NULL);
+  g_object_set (sink, "burst-value", (guint64) 80, NULL);
+
+  fail_unless (setup_handles (&socket[0], &socket[1]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < 9; i++)
+    fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (i)) == GST_FLOW_OK);
+
+  g_signal_emit_by_name (sink, "add", socket[0]);
+  fail_unless_num_handles (sink, 1);
+
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (9)) == GST_FLOW_OK);
+
+  /* the buffers arrive complete and in order */
+  fail_unless_read ("client", socket[1], 16, "deadbee00000005");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000006");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000007");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000008");
+  fail_unless_read ("client", socket[1], 16, "deadbee00000009");
+
+  /* every buffer was written by a write of its own or along with another
+   * one, the stats are updated right after the write returned */
+  do {
+    g_signal_emit_by_name (sink, "get-stats", socket[0], &stats);
+    fail_unless (gst_structure_get_uint64 (stats, "writes", &writes));
+    fail_unless (gst_structure_get_uint64 (stats, "writes-saved",
+            &writes_saved));
+    gst_structure_free (stats);
+  } while (writes + writes_saved < 5);
+
+  fail_unless_equals_uint64 (writes + writes_saved, 5);
+  fail_unless (writes_saved > 0);
+  fail_unless (writes < 5);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  g_object_unref (socket[0]);
+  g_object_unref (socket[1]);
+}
+
+GST_END_TEST;
+
+#define N_SERVE_CLIENTS 4
+
+/* Check that the clients are served and removed with the given io-mode and
+ * number of threads, including clients that ran out of data and have to be
+ * woken up for new buffers. Without epoll support the sink falls back to the
+ * main context. */
+static void
+check_serve_clients (const gchar * io_mode, guint n_threads)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *socket[2 * N_SERVE_CLIENTS];
+  gint i, j, handles;
+
+  sink = setup_multisocketsink ();
+  gst_util_set_object_arg (G_OBJECT (sink), "io-mode", io_mode);
+  g_object_set (sink, "n-threads", n_threads, NULL);
+
+  for (i = 0; i < N_SERVE_CLIENTS; i++)
+    fail_unless (setup_handles (&socket[2 * i], &socket[2 * i + 1]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < N_SERVE_CLIENTS; i++)
+    g_signal_emit_by_name (sink, "add", socket[2 * i]);
+  fail_unless_num_handles (sink, N_SERVE_CLIENTS);
+
+  /* the clients drain the queue after every buffer */
+  for (i = 0; i < 3; i++) {
+    gchar ref[16];
+
+    fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (i)) == GST_FLOW_OK);
+
+    g_snprintf (ref, sizeof (ref), "deadbee%08x", i);
+    for (j = 0; j < N_SERVE_CLIENTS; j++)
+      fail_unless_read ("client", socket[2 * j + 1], 16, ref);
+  }
+
+  /* the app removes the first client */
+  g_signal_emit_by_name (sink, "remove", socket[0]);
+  fail_unless_num_handles (sink, N_SERVE_CLIENTS - 1);
+
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (3)) == GST_FLOW_OK);
+  for (j = 1; j < N_SERVE_CLIENTS; j++)
+    fail_unless_read ("client", socket[2 * j + 1], 16, "deadbee00000003");
+
+  /* the other clients hang up */
+  for (j = 1; j < N_SERVE_CLIENTS; j++) {
+    g_object_unref (socket[2 * j + 1]);
+    socket[2 * j + 1] = NULL;
+  }
+  do {
+    g_usleep (G_USEC_PER_SEC / 100);
+    g_object_get (sink, "num-handles", &handles, NULL);
+  } while (handles != 0);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < 2 * N_SERVE_CLIENTS; i++) {
+    if (socket[i])
+      g_object_unref (socket[i]);
+  }
+}
+
+GST_START_TEST (test_epoll_clients)
+{
+  check_serve_clients ("epoll", 1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_threaded_clients)
+{
+  check_serve_clients ("main-context", 3);
+  check_serve_clients ("epoll", 3);
+}
+
+GST_END_TEST;
+
+#define BIG_BUFFER_SIZE 4096
+
+static GstBuffer *
+gst_new_big_buffer (gint i)
+{
+  GstBuffer *buffer = gst_buffer_new_and_alloc (BIG_BUFFER_SIZE);
+
+  gst_buffer_memset (buffer, 0, i & 0xff, BIG_BUFFER_SIZE);
+
+  return buffer;
+}
+
+/* read the buffers made with gst_new_big_buffer() from @first to @last */
+static void
+fail_unless_read_big_buffers (GSocket * socket, gint first, gint last)
+{
+  guint8 data[BIG_BUFFER_SIZE], ref[BIG_BUFFER_SIZE];
+  gint i;
+
+  for (i = first; i < last; i++) {
+    memset (ref, i & 0xff, BIG_BUFFER_SIZE);
+    fail_unless (read_handle_n_bytes_exactly (socket, data, BIG_BUFFER_SIZE));
+    fail_unless (memcmp (data, ref, BIG_BUFFER_SIZE) == 0,
+        "buffer %d differs", i);
+  }
+}
+
+#define N_SLOW_BUFFERS 256
+
+/* A client that doesn't read fills up its socket. The other client must
+ * still get all the data, and the slow client must get everything once it
+ * starts reading. */
+static void
+check_slow_client (const gchar * io_mode, guint n_threads)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *socket[4];
+  gint i;
+
+  sink = setup_multisocketsink ();
+  gst_util_set_object_arg (G_OBJECT (sink), "io-mode", io_mode);
+  g_object_set (sink, "n-threads", n_threads, NULL);
+
+  fail_unless (setup_handles (&socket[0], &socket[1]));
+  fail_unless (setup_handles (&socket[2], &socket[3]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  g_signal_emit_by_name (sink, "add", socket[0]);
+  g_signal_emit_by_name (sink, "add", socket[2]);
+  fail_unless_num_handles (sink, 2);
+
+  /* much more than fits in the socket of the slow client */
+  for (i = 0; i < N_SLOW_BUFFERS; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_new_big_buffer (i)) == GST_FLOW_OK);
+
+  fail_unless_read_big_buffers (socket[1], 0, N_SLOW_BUFFERS);
+
+  /* the slow client is still there and catches up */
+  fail_unless_num_handles (sink, 2);
+  fail_unless_read_big_buffers (socket[3], 0, N_SLOW_BUFFERS);
+  wait_bytes_served (sink, 2 * N_SLOW_BUFFERS * BIG_BUFFER_SIZE);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < 4; i++)
+    g_object_unref (socket[i]);
+}
+
+GST_START_TEST (test_slow_client)
+{
+  check_slow_client ("main-context", 1);
+  check_slow_client ("main-context", 2);
+  check_slow_client ("epoll", 2);
+}
+
+GST_END_TEST;
+
+#define N_REMOVE_LOOPS 200
+
+typedef struct
+{
+  GSocket *socket;
+  gint stop;
+} DrainData;
+
+/* reads and drops everything the sink writes to a client */
+static gpointer
+drain_func (gpointer user_data)
+{
+  DrainData *data = user_data;
+  gchar buf[BIG_BUFFER_SIZE];
+
+  while (!g_atomic_int_get (&data->stop)) {
+    if (g_socket_receive_with_blocking (data->socket, buf, sizeof (buf), FALSE,
+            NULL, NULL) <= 0)
+      g_usleep (100);
+  }
+  return NULL;
+}
+
+static void
+client_removed_cb (GstElement * sink, GSocket * socket, gint status,
+    gint * n_removed)
+{
+  g_atomic_int_inc (n_removed);
+}
+
+/* With more than one thread the sink writes to a client with the clients
+ * lock released. Remove and add a client again and again while the sink
+ * writes to it, the sink must notice that the client it was writing to is
+ * gone, also when the same socket was added again meanwhile. Another client
+ * must not be affected. */
+static void
+check_remove_while_writing (const gchar * io_mode)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *socket[4];
+  DrainData drain;
+  GThread *thread;
+  gint i, n_removed = 0;
+
+  sink = setup_multisocketsink ();
+  gst_util_set_object_arg (G_OBJECT (sink), "io-mode", io_mode);
+  g_object_set (sink, "n-threads", 3, NULL);
+  g_signal_connect (sink, "client-removed", G_CALLBACK (client_removed_cb),
+      &n_removed);
+
+  fail_unless (setup_handles (&socket[0], &socket[1]));
+  fail_unless (setup_handles (&socket[2], &socket[3]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  /* the client that stays */
+  g_signal_emit_by_name (sink, "add", socket[2]);
+
+  drain.socket = socket[1];
+  drain.stop = FALSE;
+  thread = g_thread_new ("drain", drain_func, &drain);
+
+  for (i = 0; i < N_REMOVE_LOOPS; i++) {
+    g_signal_emit_by_name (sink, "add", socket[0]);
+    fail_unless_num_handles (sink, 2);
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_new_big_buffer (i)) == GST_FLOW_OK);
+    g_signal_emit_by_name (sink, "remove", socket[0]);
+    fail_unless_num_handles (sink, 1);
+  }
+  fail_unless_equals_int (g_atomic_int_get (&n_removed), N_REMOVE_LOOPS);
+
+  /* the other client got everything */
+  fail_unless_read_big_buffers (socket[3], 0, N_REMOVE_LOOPS);
+
+  g_atomic_int_set (&drain.stop, TRUE);
+  g_thread_join (thread);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < 4; i++)
+    g_object_unref (socket[i]);
+}
+
+GST_START_TEST (test_remove_while_writing)
+{
+  check_remove_while_writing ("main-context");
+  check_remove_while_writing ("epoll");
+}
+
+GST_END_TEST;
+
 /* FIXME: add test simulating chained oggs where:
  * sync-method is burst-on-connect
  * (when multisocketsink actually does burst-on-connect based on byte size, not
@@ -987,7 +1388,13 @@ multisocketsink_suite (void)
   tcase_add_test (tc_chain, test_burst_client_bytes);
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
+  tcase_add_test (tc_chain, test_burst_client_time_keyframe);
   tcase_add_test (tc_chain, test_client_next_keyframe);
+  tcase_add_test (tc_chain, test_client_catch_up);
+  tcase_add_test (tc_chain, test_epoll_clients);
+  tcase_add_test (tc_chain, test_threaded_clients);
+  tcase_add_test (tc_chain, test_slow_client);
+  tcase_add_test (tc_chain, test_remove_while_writing);
 
   return s;
 }
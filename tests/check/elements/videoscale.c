@@ -989,6 +989,122 @@ GST_START_TEST (test_basetransform_negotiation)
 
 GST_END_TEST;
 
+static GstBuffer *zero_copy_inbuf;
+static guint zero_copy_n_buffers;
+
+static GstPadProbeReturn
+zero_copy_sink_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  zero_copy_inbuf = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+zero_copy_src_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstVideoFrame frame;
+  GstVideoInfo vinfo;
+  GstCaps *caps;
+  guint8 *y, *u;
+  gint ystride, ustride;
+
+  /* the picture was not copied, the input buffer was padded */
+  fail_unless (buffer == zero_copy_inbuf);
+
+  caps = gst_pad_get_current_caps (pad);
+  fail_unless (gst_video_info_from_caps (&vinfo, caps));
+  gst_caps_unref (caps);
+
+  fail_unless (gst_video_frame_map (&frame, &vinfo, buffer, GST_MAP_READ));
+  y = GST_VIDEO_FRAME_COMP_DATA (&frame, 0);
+  u = GST_VIDEO_FRAME_COMP_DATA (&frame, 1);
+  ystride = GST_VIDEO_FRAME_COMP_STRIDE (&frame, 0);
+  ustride = GST_VIDEO_FRAME_COMP_STRIDE (&frame, 1);
+
+  /* 40 lines of black above and below the white picture */
+  fail_unless_equals_int (y[0], 16);
+  fail_unless_equals_int (y[39 * ystride + 319], 16);
+  fail_unless_equals_int (y[40 * ystride], 235);
+  fail_unless_equals_int (y[279 * ystride + 319], 235);
+  fail_unless_equals_int (y[280 * ystride], 16);
+  fail_unless_equals_int (y[319 * ystride + 319], 16);
+  fail_unless_equals_int (u[0], 128);
+  fail_unless_equals_int (u[19 * ustride + 159], 128);
+  fail_unless_equals_int (u[159 * ustride + 159], 128);
+
+  gst_video_frame_unmap (&frame);
+
+  zero_copy_n_buffers++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_zero_copy_borders)
+{
+  GstElement *pipeline;
+  GstElement *src, *capsfilter1, *scale, *capsfilter2, *sink;
+  GstMessage *msg;
+  GstCaps *caps;
+  GstPad *pad;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("videotestsrc", NULL);
+  capsfilter1 = gst_element_factory_make ("capsfilter", NULL);
+  scale = gst_element_factory_make ("videoscale", NULL);
+  capsfilter2 = gst_element_factory_make ("capsfilter", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (pipeline && src && capsfilter1 && scale && capsfilter2 && sink);
+
+  g_object_set (src, "num-buffers", 3, NULL);
+  gst_util_set_object_arg (G_OBJECT (src), "pattern", "white");
+  g_object_set (scale, "add-borders", TRUE, "zero-copy-borders", TRUE, NULL);
+
+  caps = gst_caps_from_string ("video/x-raw, format=I420, width=320, "
+      "height=240, framerate=30/1, pixel-aspect-ratio=1/1");
+  g_object_set (capsfilter1, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("video/x-raw, format=I420, width=320, "
+      "height=320, pixel-aspect-ratio=1/1");
+  g_object_set (capsfilter2, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  gst_bin_add_many (GST_BIN (pipeline), src, capsfilter1, scale, capsfilter2,
+      sink, NULL);
+  fail_unless (gst_element_link_many (src, capsfilter1, scale, capsfilter2,
+          sink, NULL));
+
+  zero_copy_inbuf = NULL;
+  zero_copy_n_buffers = 0;
+
+  pad = gst_element_get_static_pad (scale, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, zero_copy_sink_probe,
+      NULL, NULL);
+  gst_object_unref (pad);
+
+  pad = gst_element_get_static_pad (scale, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, zero_copy_src_probe,
+      NULL, NULL);
+  gst_object_unref (pad);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  fail_unless_equals_int (zero_copy_n_buffers, 3);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 #endif /* !defined(VSCALE_TEST_GROUP) */
 
 static Suite *
@@ -1010,6 +1126,7 @@ videoscale_suite (void)
   tcase_add_test (tc_chain, test_reverse_negotiation);
 #endif
   tcase_add_test (tc_chain, test_basetransform_negotiation);
+  tcase_add_test (tc_chain, test_zero_copy_borders);
 #elif VSCALE_TEST_GROUP == 1
   tcase_add_test (tc_chain, test_downscale_640x480_320x240_method_0);
   tcase_add_test (tc_chain, test_downscale_640x480_320x240_method_1);
@@ -21,6 +21,10 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             /* for pthread_getaffinity_np() */
+#endif
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -28,7 +32,17 @@
 #include <gst/check/gstcheck.h>
 
 #include <gst/audio/audio.h>
+#include <gst/audio/audio-channel-mixer-private.h>
+#include <gst/audio/audio-resampler-private.h>
+#include <gst/audio/gstaudioutilsprivate.h>
 #include <string.h>
+#include <math.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_SCHED_H
+#include <sched.h>
+#endif
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -705,6 +719,1009 @@ GST_START_TEST (test_fill_silence)
 
 GST_END_TEST;
 
+#define RESAMPLE_CHANNELS 32
+#define RESAMPLE_CHUNK 1000
+#define RESAMPLE_CHUNKS 4
+
+/* resample some chunks of a different sine on each channel and return all
+ * output samples, interleaved. @kernels picks the kernels, %NULL for the
+ * default ones */
+static GArray *
+run_resampler (GstAudioFormat format, GstAudioResamplerFlags flags,
+    GstAudioResamplerFilterMode filter_mode, guint n_threads,
+    const gchar * kernels)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  GArray *result;
+  gint bps = format == GST_AUDIO_FORMAT_S16 ? 2 : 4;
+  gint i, j, c, offset = 0;
+
+  options = gst_structure_new_empty ("options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 44100, 48000, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      filter_mode, GST_AUDIO_RESAMPLER_OPT_THREADS, G_TYPE_UINT, n_threads,
+      NULL);
+  if (kernels)
+    gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_KERNELS,
+        G_TYPE_STRING, kernels, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      flags, format, RESAMPLE_CHANNELS, 44100, 48000, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  result = g_array_new (FALSE, TRUE, bps);
+
+  for (i = 0; i < RESAMPLE_CHUNKS; i++) {
+    gpointer in_data, out_data, in[1], out[RESAMPLE_CHANNELS];
+    gsize out_frames;
+
+    in_data = g_malloc (RESAMPLE_CHUNK * RESAMPLE_CHANNELS * bps);
+    for (j = 0; j < RESAMPLE_CHUNK; j++) {
+      for (c = 0; c < RESAMPLE_CHANNELS; c++) {
+        gdouble v = sin ((offset + j) * (c + 1) * G_PI / 200.0) * 0.8;
+
+        if (format == GST_AUDIO_FORMAT_S16)
+          ((gint16 *) in_data)[j * RESAMPLE_CHANNELS + c] = v * 32767;
+        else
+          ((gfloat *) in_data)[j * RESAMPLE_CHANNELS + c] = v;
+      }
+    }
+    offset += RESAMPLE_CHUNK;
+    in[0] = in_data;
+
+    out_frames = gst_audio_resampler_get_out_frames (resampler, RESAMPLE_CHUNK);
+    out_data = g_malloc0 (MAX (out_frames, 1) * RESAMPLE_CHANNELS * bps);
+    if (flags & GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT) {
+      for (c = 0; c < RESAMPLE_CHANNELS; c++)
+        out[c] = (gint8 *) out_data + c * out_frames * bps;
+    } else {
+      out[0] = out_data;
+    }
+
+    gst_audio_resampler_resample (resampler, in, RESAMPLE_CHUNK, out,
+        out_frames);
+    g_array_append_vals (result, out_data, out_frames * RESAMPLE_CHANNELS);
+
+    g_free (in_data);
+    g_free (out_data);
+  }
+  gst_audio_resampler_free (resampler);
+
+  return result;
+}
+
+static void
+check_resampler_threads (GstAudioFormat format, GstAudioResamplerFlags flags,
+    GstAudioResamplerFilterMode filter_mode)
+{
+  GArray *expected, *result;
+  guint n_threads[] = { 0, 2, 3, 64 };
+  gint i;
+
+  expected = run_resampler (format, flags, filter_mode, 1, NULL);
+  fail_unless (expected->len > 0);
+
+  for (i = 0; i < G_N_ELEMENTS (n_threads); i++) {
+    result = run_resampler (format, flags, filter_mode, n_threads[i],
+        NULL);
+    fail_unless_equals_int (result->len, expected->len);
+    fail_unless (memcmp (result->data, expected->data,
+            expected->len * g_array_get_element_size (expected)) == 0);
+    g_array_free (result, TRUE);
+  }
+  g_array_free (expected, TRUE);
+}
+
+GST_START_TEST (test_resampler_threads)
+{
+  check_resampler_threads (GST_AUDIO_FORMAT_F32, 0,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_resampler_threads (GST_AUDIO_FORMAT_F32, 0,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+  check_resampler_threads (GST_AUDIO_FORMAT_S16,
+      GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_resampler_threads (GST_AUDIO_FORMAT_S16,
+      GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+}
+
+GST_END_TEST;
+
+/* runs the same input through the C kernels and the kernels of @name, the
+ * default kernels are used when those are not available */
+static void
+check_resampler_kernels (const gchar * name, GstAudioFormat format,
+    GstAudioResamplerFilterMode filter_mode)
+{
+  GArray *expected, *result;
+  guint i;
+
+  expected = run_resampler (format, 0, filter_mode, 1, "c");
+  fail_unless (expected->len > 0);
+
+  result = run_resampler (format, 0, filter_mode, 1, name);
+  fail_unless_equals_int (result->len, expected->len);
+
+  /* the SIMD kernels sum in a different order and use FMA */
+  for (i = 0; i < expected->len; i++) {
+    if (format == GST_AUDIO_FORMAT_S16) {
+      gint a = g_array_index (expected, gint16, i);
+      gint b = g_array_index (result, gint16, i);
+
+      fail_unless (ABS (a - b) <= 1, "sample %u: %d != %d", i, a, b);
+    } else {
+      gfloat a = g_array_index (expected, gfloat, i);
+      gfloat b = g_array_index (result, gfloat, i);
+
+      fail_unless (fabs (a - b) <= 1e-5, "sample %u: %f != %f", i, a, b);
+    }
+  }
+  g_array_free (result, TRUE);
+  g_array_free (expected, TRUE);
+}
+
+GST_START_TEST (test_resampler_avx2)
+{
+  check_resampler_kernels ("avx2", GST_AUDIO_FORMAT_F32,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_resampler_kernels ("avx2", GST_AUDIO_FORMAT_F32,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+  check_resampler_kernels ("avx2", GST_AUDIO_FORMAT_S16,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_resampler_kernels ("avx2", GST_AUDIO_FORMAT_S16,
+      GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+}
+
+GST_END_TEST;
+
+static GstAudioResampler *
+new_kaiser_resampler (GstAudioResamplerFilterMode filter_mode, gint in_rate,
+    gint out_rate)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+
+  options = gst_structure_new_empty ("options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, in_rate, out_rate, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      filter_mode, NULL);
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0,
+      GST_AUDIO_FORMAT_F32, 2, in_rate, out_rate, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  return resampler;
+}
+
+static void
+check_resampler_shared_filter (GstAudioResamplerFilterMode filter_mode)
+{
+  GstAudioResampler *resampler, *other;
+  GArray *expected, *result;
+
+  /* tables made for a single resampler */
+  expected = run_resampler (GST_AUDIO_FORMAT_F32, 0, filter_mode, 1, NULL);
+  fail_unless (expected->len > 0);
+
+  /* the same parameters give the same tables */
+  resampler = new_kaiser_resampler (filter_mode, 44100, 48000);
+  other = new_kaiser_resampler (filter_mode, 44100, 48000);
+  fail_unless (resampler->filter != NULL);
+  fail_unless (other->filter == resampler->filter);
+  fail_unless (other->taps == resampler->taps);
+  fail_unless (other->cached_phases == resampler->cached_phases);
+  fail_unless (other->cached_taps == resampler->cached_taps);
+  if (filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL)
+    fail_unless (resampler->cached_taps != NULL);
+  else
+    fail_unless (resampler->taps != NULL);
+  gst_audio_resampler_free (resampler);
+
+  /* tables shared with the other resampler */
+  result = run_resampler (GST_AUDIO_FORMAT_F32, 0, filter_mode, 1, NULL);
+  fail_unless_equals_int (result->len, expected->len);
+  fail_unless (memcmp (result->data, expected->data,
+          expected->len * g_array_get_element_size (expected)) == 0);
+  g_array_free (result, TRUE);
+
+  /* the other resampler moves to new tables, the old ones are released */
+  resampler = new_kaiser_resampler (filter_mode, 44100, 48000);
+  fail_unless (gst_audio_resampler_update (other, 48000, 44100, NULL));
+  fail_unless (other->filter != NULL);
+  fail_unless (other->filter != resampler->filter);
+  gst_audio_resampler_free (resampler);
+
+  result = run_resampler (GST_AUDIO_FORMAT_F32, 0, filter_mode, 1, NULL);
+  fail_unless_equals_int (result->len, expected->len);
+  fail_unless (memcmp (result->data, expected->data,
+          expected->len * g_array_get_element_size (expected)) == 0);
+  g_array_free (result, TRUE);
+
+  gst_audio_resampler_free (other);
+  g_array_free (expected, TRUE);
+}
+
+GST_START_TEST (test_resampler_shared_filter)
+{
+  check_resampler_shared_filter (GST_AUDIO_RESAMPLER_FILTER_MODE_FULL);
+  check_resampler_shared_filter (GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED);
+}
+
+GST_END_TEST;
+
+#define MIX_FRAMES 37
+
+/* mix a sine on every channel in @format with @mix and return the raw
+ * output */
+static gpointer
+mix_sine (GstAudioChannelMixer * mix, GstAudioFormat format,
+    gint in_channels, gint out_channels)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gint bps = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  gpointer in[1], out[1];
+  gint i;
+
+  in[0] = g_malloc (MIX_FRAMES * in_channels * bps);
+  out[0] = g_malloc (MIX_FRAMES * out_channels * bps);
+
+  for (i = 0; i < MIX_FRAMES * in_channels; i++) {
+    gdouble v = sin (i * G_PI / 17.0) * 0.3;
+
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) in[0])[i] = v * G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) in[0])[i] = v * G_MAXINT32;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) in[0])[i] = v;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        ((gdouble *) in[0])[i] = v;
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+
+  gst_audio_channel_mixer_samples (mix, in, out, MIX_FRAMES);
+  g_free (in[0]);
+
+  return out[0];
+}
+
+/* mix a sine on every channel in @format and return the output as doubles
+ * in the range -1.0 to 1.0 */
+static gdouble *
+run_channel_mixer (GstAudioFormat format, gint in_channels,
+    GstAudioChannelPosition * in_position, gint out_channels,
+    GstAudioChannelPosition * out_position)
+{
+  GstAudioChannelMixer *mix;
+  gpointer out;
+  gdouble *result;
+  gint i;
+
+  mix = gst_audio_channel_mixer_new (0, format, in_channels, in_position,
+      out_channels, out_position);
+  fail_unless (mix != NULL);
+
+  out = mix_sine (mix, format, in_channels, out_channels);
+
+  result = g_new (gdouble, MIX_FRAMES * out_channels);
+  for (i = 0; i < MIX_FRAMES * out_channels; i++) {
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        result[i] = ((gint16 *) out)[i] / (gdouble) G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        result[i] = ((gint32 *) out)[i] / (gdouble) G_MAXINT32;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        result[i] = ((gfloat *) out)[i];
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        result[i] = ((gdouble *) out)[i];
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+
+  g_free (out);
+  gst_audio_channel_mixer_free (mix);
+
+  return result;
+}
+
+/* the fast way of mixing selected for the matrix must give exactly the same
+ * output as the generic functions that apply the complete matrix, and all
+ * formats must give about the same result */
+static void
+check_channel_mixer (const gchar * path, gint in_channels,
+    GstAudioChannelPosition * in_position, gint out_channels,
+    GstAudioChannelPosition * out_position)
+{
+  GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32,
+    GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64
+  };
+  GstAudioChannelMixer *mix, *generic;
+  gpointer out, expected_out;
+  gdouble *expected, *result;
+  const gchar *format, *mix_path;
+  gint i, j, bps;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    format = gst_audio_format_to_string (formats[i]);
+    bps = GST_AUDIO_FORMAT_INFO_WIDTH (gst_audio_format_get_info (formats[i]))
+        / 8;
+
+    mix = gst_audio_channel_mixer_new (0, formats[i], in_channels,
+        in_position, out_channels, out_position);
+    generic =
+        gst_audio_channel_mixer_new (GST_AUDIO_CHANNEL_MIXER_FLAGS_GENERIC,
+        formats[i], in_channels, in_position, out_channels, out_position);
+    fail_unless (mix != NULL);
+    fail_unless (generic != NULL);
+    fail_unless_equals_string (_gst_audio_channel_mixer_get_path (generic),
+        "generic");
+
+    /* dense mixing needs SIMD support and is not done for S32 */
+    mix_path = _gst_audio_channel_mixer_get_path (mix);
+    if (strcmp (path, "dense") == 0 && strcmp (mix_path, "dense") != 0) {
+      GST_INFO ("%s: no dense mixing, using %s", format, mix_path);
+      fail_unless (formats[i] == GST_AUDIO_FORMAT_S32 ||
+          strcmp (mix_path, "sparse") == 0, "%s: %s mixing", format,
+          mix_path);
+    } else {
+      fail_unless_equals_string (mix_path, path);
+    }
+
+    out = mix_sine (mix, formats[i], in_channels, out_channels);
+    expected_out = mix_sine (generic, formats[i], in_channels, out_channels);
+    fail_unless (memcmp (out, expected_out,
+            MIX_FRAMES * out_channels * bps) == 0,
+        "%s: %s mixing differs from generic mixing", format, mix_path);
+    g_free (out);
+    g_free (expected_out);
+
+    gst_audio_channel_mixer_free (mix);
+    gst_audio_channel_mixer_free (generic);
+  }
+
+  expected = run_channel_mixer (GST_AUDIO_FORMAT_F64, in_channels,
+      in_position, out_channels, out_position);
+
+  for (i = 0; i < G_N_ELEMENTS (formats) - 1; i++) {
+    result = run_channel_mixer (formats[i], in_channels, in_position,
+        out_channels, out_position);
+    for (j = 0; j < MIX_FRAMES * out_channels; j++)
+      fail_unless (fabs (result[j] - expected[j]) < 0.01,
+          "%s sample %d: %f != %f", gst_audio_format_to_string (formats[i]),
+          j, result[j], expected[j]);
+    g_free (result);
+  }
+  g_free (expected);
+}
+
+GST_START_TEST (test_channel_mixer)
+{
+  GstAudioChannelPosition stereo[] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT
+  };
+  GstAudioChannelPosition swapped[] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT
+  };
+  GstAudioChannelPosition surround71[] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+    GST_AUDIO_CHANNEL_POSITION_LFE1,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT
+  };
+  GstAudioChannelPosition all[28];
+  gdouble *in, *out;
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (all); i++)
+    all[i] = GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT + i;
+
+  /* permutation, the channels are swapped */
+  in = run_channel_mixer (GST_AUDIO_FORMAT_F64, 2, stereo, 2, stereo);
+  out = run_channel_mixer (GST_AUDIO_FORMAT_F64, 2, stereo, 2, swapped);
+  for (i = 0; i < MIX_FRAMES; i++) {
+    fail_unless_equals_float (out[2 * i], in[2 * i + 1]);
+    fail_unless_equals_float (out[2 * i + 1], in[2 * i]);
+  }
+  g_free (in);
+  g_free (out);
+  check_channel_mixer ("identity", 2, stereo, 2, stereo);
+  check_channel_mixer ("permutation", 2, stereo, 2, swapped);
+
+  /* sparse */
+  check_channel_mixer ("sparse", 8, surround71, 2, stereo);
+  check_channel_mixer ("sparse", 6, surround71, 2, stereo);
+  check_channel_mixer ("sparse", 28, all, 2, stereo);
+  check_channel_mixer ("sparse", 2, stereo, 6, surround71);
+
+  /* dense */
+  check_channel_mixer ("dense", 2, stereo, 8, surround71);
+  check_channel_mixer ("dense", 8, surround71, 28, all);
+}
+
+GST_END_TEST;
+
+/* ringbuffer where the test plays the device */
+typedef GstAudioRingBuffer TestRingBuffer;
+typedef GstAudioRingBufferClass TestRingBufferClass;
+
+static GType test_ring_buffer_get_type (void);
+G_DEFINE_TYPE (TestRingBuffer, test_ring_buffer, GST_TYPE_AUDIO_RING_BUFFER);
+
+static gboolean
+test_ring_buffer_open_device (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_close_device (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_acquire (GstAudioRingBuffer * buf,
+    GstAudioRingBufferSpec * spec)
+{
+  buf->size = spec->segtotal * spec->segsize;
+  buf->memory = g_malloc0 (buf->size);
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_release (GstAudioRingBuffer * buf)
+{
+  g_free (buf->memory);
+  buf->memory = NULL;
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_start (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static gboolean
+test_ring_buffer_stop (GstAudioRingBuffer * buf)
+{
+  return TRUE;
+}
+
+static void
+test_ring_buffer_class_init (TestRingBufferClass * klass)
+{
+  klass->open_device = test_ring_buffer_open_device;
+  klass->close_device = test_ring_buffer_close_device;
+  klass->acquire = test_ring_buffer_acquire;
+  klass->release = test_ring_buffer_release;
+  klass->start = test_ring_buffer_start;
+  klass->stop = test_ring_buffer_stop;
+}
+
+static void
+test_ring_buffer_init (TestRingBuffer * buf)
+{
+}
+
+#define RB_SEGMENTS 400
+#define RB_CHUNK 37
+
+typedef struct
+{
+  GstAudioRingBuffer *buf;
+  gint written;
+  gint ok;
+} RingBufferData;
+
+/* writes increasing samples in chunks that don't line up with the
+ * segments, waiting for the device whenever the ringbuffer is full */
+static gpointer
+ring_buffer_write_func (gpointer user_data)
+{
+  RingBufferData *data = user_data;
+  gint total = RB_SEGMENTS * data->buf->samples_per_seg;
+  gint32 samples[RB_CHUNK];
+  guint64 sample = 0;
+  gint i, len, accum = 0;
+
+  while (sample < total) {
+    len = MIN (RB_CHUNK, total - sample);
+    for (i = 0; i < len; i++)
+      samples[i] = sample + i + 1;
+
+    if (gst_audio_ring_buffer_commit (data->buf, &sample, (guint8 *) samples,
+            len, len, &accum) != len) {
+      g_atomic_int_set (&data->ok, FALSE);
+      break;
+    }
+    g_atomic_int_set (&data->written, sample);
+  }
+  return NULL;
+}
+
+/* consumes a segment once the writer has filled it and checks that it holds
+ * the samples in order */
+static gpointer
+ring_buffer_read_func (gpointer user_data)
+{
+  RingBufferData *data = user_data;
+  gint sps = data->buf->samples_per_seg;
+  gint seg, segment, len, i;
+  guint8 *readptr;
+  gint32 *samples;
+
+  for (seg = 0; seg < RB_SEGMENTS && g_atomic_int_get (&data->ok); seg++) {
+    while (g_atomic_int_get (&data->written) < (seg + 1) * sps &&
+        g_atomic_int_get (&data->ok))
+      g_thread_yield ();
+
+    if (!gst_audio_ring_buffer_prepare_read (data->buf, &segment, &readptr,
+            &len) || len != sps * sizeof (gint32)) {
+      g_atomic_int_set (&data->ok, FALSE);
+      break;
+    }
+    samples = (gint32 *) readptr;
+    for (i = 0; i < sps; i++) {
+      if (samples[i] != seg * sps + i + 1)
+        g_atomic_int_set (&data->ok, FALSE);
+    }
+    gst_audio_ring_buffer_clear (data->buf, segment);
+    gst_audio_ring_buffer_advance (data->buf, 1);
+
+    /* be slower than the writer now and then so that it has to wait */
+    if (seg % 4 == 0)
+      g_usleep (100);
+  }
+
+  /* don't leave the writer waiting for us */
+  if (!g_atomic_int_get (&data->ok))
+    gst_audio_ring_buffer_set_flushing (data->buf, TRUE);
+
+  return NULL;
+}
+
+static void
+check_ring_buffer (gboolean lock_free)
+{
+  GstAudioRingBuffer *buf;
+  RingBufferData data;
+  GThread *writer, *reader;
+  GstCaps *caps;
+
+  buf = g_object_new (test_ring_buffer_get_type (), NULL);
+  fail_unless (gst_audio_ring_buffer_set_lock_free (buf, lock_free));
+  fail_unless_equals_int (gst_audio_ring_buffer_get_lock_free (buf),
+      lock_free);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (S32),
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 48000, "channels", G_TYPE_INT, 1, NULL);
+  buf->spec.latency_time = 1000;
+  buf->spec.buffer_time = 4000;
+  fail_unless (gst_audio_ring_buffer_parse_caps (&buf->spec, caps));
+  gst_caps_unref (caps);
+
+  fail_unless (gst_audio_ring_buffer_open_device (buf));
+  fail_unless (gst_audio_ring_buffer_acquire (buf, &buf->spec));
+  fail_unless_equals_int (buf->spec.segtotal, 4);
+
+  /* can't change the mode while acquired */
+  fail_if (gst_audio_ring_buffer_set_lock_free (buf, !lock_free));
+  fail_unless_equals_int (gst_audio_ring_buffer_get_lock_free (buf),
+      lock_free);
+
+  gst_audio_ring_buffer_may_start (buf, TRUE);
+  fail_unless (gst_audio_ring_buffer_start (buf));
+
+  data.buf = buf;
+  data.written = 0;
+  data.ok = TRUE;
+  reader = g_thread_new ("reader", ring_buffer_read_func, &data);
+  writer = g_thread_new ("writer", ring_buffer_write_func, &data);
+  g_thread_join (writer);
+  g_thread_join (reader);
+  fail_unless (data.ok);
+  fail_unless_equals_int (g_atomic_int_get (&buf->segdone), RB_SEGMENTS);
+
+  fail_unless (gst_audio_ring_buffer_release (buf));
+  fail_unless (gst_audio_ring_buffer_close_device (buf));
+  gst_object_unref (buf);
+}
+
+GST_START_TEST (test_ring_buffer_lock_free)
+{
+  check_ring_buffer (FALSE);
+  check_ring_buffer (TRUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_cpu_list)
+{
+  gboolean cpus[8];
+
+  fail_unless (_gst_audio_parse_cpu_list ("2", cpus, 8));
+  fail_unless (!cpus[0] && !cpus[1] && cpus[2] && !cpus[3]);
+
+  fail_unless (_gst_audio_parse_cpu_list ("0,4-5,7", cpus, 8));
+  fail_unless (cpus[0] && !cpus[1] && !cpus[3] && cpus[4] && cpus[5]);
+  fail_unless (!cpus[6] && cpus[7]);
+
+  fail_unless (_gst_audio_parse_cpu_list ("3-3,1", cpus, 8));
+  fail_unless (!cpus[0] && cpus[1] && !cpus[2] && cpus[3] && !cpus[4]);
+
+  fail_if (_gst_audio_parse_cpu_list ("", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("foo", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("1,", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list (",1", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("1-", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("-1", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("3-1", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("1x", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("8", cpus, 8));
+  fail_if (_gst_audio_parse_cpu_list ("6-8", cpus, 8));
+}
+
+GST_END_TEST;
+
+/* the scheduling the device thread of an element runs with */
+typedef struct
+{
+  gboolean recorded;
+  gint policy;
+  gint priority;
+  gchar *affinity;
+} ThreadScheduling;
+
+static void
+thread_scheduling_record (ThreadScheduling * sched)
+{
+#if defined (HAVE_PTHREAD_SETSCHEDPARAM) && defined (HAVE_SCHED_H)
+  struct sched_param param;
+
+  fail_unless (pthread_getschedparam (pthread_self (), &sched->policy,
+          &param) == 0);
+  sched->priority = param.sched_priority;
+#else
+  sched->policy = -1;
+  sched->priority = 0;
+#endif
+
+  sched->affinity = NULL;
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  {
+    cpu_set_t set;
+    GString *list = g_string_new (NULL);
+    gint cpu;
+
+    fail_unless (pthread_getaffinity_np (pthread_self (), sizeof (set),
+            &set) == 0);
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET (cpu, &set))
+        g_string_append_printf (list, "%s%d", list->len ? "," : "", cpu);
+    }
+    sched->affinity = g_string_free (list, FALSE);
+  }
+#endif
+
+  sched->recorded = TRUE;
+}
+
+#define TEST_AUDIO_CAPS "audio/x-raw, format = (string) S16LE, " \
+    "layout = (string) interleaved, rate = (int) 48000, channels = (int) 1"
+
+/* sink and source whose device threads record their scheduling */
+typedef struct
+{
+  GstAudioSink parent;
+  ThreadScheduling sched;
+} TestAudioSink;
+typedef GstAudioSinkClass TestAudioSinkClass;
+
+static GType test_audio_sink_get_type (void);
+G_DEFINE_TYPE (TestAudioSink, test_audio_sink, GST_TYPE_AUDIO_SINK);
+
+static gint
+test_audio_sink_write (GstAudioSink * sink, gpointer data, guint length)
+{
+  TestAudioSink *self = (TestAudioSink *) sink;
+
+  if (!self->sched.recorded)
+    thread_scheduling_record (&self->sched);
+  g_usleep (1000);
+
+  return length;
+}
+
+static void
+test_audio_sink_finalize (GObject * object)
+{
+  g_free (((TestAudioSink *) object)->sched.affinity);
+
+  G_OBJECT_CLASS (test_audio_sink_parent_class)->finalize (object);
+}
+
+static void
+test_audio_sink_class_init (TestAudioSinkClass * klass)
+{
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS (TEST_AUDIO_CAPS));
+
+  G_OBJECT_CLASS (klass)->finalize = test_audio_sink_finalize;
+  gst_element_class_add_static_pad_template (GST_ELEMENT_CLASS (klass),
+      &sink_templ);
+  gst_element_class_set_metadata (GST_ELEMENT_CLASS (klass),
+      "TestAudioSink", "Sink/Audio", "yep", "me");
+  klass->write = test_audio_sink_write;
+}
+
+static void
+test_audio_sink_init (TestAudioSink * sink)
+{
+}
+
+typedef struct
+{
+  GstAudioSrc parent;
+  ThreadScheduling sched;
+} TestAudioSrc;
+typedef GstAudioSrcClass TestAudioSrcClass;
+
+static GType test_audio_src_get_type (void);
+G_DEFINE_TYPE (TestAudioSrc, test_audio_src, GST_TYPE_AUDIO_SRC);
+
+static guint
+test_audio_src_read (GstAudioSrc * src, gpointer data, guint length,
+    GstClockTime * timestamp)
+{
+  TestAudioSrc *self = (TestAudioSrc *) src;
+
+  if (!self->sched.recorded)
+    thread_scheduling_record (&self->sched);
+  g_usleep (1000);
+
+  memset (data, 0, length);
+  return length;
+}
+
+static void
+test_audio_src_finalize (GObject * object)
+{
+  g_free (((TestAudioSrc *) object)->sched.affinity);
+
+  G_OBJECT_CLASS (test_audio_src_parent_class)->finalize (object);
+}
+
+static void
+test_audio_src_class_init (TestAudioSrcClass * klass)
+{
+  static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS (TEST_AUDIO_CAPS));
+
+  G_OBJECT_CLASS (klass)->finalize = test_audio_src_finalize;
+  gst_element_class_add_static_pad_template (GST_ELEMENT_CLASS (klass),
+      &src_templ);
+  gst_element_class_set_metadata (GST_ELEMENT_CLASS (klass),
+      "TestAudioSrc", "Source/Audio", "yep", "me");
+  klass->read = test_audio_src_read;
+}
+
+static void
+test_audio_src_init (TestAudioSrc * src)
+{
+}
+
+/* checks what the device thread of @element ended up with, compared to the
+ * scheduling @initial of a thread that was left alone. @affinity is the CPU
+ * list that must have been applied, if any */
+static void
+check_applied_scheduling (GstElement * element, GstMessage * msg,
+    ThreadScheduling * sched, ThreadScheduling * initial, gboolean requested,
+    GstAudioRingBufferThreadPolicy policy, gint priority,
+    const gchar * affinity)
+{
+  const GstStructure *s;
+  GstAudioRingBufferThreadPolicy applied_policy;
+  gint applied_priority;
+  const gchar *applied_affinity;
+
+  fail_unless (sched->recorded);
+
+  /* nothing requested, nothing changed */
+  if (!requested) {
+    fail_unless (msg == NULL, "unexpected scheduling message from %s",
+        GST_ELEMENT_NAME (element));
+    fail_unless_equals_int (sched->policy, initial->policy);
+    fail_unless_equals_int (sched->priority, initial->priority);
+    fail_unless (g_strcmp0 (sched->affinity, initial->affinity) == 0);
+    return;
+  }
+
+  fail_unless (msg != NULL, "no scheduling message from %s",
+      GST_ELEMENT_NAME (element));
+  s = gst_message_get_structure (msg);
+  fail_unless (gst_structure_get_enum (s, "policy",
+          GST_TYPE_AUDIO_RING_BUFFER_THREAD_POLICY, (gint *) & applied_policy));
+  fail_unless (gst_structure_get_int (s, "priority", &applied_priority));
+  fail_unless (gst_structure_has_field_typed (s, "affinity", G_TYPE_STRING));
+  applied_affinity = gst_structure_get_string (s, "affinity");
+
+  /* realtime scheduling usually needs permissions we may not have */
+  if (applied_policy == GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT) {
+    fail_unless_equals_int (applied_priority, 0);
+    fail_unless_equals_int (sched->policy, initial->policy);
+    fail_unless_equals_int (sched->priority, initial->priority);
+  } else {
+#if defined (HAVE_PTHREAD_SETSCHEDPARAM) && defined (HAVE_SCHED_H)
+    fail_unless_equals_int (applied_policy, policy);
+    fail_unless_equals_int (applied_priority, priority);
+    fail_unless_equals_int (sched->policy,
+        policy == GST_AUDIO_RING_BUFFER_THREAD_POLICY_FIFO ?
+        SCHED_FIFO : SCHED_RR);
+    fail_unless_equals_int (sched->priority, priority);
+#else
+    fail ("realtime scheduling applied without support");
+#endif
+  }
+
+  if (affinity) {
+    fail_unless_equals_string (applied_affinity, affinity);
+    fail_unless_equals_string (sched->affinity, affinity);
+  } else {
+    fail_unless (applied_affinity == NULL);
+    fail_unless (g_strcmp0 (sched->affinity, initial->affinity) == 0);
+  }
+}
+
+/* runs a source and a sink with the given scheduling for their device
+ * threads, @valid_affinity tells if @affinity can be applied here */
+static void
+check_thread_scheduling (GstAudioRingBufferThreadPolicy policy,
+    gint priority, const gchar * affinity, gboolean valid_affinity)
+{
+  GstElement *pipeline, *src, *sink;
+  GstMessage *src_msg = NULL, *sink_msg = NULL, *msg;
+  ThreadScheduling initial = { FALSE, };
+  gboolean requested;
+  GstBus *bus;
+
+  thread_scheduling_record (&initial);
+
+  pipeline = gst_pipeline_new (NULL);
+  src = g_object_new (test_audio_src_get_type (), "num-buffers", 10, NULL);
+  sink = g_object_new (test_audio_sink_get_type (), "sync", FALSE,
+      "provide-clock", FALSE, NULL);
+  g_object_set (src, "thread-policy", policy, "thread-priority", priority,
+      "thread-affinity", affinity, NULL);
+  g_object_set (sink, "thread-policy", policy, "thread-priority", priority,
+      "thread-affinity", affinity, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+
+  bus = gst_element_get_bus (pipeline);
+  fail_if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE);
+
+  while ((msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND,
+              GST_MESSAGE_ELEMENT | GST_MESSAGE_EOS | GST_MESSAGE_ERROR))) {
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS) {
+      gst_message_unref (msg);
+      break;
+    }
+    fail_if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR);
+    if (gst_message_has_name (msg, "GstAudioThreadScheduling")) {
+      if (GST_MESSAGE_SRC (msg) == GST_OBJECT_CAST (src)) {
+        fail_unless (src_msg == NULL);
+        src_msg = msg;
+        continue;
+      }
+      if (GST_MESSAGE_SRC (msg) == GST_OBJECT_CAST (sink)) {
+        fail_unless (sink_msg == NULL);
+        sink_msg = msg;
+        continue;
+      }
+    }
+    gst_message_unref (msg);
+  }
+  fail_unless (msg != NULL, "no EOS");
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  requested = policy != GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT ||
+      (affinity && *affinity);
+  if (!valid_affinity)
+    affinity = NULL;
+  check_applied_scheduling (src, src_msg, &((TestAudioSrc *) src)->sched,
+      &initial, requested, policy, priority, affinity);
+  check_applied_scheduling (sink, sink_msg, &((TestAudioSink *) sink)->sched,
+      &initial, requested, policy, priority, affinity);
+
+  if (src_msg)
+    gst_message_unref (src_msg);
+  if (sink_msg)
+    gst_message_unref (sink_msg);
+  g_free (initial.affinity);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (test_thread_scheduling)
+{
+  gchar *first_cpu = NULL;
+  gboolean have_affinity = FALSE;
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  cpu_set_t set;
+  gint cpu;
+
+  fail_unless (pthread_getaffinity_np (pthread_self (), sizeof (set),
+          &set) == 0);
+  for (cpu = 0; cpu < CPU_SETSIZE && !first_cpu; cpu++) {
+    if (CPU_ISSET (cpu, &set))
+      first_cpu = g_strdup_printf ("%d", cpu);
+  }
+  have_affinity = TRUE;
+#else
+  first_cpu = g_strdup ("0");
+#endif
+
+  /* the defaults leave the threads alone */
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT, 50,
+      NULL, FALSE);
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT, 50,
+      "", FALSE);
+
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT, 50,
+      first_cpu, have_affinity);
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_FIFO, 10,
+      NULL, FALSE);
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_RR, 20,
+      first_cpu, have_affinity);
+
+  /* invalid CPU lists or CPUs that can't be used are ignored */
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT, 50,
+      "foo", FALSE);
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT, 50,
+      "3-1", FALSE);
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_DEFAULT, 50,
+      "100000", FALSE);
+  check_thread_scheduling (GST_AUDIO_RING_BUFFER_THREAD_POLICY_FIFO, 10,
+      "foo", FALSE);
+
+  g_free (first_cpu);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -732,6 +1749,13 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_format_s8);
   tcase_add_test (tc_chain, test_audio_format_u8);
   tcase_add_test (tc_chain, test_fill_silence);
+  tcase_add_test (tc_chain, test_resampler_threads);
+  tcase_add_test (tc_chain, test_resampler_avx2);
+  tcase_add_test (tc_chain, test_resampler_shared_filter);
+  tcase_add_test (tc_chain, test_channel_mixer);
+  tcase_add_test (tc_chain, test_ring_buffer_lock_free);
+  tcase_add_test (tc_chain, test_parse_cpu_list);
+  tcase_add_test (tc_chain, test_thread_scheduling);
 
   return s;
 }
@@ -1128,6 +1128,281 @@ GST_START_TEST (audiodecoder_plc_on_gap_event_with_delay)
 }
 GST_END_TEST;
 
+static GList *aggregated_buffers;
+static guint aggregated_lists;
+
+static gboolean
+aggregation_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  /* output is only aggregated if upstream is not live */
+  if (GST_QUERY_TYPE (query) == GST_QUERY_LATENCY) {
+    gst_query_set_latency (query, FALSE, 0, GST_CLOCK_TIME_NONE);
+    return TRUE;
+  }
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static GstFlowReturn
+aggregation_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  aggregated_buffers = g_list_append (aggregated_buffers, buffer);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+aggregation_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  guint i;
+
+  aggregated_lists++;
+  for (i = 0; i < gst_buffer_list_length (list); i++) {
+    aggregated_buffers = g_list_append (aggregated_buffers,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  }
+  gst_buffer_list_unref (list);
+  return GST_FLOW_OK;
+}
+
+static void
+run_output_aggregation (gboolean buffer_lists)
+{
+  GstElement *dec;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstSegment segment;
+  GstMapInfo map;
+  GList *l;
+  guint64 i, num = 0;
+
+  /* 4 output samples of 8 bytes each per pushed buffer */
+  dec = g_object_new (GST_AUDIO_DECODER_TESTER_TYPE, "min-output-size", 32,
+      "buffer-lists", buffer_lists, NULL);
+
+  srcpad = gst_pad_new_from_static_template (&srctemplate_default, "src");
+  gst_pad_set_query_function (srcpad, aggregation_src_query);
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate_default, "sink");
+  gst_pad_set_chain_function (sinkpad, aggregation_sink_chain);
+  gst_pad_set_chain_list_function (sinkpad, aggregation_sink_chain_list);
+
+  pad = gst_element_get_static_pad (dec, "sink");
+  fail_unless (gst_pad_link (srcpad, pad) == GST_PAD_LINK_OK);
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (dec, "src");
+  fail_unless (gst_pad_link (pad, sinkpad) == GST_PAD_LINK_OK);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  fail_unless (gst_element_set_state (dec, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("aggregation"));
+  gst_pad_push_event (srcpad, gst_event_new_caps (gst_caps_new_simple
+          ("audio/x-test-custom", "channels", G_TYPE_INT, 2, "rate",
+              G_TYPE_INT, 44100, NULL)));
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < NUM_BUFFERS; i++)
+    fail_unless (gst_pad_push (srcpad, create_test_buffer (i)) == GST_FLOW_OK);
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+
+  /* 10 samples in chunks of 32 bytes: 4 + 4 + 2 drained at EOS */
+  if (buffer_lists) {
+    fail_unless_equals_int (aggregated_lists, 3);
+    fail_unless_equals_int (g_list_length (aggregated_buffers), NUM_BUFFERS);
+  } else {
+    fail_unless_equals_int (aggregated_lists, 0);
+    fail_unless_equals_int (g_list_length (aggregated_buffers), 3);
+  }
+
+  for (l = aggregated_buffers; l; l = l->next) {
+    GstBuffer *buffer = l->data;
+    gsize offset;
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (num, GST_SECOND, TEST_MSECS_PER_SAMPLE));
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    for (offset = 0; offset < map.size; offset += sizeof (guint64))
+      fail_unless_equals_uint64 (*(guint64 *) (map.data + offset), num++);
+    gst_buffer_unmap (buffer, &map);
+  }
+  fail_unless_equals_uint64 (num, NUM_BUFFERS);
+
+  g_list_free_full (aggregated_buffers, (GDestroyNotify) gst_buffer_unref);
+  aggregated_buffers = NULL;
+  aggregated_lists = 0;
+
+  gst_element_set_state (dec, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (dec);
+}
+
+GST_START_TEST (audiodecoder_output_aggregation)
+{
+  run_output_aggregation (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_output_aggregation_buffer_lists)
+{
+  run_output_aggregation (TRUE);
+}
+
+GST_END_TEST;
+
+static GList *output_items;
+
+static gboolean
+ordering_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:{
+      GstCaps *caps;
+      gint rate = 0;
+
+      gst_event_parse_caps (event, &caps);
+      gst_structure_get_int (gst_caps_get_structure (caps, 0), "rate", &rate);
+      output_items = g_list_append (output_items,
+          g_strdup_printf ("caps %d", rate));
+      break;
+    }
+    case GST_EVENT_GAP:
+      output_items = g_list_append (output_items, g_strdup ("gap"));
+      break;
+    case GST_EVENT_EOS:
+      output_items = g_list_append (output_items, g_strdup ("eos"));
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static void
+append_output_buffer (GstBuffer * buffer)
+{
+  GstMapInfo map;
+  gsize offset;
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  for (offset = 0; offset < map.size; offset += sizeof (guint64)) {
+    output_items = g_list_append (output_items,
+        g_strdup_printf ("buffer %" G_GUINT64_FORMAT,
+            *(guint64 *) (map.data + offset)));
+  }
+  gst_buffer_unmap (buffer, &map);
+}
+
+static GstFlowReturn
+ordering_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  append_output_buffer (buffer);
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+ordering_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  guint i;
+
+  for (i = 0; i < gst_buffer_list_length (list); i++)
+    append_output_buffer (gst_buffer_list_get (list, i));
+  gst_buffer_list_unref (list);
+  return GST_FLOW_OK;
+}
+
+/* buffers collected in a list must go out before a gap or a format change
+ * that comes after them */
+GST_START_TEST (audiodecoder_output_aggregation_order)
+{
+  const gchar *expected[] = {
+    "caps 44100", "buffer 0", "buffer 1", "gap", "buffer 3", "buffer 4",
+    "caps 48000", "buffer 5", "eos"
+  };
+  GstElement *dec;
+  GstPad *srcpad, *sinkpad, *pad;
+  GstSegment segment;
+  GstAudioInfo info;
+  GstCaps *caps;
+  GList *l;
+  guint i;
+
+  /* the list is only pushed once it holds 4 samples of 8 bytes */
+  dec = g_object_new (GST_AUDIO_DECODER_TESTER_TYPE, "min-output-size", 32,
+      "buffer-lists", TRUE, NULL);
+
+  srcpad = gst_pad_new_from_static_template (&srctemplate_default, "src");
+  gst_pad_set_query_function (srcpad, aggregation_src_query);
+  sinkpad = gst_pad_new_from_static_template (&sinktemplate_default, "sink");
+  gst_pad_set_event_function (sinkpad, ordering_sink_event);
+  gst_pad_set_chain_function (sinkpad, ordering_sink_chain);
+  gst_pad_set_chain_list_function (sinkpad, ordering_sink_chain_list);
+
+  pad = gst_element_get_static_pad (dec, "sink");
+  fail_unless (gst_pad_link (srcpad, pad) == GST_PAD_LINK_OK);
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (dec, "src");
+  fail_unless (gst_pad_link (pad, sinkpad) == GST_PAD_LINK_OK);
+  gst_object_unref (pad);
+
+  gst_pad_set_active (srcpad, TRUE);
+  gst_pad_set_active (sinkpad, TRUE);
+  fail_unless (gst_element_set_state (dec, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("aggregation"));
+  gst_pad_push_event (srcpad, gst_event_new_caps (gst_caps_new_simple
+          ("audio/x-test-custom", "channels", G_TYPE_INT, 2, "rate",
+              G_TYPE_INT, 44100, NULL)));
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  fail_unless (gst_pad_push (srcpad, create_test_buffer (0)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (srcpad, create_test_buffer (1)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_gap
+          (gst_util_uint64_scale_round (2, GST_SECOND, TEST_MSECS_PER_SAMPLE),
+              gst_util_uint64_scale_round (1, GST_SECOND,
+                  TEST_MSECS_PER_SAMPLE))));
+  fail_unless (gst_pad_push (srcpad, create_test_buffer (3)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (srcpad, create_test_buffer (4)) == GST_FLOW_OK);
+
+  caps = gst_caps_new_simple ("audio/x-raw", "format", G_TYPE_STRING, "S32LE",
+      "channels", G_TYPE_INT, 2, "rate", G_TYPE_INT, 48000,
+      "layout", G_TYPE_STRING, "interleaved", NULL);
+  gst_audio_info_from_caps (&info, caps);
+  gst_caps_unref (caps);
+  fail_unless (gst_audio_decoder_set_output_format (GST_AUDIO_DECODER (dec),
+          &info));
+
+  fail_unless (gst_pad_push (srcpad, create_test_buffer (5)) == GST_FLOW_OK);
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+
+  fail_unless_equals_int (g_list_length (output_items), G_N_ELEMENTS (expected));
+  for (l = output_items, i = 0; l; l = l->next, i++)
+    fail_unless_equals_string (l->data, expected[i]);
+
+  g_list_free_full (output_items, g_free);
+  output_items = NULL;
+
+  gst_element_set_state (dec, GST_STATE_NULL);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (dec);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_audiodecoder_suite (void)
 {
@@ -1158,6 +1433,10 @@ gst_audiodecoder_suite (void)
   tcase_add_test (tc, audiodecoder_plc_on_gap_event);
   tcase_add_test (tc, audiodecoder_plc_on_gap_event_with_delay);
 
+  tcase_add_test (tc, audiodecoder_output_aggregation);
+  tcase_add_test (tc, audiodecoder_output_aggregation_buffer_lists);
+  tcase_add_test (tc, audiodecoder_output_aggregation_order);
+
   return s;
 }
 
@@ -36,6 +36,8 @@
 #include <gst/video/video.h>
 #include <gst/video/gstvideometa.h>
 #include <gst/video/video-overlay-composition.h>
+#include <gst/video/video-converter-private.h>
+#include <gst/video/video-scaler-private.h>
 #include <string.h>
 
 /* These are from the current/old videotestsrc; we check our new public API
@@ -2195,6 +2197,140 @@ GST_START_TEST (test_video_scaler)
 
 GST_END_TEST;
 
+#define VWIDTH 67
+
+static void
+scale_ntap (GstVideoScaler * hscale, GstVideoScaler * vscale,
+    GstVideoFormat format, guint bpp, guint8 * src, guint8 * lines,
+    guint out_size, guint8 * hdest, guint8 * vdest)
+{
+  gpointer srcs[64];
+  guint i, j, in_offset, max_taps;
+
+  gst_video_scaler_horizontal (hscale, format, src, hdest, 0, out_size);
+
+  for (i = 0; i < out_size; i++) {
+    gst_video_scaler_get_coeff (vscale, i, &in_offset, &max_taps);
+    fail_unless (max_taps <= G_N_ELEMENTS (srcs));
+    for (j = 0; j < max_taps; j++)
+      srcs[j] = lines + (in_offset + j) * VWIDTH * bpp;
+
+    gst_video_scaler_vertical (vscale, format, srcs,
+        vdest + i * VWIDTH * bpp, i, VWIDTH);
+  }
+}
+
+static void
+new_ntap_scalers (const gchar * kernels, GstVideoResamplerMethod method,
+    guint n_taps, guint in_size, guint out_size, GstVideoScaler ** hscale,
+    GstVideoScaler ** vscale)
+{
+  GstStructure *options;
+
+  options = gst_structure_new ("options", GST_VIDEO_SCALER_OPT_KERNELS,
+      G_TYPE_STRING, kernels, NULL);
+  *hscale = gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, n_taps,
+      in_size, out_size, options);
+  *vscale = gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, n_taps,
+      in_size, out_size, options);
+  gst_structure_free (options);
+}
+
+/* Scale a line of random pixels horizontally and VWIDTH columns of random
+ * pixels vertically with every set of optimized kernels. The result must be
+ * the same as the one of the ORC kernels. Kernels the CPU doesn't support
+ * fall back to the best supported ones. VWIDTH is chosen so that both the
+ * vectorized and the scalar code of the optimized kernels are used. */
+static void
+check_scaler_ntap (GstVideoFormat format, GstVideoResamplerMethod method,
+    guint n_taps, guint in_size, guint out_size)
+{
+  const gchar *kernels[] = { "sse41", "avx2" };
+  GstVideoScaler *hscale, *vscale;
+  guint8 *src, *lines, *hexpect, *vexpect, *hdest, *vdest;
+  gsize hsize, vsize;
+  guint i, bpp;
+  GRand *rand;
+
+  bpp = format == GST_VIDEO_FORMAT_GRAY8 ? 1 : 2;
+
+  rand = g_rand_new_with_seed (0xdeadbeef);
+  src = g_malloc (in_size * bpp);
+  for (i = 0; i < in_size * bpp; i++)
+    src[i] = g_rand_int_range (rand, 0, 256);
+  lines = g_malloc (in_size * VWIDTH * bpp);
+  for (i = 0; i < in_size * VWIDTH * bpp; i++)
+    lines[i] = g_rand_int_range (rand, 0, 256);
+  g_rand_free (rand);
+
+  hsize = out_size * bpp;
+  vsize = out_size * VWIDTH * bpp;
+  hexpect = g_malloc (hsize);
+  vexpect = g_malloc (vsize);
+  hdest = g_malloc (hsize);
+  vdest = g_malloc (vsize);
+
+  new_ntap_scalers ("orc", method, n_taps, in_size, out_size, &hscale,
+      &vscale);
+  scale_ntap (hscale, vscale, format, bpp, src, lines, out_size, hexpect,
+      vexpect);
+  gst_video_scaler_free (hscale);
+  gst_video_scaler_free (vscale);
+
+  for (i = 0; i < G_N_ELEMENTS (kernels); i++) {
+    new_ntap_scalers (kernels[i], method, n_taps, in_size, out_size, &hscale,
+        &vscale);
+    GST_INFO ("checking %s kernels, %u taps", kernels[i],
+        gst_video_scaler_get_max_taps (vscale));
+
+    memset (hdest, 0, hsize);
+    memset (vdest, 0, vsize);
+    scale_ntap (hscale, vscale, format, bpp, src, lines, out_size, hdest,
+        vdest);
+
+    fail_unless (memcmp (hdest, hexpect, hsize) == 0);
+    fail_unless (memcmp (vdest, vexpect, vsize) == 0);
+
+    gst_video_scaler_free (hscale);
+    gst_video_scaler_free (vscale);
+  }
+
+  g_free (vdest);
+  g_free (hdest);
+  g_free (vexpect);
+  g_free (hexpect);
+  g_free (lines);
+  g_free (src);
+}
+
+GST_START_TEST (test_video_scaler_ntap)
+{
+  GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_GRAY8, GST_VIDEO_FORMAT_GRAY16_LE
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_LINEAR, 2,
+        123, 77);
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_LINEAR, 2,
+        45, 131);
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_CUBIC, 0,
+        123, 77);
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_CUBIC, 0,
+        45, 131);
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_SINC, 3,
+        45, 131);
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_LANCZOS, 6,
+        123, 77);
+    check_scaler_ntap (formats[i], GST_VIDEO_RESAMPLER_METHOD_LANCZOS, 9,
+        200, 61);
+  }
+}
+
+GST_END_TEST;
+#undef VWIDTH
+
 #define WIDTH 320
 #define HEIGHT 240
 #define TIME 0.01
@@ -2445,6 +2581,616 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+static void
+fill_random (GstBuffer * buffer)
+{
+  GstMapInfo map;
+  GRand *rand;
+  gsize i;
+
+  rand = g_rand_new_with_seed (0xdeadbeef);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = g_rand_int_range (rand, 0, 256);
+  gst_buffer_unmap (buffer, &map);
+  g_rand_free (rand);
+}
+
+static GstBuffer *
+convert_with_config (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo, GstStructure * config)
+{
+  GstVideoFrame inframe, outframe;
+  GstBuffer *outbuffer;
+  GstVideoConverter *convert;
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo->size);
+  gst_buffer_memset (outbuffer, 0, 0, -1);
+
+  gst_video_frame_map (&inframe, ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (ininfo, outinfo, config);
+  fail_unless (convert != NULL);
+
+  /* convert twice so that state from the previous frame is exercised */
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  return outbuffer;
+}
+
+static GstBuffer *
+convert_with_threads (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo, guint n_threads)
+{
+  return convert_with_config (ininfo, inbuffer, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, n_threads,
+          GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, 8,
+          GST_VIDEO_CONVERTER_OPT_DEST_Y, G_TYPE_INT, 4,
+          GST_VIDEO_CONVERTER_OPT_DEST_WIDTH, G_TYPE_INT,
+          GST_VIDEO_INFO_WIDTH (outinfo) - 16,
+          GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT, G_TYPE_INT,
+          GST_VIDEO_INFO_HEIGHT (outinfo) - 8, NULL));
+}
+
+GST_START_TEST (test_video_convert_multithreading)
+{
+  static const struct
+  {
+    GstVideoFormat infmt;
+    gint in_width, in_height;
+    GstVideoFormat outfmt;
+    gint out_width, out_height;
+  } tests[] = {
+    /* fastpaths */
+    {GST_VIDEO_FORMAT_I420, 320, 240, GST_VIDEO_FORMAT_YUY2, 320, 240},
+    {GST_VIDEO_FORMAT_YUY2, 320, 241, GST_VIDEO_FORMAT_I420, 320, 241},
+    {GST_VIDEO_FORMAT_AYUV, 320, 240, GST_VIDEO_FORMAT_I420, 320, 240},
+    {GST_VIDEO_FORMAT_I420, 320, 240, GST_VIDEO_FORMAT_BGRA, 320, 240},
+    {GST_VIDEO_FORMAT_I420, 320, 240, GST_VIDEO_FORMAT_RGB, 320, 240},
+    /* plane scaling */
+    {GST_VIDEO_FORMAT_I420, 320, 240, GST_VIDEO_FORMAT_I420, 400, 317},
+    {GST_VIDEO_FORMAT_I420, 320, 240, GST_VIDEO_FORMAT_Y444, 320, 240},
+    {GST_VIDEO_FORMAT_YUY2, 320, 240, GST_VIDEO_FORMAT_YUY2, 176, 143},
+    /* generic path */
+    {GST_VIDEO_FORMAT_I420, 320, 240, GST_VIDEO_FORMAT_ARGB64, 300, 210},
+    {GST_VIDEO_FORMAT_NV12, 320, 240, GST_VIDEO_FORMAT_BGRx, 640, 481},
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (tests); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstBuffer *inbuffer, *outbuffer1, *outbuffer4;
+    GstMapInfo map1;
+
+    gst_video_info_set_format (&ininfo, tests[i].infmt, tests[i].in_width,
+        tests[i].in_height);
+    gst_video_info_set_format (&outinfo, tests[i].outfmt, tests[i].out_width,
+        tests[i].out_height);
+
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    fill_random (inbuffer);
+
+    outbuffer1 = convert_with_threads (&ininfo, inbuffer, &outinfo, 1);
+    outbuffer4 = convert_with_threads (&ininfo, inbuffer, &outinfo, 4);
+
+    GST_DEBUG ("%s %dx%d -> %s %dx%d",
+        gst_video_format_to_string (tests[i].infmt), tests[i].in_width,
+        tests[i].in_height, gst_video_format_to_string (tests[i].outfmt),
+        tests[i].out_width, tests[i].out_height);
+
+    /* splitting the frame over threads must give the exact same result */
+    gst_buffer_map (outbuffer1, &map1, GST_MAP_READ);
+    fail_unless (gst_buffer_memcmp (outbuffer4, 0, map1.data, map1.size) == 0);
+    gst_buffer_unmap (outbuffer1, &map1);
+
+    gst_buffer_unref (outbuffer1);
+    gst_buffer_unref (outbuffer4);
+    gst_buffer_unref (inbuffer);
+  }
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+convert_gamma_remap (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo)
+{
+  return convert_with_config (ininfo, inbuffer, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+          GST_VIDEO_GAMMA_MODE_REMAP, NULL));
+}
+
+static GstVideoConverter *
+new_gamma_remap_converter (GstVideoInfo * ininfo, GstVideoInfo * outinfo)
+{
+  return gst_video_converter_new (ininfo, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+          GST_VIDEO_GAMMA_MODE_REMAP, NULL));
+}
+
+GST_START_TEST (test_video_convert_plan_cache)
+{
+  GstVideoInfo ininfo, outinfo_a, outinfo_b;
+  GstBuffer *inbuffer, *outbuffer_a1, *outbuffer_a2, *outbuffer_b;
+  GstVideoConverter *convert_a1, *convert_a2, *convert_b;
+  GstMapInfo map;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420, 320, 240);
+  gst_video_info_set_format (&outinfo_a, GST_VIDEO_FORMAT_BGRx, 400, 300);
+  gst_video_info_set_format (&outinfo_b, GST_VIDEO_FORMAT_BGRx, 176, 144);
+
+  /* a converter for the same setup must reuse the cached plan, another
+   * setup must get its own plan */
+  convert_a1 = new_gamma_remap_converter (&ininfo, &outinfo_a);
+  convert_b = new_gamma_remap_converter (&ininfo, &outinfo_b);
+  convert_a2 = new_gamma_remap_converter (&ininfo, &outinfo_a);
+  fail_unless (_gst_video_converter_get_plan (convert_a1) != NULL);
+  fail_unless (_gst_video_converter_get_plan (convert_a1) ==
+      _gst_video_converter_get_plan (convert_a2));
+  fail_unless (_gst_video_converter_get_plan (convert_a1) !=
+      _gst_video_converter_get_plan (convert_b));
+  gst_video_converter_free (convert_a1);
+  gst_video_converter_free (convert_a2);
+  gst_video_converter_free (convert_b);
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  fill_random (inbuffer);
+
+  /* switch between two configurations, the second time the first
+   * configuration is used, the converter is made from the cached plan and
+   * must produce the same output */
+  outbuffer_a1 = convert_gamma_remap (&ininfo, inbuffer, &outinfo_a);
+  outbuffer_b = convert_gamma_remap (&ininfo, inbuffer, &outinfo_b);
+  gst_buffer_unref (outbuffer_b);
+  outbuffer_a2 = convert_gamma_remap (&ininfo, inbuffer, &outinfo_a);
+
+  gst_buffer_map (outbuffer_a1, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (outbuffer_a2, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (outbuffer_a1, &map);
+  gst_buffer_unref (outbuffer_a1);
+  gst_buffer_unref (outbuffer_a2);
+
+  /* same for the fastpath with plane scaling */
+  outbuffer_a1 = convert_with_threads (&ininfo, inbuffer, &ininfo, 2);
+  gst_video_info_set_format (&outinfo_a, GST_VIDEO_FORMAT_I420, 400, 318);
+  outbuffer_b = convert_with_threads (&ininfo, inbuffer, &outinfo_a, 2);
+  gst_buffer_unref (outbuffer_b);
+  outbuffer_a2 = convert_with_threads (&ininfo, inbuffer, &ininfo, 2);
+
+  gst_buffer_map (outbuffer_a1, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (outbuffer_a2, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (outbuffer_a1, &map);
+  gst_buffer_unref (outbuffer_a1);
+  gst_buffer_unref (outbuffer_a2);
+
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+static void
+fill_random_masked (GstBuffer * buffer, guint32 mask)
+{
+  GstMapInfo map;
+  guint32 *data;
+  gsize i;
+
+  fill_random (buffer);
+
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  data = (guint32 *) map.data;
+  for (i = 0; i < map.size / 4; i++)
+    data[i] &= GUINT32_TO_LE (mask);
+  gst_buffer_unmap (buffer, &map);
+}
+
+static void
+check_10bit_roundtrip (GstVideoFormat format, GstVideoFormat tmp_format,
+    gint width, gint height, guint32 mask)
+{
+  GstVideoInfo info, tmp_info;
+  GstBuffer *inbuffer, *tmpbuffer, *outbuffer;
+  GstMapInfo map;
+
+  gst_video_info_set_format (&info, format, width, height);
+  gst_video_info_set_format (&tmp_info, tmp_format, width, height);
+
+  inbuffer = gst_buffer_new_and_alloc (info.size);
+  fill_random_masked (inbuffer, mask);
+
+  tmpbuffer = convert_with_config (&info, inbuffer, &tmp_info, NULL);
+  outbuffer = convert_with_config (&tmp_info, tmpbuffer, &info, NULL);
+
+  gst_buffer_map (inbuffer, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (outbuffer, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (inbuffer, &map);
+
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (tmpbuffer);
+  gst_buffer_unref (outbuffer);
+}
+
+GST_START_TEST (test_video_convert_10bit)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoFrame frame;
+  guint16 *p;
+  guint8 *d;
+  gint i, j;
+
+  /* lossless conversions */
+  check_10bit_roundtrip (GST_VIDEO_FORMAT_P010_10LE,
+      GST_VIDEO_FORMAT_I420_10LE, 320, 240, 0xffc0ffc0);
+  check_10bit_roundtrip (GST_VIDEO_FORMAT_P010_10LE,
+      GST_VIDEO_FORMAT_I420_10LE, 322, 242, 0xffc0ffc0);
+  /* the padding bits of v210 are not kept */
+  check_10bit_roundtrip (GST_VIDEO_FORMAT_v210,
+      GST_VIDEO_FORMAT_I422_10LE, 48 * 6, 20, 0x3fffffff);
+
+  /* white and black P010 to BGRA */
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_P010_10LE, 64, 16);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_BGRA, 64, 16);
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&frame, &ininfo, inbuffer, GST_MAP_WRITE);
+  for (i = 0; i < 16; i++) {
+    p = (guint16 *) ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) +
+        i * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0));
+    for (j = 0; j < 64; j++)
+      p[j] = GUINT16_TO_LE ((i < 8 ? 940 : 64) << 6);
+  }
+  for (i = 0; i < 8; i++) {
+    p = (guint16 *) ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 1) +
+        i * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 1));
+    for (j = 0; j < 64; j++)
+      p[j] = GUINT16_TO_LE (512 << 6);
+  }
+  gst_video_frame_unmap (&frame);
+
+  outbuffer = convert_with_config (&ininfo, inbuffer, &outinfo, NULL);
+
+  gst_video_frame_map (&frame, &outinfo, outbuffer, GST_MAP_READ);
+  for (i = 0; i < 16; i++) {
+    d = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) +
+        i * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+    for (j = 0; j < 64 * 4; j += 4) {
+      fail_unless_equals_int (d[j + 0], i < 8 ? 255 : 0);
+      fail_unless_equals_int (d[j + 1], i < 8 ? 255 : 0);
+      fail_unless_equals_int (d[j + 2], i < 8 ? 255 : 0);
+      fail_unless_equals_int (d[j + 3], 255);
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  gst_buffer_unref (inbuffer);
+  gst_buffer_unref (outbuffer);
+}
+
+GST_END_TEST;
+
+static GstStructure *
+tiled_config (guint tile_width)
+{
+  return gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_TILE_WIDTH, G_TYPE_UINT, tile_width,
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      GST_VIDEO_DITHER_NONE, NULL);
+}
+
+#define TIME 0.01               /* set to something larger to do benchmarks */
+
+static gdouble
+time_convert (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo, GstBuffer * outbuffer, GstStructure * config,
+    GTimer * timer)
+{
+  GstVideoFrame inframe, outframe;
+  GstVideoConverter *convert;
+  gdouble elapsed;
+  gint count;
+
+  gst_video_frame_map (&inframe, ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (ininfo, outinfo, config);
+
+  /* warmup */
+  gst_video_converter_frame (convert, &inframe, &outframe);
+
+  count = 0;
+  g_timer_start (timer);
+  while (TRUE) {
+    gst_video_converter_frame (convert, &inframe, &outframe);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= TIME)
+      break;
+  }
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  return count / elapsed;
+}
+
+GST_START_TEST (test_video_convert_tiled)
+{
+  static const struct
+  {
+    GstVideoFormat infmt;
+    GstVideoFormat outfmt;
+    gint width, in_height, out_height;
+  } tests[] = {
+    /* the cache behaviour only depends on the width, keep the frames
+     * short to not use too much memory */
+    {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_BGRx, 3840, 128, 128},
+    {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_RGB, 3840, 256, 128},
+    {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_BGRx, 7680, 128, 128},
+    {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_RGB, 7680, 256, 128},
+    {GST_VIDEO_FORMAT_BGRA, GST_VIDEO_FORMAT_Y42B, 1000, 64, 64},
+  };
+  GTimer *timer;
+  guint i;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (tests); i++) {
+    GstVideoInfo ininfo, outinfo;
+    GstBuffer *inbuffer, *outbuffer, *tiledbuffer;
+    GstMapInfo map;
+    gdouble lines_sec, tiled_sec;
+
+    gst_video_info_set_format (&ininfo, tests[i].infmt, tests[i].width,
+        tests[i].in_height);
+    gst_video_info_set_format (&outinfo, tests[i].outfmt, tests[i].width,
+        tests[i].out_height);
+
+    inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+    fill_random (inbuffer);
+
+    /* converting in strips must give the exact same result */
+    outbuffer = convert_with_config (&ininfo, inbuffer, &outinfo,
+        tiled_config (0));
+    tiledbuffer = convert_with_config (&ininfo, inbuffer, &outinfo,
+        tiled_config (256));
+
+    gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+    fail_unless (gst_buffer_memcmp (tiledbuffer, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (outbuffer, &map);
+
+    lines_sec = time_convert (&ininfo, inbuffer, &outinfo, outbuffer,
+        tiled_config (0), timer);
+    tiled_sec = time_convert (&ininfo, inbuffer, &outinfo, tiledbuffer,
+        tiled_config (256), timer);
+
+    GST_DEBUG ("%s -> %s %dx%d: %f frames/sec, tiled %f frames/sec",
+        gst_video_format_to_string (tests[i].infmt),
+        gst_video_format_to_string (tests[i].outfmt), tests[i].width,
+        tests[i].out_height, lines_sec, tiled_sec);
+
+    gst_buffer_unref (outbuffer);
+    gst_buffer_unref (tiledbuffer);
+    gst_buffer_unref (inbuffer);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+
+#undef TIME
+
+static GstBuffer *
+convert_color_lut (GstVideoInfo * ininfo, GstBuffer * inbuffer,
+    GstVideoInfo * outinfo, guint lut_size)
+{
+  return convert_with_config (ininfo, inbuffer, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+          GST_VIDEO_GAMMA_MODE_REMAP,
+          GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
+          GST_TYPE_VIDEO_PRIMARIES_MODE, GST_VIDEO_PRIMARIES_MODE_FULL,
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE,
+          GST_VIDEO_CONVERTER_OPT_COLOR_LUT_SIZE, G_TYPE_UINT, lut_size,
+          NULL));
+}
+
+GST_START_TEST (test_video_convert_color_lut)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstBuffer *inbuffer, *outbuffer, *lutbuffer;
+  GstVideoFrame frame;
+  GstMapInfo map1, map2;
+  guint16 *p;
+  gsize i;
+  gint x, y, comp;
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420_10LE, 64, 64);
+  gst_video_colorimetry_from_string (&ininfo.colorimetry,
+      GST_VIDEO_COLORIMETRY_BT2020);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_BGRx, 64, 64);
+  gst_video_colorimetry_from_string (&outinfo.colorimetry,
+      GST_VIDEO_COLORIMETRY_SRGB);
+
+  /* luma ramp with mildly saturated colors */
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&frame, &ininfo, inbuffer, GST_MAP_WRITE);
+  for (comp = 0; comp < 3; comp++) {
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&frame, comp); y++) {
+      p = (guint16 *) ((guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame, comp) +
+          y * GST_VIDEO_FRAME_COMP_STRIDE (&frame, comp));
+      for (x = 0; x < GST_VIDEO_FRAME_COMP_WIDTH (&frame, comp); x++) {
+        if (comp == 0)
+          p[x] = GUINT16_TO_LE (64 + x * 14);
+        else
+          p[x] = GUINT16_TO_LE (512 + (comp == 1 ? x : y) * 3 - 48);
+      }
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  outbuffer = convert_color_lut (&ininfo, inbuffer, &outinfo, 0);
+  lutbuffer = convert_color_lut (&ininfo, inbuffer, &outinfo, 33);
+
+  /* the lookup table is interpolated, allow small differences */
+  gst_buffer_map (outbuffer, &map1, GST_MAP_READ);
+  gst_buffer_map (lutbuffer, &map2, GST_MAP_READ);
+  fail_unless_equals_int (map1.size, map2.size);
+  for (i = 0; i < map1.size; i++) {
+    /* skip x */
+    if ((i & 3) == 3)
+      continue;
+    fail_unless (ABS (map1.data[i] - map2.data[i]) <= 2,
+        "byte %" G_GSIZE_FORMAT ": %d != %d", i, map1.data[i], map2.data[i]);
+  }
+  gst_buffer_unmap (lutbuffer, &map2);
+  gst_buffer_unmap (outbuffer, &map1);
+
+  gst_buffer_unref (outbuffer);
+  gst_buffer_unref (lutbuffer);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+static void
+check_matrix (GstVideoInfo * ininfo, GstVideoInfo * outinfo,
+    gboolean fast_matrix, const gchar * expected)
+{
+  GstVideoConverter *convert;
+  const GstStructure *path;
+
+  convert = gst_video_converter_new (ininfo, outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE,
+          GST_VIDEO_CONVERTER_OPT_FAST_MATRIX, G_TYPE_BOOLEAN, fast_matrix,
+          NULL));
+  fail_unless (convert != NULL);
+
+  path = _gst_video_converter_get_path (convert);
+  fail_unless (path != NULL);
+  fail_unless (gst_structure_has_name (path, "generic"));
+  fail_unless_equals_string (gst_structure_get_string (path, "matrix"),
+      expected);
+
+  gst_video_converter_free (convert);
+}
+
+GST_START_TEST (test_video_convert_fast_matrix)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstBuffer *inbuffer, *outbuffer, *fastbuffer;
+  GstVideoFrame frame;
+  GstMapInfo map1, map2;
+  guint8 *p;
+  gsize i;
+  gint x, y;
+
+  /* RGB to full range YUV with the same primaries maps 128 to 128 and
+   * doesn't clip, so both the table and the orc matrix can be used */
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_BGRx, 64, 64);
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_Y444, 64, 64);
+  outinfo.colorimetry.range = GST_VIDEO_COLOR_RANGE_0_255;
+  outinfo.colorimetry.matrix = GST_VIDEO_COLOR_MATRIX_BT601;
+  outinfo.colorimetry.primaries = ininfo.colorimetry.primaries;
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&frame, &ininfo, inbuffer, GST_MAP_WRITE);
+  for (y = 0; y < GST_VIDEO_FRAME_HEIGHT (&frame); y++) {
+    p = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) +
+        y * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+    for (x = 0; x < GST_VIDEO_FRAME_WIDTH (&frame); x++) {
+      p[x * 4 + 0] = x * 4;
+      p[x * 4 + 1] = y * 4;
+      p[x * 4 + 2] = (x + y) * 2;
+      p[x * 4 + 3] = 0xff;
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  /* the option switches from the exact table to the orc matrix */
+  check_matrix (&ininfo, &outinfo, FALSE, "8bit-table");
+  check_matrix (&ininfo, &outinfo, TRUE, "8bit");
+
+  outbuffer = convert_with_config (&ininfo, inbuffer, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE, NULL));
+  fastbuffer = convert_with_config (&ininfo, inbuffer, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE,
+          GST_VIDEO_CONVERTER_OPT_FAST_MATRIX, G_TYPE_BOOLEAN, TRUE, NULL));
+
+  gst_buffer_map (outbuffer, &map1, GST_MAP_READ);
+  gst_buffer_map (fastbuffer, &map2, GST_MAP_READ);
+  fail_unless_equals_int (map1.size, map2.size);
+  for (i = 0; i < map1.size; i++) {
+    fail_unless (ABS (map1.data[i] - map2.data[i]) <= 2,
+        "byte %" G_GSIZE_FORMAT ": %d != %d", i, map1.data[i], map2.data[i]);
+  }
+  gst_buffer_unmap (fastbuffer, &map2);
+  gst_buffer_unmap (outbuffer, &map1);
+
+  gst_buffer_unref (outbuffer);
+  gst_buffer_unref (fastbuffer);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_dither_blue_noise)
+{
+  GstVideoDither *dither;
+  guint quant[GST_VIDEO_MAX_COMPONENTS] = { 256, 256, 256, 256 };
+  guint16 line[32 * 4];
+  guint sum[4];
+  gint x, y, c;
+
+  dither = gst_video_dither_new (GST_VIDEO_DITHER_BLUE_NOISE, 0,
+      GST_VIDEO_FORMAT_AYUV64, quant, 32);
+  fail_unless (dither != NULL);
+
+  /* a flat 128.5 must be dithered to an equal amount of 128 and 129 in
+   * every 16x16 block of the pattern */
+  memset (sum, 0, sizeof (sum));
+  for (y = 0; y < 16; y++) {
+    for (x = 0; x < 32 * 4; x++)
+      line[x] = 0x8080;
+
+    gst_video_dither_line (dither, line, 0, y, 32);
+
+    for (x = 0; x < 32; x++) {
+      for (c = 0; c < 4; c++) {
+        fail_unless_equals_int (line[x * 4 + c] & 0xff, 0);
+        fail_unless (line[x * 4 + c] == 0x8000 || line[x * 4 + c] == 0x8100);
+        if (x < 16)
+          sum[c] += line[x * 4 + c] >> 8;
+      }
+    }
+  }
+  for (c = 0; c < 4; c++)
+    fail_unless_equals_int (sum[c], 128 * 256 + 128);
+
+  gst_video_dither_free (dither);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -2775,9 +3521,17 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_pack_unpack2);
   tcase_add_test (tc_chain, test_video_chroma);
   tcase_add_test (tc_chain, test_video_scaler);
+  tcase_add_test (tc_chain, test_video_scaler_ntap);
   tcase_add_test (tc_chain, test_video_color_convert);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_convert_plan_cache);
+  tcase_add_test (tc_chain, test_video_convert_10bit);
+  tcase_add_test (tc_chain, test_video_convert_tiled);
+  tcase_add_test (tc_chain, test_video_convert_color_lut);
+  tcase_add_test (tc_chain, test_video_convert_fast_matrix);
+  tcase_add_test (tc_chain, test_video_dither_blue_noise);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
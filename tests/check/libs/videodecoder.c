@@ -82,6 +82,7 @@ struct _GstVideoDecoderTester
   guint64 last_buf_num;
   guint64 last_kf_num;
   gboolean set_output_state;
+  gboolean vary_delay;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -150,6 +151,10 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
 
   input_num = *((guint64 *) map.data);
 
+  /* make later frames finish first */
+  if (dectester->vary_delay)
+    g_usleep ((3 - input_num % 4) * 500);
+
   if ((input_num == dectester->last_buf_num + 1
           && dectester->last_buf_num != -1)
       || !GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
@@ -344,6 +349,135 @@ GST_START_TEST (videodecoder_playback)
 
 GST_END_TEST;
 
+static gpointer
+get_pool_stats_func (gpointer data)
+{
+  GstStructure *stats;
+
+  g_object_get (data, "pool-stats", &stats, NULL);
+
+  return stats;
+}
+
+GST_START_TEST (videodecoder_pool_stats)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  GstStructure *stats;
+  GThread *thread;
+  guint64 i, allocated, reused;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless (g_list_length (buffers) == NUM_BUFFERS);
+
+  /* the stats don't wait for the streaming thread */
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  thread = g_thread_new ("pool-stats", get_pool_stats_func, dec);
+  stats = g_thread_join (thread);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+
+  /* frames are recycled once the first ones are finished */
+  fail_unless (gst_structure_get_uint64 (stats, "frames-allocated",
+          &allocated));
+  fail_unless (gst_structure_get_uint64 (stats, "frames-reused", &reused));
+  fail_unless (allocated <= 2);
+  fail_unless_equals_uint64 (allocated + reused, NUM_BUFFERS);
+
+  /* timestamps are only tracked for parsed input */
+  fail_unless (gst_structure_get_uint64 (stats, "timestamps-allocated",
+          &allocated));
+  fail_unless (gst_structure_get_uint64 (stats, "timestamps-reused",
+          &reused));
+  fail_unless_equals_uint64 (allocated + reused, 0);
+  gst_structure_free (stats);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+
+GST_START_TEST (videodecoder_playback_threaded)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_video_decoder_set_max_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_max_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+  ((GstVideoDecoderTester *) dec)->vary_delay = TRUE;
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* all buffers are keyframes so they can be decoded in parallel */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* the output is in decoding order */
+  fail_unless (g_list_length (buffers) == NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+    num = *(guint64 *) map.data;
+    fail_unless (i == num);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
 
 GST_START_TEST (videodecoder_playback_with_events)
 {
@@ -1163,6 +1297,8 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_query_caps_with_custom_getcaps);
 
   tcase_add_test (tc, videodecoder_playback);
+  tcase_add_test (tc, videodecoder_pool_stats);
+  tcase_add_test (tc, videodecoder_playback_threaded);
   tcase_add_test (tc, videodecoder_playback_with_events);
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);